@@ -4,6 +4,7 @@
 #define P3COM_GATEWAY_CONFIG_HPP
 
 #include "p3com/generic/types.hpp"
+#include "p3com/transport/transport_config.hpp"
 
 namespace iox
 {
@@ -13,6 +14,8 @@ struct GatewayConfig_t
 {
     TransportType preferredTransport{TransportType::NONE};
     cxx::vector<capro::ServiceDescription, MAX_FORWARDED_SERVICES> forwardedServices;
+    FecServiceMap_t fecServices;
+    TransportConfig_t transportConfig;
 };
 
 class TomlGatewayConfigParser
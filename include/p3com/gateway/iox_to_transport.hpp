@@ -25,7 +25,9 @@ namespace p3com
 class Iceoryx2Transport : public Gateway<iox::popo::UntypedSubscriber>
 {
   public:
-    explicit Iceoryx2Transport(DiscoveryManager& discovery, PendingMessageManager& pendingMessageManager) noexcept;
+    Iceoryx2Transport(DiscoveryManager& discovery,
+                      PendingMessageManager& pendingMessageManager,
+                      const FecServiceMap_t& fecServices) noexcept;
 
     void updateChannels(const ServiceVector_t& services) noexcept;
 
@@ -39,6 +41,9 @@ class Iceoryx2Transport : public Gateway<iox::popo::UntypedSubscriber>
 
     DiscoveryManager& m_discovery;
     PendingMessageManager& m_pendingMessageManager;
+    const FecServiceMap_t m_fecServices;
+    // Only used by the waitset thread
+    FecParityBuffer_t m_fecParityBuffer;
 
     std::mutex m_waitsetMutex;
     popo::WaitSet<MAX_TOPICS> m_waitset;
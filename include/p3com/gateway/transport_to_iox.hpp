@@ -8,6 +8,7 @@
 #include "p3com/gateway/gateway.hpp"
 #include "p3com/generic/data_reader.hpp"
 #include "p3com/generic/discovery.hpp"
+#include "p3com/generic/fec.hpp"
 #include "p3com/generic/segmented_messages.hpp"
 #include "p3com/generic/transport_forwarder.hpp"
 #include "p3com/generic/types.hpp"
@@ -15,6 +16,7 @@
 #include "p3com/utility/vector_map.hpp"
 
 #include <chrono>
+#include <vector>
 
 namespace iox
 {
@@ -28,7 +30,8 @@ class Transport2Iceoryx : public Gateway<popo::UntypedPublisher>
   public:
     explicit Transport2Iceoryx(DiscoveryManager& discovery,
                                 TransportForwarder& transportForwarder,
-                                SegmentedMessageManager& segmentedMessageManager) noexcept;
+                                SegmentedMessageManager& segmentedMessageManager,
+                                FecManager& fecManager) noexcept;
 
     void updateChannels(const ServiceVector_t& services) noexcept;
 
@@ -37,6 +40,10 @@ class Transport2Iceoryx : public Gateway<popo::UntypedPublisher>
     void deleteChannel(const capro::ServiceDescription& service) noexcept;
 
     void receive(const void* receivedUserPayload, size_t size, DeviceIndex_t deviceIndex) noexcept;
+    bool deliver(const IoxChunkDatagramHeader_t& datagramHeader,
+                 const void* data,
+                 DeviceIndex_t deviceIndex,
+                 popo::UntypedPublisher& publisher) noexcept;
     void* loanBuffer(const void* serializedDatagramHeader, size_t size) noexcept;
     void releaseBuffer(const void* serializedDatagramHeader,
                        size_t size,
@@ -46,6 +53,7 @@ class Transport2Iceoryx : public Gateway<popo::UntypedPublisher>
     DiscoveryManager& m_discovery;
     TransportForwarder& m_transportForwarder;
     SegmentedMessageManager& m_segmentedMessageManager;
+    FecManager& m_fecManager;
 };
 
 } // namespace p3com
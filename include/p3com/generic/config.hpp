@@ -25,7 +25,7 @@ constexpr uint32_t MAX_TOPICS{6U};
 constexpr uint32_t MAX_TOPICS{32U};
 #endif
 
-constexpr uint32_t TRANSPORT_TYPE_COUNT{4U};
+constexpr uint32_t TRANSPORT_TYPE_COUNT{10U};
 
 #if defined(__FREERTOS___)
 constexpr uint32_t MAX_DEVICE_COUNT{2U};
@@ -35,6 +35,28 @@ constexpr uint32_t MAX_DEVICE_COUNT{10U};
 constexpr uint32_t MAX_FORWARDED_SERVICES{8U};
 #endif
 
+#if defined(__FREERTOS__)
+constexpr uint32_t MAX_FEC_SERVICES{2U};
+constexpr uint32_t MAX_FEC_PARITY_COUNT{2U};
+constexpr uint32_t MAX_FEC_SUBMESSAGE_SIZE{1472U};
+constexpr uint32_t MAX_FEC_SUBMESSAGE_COUNT{64U};
+constexpr uint32_t MAX_FEC_PARITY_BUFFER_COUNT{4U};
+#else
+constexpr uint32_t MAX_FEC_SERVICES{8U};
+// Messages using FEC are segmented into submessages of at most the size of a UDP datagram in a jumbo frame
+constexpr uint32_t MAX_FEC_PARITY_COUNT{8U};
+constexpr uint32_t MAX_FEC_SUBMESSAGE_SIZE{8972U};
+constexpr uint32_t MAX_FEC_SUBMESSAGE_COUNT{1024U};
+// Parity submessages kept by the receiver until they are used, shared by all messages
+constexpr uint32_t MAX_FEC_PARITY_BUFFER_COUNT{64U};
+#endif
+
+#if defined(__FREERTOS__)
+constexpr uint32_t MAX_SEND_BATCH_SIZE{4U};
+#else
+constexpr uint32_t MAX_SEND_BATCH_SIZE{64U};
+#endif
+
 constexpr uint32_t USER_HEADER_ALIGNMENT{8U};
 constexpr uint32_t MAX_NETWORK_IFACE_COUNT{10U};
 
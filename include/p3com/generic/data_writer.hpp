@@ -8,10 +8,15 @@
 
 #include "iceoryx_posh/mepoo/chunk_header.hpp"
 
+#include <array>
+
 namespace iox
 {
 namespace p3com
 {
+// Scratch space for the FEC parity submessages of one message, preallocated by the owner of the sending thread
+using FecParityBuffer_t = std::array<uint8_t, static_cast<size_t>(MAX_FEC_PARITY_COUNT) * MAX_FEC_SUBMESSAGE_SIZE>;
+
 /**
  * @brief Write the user message over all enabled transport layers.
  *
@@ -19,7 +24,10 @@ namespace p3com
  * @param chunkHeader
  * @param deviceIndices
  * @param pendingMessageManager
+ * @param mutex
  * @param subscriber
+ * @param fecConfig
+ * @param fecParityBuffer Only used by the calling thread
  *
  * @return 
  */
@@ -28,7 +36,9 @@ void writeSegmented(IoxChunkDatagramHeader_t& datagramHeader,
                     const cxx::vector<DeviceIndex_t, MAX_DEVICE_COUNT>& deviceIndices,
                     PendingMessageManager& pendingMessageManager,
                     std::mutex& mutex,
-                    popo::UntypedSubscriber& subscriber) noexcept;
+                    popo::UntypedSubscriber& subscriber,
+                    const FecConfig_t& fecConfig,
+                    FecParityBuffer_t& fecParityBuffer) noexcept;
 
 } // namespace p3com
 } // namespace iox
@@ -72,6 +72,8 @@ class DiscoveryManager
   private:
     DeviceIndexVector_t computeDeviceIndices(const capro::ServiceDescription::ClassHash& serviceHash) const
         noexcept;
+    void replaceByDeviceGroups(const capro::ServiceDescription::ClassHash& serviceHash,
+                               DeviceIndexVector_t& deviceIndices) const noexcept;
 
     PubSubInfo_t generateDiscoveryInfo() noexcept;
     static void sendDiscoveryInfo(const PubSubInfo_t& info) noexcept;
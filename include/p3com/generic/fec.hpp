@@ -0,0 +1,135 @@
+// Copyright 2023 NXP
+
+#ifndef P3COM_FEC_HPP
+#define P3COM_FEC_HPP
+
+#include "p3com/generic/types.hpp"
+#include "p3com/utility/vector_map.hpp"
+
+#include "iceoryx_hoofs/cxx/vector.hpp"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+
+namespace iox
+{
+namespace p3com
+{
+// Buffer for a single rebuilt user payload submessage
+using FecSubmessageBuffer_t = std::array<uint8_t, MAX_FEC_SUBMESSAGE_SIZE>;
+
+/**
+ * @brief Receiver side of the forward error correction. Keeps track of the received submessages of every message
+ * using FEC and rebuilds lost user payload submessages from the parity submessages. All storage is preallocated, the
+ * parity submessages are kept in a pool shared by all messages.
+ */
+class FecManager
+{
+  public:
+    FecManager() noexcept = default;
+
+    FecManager(const FecManager&) = delete;
+    FecManager(FecManager&&) = delete;
+    FecManager& operator=(const FecManager&) = delete;
+    FecManager& operator=(FecManager&&) = delete;
+    ~FecManager() = default;
+
+    /**
+     * @brief Record a received data submessage.
+     *
+     * @param datagramHeader
+     * @param deadline
+     *
+     * @return False if the submessage was received or recovered before, or if its message is already complete. True
+     * otherwise.
+     */
+    bool acceptData(const IoxChunkDatagramHeader_t& datagramHeader,
+                    std::chrono::steady_clock::time_point deadline) noexcept;
+
+    /**
+     * @brief Keep a received parity submessage until it has been used for the recovery or is not needed anymore.
+     *
+     * @param datagramHeader
+     * @param data
+     * @param deadline
+     */
+    void acceptParity(const IoxChunkDatagramHeader_t& datagramHeader,
+                      const void* data,
+                      std::chrono::steady_clock::time_point deadline) noexcept;
+
+    /**
+     * @brief Rebuild the next lost user payload submessage of a message, if possible.
+     *
+     * @param messageHash
+     * @param userPayload Chunk which the already received submessages were written to, may be nullptr
+     * @param datagramHeader Header of the rebuilt submessage, its submessage size is the size of the data
+     * @param data Data of the rebuilt submessage
+     *
+     * @return True if a submessage was rebuilt.
+     */
+    bool recoverNext(hash_t messageHash,
+                     const uint8_t* userPayload,
+                     IoxChunkDatagramHeader_t& datagramHeader,
+                     FecSubmessageBuffer_t& data) noexcept;
+
+    /**
+     * @brief Forget about a message which was published, all of its further submessages are discarded.
+     *
+     * @param messageHash
+     */
+    void complete(hash_t messageHash) noexcept;
+
+    void checkMessages() noexcept;
+
+    FecStatistics_t getStatistics() const noexcept;
+
+  private:
+    struct Parity_t
+    {
+        // False if the buffer is free
+        bool isUsed{false};
+        hash_t messageHash{0U};
+        uint32_t groupOffset{0U};
+        uint32_t index{0U};
+        FecSubmessageBuffer_t data;
+    };
+
+    struct FecMessage_t
+    {
+        // Datagram header of the first received submessage
+        IoxChunkDatagramHeader_t datagramHeader;
+        // Size of the full user payload submessages, 0 until known
+        uint32_t submessageSize;
+        // Sorted offsets of the received and recovered data submessages
+        cxx::vector<uint32_t, MAX_FEC_SUBMESSAGE_COUNT> receivedOffsets;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    FecMessage_t* findOrCreate(const IoxChunkDatagramHeader_t& datagramHeader,
+                               std::chrono::steady_clock::time_point deadline) noexcept;
+    bool wasCompleted(hash_t messageHash) const noexcept;
+    void releaseParities(hash_t messageHash) noexcept;
+
+    static bool isReceived(const FecMessage_t& message, uint32_t offset) noexcept;
+    static void markReceived(FecMessage_t& message, uint32_t offset) noexcept;
+
+    static constexpr uint32_t COMPLETED_HISTORY_SIZE = 256U;
+#if defined(__FREERTOS__)
+    static constexpr uint32_t MAX_FEC_MESSAGE_COUNT = 4U;
+#else
+    static constexpr uint32_t MAX_FEC_MESSAGE_COUNT = 64U;
+#endif
+
+    mutable std::mutex m_mutex;
+    cxx::vector_map<hash_t, FecMessage_t, MAX_FEC_MESSAGE_COUNT> m_messages;
+    std::array<Parity_t, MAX_FEC_PARITY_BUFFER_COUNT> m_parities;
+    std::array<hash_t, COMPLETED_HISTORY_SIZE> m_completedMessages{};
+    uint32_t m_completedIndex{0U};
+    FecStatistics_t m_statistics;
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // P3COM_FEC_HPP
@@ -0,0 +1,71 @@
+// Copyright 2023 NXP
+
+#ifndef P3COM_LATENCY_HISTOGRAM_HPP
+#define P3COM_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace iox
+{
+namespace p3com
+{
+/**
+ * @brief Lock-free histogram of latencies in nanoseconds.
+ * Every power of two is split into four linear buckets, so the reported percentiles are at most 25 % above the exact
+ * values, from a few nanoseconds up to about four seconds. Latencies beyond are counted in the last bucket.
+ */
+class LatencyHistogram
+{
+  public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 2U;
+    static constexpr uint32_t SUB_BUCKET_COUNT = 1U << SUB_BUCKET_BITS;
+    static constexpr uint32_t BUCKET_COUNT = 128U;
+
+    using Counts_t = std::array<uint64_t, BUCKET_COUNT>;
+
+    LatencyHistogram() noexcept = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+    ~LatencyHistogram() = default;
+
+    /**
+     * @brief Count a latency, negative latencies are counted as zero.
+     *
+     * @param latency
+     */
+    void record(std::chrono::nanoseconds latency) noexcept;
+
+    /**
+     * @brief Current bucket counts, which can be summed up with the counts of other histograms.
+     *
+     * @return
+     */
+    Counts_t counts() const noexcept;
+
+    /**
+     * @brief Upper bound of the bucket which contains the given fraction of all counted latencies.
+     *
+     * @param counts
+     * @param fraction Between 0 and 1, e.g. 0.99 for the 99th percentile
+     *
+     * @return Latency in nanoseconds, 0 if nothing was counted
+     */
+    static uint64_t percentile(const Counts_t& counts, double fraction) noexcept;
+
+  private:
+    static uint32_t bucketIndex(uint64_t value) noexcept;
+    static uint64_t bucketUpperBound(uint32_t index) noexcept;
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts{};
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // P3COM_LATENCY_HISTOGRAM_HPP
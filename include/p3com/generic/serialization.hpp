@@ -39,6 +39,9 @@ constexpr inline uint32_t maxIoxChunkDatagramHeaderSerializationSize() noexcept
     total_size += sizeof(uint32_t);                                   // userPayloadSize
     total_size += sizeof(uint32_t);                                   // userPayloadAlignment
     total_size += sizeof(uint32_t);                                   // userHeaderSize
+    total_size += sizeof(uint32_t);                                   // fecGroupSize
+    total_size += sizeof(uint32_t);                                   // fecParityCount
+    total_size += sizeof(uint32_t);                                   // fecParityIndex
 
     return static_cast<uint32_t>(total_size);
 }
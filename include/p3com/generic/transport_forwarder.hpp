@@ -4,8 +4,10 @@
 #define P3COM_TRANSPORT_FORWARDER_HPP
 
 #include "p3com/generic/config.hpp"
+#include "p3com/generic/data_writer.hpp"
 #include "p3com/generic/discovery.hpp"
 #include "p3com/generic/pending_messages.hpp"
+#include "p3com/generic/types.hpp"
 #include "p3com/utility/vector_map.hpp"
 
 #include "iceoryx_posh/capro/service_description.hpp"
@@ -20,7 +22,8 @@ class TransportForwarder
     TransportForwarder(
         DiscoveryManager& discovery,
         PendingMessageManager& pendingMessageManager,
-        const cxx::vector<capro::ServiceDescription, MAX_FORWARDED_SERVICES>& forwardedServices) noexcept;
+        const cxx::vector<capro::ServiceDescription, MAX_FORWARDED_SERVICES>& forwardedServices,
+        const FecServiceMap_t& fecServices) noexcept;
 
     TransportForwarder(const TransportForwarder&) = delete;
     TransportForwarder(TransportForwarder&&) = delete;
@@ -37,6 +40,9 @@ class TransportForwarder
 
     DiscoveryManager& m_discovery;
     PendingMessageManager& m_pendingMessageManager;
+    const FecServiceMap_t m_fecServices;
+    // Only used by the waitset thread
+    FecParityBuffer_t m_fecParityBuffer;
 
     cxx::vector<capro::ServiceDescription::ClassHash, MAX_FORWARDED_SERVICES> m_forwardedServiceHashes;
 
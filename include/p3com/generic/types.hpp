@@ -10,6 +10,7 @@
 
 #include "p3com/generic/config.hpp"
 #include "p3com/transport/transport_type.hpp"
+#include "p3com/utility/vector_map.hpp"
 
 #include <array>
 #include <cstdint>
@@ -75,6 +76,79 @@ struct IoxChunkDatagramHeader_t
     uint32_t userPayloadAlignment;
     // User header size
     uint32_t userHeaderSize;
+    // Number of user payload submessages protected by one group of parity submessages, 0 if FEC is disabled. The FEC
+    // fields are always serialized, so gateways from before the FEC discard the datagrams as invalid.
+    uint32_t fecGroupSize;
+    // Number of parity submessages per group
+    uint32_t fecParityCount;
+    // Index of this parity submessage within its group, FEC_DATA_INDEX for submessages carrying data
+    uint32_t fecParityIndex;
+};
+
+// Value of IoxChunkDatagramHeader_t::fecParityIndex for submessages carrying data
+constexpr uint32_t FEC_DATA_INDEX{0xFFFFFFFFU};
+
+/**
+ * @brief Forward error correction settings of a service
+ *
+ * @note The user payload submessages of every group are protected by interleaved XOR parity submessages, the parity
+ * submessage with index j covers every data submessage whose index in the group modulo the parity count is j. So, up
+ * to `parityCount` consecutive lost submessages per group can be recovered by the receiver.
+ */
+struct FecConfig_t
+{
+    // Number of user payload submessages per group, 0 disables FEC
+    uint32_t groupSize{0U};
+    // Number of parity submessages per group
+    uint32_t parityCount{0U};
+};
+
+// Forward error correction settings per service
+using FecServiceMap_t = cxx::vector_map<capro::ServiceDescription::ClassHash, FecConfig_t, MAX_FEC_SERVICES>;
+
+/**
+ * @brief Runtime statistics of a transport layer
+ */
+struct TransportStatistics_t
+{
+    // Number of received user data messages (datagrams, frames, ...)
+    uint64_t receivedMessages{0U};
+    // Number of received user data bytes, including the serialized datagram headers
+    uint64_t receivedBytes{0U};
+    // Number of times the receiving thread was woken up to process incoming data
+    uint64_t receiveWakeups{0U};
+    // Number of sent user data messages (datagrams, frames, ...)
+    uint64_t sentMessages{0U};
+    // Number of sent user data bytes, including the serialized datagram headers
+    uint64_t sentBytes{0U};
+    // Number of system calls used to send the user data messages
+    uint64_t sendCalls{0U};
+    // Number of system calls which sent user data straight from the iceoryx chunks with MSG_ZEROCOPY
+    uint64_t zeroCopySends{0U};
+    // Number of zero-copy system calls for which the kernel copied the data after all
+    uint64_t zeroCopyCopiedSends{0U};
+    // Number of user data messages which were sent again on request of the receiver
+    uint64_t retransmittedMessages{0U};
+    // Number of retransmission requests sent to the senders
+    uint64_t retransmitRequests{0U};
+    // Number of user data messages which were dropped because the send queue towards the device was full
+    uint64_t droppedMessages{0U};
+    // Median and 99th percentile of the time from receiving a user data message to handing it over to iceoryx
+    uint64_t receiveLatencyP50Ns{0U};
+    uint64_t receiveLatencyP99Ns{0U};
+    // Current paced send rate in bytes per second, indexed by the device index, 0 if not paced
+    std::array<uint64_t, MAX_DEVICE_COUNT> sendRates{};
+};
+
+/**
+ * @brief Runtime statistics of the forward error correction
+ */
+struct FecStatistics_t
+{
+    // Number of lost user data submessages which were rebuilt from the parity submessages
+    uint64_t recoveredSubmessages{0U};
+    // Number of messages using FEC which could not be completed
+    uint64_t lostMessages{0U};
 };
 
 } // namespace p3com
@@ -6,6 +6,7 @@
 #include "iceoryx_posh/capro/service_description.hpp"
 #include "iceoryx_posh/roudi/introspection_types.hpp"
 #include "p3com/generic/config.hpp"
+#include "p3com/generic/types.hpp"
 
 namespace iox
 {
@@ -26,6 +27,18 @@ struct GwRegisteredData
 const capro::ServiceDescription
     IntrospectionGwService(roudi::INTROSPECTION_SERVICE_ID, "RouDi_ID", "RegisteredPublishers");
 
+/**
+ * @brief Runtime statistics of all transport layers, indexed by the transport type index
+ */
+struct GwTransportStatisticsData
+{
+    std::array<TransportStatistics_t, TRANSPORT_TYPE_COUNT> transports;
+    FecStatistics_t fec;
+};
+
+const capro::ServiceDescription
+    IntrospectionGwStatisticsService(roudi::INTROSPECTION_SERVICE_ID, "RouDi_ID", "TransportStatistics");
+
 } // namespace p3com
 } // namespace iox
 
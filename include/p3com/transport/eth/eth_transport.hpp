@@ -0,0 +1,153 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_ETH_TRANSPORT_HPP
+#define IOX_ETH_TRANSPORT_HPP
+
+#include "p3com/generic/config.hpp"
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/generic/serialization.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <linux/if_ether.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace iox
+{
+namespace p3com
+{
+namespace eth
+{
+/**
+ * @brief Transport layer which sends the discovery messages and the user data directly in Ethernet frames with its own
+ * EtherType, without IP and UDP, e.g. for point-to-point links of an automotive Ethernet backbone. The frames are
+ * exchanged with the kernel through the memory-mapped TPACKET_V3 rings of a packet socket, the receive ring hands
+ * over whole blocks of frames per wakeup. Remote gateways are discovered by broadcast frames, and their device index
+ * is assigned by their MAC address. Discovery messages larger than a frame are fragmented, user data is segmented by
+ * the data writer.
+ */
+class EthernetTransport : public TransportLayer
+{
+  public:
+    explicit EthernetTransport(const EthernetTransportConfig_t& config) noexcept;
+    EthernetTransport(const EthernetTransport&) = delete;
+    EthernetTransport(EthernetTransport&&) = delete;
+    EthernetTransport& operator=(const EthernetTransport&) = delete;
+    EthernetTransport& operator=(EthernetTransport&&) = delete;
+
+    ~EthernetTransport() override;
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
+    void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+
+    void sendBroadcast(const void* data, size_t size) noexcept override;
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
+
+  private:
+    static constexpr uint32_t MAX_DISCOVERY_SIZE = maxPubSubInfoSerializationSize();
+
+    enum class FrameKind : uint8_t
+    {
+        DISCOVERY = 1U,
+        USER_DATA = 2U
+    };
+
+    // Follows the Ethernet header of every frame, the sizes and offsets in network byte order
+    struct FrameHeader_t
+    {
+        FrameKind kind;
+        // Discovery message which a fragment belongs to
+        uint8_t sequence;
+        // Size of the message data in this frame, without the padding to the minimum frame size
+        uint16_t size;
+        // Offset of this fragment in the message
+        uint16_t offset;
+        // Size of the whole message
+        uint16_t totalSize;
+    };
+
+    // Remote gateway, its index is the device index. Devices are only appended, and their address never changes.
+    struct Device_t
+    {
+        std::array<uint8_t, ETH_ALEN> mac;
+        // Only used by the receiving thread, to put the fragments of a discovery message together
+        std::array<uint8_t, MAX_DISCOVERY_SIZE> discoveryBuffer;
+        uint8_t discoverySequence{0U};
+        uint32_t discoveryReceivedSize{0U};
+    };
+
+    bool readInterface() noexcept;
+    bool setUpRings() noexcept;
+    void closeAll() noexcept;
+
+    // Both are called with the send mutex locked
+    bool queueFrame(const uint8_t* destination,
+                    const FrameHeader_t& header,
+                    const void* data1,
+                    size_t size1,
+                    const void* data2,
+                    size_t size2) noexcept;
+    void flush() noexcept;
+
+    void receiveWorker() noexcept;
+    void receiveBlock(const uint8_t* block) noexcept;
+    void handleFrame(const uint8_t* frame, uint32_t size) noexcept;
+    void handleDiscovery(
+        Device_t& device, uint32_t deviceIndex, const FrameHeader_t& header, const uint8_t* data) noexcept;
+    cxx::optional<uint32_t> findDevice(const uint8_t* mac, bool addIfUnknown) noexcept;
+
+    const EthernetTransportConfig_t m_config;
+    uint32_t m_ifindex{0U};
+    std::array<uint8_t, ETH_ALEN> m_localMac;
+    uint32_t m_mtu{0U};
+    int m_socket{-1};
+    // Wakes up the receiving thread for termination
+    int m_wakeEvent{-1};
+
+    // Both rings are mapped at once, the receive ring first
+    uint8_t* m_ring{nullptr};
+    size_t m_ringSize{0U};
+    uint8_t* m_txRing{nullptr};
+    uint32_t m_txFrameSize{0U};
+    uint32_t m_txFrameCount{0U};
+
+    std::atomic<bool> m_isRunning{true};
+    std::thread m_receiveThread;
+
+    // Protects the send ring and the discovery sequence
+    std::mutex m_sendMutex;
+    uint32_t m_txFrame{0U};
+    uint8_t m_discoverySequence{0U};
+
+    std::array<Device_t, MAX_DEVICE_COUNT> m_devices;
+    // Number of devices visible to the sending threads, written by the receiving thread after a device is added
+    std::atomic<uint32_t> m_deviceCount{0U};
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    userDataCallback_t m_userDataCallback;
+    remoteDiscoveryCallback_t m_remoteDiscoveryCallback;
+};
+
+} // namespace eth
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_ETH_TRANSPORT_HPP
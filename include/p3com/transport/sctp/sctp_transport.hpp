@@ -0,0 +1,117 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_SCTP_TRANSPORT_HPP
+#define IOX_SCTP_TRANSPORT_HPP
+
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/transport/socket/socket_discovery.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+// Needs the socket types, which the kernel header does not include
+#include <linux/sctp.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+namespace sctp
+{
+/**
+ * @brief Transport layer over SCTP, with a single one-to-many socket which carries one association per remote
+ * gateway. The device indices are those of the discovery shared with the UDP and TCP transports. Every service class
+ * is mapped to a stream of the association, so that the messages of a service stay in order without waiting for the
+ * retransmissions of other services. SCTP keeps the message boundaries, so messages are not framed, and only messages
+ * larger than the send buffer are segmented. The socket is bound to all interfaces found by the discovery, so that an
+ * association switches to another path when one fails, without reconnecting.
+ */
+class SCTPTransport : public TransportLayer
+{
+  public:
+    explicit SCTPTransport(const SCTPTransportConfig_t& config) noexcept;
+    SCTPTransport(const SCTPTransport&) = delete;
+    SCTPTransport(SCTPTransport&&) = delete;
+    SCTPTransport& operator=(const SCTPTransport&) = delete;
+    SCTPTransport& operator=(SCTPTransport&&) = delete;
+
+    ~SCTPTransport() override;
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
+    void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+
+    void sendBroadcast(const void* data, size_t size) noexcept override;
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
+
+  private:
+    // Differs from the data ports of the UDP and TCP transports, so that all of them can be enabled on the same host
+    static constexpr uint16_t DATA_PORT = 9337U;
+    // Largest number of streams of an association
+    static constexpr uint32_t MAX_STREAM_COUNT = 65535U;
+    // Maximum number of messages read per wakeup, so that the termination is not delayed by a busy socket
+    static constexpr uint32_t MAX_RECEIVE_BATCH = 16U;
+    // Enough for the notifications, which are received into the same buffer as the user data
+    static constexpr uint32_t MIN_RECEIVE_BUFFER_SIZE = 4096U;
+
+    bool openSocket() noexcept;
+    bool bindInterfaces() noexcept;
+    void configureAssociations() noexcept;
+    uint16_t selectStream(const void* serializedDatagramHeader, size_t size) const noexcept;
+
+    void receiveWorker() noexcept;
+    bool receive() noexcept;
+    void handleNotification(const void* data, size_t size) noexcept;
+    void handleUserData(const void* data, size_t size, const sockaddr_in& sender, sctp_assoc_t association) noexcept;
+    cxx::optional<uint32_t> findDevice(const sockaddr_in& sender, sctp_assoc_t association) noexcept;
+
+    const SCTPTransportConfig_t m_config;
+    const uint32_t m_streamCount;
+    // Largest message which fits into the send buffer
+    uint32_t m_maxMessageSize{0U};
+    int m_socket{-1};
+    // Wakes up the receiving thread for termination
+    int m_wakeEvent{-1};
+
+    // Discovery socket shared with the UDP and TCP transports
+    std::shared_ptr<SocketDiscovery> m_discovery;
+
+    std::atomic<bool> m_isRunning{true};
+    std::thread m_receiveThread;
+
+    // Only used by the receiving thread. A message may arrive in several parts, which are put together in the buffer.
+    std::vector<uint8_t> m_receiveBuffer;
+    size_t m_receivedSize{0U};
+    bool m_isDiscarding{false};
+    // Device index of every association, since its messages may arrive from any address of the remote gateway
+    std::unordered_map<sctp_assoc_t, uint32_t> m_associationDevices;
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    userDataCallback_t m_userDataCallback;
+};
+
+} // namespace sctp
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_SCTP_TRANSPORT_HPP
@@ -0,0 +1,193 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_SHM_REGION_HPP
+#define IOX_SHM_REGION_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace iox
+{
+namespace p3com
+{
+namespace shm
+{
+/**
+ * @brief Single producer single consumer ring of descriptors in shared memory. Every position of the ring owns a data
+ * slot of fixed size, so the producer writes the message straight into the slot of the next position and the consumer
+ * hands out a pointer into it until the position is popped.
+ * The consumer can sleep on a doorbell (a futex word) which the producer rings after committing a message, like the
+ * interrupt which signals a completed DMA transfer.
+ */
+class SHMRing
+{
+  public:
+    // Kind of the message in a slot
+    enum class Kind : uint32_t
+    {
+        DISCOVERY = 1U,
+        USER_DATA = 2U,
+        // User data which was copied by the copy worker of the sender, received straight into the loaned chunk
+        USER_DATA_DIRECT = 3U
+    };
+
+    struct Descriptor_t
+    {
+        Kind kind;
+        uint32_t size;
+    };
+
+    SHMRing() noexcept = default;
+
+    /**
+     * @brief Size of the shared memory needed by a ring.
+     *
+     * @param slotCount
+     * @param slotSize
+     *
+     * @return
+     */
+    static size_t requiredSize(uint32_t slotCount, uint32_t slotSize) noexcept;
+
+    /**
+     * @brief Use the ring at the given shared memory, which was zeroed by its creator.
+     *
+     * @param memory
+     * @param slotCount
+     * @param slotSize
+     */
+    void attach(void* memory, uint32_t slotCount, uint32_t slotSize) noexcept;
+
+    /**
+     * @brief Producer: slot of the next position, to be filled and committed.
+     *
+     * @return nullptr if the ring is full.
+     */
+    uint8_t* reserve() noexcept;
+
+    /**
+     * @brief Producer: publish the reserved slot and ring the doorbell.
+     *
+     * @param kind
+     * @param size
+     *
+     * @return True if the consumer was sleeping and had to be woken up with a system call.
+     */
+    bool commit(Kind kind, uint32_t size) noexcept;
+
+    /**
+     * @brief Consumer: oldest message in the ring, which stays valid until it is popped.
+     *
+     * @param descriptor
+     *
+     * @return nullptr if the ring is empty.
+     */
+    const uint8_t* peek(Descriptor_t& descriptor) const noexcept;
+
+    /**
+     * @brief Consumer: release the oldest message.
+     */
+    void pop() noexcept;
+
+    /**
+     * @brief Consumer: drop all messages in the ring, e.g. the ones left over for a previous consumer.
+     */
+    void discard() noexcept;
+
+    /**
+     * @brief Consumer: sleep until a message is committed or the timeout expires.
+     *
+     * @param timeout
+     */
+    void wait(std::chrono::milliseconds timeout) noexcept;
+
+    /**
+     * @brief Wake up the consumer without committing a message, e.g. to let it terminate.
+     */
+    void wake() noexcept;
+
+  private:
+    struct Control_t;
+
+    Control_t* m_control{nullptr};
+    Descriptor_t* m_descriptors{nullptr};
+    uint8_t* m_slots{nullptr};
+    uint32_t m_slotCount{0U};
+    uint32_t m_slotSize{0U};
+};
+
+/**
+ * @brief POSIX shared memory region connecting two gateways on the same host. It contains one ring per direction, and
+ * every gateway claims one of the two sides of the region: it is the consumer of the ring of its side and the producer
+ * of the ring of the other side. Both gateways publish a heartbeat in the region, so that a side whose gateway has
+ * died can be claimed again.
+ */
+class SHMRegion
+{
+  public:
+    SHMRegion() noexcept = default;
+    ~SHMRegion();
+
+    SHMRegion(const SHMRegion&) = delete;
+    SHMRegion& operator=(const SHMRegion&) = delete;
+    SHMRegion(SHMRegion&&) = delete;
+    SHMRegion& operator=(SHMRegion&&) = delete;
+
+    /**
+     * @brief Open or create the region and claim a free side of it.
+     *
+     * @param name Name of the POSIX shared memory object, without the leading slash
+     * @param slotCount Number of slots of every ring, has to be the same for both gateways
+     * @param slotSize Size of every slot, has to be the same for both gateways
+     *
+     * @return False if the region could not be mapped or both sides are in use.
+     */
+    bool open(const std::string& name, uint32_t slotCount, uint32_t slotSize) noexcept;
+
+    /**
+     * @brief Publish the heartbeat of this side, has to be called more often than PEER_TIMEOUT.
+     */
+    void heartbeat() noexcept;
+
+    /**
+     * @brief Is the other side claimed by a gateway which published its heartbeat recently?
+     *
+     * @return
+     */
+    bool isPeerAlive() const noexcept;
+
+    SHMRing& inbound() noexcept;
+    SHMRing& outbound() noexcept;
+
+    // A side without a heartbeat for this long is considered free
+    static constexpr std::chrono::milliseconds PEER_TIMEOUT{1000U};
+
+  private:
+    struct Header_t;
+
+    static constexpr uint32_t SIDE_COUNT = 2U;
+    static constexpr uint32_t MAGIC = 0x70336d73U; // "p3ms"
+    static constexpr uint32_t VERSION = 1U;
+    static constexpr std::chrono::milliseconds INITIALIZATION_TIMEOUT{1000U};
+
+    static uint64_t now() noexcept;
+    static bool isAlive(uint64_t heartbeat, uint64_t timestamp) noexcept;
+
+    bool initialize(uint32_t slotCount, uint32_t slotSize) noexcept;
+    bool claimSide() noexcept;
+
+    void* m_memory{nullptr};
+    size_t m_size{0U};
+    Header_t* m_header{nullptr};
+    uint32_t m_side{SIDE_COUNT};
+    std::array<SHMRing, SIDE_COUNT> m_rings;
+};
+
+} // namespace shm
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_SHM_REGION_HPP
@@ -0,0 +1,132 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_SHM_TRANSPORT_HPP
+#define IOX_SHM_TRANSPORT_HPP
+
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/transport/shm/shm_region.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+namespace shm
+{
+/**
+ * @brief Transport layer between two gateways on the same host, e.g. in containers with their own RouDi, over a POSIX
+ * shared memory region. Small messages are copied into the ring by the sending thread. Large user payloads are handed
+ * over to a copy worker which mimics a DMA engine: the iceoryx chunk stays pending until the worker has copied it into
+ * the ring, and the receiver copies it straight into a loaned chunk. The gateway on the other side of the region is
+ * the only remote device, with the device index 0.
+ */
+class SHMTransport : public TransportLayer
+{
+  public:
+    explicit SHMTransport(const SHMTransportConfig_t& config) noexcept;
+    SHMTransport(const SHMTransport&) = delete;
+    SHMTransport(SHMTransport&&) = delete;
+    SHMTransport& operator=(const SHMTransport&) = delete;
+    SHMTransport& operator=(SHMTransport&&) = delete;
+
+    ~SHMTransport() override;
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
+    void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+    void registerBufferNeededCallback(bufferNeededCallback_t callback) noexcept override;
+    void registerBufferReleasedCallback(bufferReleasedCallback_t callback) noexcept override;
+    void registerBufferSentCallback(bufferSentCallback_t callback) noexcept override;
+
+    void sendBroadcast(const void* data, size_t size) noexcept override;
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    bool willBePending(size_t userPayloadSize) const noexcept override;
+    TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
+
+  private:
+    // Device index of the gateway on the other side of the region
+    static constexpr uint32_t PEER_DEVICE_INDEX = 0U;
+    // Maximum number of messages queued for the copy worker
+    static constexpr uint32_t MAX_COPY_JOB_COUNT = 64U;
+    // Maximum time the receiving thread sleeps, it publishes the heartbeat in between
+    static constexpr std::chrono::milliseconds HEARTBEAT_INTERVAL{100U};
+    // Time the copy worker waits before checking a full ring again
+    static constexpr std::chrono::microseconds FULL_RING_POLL_INTERVAL{50U};
+
+    /**
+     * @brief Message waiting for the copy worker, either to be copied from the chunk or to keep the order of the
+     * messages behind such a copy.
+     */
+    struct CopyJob_t
+    {
+        SHMRing::Kind kind;
+        // Serialized datagram header, followed by the user payload unless it is copied from the chunk
+        std::vector<uint8_t> data;
+        // Pending user payload which is copied straight from the iceoryx chunk, nullptr otherwise
+        const void* userPayload;
+        size_t userPayloadSize;
+    };
+
+    bool send(SHMRing::Kind kind,
+              const void* data1,
+              size_t size1,
+              const void* data2,
+              size_t size2,
+              bool isPending) noexcept;
+    bool isWholeUserPayload(const void* serializedDatagramHeader, size_t size, size_t userDataSize) const noexcept;
+    void commit(SHMRing::Kind kind, size_t size) noexcept;
+    uint8_t* waitForSlot() noexcept;
+    void copyWorker() noexcept;
+    void receiveWorker() noexcept;
+    void receive(const SHMRing::Descriptor_t& descriptor, const uint8_t* data) noexcept;
+    bool receiveDirect(const uint8_t* data, size_t size) noexcept;
+
+    const uint32_t m_slotSize;
+    const uint32_t m_asyncCopyThreshold;
+    SHMRegion m_region;
+
+    std::atomic<bool> m_isRunning{true};
+    std::thread m_receiveThread;
+    std::thread m_copyThread;
+
+    // Protects the producer side of the outbound ring and the copy jobs. While the copy worker is copying, it is the
+    // only producer of the ring.
+    std::mutex m_sendMutex;
+    std::condition_variable m_jobsCondition;
+    std::deque<CopyJob_t> m_jobs;
+    bool m_isCopying{false};
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    userDataCallback_t m_userDataCallback;
+    remoteDiscoveryCallback_t m_remoteDiscoveryCallback;
+    bufferNeededCallback_t m_bufferNeededCallback;
+    bufferReleasedCallback_t m_bufferReleasedCallback;
+    bufferSentCallback_t m_bufferSentCallback;
+};
+
+} // namespace shm
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_SHM_TRANSPORT_HPP
@@ -0,0 +1,45 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_BUSY_POLL_HPP
+#define IOX_BUSY_POLL_HPP
+
+#include <asio.hpp>
+
+#include <chrono>
+
+namespace iox
+{
+namespace p3com
+{
+/**
+ * @brief Low-latency mode of the socket transports, which trades CPU time for receive latency.
+ * Instead of sleeping in epoll, the io thread keeps polling its sockets without blocking for as long as data arrived
+ * within the idle budget, so that a sample arriving meanwhile does not pay the interrupt and scheduler wakeup latency.
+ * Once the budget has passed without any data, the thread blocks as usual until the next event.
+ */
+class BusyPoll
+{
+  public:
+    /**
+     * @brief Let the kernel poll the device queue of the socket for the given time before reporting no data
+     * (SO_BUSY_POLL), and prefer busy polling over interrupts (SO_PREFER_BUSY_POLL).
+     *
+     * @param fd
+     * @param socketBusyPoll
+     */
+    static void enableSocket(int fd, std::chrono::microseconds socketBusyPoll) noexcept;
+
+    /**
+     * @brief Run the handlers of the context like asio::io_service::run, but spin for the idle budget before blocking.
+     * Returns once the context is stopped.
+     *
+     * @param context
+     * @param idleBudget
+     */
+    static void run(asio::io_service& context, std::chrono::microseconds idleBudget);
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_BUSY_POLL_HPP
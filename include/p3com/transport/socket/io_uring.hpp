@@ -0,0 +1,167 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_IO_URING_HPP
+#define IOX_IO_URING_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+/**
+ * @brief Data plane backend based on io_uring, used by the socket transports instead of a system call per send and
+ * receive. A ring of a datagram socket is either used for receiving or for sending:
+ * - Receiving arms one multishot recvmsg on the socket, which keeps producing completions into a ring of provided
+ *   buffers registered with the kernel, so the socket needs no new submission per datagram.
+ * - Sending submits the messages of a batch as linked SQEs, so that they are sent in order with a single
+ *   io_uring_enter, and a failed message cancels the rest of the batch.
+ * A ring of a stream socket does both without blocking: a multishot recv fills the provided buffers with the stream,
+ * and every gather write is a single sendmsg SQE. Their completions are handed over once the file descriptor of the
+ * ring is readable, so that the ring can be driven by an event loop.
+ * The backend is only available if the gateway was built with the IO_URING option and the kernel supports it, the
+ * transports fall back to their regular system calls otherwise.
+ */
+class IoUring
+{
+  public:
+    // Called with the received data, its size and the source address
+    using receiveCallback_t = std::function<void(const void*, size_t, const struct sockaddr_in&)>;
+    // Called with the next received part of the stream and its size
+    using streamCallback_t = std::function<void(const void*, size_t)>;
+    // Called with the number of sent bytes of the completed send, or -errno if it failed
+    using sendCallback_t = std::function<void(int32_t)>;
+
+    IoUring() noexcept;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+    IoUring(IoUring&&) = delete;
+    IoUring& operator=(IoUring&&) = delete;
+
+    /**
+     * @brief Create the ring with the given number of submission queue entries.
+     *
+     * @param entryCount
+     *
+     * @return False if io_uring is not available.
+     */
+    bool initialize(uint32_t entryCount) noexcept;
+
+    /**
+     * @brief Register the provided buffers and arm a multishot recvmsg on the given datagram socket.
+     *
+     * @param fd
+     * @param bufferCount Number of buffers, rounded up to a power of two
+     * @param bufferSize Size of every buffer, has to hold the largest datagram plus the recvmsg metadata
+     *
+     * @return False if the kernel does not support multishot receives with provided buffers.
+     */
+    bool receiveMultishot(int fd, uint32_t bufferCount, size_t bufferSize) noexcept;
+
+    /**
+     * @brief Wait for received datagrams and hand them over to the callback. The buffers are given back to the kernel
+     * right after the callback returned, and the receive is armed again if the kernel stopped it.
+     *
+     * @param callback
+     * @param timeout Maximum time to wait for the first datagram
+     *
+     * @return Number of handled completions, or -1 if the receive failed for good.
+     */
+    int32_t processReceived(const receiveCallback_t& callback, std::chrono::milliseconds timeout) noexcept;
+
+    /**
+     * @brief Send the given messages in order with linked SQEs, with the same semantics as sendmmsg: the number of
+     * sent bytes of every sent message is stored in its msg_len.
+     *
+     * @param fd
+     * @param messages
+     * @param messageCount
+     * @param flags Flags of every sendmsg, e.g. MSG_DONTWAIT to complete right away on a full socket buffer
+     *
+     * @return Number of messages sent before the first failure, or -1 with errno set if the first message failed.
+     */
+    int sendMessages(int fd, struct mmsghdr* messages, uint32_t messageCount, int flags = 0) noexcept;
+
+    /**
+     * @brief Register the provided buffers and arm a multishot recv on the given stream socket.
+     *
+     * @param fd
+     * @param bufferCount Number of buffers, rounded up to a power of two
+     * @param bufferSize Size of every buffer, the largest part of the stream handed over at once
+     *
+     * @return False if the kernel does not support multishot receives with provided buffers.
+     */
+    bool receiveStreamMultishot(int fd, uint32_t bufferCount, size_t bufferSize) noexcept;
+
+    /**
+     * @brief Submit a single sendmsg SQE with all buffers of the given message, without waiting for it. Its result is
+     * handed to the send callback of processStreamCompletions, the message and its buffers have to stay valid until
+     * then. Only one send may be in flight at a time.
+     *
+     * @param fd
+     * @param message
+     * @param flags
+     *
+     * @return False with errno set if the send could not be submitted.
+     */
+    bool submitSend(int fd, const struct msghdr* message, int flags) noexcept;
+
+    /**
+     * @brief Hand the completed receives and sends of the stream socket over to the callbacks, without waiting. The
+     * buffers are given back to the kernel right after the callback returned, and the receive is armed again if the
+     * kernel stopped it.
+     *
+     * @param receiveCallback
+     * @param sendCallback
+     *
+     * @return Number of handled completions, or -1 once the receive has ended, with errno set to its error or to 0 if
+     * the remote side has closed the connection.
+     */
+    int32_t processStreamCompletions(const streamCallback_t& receiveCallback,
+                                     const sendCallback_t& sendCallback) noexcept;
+
+    /**
+     * @brief Cancel the receive and the send in flight and wait for their completions, so that the kernel does not
+     * touch the buffers of the caller anymore. Completions which are still pending are dropped.
+     */
+    void cancel() noexcept;
+
+    /**
+     * @brief File descriptor of the ring, which is readable while completions are pending.
+     *
+     * @return -1 if the ring is not initialized.
+     */
+    int fd() const noexcept;
+
+  private:
+    struct Ring_t;
+
+    bool setupBuffers(uint32_t bufferCount, size_t bufferSize) noexcept;
+    bool armReceive() noexcept;
+
+    std::unique_ptr<Ring_t> m_ring;
+    uint32_t m_entryCount{0U};
+
+    // State of the multishot receive, the message header only describes the layout of the buffers
+    int m_receiveFd{-1};
+    bool m_isStream{false};
+    bool m_isReceiveArmed{false};
+    bool m_isSending{false};
+    struct msghdr m_receiveMessage{};
+    uint32_t m_bufferCount{0U};
+    size_t m_bufferSize{0U};
+    std::vector<uint8_t> m_buffers;
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_IO_URING_HPP
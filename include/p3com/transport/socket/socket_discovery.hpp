@@ -0,0 +1,122 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_SOCKET_DISCOVERY_HPP
+#define IOX_SOCKET_DISCOVERY_HPP
+
+#include "p3com/generic/config.hpp"
+#include "p3com/transport/transport.hpp"
+
+#include <asio.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+/**
+ * @brief Discovery over UDP broadcasts, shared by the socket transports (UDP, TCP, SCTP and AF_XDP) of the gateway.
+ * There is a single discovery socket per process, so that both transports can be enabled at the same time. Every
+ * transport registers its own discovery callback, and every received discovery message is reported to all of them
+ * with the device index of the sender. The device indices are the same for all transports, which is why the data
+ * sockets of the transports are only distinguished by their ports.
+ */
+class SocketDiscovery : public TransportLayerBase
+{
+  public:
+    /**
+     * @brief Get the discovery of this process, it is created by the first transport which needs it and lives as long
+     * as any transport holds it.
+     *
+     * @return
+     */
+    static std::shared_ptr<SocketDiscovery> acquire() noexcept;
+
+    SocketDiscovery() noexcept;
+
+    SocketDiscovery(const SocketDiscovery&) = delete;
+    SocketDiscovery& operator=(const SocketDiscovery&) = delete;
+    SocketDiscovery(SocketDiscovery&&) = delete;
+    SocketDiscovery& operator=(SocketDiscovery&&) = delete;
+    ~SocketDiscovery();
+
+    /**
+     * @brief Register the discovery callback of the given transport, it is called from the discovery thread.
+     *
+     * @param transport
+     * @param callback
+     */
+    void registerDiscoveryCallback(TransportType transport, remoteDiscoveryCallback_t callback) noexcept;
+
+    /**
+     * @brief Remove the discovery callback of the given transport. The callback is not running anymore once this
+     * returns, so the transport can be destroyed afterwards.
+     *
+     * @param transport
+     */
+    void unregisterDiscoveryCallback(TransportType transport) noexcept;
+
+    /**
+     * @brief Broadcast the discovery message on all interfaces. The gateway hands the same message to every enabled
+     * transport, so a message which is identical to the previous one is only sent once.
+     *
+     * @param data
+     * @param size
+     */
+    void sendBroadcast(const void* data, size_t size) noexcept;
+
+    uint64_t discoveredEndpoints() const noexcept;
+    asio::ip::udp::endpoint getEndpoint(uint32_t deviceIndex) noexcept;
+    cxx::optional<asio::ip::address> getAddress(uint32_t deviceIndex) const noexcept;
+    cxx::optional<uint32_t> getIndex(asio::ip::address address) const noexcept;
+
+    /**
+     * @brief Get the addresses of the non-loopback interfaces which the discovery messages are broadcast on
+     *
+     * @return
+     */
+    cxx::vector<asio::ip::address, MAX_NETWORK_IFACE_COUNT> interfaceAddresses() const noexcept;
+
+  private:
+    static constexpr uint16_t DISCOVERY_PORT = 9332U;
+    static constexpr uint32_t MAX_DATAGRAM_SIZE = 32768U; // 32 kB
+
+    static uint32_t sockAddrToUint32(struct sockaddr* address) noexcept;
+    static std::string inetNtoA(uint32_t addr) noexcept;
+
+    void discoverySocketCallback(asio::error_code ec, size_t bytes) noexcept;
+    void discoveryAsyncReceive() noexcept;
+    void discoverBroadcastAddresses() noexcept;
+
+    asio::io_service m_context;
+    cxx::optional<asio::io_service::work> m_work;
+    std::thread m_thread;
+
+    asio::ip::udp::socket m_discoverySocket;
+    cxx::vector<asio::ip::udp::endpoint, MAX_NETWORK_IFACE_COUNT> m_interfaceEndpoints;
+    cxx::vector<asio::ip::udp::endpoint, MAX_NETWORK_IFACE_COUNT> m_broadcastEndpoints;
+    std::array<uint8_t, MAX_DATAGRAM_SIZE> m_outputBuffer;
+    asio::ip::udp::endpoint m_outputEndpoint;
+
+    // Protects m_callbacks, held while a callback is running
+    std::mutex m_callbacksMutex;
+    std::array<remoteDiscoveryCallback_t, TRANSPORT_TYPE_COUNT> m_callbacks;
+
+    // Protects the sending socket and m_lastBroadcast
+    std::mutex m_sendMutex;
+    std::vector<uint8_t> m_lastBroadcast;
+
+    // Protects m_devices, which is looked up by the user data threads while the discovery thread adds new devices
+    mutable std::mutex m_devicesMutex;
+    cxx::vector<asio::ip::udp::endpoint, MAX_DEVICE_COUNT> m_devices;
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_SOCKET_DISCOVERY_HPP
@@ -0,0 +1,126 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_ZERO_COPY_TRACKER_HPP
+#define IOX_ZERO_COPY_TRACKER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <sys/socket.h>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+/**
+ * @brief Bookkeeping of the sends of a socket with MSG_ZEROCOPY.
+ * The kernel keeps referencing the sent user memory until it reports the completion of the send on the error queue
+ * of the socket. Every successful send call with MSG_ZEROCOPY gets the next number of a per socket counter, and the
+ * completions are reported as ranges of these numbers. The tracker maps the numbers back to the keys of the sent
+ * buffers and reports a key once all of its sends have completed.
+ */
+class ZeroCopyTracker
+{
+  public:
+    using completionCallback_t = std::function<void(uint64_t)>;
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    static constexpr int SEND_FLAG = MSG_ZEROCOPY;
+#else
+    static constexpr int SEND_FLAG = 0;
+#endif
+
+    /**
+     * @brief Create the tracker for a socket.
+     *
+     * @param completionCallback Called with every key once all of its sends have completed
+     * @param maxFreeDataCount Number of completed data buffers which are kept for reuse with acquireData
+     */
+    explicit ZeroCopyTracker(completionCallback_t completionCallback, uint32_t maxFreeDataCount = 0U) noexcept;
+
+    ZeroCopyTracker(const ZeroCopyTracker&) = delete;
+    ZeroCopyTracker& operator=(const ZeroCopyTracker&) = delete;
+    ZeroCopyTracker(ZeroCopyTracker&&) = delete;
+    ZeroCopyTracker& operator=(ZeroCopyTracker&&) = delete;
+    ~ZeroCopyTracker() = default;
+
+    /**
+     * @brief Enable MSG_ZEROCOPY sends on the given socket.
+     *
+     * @param fd
+     *
+     * @return False if the platform or the socket does not support it.
+     */
+    static bool enable(int fd) noexcept;
+
+    /**
+     * @brief Record the send calls which were just made with MSG_ZEROCOPY for the given key. Has to be called in the
+     * order of the send calls, i.e. while holding the lock of the socket.
+     *
+     * @param key
+     * @param sendCount Number of successful send calls with MSG_ZEROCOPY
+     * @param data Memory referenced by the sends besides the buffer of the key, kept until they have completed
+     *
+     * @return False if no send has to be waited for, the key is not reported then.
+     */
+    bool track(uint64_t key, uint32_t sendCount, std::vector<uint8_t>&& data) noexcept;
+
+    /**
+     * @brief Get the data buffer of a completed send for reuse, so that the memory referenced by the sends is not
+     * allocated for every send.
+     *
+     * @return Empty buffer which keeps its capacity, or a new one if none is free.
+     */
+    std::vector<uint8_t> acquireData() noexcept;
+
+    /**
+     * @brief Read all completions from the error queue of the socket and report the completed keys.
+     *
+     * @param fd
+     */
+    void drain(int fd) noexcept;
+
+    /**
+     * @brief Report all keys which are still in flight, to be called once the socket is closed. The tracker can be
+     * used for a new socket afterwards.
+     */
+    void releaseAll() noexcept;
+
+    /**
+     * @brief Number of send calls which were completed by copying the data after all, e.g. over the loopback device.
+     *
+     * @return
+     */
+    uint64_t copiedSends() const noexcept;
+
+  private:
+    struct Send_t
+    {
+        uint64_t key;
+        uint32_t firstId;
+        uint32_t count;
+        uint32_t remaining;
+        std::vector<uint8_t> data;
+    };
+
+    void complete(uint32_t firstId, uint32_t lastId) noexcept;
+    // Called with the mutex held
+    void releaseData(std::vector<uint8_t>&& data) noexcept;
+
+    std::mutex m_mutex;
+    uint32_t m_nextId{0U};
+    std::deque<Send_t> m_sends;
+    const uint32_t m_maxFreeDataCount;
+    std::vector<std::vector<uint8_t>> m_freeData;
+    std::atomic<uint64_t> m_copiedSends{0U};
+
+    completionCallback_t m_completionCallback;
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_ZERO_COPY_TRACKER_HPP
@@ -8,6 +8,7 @@
 
 #include <asio.hpp>
 
+#include <chrono>
 #include <functional>
 #include <string>
 
@@ -23,26 +24,38 @@ class TCPClientTransportSession : public TCPTransportSession
     using sessionOpenCallback_t = std::function<void(TCPTransportSession *)>;
 
     TCPClientTransportSession(asio::io_service& io_service,
+                              const TCPTransportConfig_t& config,
                               const dataCallback_t& dataCallbackHandler,
+                              const largeMessageCallback_t& largeMessageHandler,
+                              const largeMessageReadCallback_t& largeMessageReadHandler,
+                              const zeroCopySentCallback_t& zeroCopySentHandler,
                               const sessionClosedCallback_t& sessionClosedHandler,
                               const sessionOpenCallback_t& sessionOpenHandler,
-                              asio::ip::tcp::endpoint remote_endpoint = asio::ip::tcp::endpoint(),
-                              int max_reconnection_attempts = 3) noexcept;
+                              asio::ip::tcp::endpoint remote_endpoint = asio::ip::tcp::endpoint()) noexcept;
 
     asio::ip::tcp::endpoint remoteEndpoint() noexcept override;
     void start() noexcept override;
 
+    /**
+     * @brief Stop reconnecting and close the session, e.g. once the remote gateway has terminated.
+     */
+    void stop() noexcept override;
+
   private:
-    static constexpr std::chrono::seconds M_RETRY_TIMEOUT{1};
+    // The time between connection attempts doubles after every failed attempt, up to the maximum
+    static constexpr std::chrono::milliseconds MIN_RETRY_TIMEOUT{100};
+    static constexpr std::chrono::milliseconds MAX_RETRY_TIMEOUT{10000};
 
     asio::ip::tcp::resolver m_resolver;
     asio::ip::tcp::endpoint m_remoteEndpoint;
-    int m_retriesLeft;
+    std::chrono::milliseconds m_retryTimeout;
+    bool m_isStopped{false};
     asio::steady_timer m_retryTimer;
     const sessionOpenCallback_t m_sessionOpenCallback;
 
     void connectToEndpoint() noexcept;
     void connectionFailedHandler() noexcept;
+    void connectionLost(std::error_code ec) noexcept override;
 };
 
 } // namespace tcp
@@ -20,7 +20,11 @@ class TCPServerTransportSession : public TCPTransportSession
 {
   public:
     TCPServerTransportSession(asio::io_service& io_service,
+                              const TCPTransportConfig_t& config,
                               const dataCallback_t& dataCallbackHandler,
+                              const largeMessageCallback_t& largeMessageHandler,
+                              const largeMessageReadCallback_t& largeMessageReadHandler,
+                              const zeroCopySentCallback_t& zeroCopySentHandler,
                               const sessionClosedCallback_t& sessionClosedHandler) noexcept;
 
     asio::ip::tcp::endpoint remoteEndpoint() noexcept override;
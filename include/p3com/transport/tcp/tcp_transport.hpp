@@ -5,13 +5,19 @@
 
 #include "p3com/transport/tcp/tcp_transport_session.hpp"
 #include "p3com/transport/tcp/tcp_client_transport_session.hpp"
+#include "p3com/transport/socket/socket_discovery.hpp"
 #include "p3com/transport/transport.hpp"
-#include "p3com/transport/udp/udp_transport_broadcast.hpp"
+#include "p3com/transport/transport_config.hpp"
+#include "p3com/generic/latency_histogram.hpp"
 #include "p3com/generic/serialization.hpp"
 
 #include <asio.hpp>
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <thread>
+#include <vector>
 
 namespace iox
 {
@@ -22,7 +28,7 @@ namespace tcp
 class TCPTransport : public TransportLayer
 {
   public:
-    TCPTransport() noexcept;
+    explicit TCPTransport(const TCPTransportConfig_t& config) noexcept;
     TCPTransport(const TCPTransport&) = delete;
     TCPTransport(TCPTransport&&) = delete;
     TCPTransport& operator=(const TCPTransport&) = delete;
@@ -32,45 +38,91 @@ class TCPTransport : public TransportLayer
 
     void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
     void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+    void registerBufferNeededCallback(bufferNeededCallback_t callback) noexcept override;
+    void registerBufferReleasedCallback(bufferReleasedCallback_t callback) noexcept override;
+    void registerBufferSentCallback(bufferSentCallback_t callback) noexcept override;
 
     void sendBroadcast(const void* data, size_t size) noexcept override;
     bool sendUserData(
         const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
 
-    size_t maxMessageSize() const noexcept override;
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    bool willBePending(size_t userPayloadSize) const noexcept override;
     TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
 
   private:
-    static constexpr uint16_t DATA_PORT = 9333U;
+    // Differs from the data port of the UDP transport, so that both transports can be enabled on the same host
+    static constexpr uint16_t DATA_PORT = 9335U;
+    // Maximum number of bulk connections to a single device
+    static constexpr uint32_t MAX_BULK_CONNECTION_COUNT = 8U;
+
+    /**
+     * @brief Connections to a remote gateway. The first connection is the lane for small and latency sensitive
+     * messages, all further connections are bulk lanes. Both gateways choose the lanes of their sends independently,
+     * as the two directions of a connection do not block each other.
+     */
+    struct Peer_t
+    {
+        // The slot of a peer is its device index. A free slot keeps the address of its last gateway, which gets the
+        // same device index again when it comes back.
+        bool isUsed{false};
+        asio::ip::address address;
+        // Whether the connections were opened by this gateway or accepted from the remote gateway
+        bool isClient{false};
+        // Shared with the sending threads, which keep a session alive while sending even if it is closed meanwhile
+        std::vector<std::shared_ptr<TCPTransportSession>> sessions;
+    };
+
+    const TCPTransportConfig_t m_config;
+    const uint32_t m_bulkConnectionCount;
 
     asio::io_service m_context;
     cxx::optional<asio::io_service::work> m_work;
     std::thread m_thread;
 
     asio::ip::tcp::acceptor m_dataAcceptor;
-    udp::UDPBroadcast m_broadcast;
-    mutable std::mutex m_transportSessionsMutex;
+    // Discovery socket shared with the UDP transport
+    std::shared_ptr<SocketDiscovery> m_discovery;
+    mutable std::mutex m_peersMutex;
 
-    cxx::vector<std::unique_ptr<TCPTransportSession>, MAX_DEVICE_COUNT> m_transportSessions;
+    std::array<Peer_t, MAX_DEVICE_COUNT> m_peers;
     cxx::vector<std::pair<asio::ip::tcp::endpoint, cxx::vector<uint8_t, maxPubSubInfoSerializationSize()>>,
                 MAX_DEVICE_COUNT>
         m_infoToReport;
-    std::unique_ptr<TCPTransportSession> m_serverListeningSession;
+    std::shared_ptr<TCPTransportSession> m_serverListeningSession;
+
+    // Send counters of the sessions which have already been closed, guarded by the peers mutex
+    TransportStatistics_t m_closedSessionStatistics;
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    LatencyHistogram m_receiveLatency;
 
     userDataCallback_t m_userDataCallback;
     remoteDiscoveryCallback_t m_remoteDiscoveryCallback;
+    bufferNeededCallback_t m_bufferNeededCallback;
+    bufferReleasedCallback_t m_bufferReleasedCallback;
+    bufferSentCallback_t m_bufferSentCallback;
 
     void startAccept() noexcept;
-    void addSession() noexcept;
-    void addSession(asio::ip::tcp::endpoint& endpoint) noexcept;
+    bool acceptSession() noexcept;
+    void addPeer(asio::ip::tcp::endpoint& endpoint) noexcept;
+    Peer_t* allocatePeer(const asio::ip::address& address) noexcept;
+    bool isZeroCopy(const void* serializedDatagramHeader, size_t size, size_t userDataSize) const noexcept;
+    const std::shared_ptr<TCPTransportSession>&
+    selectLane(const Peer_t& peer, const void* serializedDatagramHeader, size_t size) const noexcept;
 
     void udpDiscoveryCallback(const void* epIter, size_t size, DeviceIndex_t deviceIndex) noexcept;
+    void handleDiscoveryInfo(const void* data, size_t size, DeviceIndex_t deviceIndex, bool isTermination) noexcept;
     void remoteDiscoveryHandler(const void* data, size_t size, const uint32_t device) const noexcept;
 
     static TCPTransportSession::dataCallback_t handleUserDataCallback(TCPTransport* self) noexcept;
+    static TCPTransportSession::largeMessageCallback_t handleLargeMessage(TCPTransport* self) noexcept;
+    static TCPTransportSession::largeMessageReadCallback_t handleLargeMessageRead(TCPTransport* self) noexcept;
+    static TCPTransportSession::zeroCopySentCallback_t handleZeroCopySent(TCPTransport* self) noexcept;
     static TCPTransportSession::sessionClosedCallback_t handleSessionClose(TCPTransport* self) noexcept;
     static TCPClientTransportSession::sessionOpenCallback_t handleSessionOpen(TCPTransport* self) noexcept;
-    std::unique_ptr<tcp::TCPTransportSession>* findSession(const asio::ip::tcp::endpoint& endpoint) noexcept;
+    Peer_t* findPeer(const asio::ip::address& address) noexcept;
 };
 
 } // namespace tcp
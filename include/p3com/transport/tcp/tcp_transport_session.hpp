@@ -3,10 +3,25 @@
 #ifndef IOX_TCP_TRANSPORT_SESSION_HPP
 #define IOX_TCP_TRANSPORT_SESSION_HPP
 
+#include "p3com/generic/serialization.hpp"
+#include "p3com/generic/types.hpp"
+#include "p3com/transport/socket/io_uring.hpp"
+#include "p3com/transport/socket/zero_copy_tracker.hpp"
+#include "p3com/transport/transport_config.hpp"
+
 #include <asio.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
 
 namespace iox
 {
@@ -14,14 +29,46 @@ namespace p3com
 {
 namespace tcp
 {
-class TCPTransportSession
+/**
+ * @brief Connection to a remote gateway. Sessions are owned by shared pointers, every pending asynchronous operation
+ * keeps its session alive until its handler has run.
+ */
+class TCPTransportSession : public std::enable_shared_from_this<TCPTransportSession>
 {
   public:
-    using dataCallback_t = std::function<void(const void*, size_t, asio::ip::tcp::endpoint)>;
+    // The time point is when the beginning of the message was read from the socket
+    using dataCallback_t =
+        std::function<void(const void*, size_t, asio::ip::tcp::endpoint, std::chrono::steady_clock::time_point)>;
     using sessionClosedCallback_t = std::function<void(TCPTransportSession*)>;
 
+    /**
+     * @brief Buffer for the rest of a large message, which is read straight into it
+     */
+    struct MessageBuffer_t
+    {
+        // Destination of the message after its header, nullptr if the message should be discarded
+        void* data;
+        // Size of the header at the beginning of the message, which is not stored in the buffer
+        size_t headerSize;
+        // Device which sent the message, handed back once the message is read
+        uint32_t deviceIndex;
+    };
+    // Called with the beginning of a large message, the size of this beginning, the size of the whole message and the
+    // remote endpoint
+    using largeMessageCallback_t = std::function<MessageBuffer_t(const void*, size_t, size_t, asio::ip::tcp::endpoint)>;
+    // Called with the header of a large message, its size, whether the message was read completely, the device index
+    // of its buffer and when the beginning of the message was read from the socket
+    using largeMessageReadCallback_t =
+        std::function<void(const void*, size_t, bool, uint32_t, std::chrono::steady_clock::time_point)>;
+    // Called with the user payload of a pending message once the kernel does not reference it anymore
+    using zeroCopySentCallback_t = std::function<void(const void*)>;
+
     TCPTransportSession(asio::io_service& io_service,
+                        const TCPTransportConfig_t& config,
                         const dataCallback_t& dataCallbackHandler,
+                        const largeMessageCallback_t& largeMessageHandler,
+                        const largeMessageReadCallback_t& largeMessageReadHandler,
+                        const zeroCopySentCallback_t& zeroCopySentHandler,
                         const sessionClosedCallback_t& sessionClosedHandler) noexcept;
 
     // Copy
@@ -37,22 +84,207 @@ class TCPTransportSession
     virtual asio::ip::tcp::endpoint remoteEndpoint() noexcept = 0;
     virtual void start() noexcept = 0;
 
+    /**
+     * @brief Close the session for good, the session closed callback is called with it.
+     */
+    virtual void stop() noexcept;
+
     asio::ip::tcp::socket& getSocket() noexcept;
     std::string endpointToString() noexcept;
     std::string remoteEndpointToString() noexcept;
-    bool sendData(const void* data1, size_t size1, const void* data2, size_t size2) noexcept;
 
+    /**
+     * @brief Queue a message for sending. The message is copied into a frame with its length prefix, which is written
+     * by the io thread. If the send queue is full, the caller waits for the configured send queue timeout at most and
+     * the message is dropped afterwards. Messages to a disconnected device are dropped right away.
+     *
+     * @param data1
+     * @param size1
+     * @param data2
+     * @param size2
+     * @param isZeroCopy Send the second part straight from its memory with MSG_ZEROCOPY instead of copying it
+     *
+     * @return True if the second part is sent with MSG_ZEROCOPY and the message is pending until the zero-copy sent
+     * callback is called with it.
+     */
+    bool sendData(const void* data1, size_t size1, const void* data2, size_t size2, bool isZeroCopy = false) noexcept;
+
+    /**
+     * @brief Add the send, zero-copy and receive wakeup counters of this session to the given statistics.
+     *
+     * @param stats
+     */
+    void addStatistics(TransportStatistics_t& stats) const noexcept;
+
+    // Larger messages are not handed over from the read buffer, but read straight into a buffer of the receiver
     static constexpr size_t MAX_PACKET_SIZE = 65535U; // 64 kB
 
   private:
+    // Maximum number of frames written with a single gather write
+    static constexpr uint32_t MAX_GATHER_FRAMES = 64U;
+    // Maximum number of written frames kept for reuse, larger frames are never reused
+    static constexpr uint32_t MAX_FREE_FRAMES = 16U;
+    // Size of a frame with the largest message
+    static constexpr size_t MAX_FRAME_SIZE = sizeof(size_t) + MAX_PACKET_SIZE;
+    // The read buffer holds several frames, so that streams of small messages are read with a single system call
+    static constexpr size_t READ_BUFFER_SIZE = 4U * MAX_FRAME_SIZE;
+    // Beginning of a large message which is read before its buffer is requested, holds the largest datagram header
+    static constexpr size_t LARGE_MESSAGE_PEEK_SIZE = maxIoxChunkDatagramHeaderSerializationSize();
+    // Number of heartbeat intervals without any received data after which the connection is considered lost
+    static constexpr uint32_t HEARTBEAT_TIMEOUT_FACTOR = 3U;
+    // Submission queue size of the io_uring of a connection, which only ever has a receive, a send and a cancel
+    static constexpr uint32_t IO_URING_ENTRY_COUNT = 4U;
+    // Provided buffers of the io_uring receive, every completion hands over one buffer of the stream at most
+    static constexpr uint32_t IO_URING_BUFFER_COUNT = 16U;
+    static constexpr size_t IO_URING_BUFFER_SIZE = 65536U;
+
+    /**
+     * @brief Length prefixed message
+     */
+    struct Frame_t
+    {
+        // Length prefix followed by the copied message, or only by its first part for zero-copy frames
+        std::vector<uint8_t> data;
+        // Second part of the message which is sent straight from its memory, nullptr if the message is copied
+        const void* zeroCopyData{nullptr};
+        size_t zeroCopySize{0U};
+        // Size of the whole frame
+        size_t size{0U};
+    };
+
+    /**
+     * @brief Frames waiting to be written by the io thread. It is shared with the pending write handlers, so that they
+     * can tell whether the session has been closed in the meantime.
+     */
+    struct SendQueue_t
+    {
+        std::mutex mutex;
+        std::condition_variable spaceAvailable;
+        // Length prefixed frames in the order of the sendData calls
+        std::deque<Frame_t> frames;
+        // Frames of the gather write in flight, a zero-copy frame is always written on its own
+        std::vector<Frame_t> writing;
+        std::vector<std::vector<uint8_t>> freeFrames;
+        // Size of all queued and written frames, including the frames reserved by the senders which are being filled
+        size_t queuedBytes{0U};
+        bool isWriting{false};
+        bool isOpen{true};
+        // Whether the socket is connected, messages are only queued while it is
+        bool isConnected{false};
+        // Number of the current connection, the write handlers of a lost connection do not touch the queue anymore
+        uint32_t connection{0U};
+    };
+
+    void startWrite(const std::shared_ptr<SendQueue_t>& queue) noexcept;
+    void writeCompleted(const std::shared_ptr<SendQueue_t>& queue, uint32_t connection, std::error_code ec) noexcept;
+    void writeZeroCopy(const std::shared_ptr<SendQueue_t>& queue,
+                       uint32_t connection,
+                       std::vector<asio::const_buffer> buffers,
+                       uint32_t sendCount) noexcept;
+    void zeroCopyErrorAsyncWait() noexcept;
+    void receiveTcpData() noexcept;
+    bool processReadData(size_t size) noexcept;
+    bool readLargeMessage(size_t messageSize, std::chrono::steady_clock::time_point readTime) noexcept;
+    void readLargeMessageData(uint8_t* data, size_t size, std::chrono::steady_clock::time_point readTime) noexcept;
+    bool startRing() noexcept;
+    void stopRing() noexcept;
+    void ringAsyncWait() noexcept;
+    void ringReceived(const uint8_t* data, size_t size) noexcept;
+    void ringWrite(const std::shared_ptr<SendQueue_t>& queue,
+                   uint32_t connection,
+                   std::vector<asio::const_buffer> buffers) noexcept;
+    void ringSendCompleted(int32_t result) noexcept;
+    void abortConnection() noexcept;
+    void enableBusyPoll() noexcept;
+    void enableZeroCopy() noexcept;
+    void enableFailureDetection() noexcept;
+    void startHeartbeat() noexcept;
+    void sendHeartbeat() noexcept;
+
+    asio::io_service& m_ioService;
+    const std::chrono::microseconds m_socketBusyPoll;
+    const size_t m_sendQueueSize;
+    const std::chrono::milliseconds m_sendQueueTimeout;
+    const std::chrono::milliseconds m_userTimeout;
+    const std::chrono::seconds m_keepAlive;
+    const std::chrono::milliseconds m_heartbeatInterval;
+    const bool m_isIoUring;
     const sessionClosedCallback_t m_sessionClosedCallback;
     const dataCallback_t m_dataCallback;
+    const largeMessageCallback_t m_largeMessageCallback;
+    const largeMessageReadCallback_t m_largeMessageReadCallback;
+    const zeroCopySentCallback_t m_zeroCopySentCallback;
     asio::ip::tcp::socket m_dataSocket;
-    size_t m_readBufferSize;
-    std::array<uint8_t, MAX_PACKET_SIZE> m_readBuffer;
+    // Received frames which have not been handed over yet are stored between the begin and the end offset
+    std::array<uint8_t, READ_BUFFER_SIZE> m_readBuffer;
+    size_t m_readBegin{0U};
+    size_t m_readEnd{0U};
+    // Time when the beginning of the incomplete frame at the begin offset was read
+    std::chrono::steady_clock::time_point m_readTime;
+    // Remaining size of a discarded large message, which is skipped in the stream
+    size_t m_discardSize{0U};
+    // Header of the large message which is being read into its buffer
+    std::vector<uint8_t> m_largeMessageHeader;
+    uint32_t m_largeMessageDeviceIndex{0U};
+    // Rest of the large message which is copied from the io_uring receive buffers, nullptr if none is being read
+    uint8_t* m_largeMessageData{nullptr};
+    size_t m_largeMessageSize{0U};
+    std::chrono::steady_clock::time_point m_largeMessageReadTime;
+    // Time when data was last read from the socket, checked against the heartbeat timeout
+    std::chrono::steady_clock::time_point m_lastReceiveTime;
+    // Whether anything was received on the current connection, the remote gateway sends an empty frame right after
+    // accepting it
+    bool m_isConfirmed{false};
+    asio::steady_timer m_heartbeatTimer;
+
+    std::shared_ptr<SendQueue_t> m_sendQueue;
+    // io_uring of the current connection, nullptr if the socket is read and written by the io thread itself. The io
+    // thread waits on a duplicate of its file descriptor for the completions.
+    std::unique_ptr<IoUring> m_ring;
+    asio::posix::stream_descriptor m_ringDescriptor;
+    // Gather write in flight on the io_uring, its message references the iovecs of the frame buffers
+    std::shared_ptr<SendQueue_t> m_ringSendQueue;
+    uint32_t m_ringSendConnection{0U};
+    std::vector<asio::const_buffer> m_ringSendBuffers;
+    std::vector<struct iovec> m_ringSendIovecs;
+    struct msghdr m_ringSendMessage{};
+    // Completions of the MSG_ZEROCOPY sends, nullptr if zero-copy sending is disabled
+    std::unique_ptr<ZeroCopyTracker> m_zeroCopy;
+    std::atomic<bool> m_isZeroCopy{false};
+
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_zeroCopySends{0U};
 
   protected:
-    void receiveTcpData() noexcept;
+    /**
+     * @brief Set up the freshly connected socket and start receiving, sending and the heartbeat.
+     */
+    void sessionOpened() noexcept;
+
+    /**
+     * @brief Close the socket and drop all queued messages, the session can be opened again afterwards.
+     */
+    void disconnect() noexcept;
+
+    /**
+     * @brief Handle the loss of the connection, which closes the session by default.
+     *
+     * @param ec Error which ended the connection
+     */
+    virtual void connectionLost(std::error_code ec) noexcept;
+
+    /**
+     * @brief Whether anything was received on the current connection. Every session sends an empty frame once it is
+     * opened, so an unconfirmed connection which is closed was rejected by the remote gateway.
+     *
+     * @return
+     */
+    bool isConfirmed() const noexcept;
+
     void sessionClosedHandler() noexcept;
 };
 
@@ -75,7 +75,8 @@ using userDataCallback_t = std::function<void(const void*, size_t, DeviceIndex_t
  * @note Should return a valid pointer to the loaned buffer or `nullptr` in the case that a buffer of this size cannot
  * be loaned for some reason.
  *
- * @note Currently only used in PCIe transport to implement DMA data transfers.
+ * @note Used in PCIe transport to implement DMA data transfers and in UDP transport to receive the user data straight
+ * into the loaned chunks.
  */
 using bufferNeededCallback_t = std::function<void*(const void*, size_t)>;
 
@@ -87,7 +88,8 @@ using bufferNeededCallback_t = std::function<void*(const void*, size_t)>;
  * size, the third argument is whether the buffer should be published and the fourth argument is the index of the device
  * that sent the message.
  *
- * @note Currently only used in PCIe transport to implement DMA data transfers.
+ * @note Used in PCIe transport to implement DMA data transfers and in UDP transport to receive the user data straight
+ * into the loaned chunks.
  */
 using bufferReleasedCallback_t = std::function<void(const void*, size_t, bool, DeviceIndex_t)>;
 
@@ -97,10 +99,26 @@ using bufferReleasedCallback_t = std::function<void(const void*, size_t, bool, D
  *
  * @note The first parameter is the payload of the message that can now be released.
  *
- * @note Currently only used in PCIe transport to implement DMA data transfers.
+ * @note Used in PCIe transport to implement DMA data transfers and in UDP transport for retransmissions and
+ * MSG_ZEROCOPY sends.
  */
 using bufferSentCallback_t = std::function<void(const void*)>;
 
+/**
+ * @brief A single submessage handed over to the transport layer with the `sendUserDataBatch` method
+ */
+struct UserDataSegment_t
+{
+    // Serialized datagram header of this submessage
+    const void* serializedDatagramHeader;
+    // Size of the serialized datagram header
+    size_t serializedDatagramHeaderSize;
+    // Data carried by this submessage
+    const void* userPayload;
+    // Size of the data carried by this submessage
+    size_t userPayloadSize;
+};
+
 /**
  * @brief Transport layer base class
  */
@@ -184,7 +202,8 @@ class TransportLayerUserData : virtual public TransportLayerBase
      *
      * @param bufferNeededCallback_t
      *
-     * @note Currently only used in PCIe transport to implement DMA data transfers.
+     * @note Used in PCIe transport to implement DMA data transfers and in UDP transport to receive the user data
+     * straight into the loaned chunks.
      */
     virtual void registerBufferNeededCallback(bufferNeededCallback_t) noexcept
     {
@@ -195,7 +214,8 @@ class TransportLayerUserData : virtual public TransportLayerBase
      *
      * @param bufferSentCallback_t
      *
-     * @note Currently only used in PCIe transport to implement DMA data transfers.
+     * @note Used in PCIe transport to implement DMA data transfers and in UDP transport for retransmissions and
+     * MSG_ZEROCOPY sends.
      */
     virtual void registerBufferSentCallback(bufferSentCallback_t) noexcept
     {
@@ -206,7 +226,8 @@ class TransportLayerUserData : virtual public TransportLayerBase
      *
      * @param bufferReleasedCallback_t
      *
-     * @note Currently only used in PCIe transport to implement DMA data transfers.
+     * @note Used in PCIe transport to implement DMA data transfers and in UDP transport to receive the user data
+     * straight into the loaned chunks.
      */
     virtual void registerBufferReleasedCallback(bufferReleasedCallback_t) noexcept
     {
@@ -237,6 +258,35 @@ class TransportLayerUserData : virtual public TransportLayerBase
                               size_t userPayloadSize,
                               uint32_t deviceIndex) noexcept = 0;
 
+    /**
+     * @brief Send a batch of user data messages to the same device.
+     * All submessages of a single message are handed over at once, so that transport layers can send them with
+     * fewer system calls and less locking. The submessages have to be sent in the given order.
+     *
+     * @param segments
+     * @param segmentCount
+     * @param deviceIndex
+     *
+     * @return Number of submessages which are pending.
+     *
+     * @note The default implementation sends the submessages one by one with the `sendUserData` method.
+     */
+    virtual uint32_t
+    sendUserDataBatch(const UserDataSegment_t* segments, uint32_t segmentCount, uint32_t deviceIndex) noexcept
+    {
+        uint32_t pendingCount = 0U;
+        for (uint32_t i = 0U; i < segmentCount; ++i)
+        {
+            const auto& segment = segments[i];
+            pendingCount += static_cast<uint32_t>(sendUserData(segment.serializedDatagramHeader,
+                                                               segment.serializedDatagramHeaderSize,
+                                                               segment.userPayload,
+                                                               segment.userPayloadSize,
+                                                               deviceIndex));
+        }
+        return pendingCount;
+    }
+
     /**
      * @brief Will a message with this size be pending?
      *
@@ -251,11 +301,55 @@ class TransportLayerUserData : virtual public TransportLayerBase
     }
 
     /**
-     * @brief Maximum single message size possible to send with this transport.
+     * @brief Can single submessages get lost with this transport?
+     *
+     * @return
+     *
+     * @note Forward error correction is only applied to transports which may drop submessages.
+     */
+    virtual bool mayDropSubmessages() const noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief Device index which reaches all devices subscribed to the given service at once, e.g. a multicast group.
+     * Messages sent to this device index are received by every device which has a subscriber for the service and is
+     * reached by this transport layer, but sent only once.
+     *
+     * @param serviceHash
+     *
+     * @return Device index of the group, or nullopt if the transport layer does not support groups.
+     */
+    virtual cxx::optional<uint32_t>
+    groupDeviceIndex(const capro::ServiceDescription::ClassHash& serviceHash) const noexcept
+    {
+        static_cast<void>(serviceHash);
+        return cxx::nullopt;
+    }
+
+    /**
+     * @brief Set the services which have a subscriber on this device, so that the transport layer can receive the
+     * messages sent to the device groups of these services.
+     *
+     * @param services
+     */
+    virtual void setSubscribedServices(const ServiceVector_t& services) noexcept
+    {
+        static_cast<void>(services);
+    }
+
+    /**
+     * @brief Maximum single message size possible to send to the given device with this transport.
+     *
+     * @param deviceIndex
      *
      * @return size
+     *
+     * @note Transports whose message size depends on the path to the device, like UDP with the path MTU, can return
+     * different sizes for different devices. The result may change over time, it is queried for every message.
      */
-    virtual size_t maxMessageSize() const noexcept = 0;
+    virtual size_t maxMessageSize(uint32_t deviceIndex) const noexcept = 0;
 };
 
 /**
@@ -279,6 +373,18 @@ class TransportLayer : public TransportLayerUserData, public TransportLayerDisco
      * @return type
      */
     virtual TransportType getType() const noexcept = 0;
+
+    /**
+     * @brief Runtime statistics of this transport.
+     *
+     * @return statistics
+     *
+     * @note Transport layers which dont collect any statistics dont need to implement this.
+     */
+    virtual TransportStatistics_t getStatistics() const noexcept
+    {
+        return {};
+    }
 };
 
 } // namespace p3com
@@ -0,0 +1,255 @@
+// Copyright 2023 NXP
+
+#ifndef P3COM_TRANSPORT_CONFIG_HPP
+#define P3COM_TRANSPORT_CONFIG_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+/**
+ * @brief Configuration of the UDP transport layer
+ */
+struct UDPTransportConfig_t
+{
+    // Maximum number of datagrams drained from the data socket per wakeup. A value of 1 disables batched receiving.
+    uint32_t receiveBatchSize{16U};
+    // Let the kernel split batches of equally sized submessages into datagrams (UDP generic segmentation offload)
+    bool segmentationOffload{false};
+    // Number of data plane workers, each with its own socket and thread. Sends are sharded by peer and service.
+    uint32_t dataWorkerCount{1U};
+    // Minimum user payload size in bytes which is sent with MSG_ZEROCOPY straight from the iceoryx chunk, which is
+    // then kept pending until the kernel has completed the send. A value of 0 disables zero-copy sending.
+    uint32_t zeroCopyThreshold{0U};
+    // Peek at the header of every received datagram and receive the user data straight into the loaned iceoryx chunk,
+    // instead of copying it out of the worker buffer. Costs one additional syscall per datagram.
+    bool directReceive{false};
+    // Send and receive the user data with io_uring instead of sendmmsg and recvmmsg, if the gateway was built with it
+    bool ioUring{false};
+    // Time the data plane threads keep polling their sockets without blocking after the last received data, trading
+    // CPU time for receive latency. 0 disables busy polling.
+    std::chrono::microseconds busyPollBudget{0U};
+    // Time the kernel polls the device queue before reporting no data (SO_BUSY_POLL). 0 keeps the system default.
+    std::chrono::microseconds socketBusyPoll{0U};
+    // Link MTU which the datagrams are sized for. 0 discovers the path MTU to every device and sets the DF bit.
+    uint32_t mtu{0U};
+    // Pace the user data sent to every device with a token bucket
+    bool pacing{false};
+    // Maximum send rate per device in Mbit/s when pacing. With reliability, the rate adapts to the receiver feedback.
+    uint32_t maxRateMbps{1000U};
+    // Send the messages of a service with multiple subscribed devices once to a multicast group of the service.
+    // Has to be enabled on all gateways.
+    bool multicast{false};
+    // Retransmit lost submessages on request of the receiver. Only used towards devices which have it enabled as well.
+    bool reliability{false};
+    // Maximum number of retransmission requests per message
+    uint32_t retransmitBudget{3U};
+    // Time without any new submessage after which the receiver requests the missing submessages
+    std::chrono::milliseconds nackDelay{5U};
+    // Time without any acknowledgment or retransmission request after which the sender releases a message
+    std::chrono::milliseconds retentionTimeout{50U};
+};
+
+/**
+ * @brief Configuration of the TCP transport layer
+ */
+struct TCPTransportConfig_t
+{
+    // Maximum number of bytes queued for sending to a device, including the length prefixes
+    uint32_t sendQueueSize{4U * 1024U * 1024U};
+    // Time a sender waits for space in a full send queue before dropping the message. 0 drops it right away.
+    std::chrono::milliseconds sendQueueTimeout{10U};
+    // Number of additional connections to every device for messages with at least bulkThreshold bytes of user payload,
+    // so that large messages do not delay small ones. 0 sends all messages over a single connection.
+    uint32_t bulkConnectionCount{0U};
+    // Minimum user payload size in bytes of the messages sent over the bulk connections
+    uint32_t bulkThreshold{65536U};
+    // Size in bytes of the stripes which large messages are split into and sent in parallel over all bulk connections.
+    // 0 sends every message over a single bulk connection.
+    uint32_t stripeSize{0U};
+    // Minimum user payload size in bytes which is sent with MSG_ZEROCOPY straight from the iceoryx chunk, which is
+    // then kept pending until the kernel has completed the send. A value of 0 disables zero-copy sending.
+    uint32_t zeroCopyThreshold{0U};
+    // Time unacknowledged data may remain in flight before the connection is dropped (TCP_USER_TIMEOUT). 0 keeps the
+    // system default.
+    std::chrono::milliseconds userTimeout{0U};
+    // Idle time after which keepalive probes are sent, also the interval between the probes. The connection is
+    // dropped after 3 unanswered probes. 0 disables keepalive probes.
+    std::chrono::seconds keepAlive{0U};
+    // Interval of the heartbeats which are sent over idle connections. A connection without any received data for 3
+    // intervals is dropped. All gateways have to support heartbeats. 0 disables heartbeats.
+    std::chrono::milliseconds heartbeatInterval{0U};
+    // Receive with a multishot recv and write every gather write with a single sendmsg SQE of an io_uring, if the
+    // gateway was built with it
+    bool ioUring{false};
+    // Time the io thread keeps polling its sockets without blocking after the last event. 0 disables busy polling.
+    std::chrono::microseconds busyPollBudget{0U};
+    // Time the kernel polls the device queue before reporting no data (SO_BUSY_POLL). 0 keeps the system default.
+    std::chrono::microseconds socketBusyPoll{0U};
+};
+
+/**
+ * @brief Configuration of the shared memory transport layer
+ */
+struct SHMTransportConfig_t
+{
+    // Name of the POSIX shared memory object which connects the two gateways, has to be the same for both
+    std::string regionName{"p3com_shm"};
+    // Number of message slots per direction, has to be the same for both gateways
+    uint32_t slotCount{64U};
+    // Size in bytes of every slot, which limits the size of a submessage. Has to be the same for both gateways.
+    uint32_t slotSize{131072U};
+    // Minimum user payload size in bytes which is copied by the copy worker straight from the iceoryx chunk, which is
+    // then kept pending until the copy has completed. A value of 0 copies all messages in the sending thread.
+    uint32_t asyncCopyThreshold{16384U};
+};
+
+/**
+ * @brief Configuration of the Unix domain socket transport layer
+ */
+struct UDSTransportConfig_t
+{
+    // Prefix of the abstract socket names, gateways with the same prefix on a host discover each other
+    std::string name{"p3com"};
+    // Requested send buffer size of the data sockets, which limits the size of a message sent through the socket. The
+    // kernel caps it at net.core.wmem_max. Has to be the same for all gateways.
+    uint32_t socketBufferSize{4U * 1024U * 1024U};
+    // Minimum user payload size in bytes which is passed in a sealed memfd instead of through the socket, so that it is
+    // not segmented. It is copied as often as through the socket. A value of 0 sends all messages through the socket.
+    uint32_t memfdThreshold{65536U};
+    // Time a sender waits for space in the socket of a device before dropping the message. 0 drops it right away.
+    std::chrono::milliseconds sendTimeout{10U};
+};
+
+/**
+ * @brief Configuration of the SCTP transport layer
+ */
+struct SCTPTransportConfig_t
+{
+    // Number of streams per association. The messages of a service are ordered within its stream, but do not wait
+    // for the messages of other services. Has to be the same for all gateways.
+    uint32_t streamCount{64U};
+    // Maximum size in bytes of a message, which is sent without segmentation. It is further limited by the send
+    // buffer size, and has to be the same for all gateways.
+    uint32_t maxMessageSize{1024U * 1024U};
+    // Requested send and receive buffer size of the socket, capped by net.core.wmem_max and net.core.rmem_max
+    uint32_t socketBufferSize{4U * 1024U * 1024U};
+    // Interval of the heartbeats on the idle paths of an association. 0 keeps the system default.
+    std::chrono::milliseconds heartbeatInterval{1000U};
+    // Number of unanswered retransmissions or heartbeats after which an association switches to another path
+    uint32_t pathMaxRetransmissions{2U};
+    // Maximum retransmission timeout, which bounds the time until a lost path is detected. 0 keeps the system default.
+    std::chrono::milliseconds rtoMax{1000U};
+    // Time a sender waits for space in the send buffer before dropping the message. 0 drops it right away.
+    std::chrono::milliseconds sendTimeout{10U};
+};
+
+/**
+ * @brief Configuration of the AF_XDP transport layer
+ */
+struct XDPTransportConfig_t
+{
+    // Network interface which the XDP program is attached to and the user data is sent on
+    std::string interfaceName;
+    // Receive queue of the interface which the socket is bound to. The user data has to arrive on this queue, e.g.
+    // with a single combined queue or an ntuple filter for the data port.
+    uint32_t queueId{0U};
+    // Number of frames of the shared packet buffer (UMEM), half of them for receiving and half for sending. Has to be
+    // a power of two.
+    uint32_t frameCount{4096U};
+    // Size in bytes of a frame, 2048 or 4096. Together with the MTU it limits the size of a submessage, so it has to
+    // be the same for all gateways.
+    uint32_t frameSize{2048U};
+    // Let the driver transfer the frames straight to and from the packet buffer. Falls back to copy mode if the
+    // driver does not support it.
+    bool zeroCopy{true};
+    // Attach the XDP program in generic mode, e.g. for veth pairs, which works with every driver but only in copy mode
+    bool genericXdp{false};
+};
+
+/**
+ * @brief Configuration of the raw Ethernet transport layer
+ */
+struct EthernetTransportConfig_t
+{
+    // Network interface which the frames are sent and received on
+    std::string interfaceName;
+    // EtherType of the frames, has to be the same for all gateways. Defaults to the local experimental EtherType.
+    uint16_t etherType{0x88B5U};
+    // Size in bytes of a block of the receive ring, a multiple of the page size
+    uint32_t blockSize{262144U};
+    // Number of blocks of the receive ring
+    uint32_t blockCount{16U};
+    // Time after which the kernel hands over a block which is not full yet. Bounds the receive latency at a low rate.
+    std::chrono::milliseconds blockTimeout{1U};
+    // Number of frames of the send ring
+    uint32_t txFrameCount{256U};
+    // Hand the frames straight to the driver, bypassing the queueing discipline of the interface
+    bool qdiscBypass{false};
+};
+
+/**
+ * @brief Remote gateway which the vsock transport layer connects to
+ */
+struct VSOCKPeer_t
+{
+    // Context ID of the virtual machine, 2 is the host
+    uint32_t cid{2U};
+    uint32_t port{9336U};
+};
+
+/**
+ * @brief Configuration of the vsock transport layer
+ */
+struct VSOCKTransportConfig_t
+{
+    // Port of the listening socket, which the other gateways connect to
+    uint32_t port{9336U};
+    // Use SOCK_SEQPACKET instead of SOCK_STREAM connections, has to be the same for all gateways. Requires Linux 5.16
+    // or newer on both sides.
+    bool seqpacket{false};
+    // Gateways which this gateway connects to, e.g. the host from a guest. Gateways which connect to this one are
+    // added on their own.
+    std::vector<VSOCKPeer_t> peers;
+    // Number of context IDs from 3 on which gateways listening on the same port are probed for, e.g. the guests from
+    // the host. 0 disables probing.
+    uint32_t scanCidCount{0U};
+    // Buffer size of the connections, which also limits the size of a message with SOCK_SEQPACKET
+    uint32_t bufferSize{1024U * 1024U};
+    // Time a sender waits for a connection to accept a message before dropping it. A stream connection is closed
+    // when this happens in the middle of a message. 0 waits without limit.
+    std::chrono::milliseconds sendTimeout{1000U};
+};
+
+/**
+ * @brief Configuration of all transport layers, handed over to the transport layers when they are enabled
+ */
+struct TransportConfig_t
+{
+    // UDP transport layer configuration
+    UDPTransportConfig_t udp;
+    // TCP transport layer configuration
+    TCPTransportConfig_t tcp;
+    // Shared memory transport layer configuration
+    SHMTransportConfig_t shm;
+    // Unix domain socket transport layer configuration
+    UDSTransportConfig_t uds;
+    // vsock transport layer configuration
+    VSOCKTransportConfig_t vsock;
+    // SCTP transport layer configuration
+    SCTPTransportConfig_t sctp;
+    // AF_XDP transport layer configuration
+    XDPTransportConfig_t xdp;
+    // Raw Ethernet transport layer configuration
+    EthernetTransportConfig_t ethernet;
+};
+
+} // namespace p3com
+} // namespace iox
+
+#endif // P3COM_TRANSPORT_CONFIG_HPP
@@ -7,18 +7,37 @@
 
 #include "p3com/generic/types.hpp"
 #include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
 #include "p3com/transport/transport_type.hpp"
 #include "p3com/internal/log/logging.hpp"
 
-#if defined(PCIE_GATEWAY)
+#if defined(PCIE_TRANSPORT)
 #include "p3com/transport/pcie/pcie_transport.hpp"
 #endif
-#if defined(UDP_GATEWAY)
+#if defined(UDP_TRANSPORT)
 #include "p3com/transport/udp/udp_transport.hpp"
 #endif
-#if defined(TCP_GATEWAY)
+#if defined(TCP_TRANSPORT)
 #include "p3com/transport/tcp/tcp_transport.hpp"
 #endif
+#if defined(SHM_TRANSPORT)
+#include "p3com/transport/shm/shm_transport.hpp"
+#endif
+#if defined(UDS_TRANSPORT)
+#include "p3com/transport/uds/uds_transport.hpp"
+#endif
+#if defined(VSOCK_TRANSPORT)
+#include "p3com/transport/vsock/vsock_transport.hpp"
+#endif
+#if defined(SCTP_TRANSPORT)
+#include "p3com/transport/sctp/sctp_transport.hpp"
+#endif
+#if defined(XDP_TRANSPORT)
+#include "p3com/transport/xdp/xdp_transport.hpp"
+#endif
+#if defined(ETH_TRANSPORT)
+#include "p3com/transport/eth/eth_transport.hpp"
+#endif
 
 #include <array>
 #include <cstdint>
@@ -41,8 +60,8 @@ class TransportInfo
   public:
     using transportFailCallback_t = std::function<void()>;
 
-    static void enable(TransportType type) noexcept;
-    static void enableAll() noexcept;
+    static void enable(TransportType type, const TransportConfig_t& config) noexcept;
+    static void enableAll(const TransportConfig_t& config) noexcept;
 
     static void registerTransportFailCallback(transportFailCallback_t callback) noexcept;
 
@@ -117,6 +136,13 @@ class TransportInfo
         return s_bitset;
     }
 
+    static TransportStatistics_t statistics(TransportType type) noexcept
+    {
+        TransportStatistics_t stats;
+        doFor(type, [&stats](TransportLayer& transport) { stats = transport.getStatistics(); });
+        return stats;
+    }
+
     static void terminate() noexcept
     {
         for (auto& t : s_transports)
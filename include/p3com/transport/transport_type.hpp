@@ -23,8 +23,20 @@ enum struct TransportType
     UDP = 2,
     // TCP transport layer
     TCP = 3,
+    // Shared memory transport layer
+    SHM = 4,
+    // Unix domain socket transport layer
+    UDS = 5,
+    // Virtio-vsock transport layer
+    VSOCK = 6,
+    // SCTP transport layer
+    SCTP = 7,
+    // AF_XDP transport layer
+    XDP = 8,
+    // Raw Ethernet transport layer
+    ETH = 9,
     // None
-    NONE = 4
+    NONE = 10
 };
 
 static_assert(static_cast<uint32_t>(TransportType::NONE) == TRANSPORT_TYPE_COUNT, "");
@@ -51,10 +63,13 @@ inline TransportType type(const uint32_t index) noexcept
     return static_cast<TransportType>(index);
 }
 
-constexpr std::array<const char*, TRANSPORT_TYPE_COUNT> TRANSPORT_TYPE_NAMES{{"PCIE", "UDP", "TCP"}};
+// Indexed by the transport type, the first entry is unused since the types start at 1
+constexpr std::array<const char*, TRANSPORT_TYPE_COUNT> TRANSPORT_TYPE_NAMES{
+    {"", "PCIE", "UDP", "TCP", "SHM", "UDS", "VSOCK", "SCTP", "XDP", "ETH"}};
 
 // List of gateway types which have the potential to lose messages during transfer
-constexpr std::array<TransportType, 2U> LOSSY_TRANSPORT_TYPES{TransportType::UDP, TransportType::TCP};
+constexpr std::array<TransportType, 5U> LOSSY_TRANSPORT_TYPES{
+    TransportType::UDP, TransportType::TCP, TransportType::SCTP, TransportType::XDP, TransportType::ETH};
 
 } // namespace p3com
 } // namespace iox
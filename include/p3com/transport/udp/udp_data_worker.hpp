@@ -0,0 +1,297 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_UDP_DATA_WORKER_HPP
+#define IOX_UDP_DATA_WORKER_HPP
+
+#include "iceoryx_hoofs/cxx/optional.hpp"
+
+#include "p3com/generic/config.hpp"
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/generic/types.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/socket/busy_poll.hpp"
+#include "p3com/transport/socket/io_uring.hpp"
+#include "p3com/transport/socket/zero_copy_tracker.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+namespace udp
+{
+/**
+ * @brief One shard of the UDP data plane.
+ * Every worker runs its own io_service on its own thread and owns a data socket bound to the shared data port with
+ * SO_REUSEPORT, so that the kernel spreads the incoming datagrams over the workers. Outgoing datagrams are sent from a
+ * separate socket of the worker, so that the receiving side shards them by the source port as well. With multicast
+ * enabled, the first worker additionally receives the datagrams of the joined multicast groups on its own socket.
+ */
+class UDPDataWorker
+{
+  public:
+    // The flag is set for datagrams received over a multicast group
+    using dataCallback_t = std::function<void(const void*, size_t, const asio::ip::address&, bool)>;
+    using failCallback_t = std::function<void()>;
+    // Called with the key of a zero-copy send once the kernel does not reference the sent data anymore
+    using zeroCopyCallback_t = std::function<void(uint64_t)>;
+
+    /**
+     * @brief Where the user data of a datagram is received to.
+     */
+    struct ReceiveTarget_t
+    {
+        enum class Action : uint8_t
+        {
+            // Receive the whole datagram into the worker buffer and hand it over to the data callback
+            COPY,
+            // Receive the serialized datagram header into the worker buffer and the user data straight into data
+            DIRECT,
+            // Drop the datagram
+            DISCARD
+        };
+
+        Action action{Action::COPY};
+        void* data{nullptr};
+        size_t headerSize{0U};
+        // Device which the buffer was requested for, handed back to the received callback
+        uint32_t deviceIndex{0U};
+    };
+
+    /**
+     * @brief Called with the beginning of a datagram before it is received, to choose where it is received to.
+     *
+     * @note The arguments are the peeked data, its size, the size of the whole datagram and the source address.
+     */
+    using receiveTargetCallback_t =
+        std::function<ReceiveTarget_t(const void*, size_t, size_t, const asio::ip::address&)>;
+
+    /**
+     * @brief Called after a datagram was received directly.
+     *
+     * @note The arguments are the serialized datagram header, its size, whether the user data was received completely
+     * and the device index of the receive target.
+     */
+    using receivedCallback_t = std::function<void(const void*, size_t, bool, uint32_t)>;
+
+    static constexpr uint16_t DATA_PORT = 9333U;
+    static constexpr uint16_t MULTICAST_PORT = 9336U;
+    // Upper bound of the datagram size, the datagrams are usually sized to the path MTU
+    static constexpr size_t MAX_DATAGRAM_SIZE = 32768U; // 32 kB
+
+    UDPDataWorker(uint32_t workerIndex,
+                  const UDPTransportConfig_t& config,
+                  dataCallback_t dataCallback,
+                  failCallback_t failCallback,
+                  zeroCopyCallback_t zeroCopyCallback,
+                  receiveTargetCallback_t receiveTargetCallback,
+                  receivedCallback_t receivedCallback) noexcept;
+    ~UDPDataWorker();
+
+    UDPDataWorker(const UDPDataWorker&) = delete;
+    UDPDataWorker& operator=(const UDPDataWorker&) = delete;
+    UDPDataWorker(UDPDataWorker&&) = delete;
+    UDPDataWorker& operator=(UDPDataWorker&&) = delete;
+
+    /**
+     * @brief Send the given submessages in order to the given endpoint.
+     *
+     * @param segments
+     * @param segmentCount
+     * @param endpoint
+     *
+     * @return Number of submessages which were sent.
+     */
+    uint32_t
+    send(const UserDataSegment_t* segments, uint32_t segmentCount, const asio::ip::udp::endpoint& endpoint) noexcept;
+
+    /**
+     * @brief Send the given submessages in order to the given endpoint with MSG_ZEROCOPY, so that the user payloads
+     * are not copied into the kernel. The zero-copy callback is called exactly once for the key, when the user
+     * payloads may be released. Falls back to copying if zero-copy sends are not available.
+     *
+     * @param segments
+     * @param segmentCount
+     * @param endpoint
+     * @param key
+     *
+     * @return Number of submessages which were sent.
+     */
+    uint32_t sendZeroCopy(const UserDataSegment_t* segments,
+                          uint32_t segmentCount,
+                          const asio::ip::udp::endpoint& endpoint,
+                          uint64_t key) noexcept;
+
+    bool isZeroCopy() const noexcept;
+
+    /**
+     * @brief Receive the datagrams sent to the given multicast group. Only supported by the first worker.
+     *
+     * @param group
+     */
+    void joinGroup(const asio::ip::address& group) noexcept;
+
+    /**
+     * @brief Stop receiving the datagrams sent to the given multicast group.
+     *
+     * @param group
+     */
+    void leaveGroup(const asio::ip::address& group) noexcept;
+
+    TransportStatistics_t getStatistics() const noexcept;
+
+    /**
+     * @brief Histogram of the time from receiving a datagram to handing it over to the transport.
+     *
+     * @return
+     */
+    LatencyHistogram::Counts_t receiveLatencyCounts() const noexcept;
+
+  private:
+    static constexpr uint32_t MAX_RECEIVE_BATCH_SIZE = 64U;
+    static constexpr uint32_t MAX_GSO_SEGMENT_COUNT = 64U;
+    static constexpr size_t MAX_GSO_SIZE = 65507U; // Maximum UDP payload size over IPv4
+    // Largest datagram which fits into a jumbo frame, GSO is not attempted for larger segments
+    static constexpr size_t MAX_GSO_SEGMENT_SIZE = 9000U - 28U;
+    static constexpr std::chrono::milliseconds SEND_TIMEOUT{1000U};
+    static constexpr uint32_t IO_URING_ENTRY_COUNT = 64U;
+    static constexpr uint32_t IO_URING_BUFFER_COUNT = 64U;
+    // Room for the recvmsg metadata and the source address in front of every datagram
+    static constexpr size_t IO_URING_BUFFER_HEADROOM = 64U;
+    static constexpr std::chrono::milliseconds IO_URING_WAIT_TIMEOUT{100U};
+    // Number of header buffers of completed zero-copy sends which are kept for reuse
+    static constexpr uint32_t MAX_FREE_ZERO_COPY_HEADERS = 64U;
+
+    void fail() noexcept;
+
+    void setupIoUring() noexcept;
+    void ringReceiveLoop() noexcept;
+
+    void dataSocketCallback(asio::error_code ec, size_t bytes) noexcept;
+    void dataAsyncReceive() noexcept;
+    void dataBatchCallback(asio::error_code ec) noexcept;
+    void dataAsyncReceiveBatch() noexcept;
+    void dataDirectCallback(asio::error_code ec) noexcept;
+    void dataAsyncReceiveDirect() noexcept;
+    bool receiveDirect() noexcept;
+    void multicastSocketCallback(asio::error_code ec, size_t bytes) noexcept;
+    void multicastAsyncReceive() noexcept;
+    void dispatchUserData(const void* data,
+                          size_t size,
+                          const asio::ip::address& address,
+                          bool isMulticast,
+                          std::chrono::system_clock::time_point receiveTime) noexcept;
+    static std::chrono::system_clock::time_point receiveTimestamp(const struct msghdr& message) noexcept;
+
+    void errorAsyncWait() noexcept;
+
+    uint32_t sendLocked(const UserDataSegment_t* segments,
+                        uint32_t segmentCount,
+                        const asio::ip::udp::endpoint& endpoint,
+                        int flags,
+                        uint32_t& zeroCopySendCount) noexcept;
+    uint32_t gsoRunLength(const UserDataSegment_t* segments, uint32_t segmentCount) const noexcept;
+    enum class GsoResult : uint8_t
+    {
+        SENT,
+        // Not sent, the segments are sent without segmentation offload
+        NOT_SENT,
+        // Timed out waiting for the send buffer, the rest of the message is dropped
+        DROPPED
+    };
+    GsoResult sendSegmentsGso(const UserDataSegment_t* segments,
+                              uint32_t segmentCount,
+                              const asio::ip::udp::endpoint& endpoint,
+                              int flags) noexcept;
+    uint32_t sendSegmentsMmsg(const UserDataSegment_t* segments,
+                              uint32_t segmentCount,
+                              const asio::ip::udp::endpoint& endpoint,
+                              int flags,
+                              uint32_t& zeroCopySendCount) noexcept;
+    bool waitWritable() noexcept;
+
+    const uint32_t m_workerIndex;
+    std::atomic<bool> m_isGood{true};
+
+    asio::io_service m_context;
+    cxx::optional<asio::io_service::work> m_work;
+    std::thread m_thread;
+
+    asio::ip::udp::socket m_dataSocket;
+    std::mutex m_sendSocketMutex;
+    asio::ip::udp::socket m_sendSocket;
+
+    std::array<uint8_t, MAX_DATAGRAM_SIZE> m_outputBuffer;
+    asio::ip::udp::endpoint m_outputEndpoint;
+
+    // Peek at every datagram and let the transport choose where it is received to
+    const bool m_isDirectReceive;
+
+    // Time the thread keeps polling without blocking after the last received data, 0 if busy polling is disabled
+    const std::chrono::microseconds m_busyPollBudget;
+
+    // Receives the joined multicast groups, only open in the first worker with multicast enabled
+    asio::ip::udp::socket m_multicastSocket;
+    std::vector<uint8_t> m_multicastBuffer;
+    asio::ip::udp::endpoint m_multicastEndpoint;
+
+    // Ring of preallocated buffers for the batched receive, one buffer per datagram
+    const uint32_t m_receiveBatchSize;
+    std::vector<uint8_t> m_batchBuffers;
+    std::vector<struct iovec> m_batchIovecs;
+    std::vector<struct sockaddr_in> m_batchAddresses;
+    std::vector<struct mmsghdr> m_batchMessages;
+    std::vector<std::array<char, CMSG_SPACE(sizeof(struct timespec))>> m_batchControls;
+
+    // Scratch space for the batched send, protected by m_sendSocketMutex
+    std::atomic<bool> m_segmentationOffload;
+    std::array<struct iovec, 2U * MAX_SEND_BATCH_SIZE> m_sendIovecs;
+    std::array<struct mmsghdr, MAX_SEND_BATCH_SIZE> m_sendMessages;
+
+    // io_uring backend, nullptr if disabled or not supported. The receive ring is only used by its own thread, the
+    // send ring is protected by m_sendSocketMutex.
+    std::unique_ptr<IoUring> m_receiveRing;
+    std::unique_ptr<IoUring> m_sendRing;
+    std::thread m_ringThread;
+    std::atomic<bool> m_isRingRunning{false};
+
+    // Sends in flight with MSG_ZEROCOPY, nullptr if zero-copy sending is disabled
+    std::unique_ptr<ZeroCopyTracker> m_zeroCopy;
+    // Submessages of a zero-copy send pointing to the copied headers, protected by m_sendSocketMutex
+    std::vector<UserDataSegment_t> m_zeroCopySegments;
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_zeroCopySends{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    dataCallback_t m_dataCallback;
+    failCallback_t m_failCallback;
+    zeroCopyCallback_t m_zeroCopyCallback;
+    receiveTargetCallback_t m_receiveTargetCallback;
+    receivedCallback_t m_receivedCallback;
+};
+
+} // namespace udp
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_UDP_DATA_WORKER_HPP
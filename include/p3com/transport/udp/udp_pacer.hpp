@@ -0,0 +1,129 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_UDP_PACER_HPP
+#define IOX_UDP_PACER_HPP
+
+#include "p3com/generic/config.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace iox
+{
+namespace p3com
+{
+namespace udp
+{
+/**
+ * @brief Per device pacing and congestion control of the UDP user data.
+ * The datagrams to every device pass a token bucket which is refilled with the current send rate of the device, so
+ * that bursts never exceed a small multiple of the datagram size. If the receivers send feedback, the send rate is
+ * adapted to it: it grows multiplicatively until the first congestion signal (slow start) and additively afterwards,
+ * and it shrinks multiplicatively on lost submessages and on a rising round trip time. The feedback is provided by the
+ * acknowledgments and retransmission requests of UDPReliability.
+ */
+class UDPPacer
+{
+  public:
+    explicit UDPPacer(const UDPTransportConfig_t& config) noexcept;
+
+    UDPPacer(const UDPPacer&) = delete;
+    UDPPacer& operator=(const UDPPacer&) = delete;
+    UDPPacer(UDPPacer&&) = delete;
+    UDPPacer& operator=(UDPPacer&&) = delete;
+    ~UDPPacer() = default;
+
+    /**
+     * @brief Wait until the given amount of data may be sent to the device.
+     *
+     * @param deviceIndex
+     * @param bytes
+     */
+    void acquire(uint32_t deviceIndex, size_t bytes) noexcept;
+
+    /**
+     * @brief Take the given amount of data from the budget of the device without waiting, the following sends to the
+     * device wait for it instead.
+     *
+     * @param deviceIndex
+     * @param bytes
+     */
+    void consume(uint32_t deviceIndex, size_t bytes) noexcept;
+
+    /**
+     * @brief Amount of data which may be sent to the device at once.
+     *
+     * @param deviceIndex
+     *
+     * @return Burst size in bytes
+     */
+    size_t burstSize(uint32_t deviceIndex) const noexcept;
+
+    /**
+     * @brief Adapt the send rate to the feedback of the device.
+     *
+     * @param deviceIndex
+     * @param isLoss True if submessages were lost
+     * @param roundTripTime Time from sending a message to its acknowledgment, zero if unknown
+     * @param bytes Size of the acknowledged message
+     */
+    void feedback(uint32_t deviceIndex,
+                  bool isLoss,
+                  std::chrono::steady_clock::duration roundTripTime,
+                  size_t bytes) noexcept;
+
+    /**
+     * @brief Current send rate to the device in bytes per second.
+     *
+     * @param deviceIndex
+     *
+     * @return
+     */
+    uint64_t rate(uint32_t deviceIndex) const noexcept;
+
+  private:
+    static constexpr double MIN_RATE = 125000.0; // 1 Mbit/s
+    static constexpr double INITIAL_RATE_FRACTION = 0.125;
+    static constexpr double SLOW_START_FACTOR = 1.5;
+    static constexpr double INCREASE_FRACTION = 0.02;
+    static constexpr double LOSS_DECREASE_FACTOR = 0.7;
+    static constexpr double DELAY_DECREASE_FACTOR = 0.9;
+    static constexpr size_t MIN_BURST_SIZE = 65536U;
+    static constexpr std::chrono::microseconds BURST_DURATION{1000U};
+    static constexpr std::chrono::microseconds DELAY_MARGIN{1000U};
+    static constexpr std::chrono::microseconds MIN_ADAPTATION_PERIOD{5000U};
+
+    struct Peer_t
+    {
+        // Send rate in bytes per second, 0 until the first data is sent to the device
+        double rate{0.0};
+        // Available bytes, negative while the sender is waiting
+        double tokens{0.0};
+        std::chrono::steady_clock::time_point lastRefill;
+        bool isSlowStart{true};
+        std::chrono::steady_clock::time_point lastAdaptation;
+        std::chrono::steady_clock::duration minRoundTripTime{std::chrono::steady_clock::duration::max()};
+        std::chrono::steady_clock::duration smoothedRoundTripTime{std::chrono::steady_clock::duration::zero()};
+    };
+
+    void initialize(Peer_t& peer, std::chrono::steady_clock::time_point now) const noexcept;
+    // Takes the tokens and returns the time until they are available
+    std::chrono::nanoseconds take(uint32_t deviceIndex, size_t bytes) noexcept;
+    static size_t peerBurstSize(const Peer_t& peer) noexcept;
+
+    const double m_maxRate;
+    // Without feedback of the receivers, every device is paced with the maximum rate
+    const bool m_isAdaptive;
+
+    mutable std::mutex m_mutex;
+    std::array<Peer_t, MAX_DEVICE_COUNT> m_peers;
+};
+
+} // namespace udp
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_UDP_PACER_HPP
@@ -0,0 +1,289 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_UDP_RELIABILITY_HPP
+#define IOX_UDP_RELIABILITY_HPP
+
+#include "p3com/generic/config.hpp"
+#include "p3com/generic/serialization.hpp"
+#include "p3com/generic/types.hpp"
+#include "p3com/transport/socket/socket_discovery.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+#include "p3com/utility/vector_map.hpp"
+
+#include "iceoryx_hoofs/cxx/vector.hpp"
+
+#include <asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace iox
+{
+namespace p3com
+{
+namespace udp
+{
+/**
+ * @brief Byte ranges of a segmented message which have been received, kept sorted and disjoint.
+ */
+class UDPRangeList
+{
+  public:
+    struct Range_t
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    // The received ranges are only gaps apart, so more than can be requested at once are not needed
+    static constexpr uint32_t MAX_RANGE_COUNT = 64U;
+
+    /**
+     * @brief Record a received range, it is merged with all ranges it overlaps or touches.
+     *
+     * @param range
+     *
+     * @return False if the range would need a new entry, but the list is full. True otherwise.
+     */
+    bool insert(Range_t range) noexcept;
+
+    /**
+     * @brief Whether the given range lies within a single received range.
+     *
+     * @param range
+     *
+     * @return
+     */
+    bool isCovered(Range_t range) const noexcept;
+
+    /**
+     * @brief Total size of the received ranges.
+     *
+     * @return
+     */
+    uint32_t coveredSize() const noexcept;
+
+    /**
+     * @brief Write the gaps between the received ranges and the missing tail of a message of the given size.
+     *
+     * @param totalSize
+     * @param ranges
+     * @param maxCount
+     *
+     * @return Number of written ranges, the first ones if there are more than maxCount.
+     */
+    uint32_t missingRanges(uint32_t totalSize, Range_t* ranges, uint32_t maxCount) const noexcept;
+
+    uint32_t size() const noexcept;
+    const Range_t& operator[](uint32_t index) const noexcept;
+
+  private:
+    cxx::vector<Range_t, MAX_RANGE_COUNT> m_ranges;
+};
+
+/**
+ * @brief Selective retransmission of lost UDP submessages.
+ * The receiver keeps track of the received byte ranges of every segmented message. When no new submessage of an
+ * incomplete message arrives for some time, it sends a NACK with the missing byte ranges to the sender over a separate
+ * feedback socket. Complete messages are acknowledged with an ACK. The sender keeps the sent iceoryx chunk pending
+ * until it is acknowledged, until the retransmit budget is exhausted or until the retention timeout expires.
+ * Messages are only retained for devices which have answered a HELLO on the feedback socket, so a gateway without
+ * retransmissions, which never acknowledges anything, does not hold the chunks until the retention timeout.
+ */
+class UDPReliability
+{
+  public:
+    using sendCallback_t = std::function<void(const UserDataSegment_t*, uint32_t, uint32_t)>;
+    using failCallback_t = std::function<void()>;
+    /**
+     * @brief Called for every acknowledgment and retransmission request received for a retained message.
+     *
+     * @note The arguments are the device index, whether submessages were lost, the round trip time of the message
+     * (zero if unknown, e.g. after retransmissions) and the message size.
+     */
+    using feedbackCallback_t =
+        std::function<void(uint32_t, bool, std::chrono::steady_clock::duration, size_t)>;
+    /**
+     * @brief Called when a pending message is released.
+     *
+     * @note The arguments are the user payload, the device index and the message hash.
+     */
+    using releaseCallback_t = std::function<void(const void*, uint32_t, hash_t)>;
+
+    UDPReliability(asio::io_service& context,
+                   SocketDiscovery& discovery,
+                   const UDPTransportConfig_t& config,
+                   sendCallback_t sendCallback,
+                   failCallback_t failCallback) noexcept;
+    ~UDPReliability() = default;
+
+    UDPReliability(const UDPReliability&) = delete;
+    UDPReliability& operator=(const UDPReliability&) = delete;
+    UDPReliability(UDPReliability&&) = delete;
+    UDPReliability& operator=(UDPReliability&&) = delete;
+
+    void registerReleaseCallback(releaseCallback_t callback) noexcept;
+    void registerFeedbackCallback(feedbackCallback_t callback) noexcept;
+
+    /**
+     * @brief Keep the sent submessages of a message around for retransmissions.
+     *
+     * @param segments
+     * @param segmentCount
+     * @param deviceIndex
+     *
+     * @return True if the message is now complete and pending until it is acknowledged. False otherwise.
+     */
+    bool retain(const UserDataSegment_t* segments, uint32_t segmentCount, uint32_t deviceIndex) noexcept;
+
+    /**
+     * @brief Record a received submessage.
+     *
+     * @param data
+     * @param size
+     * @param deviceIndex
+     * @param address
+     *
+     * @return False if the submessage was already received before and should be discarded. True otherwise.
+     */
+    bool accept(const void* data, size_t size, uint32_t deviceIndex, const asio::ip::address& address) noexcept;
+
+    /**
+     * @brief Release all messages which are still pending, to be called once no more feedback is processed.
+     */
+    void releaseAll() noexcept;
+
+    uint64_t retransmittedMessages() const noexcept;
+    uint64_t retransmitRequests() const noexcept;
+
+  private:
+    static constexpr uint16_t FEEDBACK_PORT = 9334U;
+    static constexpr uint32_t FEEDBACK_MAGIC = 0x70336e6bU;
+    static constexpr uint32_t MAX_NACK_RANGES = 64U;
+    static constexpr uint32_t COMPLETED_HISTORY_SIZE = 256U;
+    static constexpr std::chrono::milliseconds HELLO_PERIOD{500U};
+#if defined(__FREERTOS__)
+    static constexpr uint32_t MAX_RETAINED_MESSAGE_COUNT = 4U;
+    static constexpr uint32_t MAX_TRACKED_MESSAGE_COUNT = 4U;
+#else
+    static constexpr uint32_t MAX_RETAINED_MESSAGE_COUNT = 64U;
+    static constexpr uint32_t MAX_TRACKED_MESSAGE_COUNT = 64U;
+#endif
+
+    enum class FeedbackType : uint8_t
+    {
+        ACK = 1U,
+        NACK = 2U,
+        // Asks the device whether it retransmits, answered by an ACK without a message
+        HELLO = 3U
+    };
+
+    struct Release_t
+    {
+        const void* userPayload;
+        uint32_t deviceIndex;
+        hash_t messageHash;
+    };
+
+    using Range_t = UDPRangeList::Range_t;
+
+    static constexpr size_t FEEDBACK_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t)
+                                                   + sizeof(hash_t);
+    static constexpr size_t MAX_FEEDBACK_SIZE = FEEDBACK_HEADER_SIZE + MAX_NACK_RANGES * sizeof(Range_t);
+
+    // A message sent by this gateway, kept for retransmissions
+    struct RetainedMessage_t
+    {
+        uint64_t key;
+        // Datagram header of the first submessage, the other ones only differ in offset and size
+        IoxChunkDatagramHeader_t datagramHeader;
+        // User payload of the chunk, valid as long as the message is pending. The user header is found in the chunk.
+        const uint8_t* userPayload;
+        // Size of the submessages the message was split into
+        uint32_t submessageSize;
+        uint32_t deviceIndex;
+        uint32_t retransmitCount;
+        bool isPending;
+        std::chrono::steady_clock::time_point sendTime;
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+    // A message received by this gateway, which has not been completed yet
+    struct TrackedMessage_t
+    {
+        uint64_t key;
+        hash_t messageHash;
+        asio::ip::address address;
+        uint32_t totalSize;
+        UDPRangeList receivedRanges;
+        uint32_t nackCount;
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+    static uint64_t makeKey(uint32_t deviceIndex, hash_t messageHash) noexcept;
+
+    void feedbackAsyncReceive() noexcept;
+    void feedbackSocketCallback(asio::error_code ec, size_t bytes) noexcept;
+    void timerAsyncWait() noexcept;
+    void timerCallback(asio::error_code ec) noexcept;
+
+    void sendFeedback(FeedbackType type,
+                      hash_t messageHash,
+                      const Range_t* ranges,
+                      uint32_t rangeCount,
+                      const asio::ip::address& address) noexcept;
+    void handleAck(uint32_t deviceIndex, hash_t messageHash) noexcept;
+    void handleNack(uint32_t deviceIndex, hash_t messageHash, const Range_t* ranges, uint32_t rangeCount) noexcept;
+    void retransmit(const RetainedMessage_t& message, const Range_t* ranges, uint32_t rangeCount) noexcept;
+    void confirmPeer(uint32_t deviceIndex, const asio::ip::address& address) noexcept;
+    void checkPeers(std::chrono::steady_clock::time_point now) noexcept;
+    void checkRetainedMessages(std::chrono::steady_clock::time_point now) noexcept;
+    void checkTrackedMessages(std::chrono::steady_clock::time_point now) noexcept;
+    void markCompleted(uint64_t key) noexcept;
+    bool wasCompleted(uint64_t key) const noexcept;
+
+    SocketDiscovery& m_discovery;
+    const uint32_t m_retransmitBudget;
+    const std::chrono::milliseconds m_nackDelay;
+    const std::chrono::milliseconds m_retentionTimeout;
+
+    asio::ip::udp::socket m_feedbackSocket;
+    std::mutex m_feedbackSocketMutex;
+    asio::steady_timer m_timer;
+    std::array<uint8_t, MAX_FEEDBACK_SIZE> m_feedbackBuffer;
+    asio::ip::udp::endpoint m_feedbackEndpoint;
+
+    // Sender side, messages waiting for an acknowledgment
+    std::mutex m_retainedMutex;
+    cxx::vector_map<uint64_t, RetainedMessage_t, MAX_RETAINED_MESSAGE_COUNT> m_retainedMessages;
+
+    // Receiver side, incomplete messages and recently completed messages
+    std::mutex m_trackedMutex;
+    cxx::vector_map<uint64_t, TrackedMessage_t, MAX_TRACKED_MESSAGE_COUNT> m_trackedMessages;
+    std::array<uint64_t, COMPLETED_HISTORY_SIZE> m_completedMessages{};
+    uint32_t m_completedIndex{0U};
+
+    // Devices which answered a HELLO and their address at that time, the addresses are only used by the io thread
+    std::array<std::atomic<bool>, MAX_DEVICE_COUNT> m_isReliablePeer{};
+    std::array<asio::ip::address, MAX_DEVICE_COUNT> m_peerAddresses;
+    std::chrono::steady_clock::time_point m_lastHello;
+
+    std::atomic<uint64_t> m_retransmittedMessages{0U};
+    std::atomic<uint64_t> m_retransmitRequests{0U};
+
+    sendCallback_t m_sendCallback;
+    failCallback_t m_failCallback;
+    releaseCallback_t m_releaseCallback;
+    feedbackCallback_t m_feedbackCallback;
+};
+
+} // namespace udp
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_UDP_RELIABILITY_HPP
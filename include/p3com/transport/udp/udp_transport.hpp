@@ -4,19 +4,27 @@
 #define IOX_UDP_TRANSPORT_HPP
 
 #include "iceoryx_hoofs/cxx/optional.hpp"
-#include "iceoryx_hoofs/cxx/vector.hpp"
 
 #include "p3com/generic/config.hpp"
 #include "p3com/generic/types.hpp"
+#include "p3com/transport/socket/socket_discovery.hpp"
 #include "p3com/transport/transport.hpp"
-#include "p3com/transport/udp/udp_transport_broadcast.hpp"
+#include "p3com/transport/transport_config.hpp"
+#include "p3com/transport/udp/udp_data_worker.hpp"
+#include "p3com/transport/udp/udp_pacer.hpp"
+#include "p3com/transport/udp/udp_reliability.hpp"
+#include "p3com/utility/vector_map.hpp"
 
 #include <asio.hpp>
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace iox
 {
@@ -27,7 +35,7 @@ namespace udp
 class UDPTransport : public TransportLayer
 {
   public:
-    UDPTransport() noexcept;
+    explicit UDPTransport(const UDPTransportConfig_t& config) noexcept;
     ~UDPTransport() override;
 
     UDPTransport(const UDPTransport&) = delete;
@@ -37,33 +45,126 @@ class UDPTransport : public TransportLayer
 
     void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
     void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+    void registerBufferSentCallback(bufferSentCallback_t callback) noexcept override;
+    void registerBufferNeededCallback(bufferNeededCallback_t callback) noexcept override;
+    void registerBufferReleasedCallback(bufferReleasedCallback_t callback) noexcept override;
 
     void sendBroadcast(const void* data, size_t size) noexcept override;
     bool sendUserData(
         const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+    uint32_t sendUserDataBatch(const UserDataSegment_t* segments,
+                               uint32_t segmentCount,
+                               uint32_t deviceIndex) noexcept override;
 
-    size_t maxMessageSize() const noexcept override;
+    cxx::optional<uint32_t>
+    groupDeviceIndex(const capro::ServiceDescription::ClassHash& serviceHash) const noexcept override;
+    void setSubscribedServices(const ServiceVector_t& services) noexcept override;
+
+    bool willBePending(size_t userPayloadSize) const noexcept override;
+    bool mayDropSubmessages() const noexcept override;
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
     TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
 
   private:
-    static constexpr uint16_t DATA_PORT = 9333U;
-    static constexpr size_t MAX_DATAGRAM_SIZE = 32768U; // 32 kB
-
-    void dataSocketCallback(asio::error_code ec, size_t bytes) noexcept;
-    void dataAsyncReceive() noexcept;
+    static constexpr uint32_t MAX_DATA_WORKER_COUNT = 16U;
+    static constexpr uint32_t IP_UDP_HEADER_SIZE = 28U;
+    static constexpr uint32_t DEFAULT_MTU = 1500U;
+    static constexpr uint32_t MIN_MTU = 576U;
+    static constexpr std::chrono::seconds PATH_MTU_REFRESH_PERIOD{10U};
+    // Device indices with this bit set address the multicast group given by the lower 16 bits
+    static constexpr uint32_t GROUP_DEVICE_INDEX_FLAG = 0x80000000U;
+    // Organization-local scope 239.255.0.0/16
+    static constexpr uint32_t MULTICAST_GROUP_BASE = 0xEFFF0000U;
+#if defined(__FREERTOS__)
+    static constexpr uint32_t MAX_PENDING_BUFFER_COUNT = 4U;
+#else
+    static constexpr uint32_t MAX_PENDING_BUFFER_COUNT = 64U;
+#endif
+
+    // A message sent straight from its chunk, which is released once nothing holds it anymore
+    struct PendingBuffer_t
+    {
+        const void* userPayload;
+        uint32_t holdCount;
+    };
+
+    // Probed by the io thread and read by the sending threads
+    struct PathMtu_t
+    {
+        // 0 until the first probe
+        std::atomic<uint32_t> mtu{0U};
+        std::atomic<bool> isProbePending{false};
+    };
+
+    static uint32_t probePathMtu(const asio::ip::address& address) noexcept;
+    uint32_t pathMtu(uint32_t deviceIndex) const noexcept;
+    void requestPathMtuProbe(uint32_t deviceIndex) noexcept;
+    void updatePathMtu(uint32_t deviceIndex) noexcept;
+    void refreshPathMtus() noexcept;
+
+    static uint32_t groupOf(const capro::ServiceDescription::ClassHash& serviceHash) noexcept;
+    static bool isGroup(uint32_t deviceIndex) noexcept;
+    asio::ip::udp::endpoint dataEndpoint(uint32_t deviceIndex) noexcept;
+
+    static uint64_t bufferKey(uint32_t deviceIndex, hash_t messageHash) noexcept;
+    bool isZeroCopy(size_t userPayloadSize) const noexcept;
+    cxx::optional<uint32_t>
+    sendZeroCopy(const UserDataSegment_t* segments, uint32_t segmentCount, uint32_t deviceIndex) noexcept;
+    void holdBuffer(uint64_t key) noexcept;
+    void releaseBuffer(uint64_t key) noexcept;
+    void releaseRetainedBuffer(const void* userPayload, uint32_t deviceIndex, hash_t messageHash) noexcept;
+
+    uint32_t workerIndex(const UserDataSegment_t& segment, uint32_t deviceIndex) const noexcept;
+    uint32_t sendSegments(const UserDataSegment_t* segments,
+                          uint32_t segmentCount,
+                          uint32_t deviceIndex,
+                          cxx::optional<uint64_t> zeroCopyKey,
+                          bool mayWait = true) noexcept;
+    void dispatchUserData(const void* data, size_t size, const asio::ip::address& address, bool isMulticast) noexcept;
+    bool isSubscribed(const void* data, size_t size) noexcept;
+    UDPDataWorker::ReceiveTarget_t
+    receiveTarget(const void* data, size_t size, size_t datagramSize, const asio::ip::address& address) noexcept;
+    void receivedDirect(const void* data, size_t size, bool isComplete, uint32_t deviceIndex) noexcept;
 
     asio::io_service m_context;
     cxx::optional<asio::io_service::work> m_work;
     std::thread m_thread;
 
-    std::mutex m_socketMutex;
-    asio::ip::udp::socket m_dataSocket;
-    UDPBroadcast m_broadcast;
+    // Discovery socket shared with the TCP transport
+    std::shared_ptr<SocketDiscovery> m_discovery;
+
+    // Data plane shards, each with its own sockets and thread
+    std::vector<std::unique_ptr<UDPDataWorker>> m_workers;
+
+    // Optional retransmission of lost submessages
+    std::unique_ptr<UDPReliability> m_reliability;
+
+    // Optional pacing of the sent user data
+    std::unique_ptr<UDPPacer> m_pacer;
+
+    // Configured link MTU, or 0 if the path MTU to every device is discovered. The path MTU is probed when a device
+    // is discovered, when datagrams to it are rejected and periodically.
+    const uint32_t m_configuredMtu;
+    std::array<PathMtu_t, MAX_DEVICE_COUNT> m_pathMtus;
+    asio::steady_timer m_pathMtuTimer;
+
+    // Messages sent with MSG_ZEROCOPY, keyed by the device index and the message hash
+    const uint32_t m_zeroCopyThreshold;
+    std::mutex m_pendingBufferMutex;
+    cxx::vector_map<uint64_t, PendingBuffer_t, MAX_PENDING_BUFFER_COUNT> m_pendingBuffers;
 
-    std::array<uint8_t, MAX_DATAGRAM_SIZE> m_outputBuffer;
-    asio::ip::udp::endpoint m_outputEndpoint;
+    // Multicast groups of the locally subscribed services, which are only joined and received by the first worker.
+    // Services may share a group, so the datagrams of the services which are not subscribed are dropped on receive.
+    const bool m_isMulticast;
+    std::mutex m_groupMutex;
+    std::vector<uint32_t> m_joinedGroups;
+    std::vector<capro::ServiceDescription::ClassHash> m_subscribedServices;
 
     userDataCallback_t m_userDataCallback;
+    bufferSentCallback_t m_bufferSentCallback;
+    bufferNeededCallback_t m_bufferNeededCallback;
+    bufferReleasedCallback_t m_bufferReleasedCallback;
 };
 
 } // namespace udp
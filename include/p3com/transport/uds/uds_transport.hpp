@@ -0,0 +1,155 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_UDS_TRANSPORT_HPP
+#define IOX_UDS_TRANSPORT_HPP
+
+#include "p3com/generic/config.hpp"
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+namespace uds
+{
+/**
+ * @brief Transport layer between gateways on the same host, e.g. in containers with their own RouDi, over Unix domain
+ * sockets in the abstract namespace. Every gateway claims the first free index by binding its discovery socket, and
+ * the index of a gateway is its device index for all other gateways. Discovery messages are datagrams sent to the
+ * discovery sockets of all indices, user data is sent over SOCK_SEQPACKET connections. Large user payloads are copied
+ * into a sealed memfd which is passed with SCM_RIGHTS, so that the receiver maps it instead of reading it through the
+ * socket. This lifts the size limit of the socket, but copies a payload as often as the socket does.
+ */
+class UDSTransport : public TransportLayer
+{
+  public:
+    explicit UDSTransport(const UDSTransportConfig_t& config) noexcept;
+    UDSTransport(const UDSTransport&) = delete;
+    UDSTransport(UDSTransport&&) = delete;
+    UDSTransport& operator=(const UDSTransport&) = delete;
+    UDSTransport& operator=(UDSTransport&&) = delete;
+
+    ~UDSTransport() override;
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
+    void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+    void registerBufferNeededCallback(bufferNeededCallback_t callback) noexcept override;
+    void registerBufferReleasedCallback(bufferReleasedCallback_t callback) noexcept override;
+
+    void sendBroadcast(const void* data, size_t size) noexcept override;
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
+
+  private:
+    static constexpr uint32_t MAX_NAME_LENGTH = 64U;
+    static constexpr uint32_t MAX_DISCOVERY_SIZE = 32768U; // 32 kB
+    // Overhead the kernel subtracts from the send buffer size when checking the size of a message
+    static constexpr uint32_t SEND_BUFFER_OVERHEAD = 32U;
+    // Maximum number of messages read from a connection per wakeup, so that one sender cannot starve the others
+    static constexpr uint32_t MAX_RECEIVE_BATCH = 16U;
+    // Marks the first message of a connection, which carries the index of the connecting gateway
+    static constexpr uint32_t HELLO_MAGIC = 0x70337564U; // "p3ud"
+
+    enum class SocketKind
+    {
+        DISCOVERY,
+        DATA
+    };
+
+    struct Address_t
+    {
+        sockaddr_un address;
+        socklen_t length;
+    };
+
+    struct Hello_t
+    {
+        uint32_t magic;
+        uint32_t index;
+    };
+
+    // Connection for sending user data to a remote gateway, opened on the first message
+    struct Peer_t
+    {
+        std::mutex mutex;
+        int socket{-1};
+    };
+
+    // Accepted connection of a remote gateway, its device index is known after the hello message
+    struct Connection_t
+    {
+        int socket;
+        uint32_t deviceIndex;
+    };
+
+    Address_t address(SocketKind kind, uint32_t index) const noexcept;
+    bool claimIndex() noexcept;
+    int connect(uint32_t deviceIndex) noexcept;
+    bool sendInline(Peer_t& peer, const void* data1, size_t size1, const void* data2, size_t size2) noexcept;
+    bool sendMemfd(Peer_t& peer, const void* data1, size_t size1, const void* data2, size_t size2) noexcept;
+    bool sendMessage(Peer_t& peer, const msghdr& message) noexcept;
+
+    void receiveWorker() noexcept;
+    void receiveDiscovery() noexcept;
+    void accept() noexcept;
+    bool receive(Connection_t& connection) noexcept;
+    void receiveMemfd(const void* data, size_t size, int memfd, uint32_t deviceIndex) noexcept;
+    void closeSockets() noexcept;
+
+    const UDSTransportConfig_t m_config;
+    // Largest message which fits into the send buffer of a data socket
+    uint32_t m_maxInlineSize{0U};
+    uint32_t m_index{MAX_DEVICE_COUNT};
+    int m_discoverySocket{-1};
+    int m_listeningSocket{-1};
+    // Wakes up the receiving thread for termination
+    int m_wakeEvent{-1};
+
+    std::atomic<bool> m_isRunning{true};
+    std::thread m_receiveThread;
+
+    std::array<Peer_t, MAX_DEVICE_COUNT> m_peers;
+
+    // Only used by the receiving thread
+    std::vector<Connection_t> m_connections;
+    std::vector<uint8_t> m_receiveBuffer;
+    std::vector<uint8_t> m_messageBuffer;
+    std::array<uint8_t, MAX_DISCOVERY_SIZE> m_discoveryBuffer;
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    userDataCallback_t m_userDataCallback;
+    remoteDiscoveryCallback_t m_remoteDiscoveryCallback;
+    bufferNeededCallback_t m_bufferNeededCallback;
+    bufferReleasedCallback_t m_bufferReleasedCallback;
+};
+
+} // namespace uds
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_UDS_TRANSPORT_HPP
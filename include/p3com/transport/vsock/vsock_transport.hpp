@@ -0,0 +1,175 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_VSOCK_TRANSPORT_HPP
+#define IOX_VSOCK_TRANSPORT_HPP
+
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <sys/socket.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+namespace vsock
+{
+/**
+ * @brief Transport layer between the gateways of a host and its virtual machines over virtio-vsock, without the network
+ * stack of a virtual NIC. There is no broadcast, so the gateways to connect to are configured or probed on a range of
+ * context IDs, and the gateways connecting to this one are added with their first connection. Every remote gateway
+ * has its own device index. The discovery messages and the user data are sent as frames over an outgoing connection
+ * to every remote gateway, and received with one thread per incoming connection. With stream connections, large
+ * messages are not segmented and read straight into the loaned chunk, as with the TCP transport layer.
+ */
+class VSOCKTransport : public TransportLayer
+{
+  public:
+    explicit VSOCKTransport(const VSOCKTransportConfig_t& config) noexcept;
+    VSOCKTransport(const VSOCKTransport&) = delete;
+    VSOCKTransport(VSOCKTransport&&) = delete;
+    VSOCKTransport& operator=(const VSOCKTransport&) = delete;
+    VSOCKTransport& operator=(VSOCKTransport&&) = delete;
+
+    ~VSOCKTransport() override;
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
+    void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+    void registerBufferNeededCallback(bufferNeededCallback_t callback) noexcept override;
+    void registerBufferReleasedCallback(bufferReleasedCallback_t callback) noexcept override;
+
+    void sendBroadcast(const void* data, size_t size) noexcept override;
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
+
+  private:
+    // Maximum number of configured, probed and connecting gateways
+    static constexpr uint32_t MAX_PEER_COUNT = 64U;
+    // First context ID of a virtual machine
+    static constexpr uint32_t FIRST_GUEST_CID = 3U;
+    // Stream messages larger than this are read straight into the loaned chunk
+    static constexpr uint32_t MAX_BUFFERED_MESSAGE_SIZE = 65535U; // 64 kB
+    // Time between the connection attempts to a gateway which could not be reached
+    static constexpr std::chrono::milliseconds RECONNECT_INTERVAL{1000U};
+    // Time a connection attempt waits for the other side, so that probing absent context IDs stays short
+    static constexpr std::chrono::milliseconds CONNECT_TIMEOUT{200U};
+    // Marks the first frame of a connection, which carries the listening port of the connecting gateway
+    static constexpr uint32_t HELLO_MAGIC = 0x70337673U; // "p3vs"
+
+    enum class FrameKind : uint32_t
+    {
+        HELLO = 1U,
+        DISCOVERY = 2U,
+        USER_DATA = 3U
+    };
+
+    // Precedes every message, in the byte order of the host since all gateways run on the same machine
+    struct FrameHeader_t
+    {
+        FrameKind kind;
+        // Size of the serialized datagram header at the beginning of a user data message
+        uint32_t headerSize;
+        // Size of the message following the frame header
+        uint32_t size;
+    };
+
+    struct Hello_t
+    {
+        uint32_t magic;
+        uint32_t port;
+    };
+
+    // Remote gateway with the outgoing connection to it. Peers are only appended, and their address never changes.
+    // The connection is only opened by the accepting thread, the sending threads drop their messages meanwhile.
+    struct Peer_t
+    {
+        uint32_t cid{0U};
+        uint32_t port{0U};
+        std::mutex mutex;
+        int socket{-1};
+        // Only used by the accepting thread
+        std::chrono::steady_clock::time_point nextConnectTime;
+    };
+
+    // Incoming connection of a remote gateway with the thread receiving from it
+    struct Connection_t
+    {
+        int socket{-1};
+        uint32_t cid{0U};
+        std::atomic<bool> isFinished{false};
+        std::vector<uint8_t> buffer;
+        std::thread thread;
+    };
+
+    int socketType() const noexcept;
+    void configureSocket(int socket) const noexcept;
+    uint32_t addPeer(uint32_t cid, uint32_t port) noexcept;
+    int connect(uint32_t cid, uint32_t port) const noexcept;
+    bool sendFrame(
+        Peer_t& peer, FrameKind kind, const void* data1, size_t size1, const void* data2, size_t size2) noexcept;
+    void probePeers() noexcept;
+
+    void acceptWorker() noexcept;
+    void accept() noexcept;
+    void receiveWorker(Connection_t& connection) noexcept;
+    bool waitReadable(int socket) noexcept;
+    bool readExactly(Connection_t& connection, void* data, size_t size) noexcept;
+    bool receiveStreamFrame(Connection_t& connection, FrameHeader_t& frame) noexcept;
+    bool receiveSeqpacketFrame(Connection_t& connection, FrameHeader_t& frame) noexcept;
+    bool receiveLargeMessage(Connection_t& connection, const FrameHeader_t& frame, uint32_t deviceIndex) noexcept;
+    void closeSockets() noexcept;
+
+    const VSOCKTransportConfig_t m_config;
+    // Context ID of this machine, which is not probed
+    uint32_t m_localCid{0U};
+    int m_listeningSocket{-1};
+    // Wakes up all threads for termination
+    int m_wakeEvent{-1};
+    std::atomic<bool> m_isRunning{true};
+    std::thread m_acceptThread;
+
+    std::mutex m_peersMutex;
+    std::array<Peer_t, MAX_PEER_COUNT> m_peers;
+    std::atomic<uint32_t> m_peerCount{0U};
+
+    // Sent to the gateways which are connected later on
+    std::mutex m_discoveryMutex;
+    std::vector<uint8_t> m_lastDiscovery;
+
+    // Only used by the accepting thread
+    std::vector<std::unique_ptr<Connection_t>> m_connections;
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    userDataCallback_t m_userDataCallback;
+    remoteDiscoveryCallback_t m_remoteDiscoveryCallback;
+    bufferNeededCallback_t m_bufferNeededCallback;
+    bufferReleasedCallback_t m_bufferReleasedCallback;
+};
+
+} // namespace vsock
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_VSOCK_TRANSPORT_HPP
@@ -0,0 +1,163 @@
+// Copyright 2023 NXP
+
+#ifndef IOX_XDP_TRANSPORT_HPP
+#define IOX_XDP_TRANSPORT_HPP
+
+#include "p3com/generic/config.hpp"
+#include "p3com/generic/latency_histogram.hpp"
+#include "p3com/transport/socket/socket_discovery.hpp"
+#include "p3com/transport/transport.hpp"
+#include "p3com/transport/transport_config.hpp"
+
+#include <linux/if_ether.h>
+#include <linux/if_xdp.h>
+#include <netinet/in.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iox
+{
+namespace p3com
+{
+namespace xdp
+{
+/**
+ * @brief Transport layer which sends and receives the user data as UDP datagrams through an AF_XDP socket, bypassing
+ * the network stack of the kernel. A small XDP program on the interface steers only the datagrams for the data port of
+ * this transport into the socket, everything else, including the discovery shared with the UDP, TCP and SCTP
+ * transports, passes on to the kernel. The frames are exchanged with the driver through a shared packet buffer
+ * (UMEM), without a copy if the driver supports it. The datagrams carry the same datagram header as those of the UDP
+ * transport, and messages larger than a frame are segmented by the data writer.
+ */
+class XDPTransport : public TransportLayer
+{
+  public:
+    explicit XDPTransport(const XDPTransportConfig_t& config) noexcept;
+    XDPTransport(const XDPTransport&) = delete;
+    XDPTransport(XDPTransport&&) = delete;
+    XDPTransport& operator=(const XDPTransport&) = delete;
+    XDPTransport& operator=(XDPTransport&&) = delete;
+
+    ~XDPTransport() override;
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t callback) noexcept override;
+    void registerUserDataCallback(userDataCallback_t callback) noexcept override;
+
+    void sendBroadcast(const void* data, size_t size) noexcept override;
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override;
+
+    size_t maxMessageSize(uint32_t deviceIndex) const noexcept override;
+    TransportType getType() const noexcept override;
+    TransportStatistics_t getStatistics() const noexcept override;
+
+  private:
+    // Differs from the data ports of the other socket transports, so that all of them can be enabled on the same host
+    static constexpr uint16_t DATA_PORT = 9338U;
+    // Maximum number of frames received per wakeup
+    static constexpr uint32_t MAX_RECEIVE_BATCH = 64U;
+    // Ethernet, IPv4 header without options and UDP header in front of every message
+    static constexpr uint32_t FRAME_HEADER_SIZE = 42U;
+    // Time between the neighbor lookups of a device whose MAC address is not known yet
+    static constexpr std::chrono::milliseconds RESOLVE_INTERVAL{100U};
+
+    /**
+     * @brief One of the four rings shared with the kernel. The fill and TX rings are produced by this transport, the
+     * RX and completion rings by the kernel.
+     */
+    struct Ring_t
+    {
+        void* map{nullptr};
+        size_t mapSize{0U};
+        uint32_t* producer{nullptr};
+        uint32_t* consumer{nullptr};
+        uint32_t* flags{nullptr};
+        void* descriptors{nullptr};
+        uint32_t size{0U};
+        uint32_t mask{0U};
+    };
+
+    // MAC address of a device, looked up in the neighbor table of the kernel
+    struct Neighbor_t
+    {
+        bool isResolved{false};
+        std::array<uint8_t, ETH_ALEN> mac;
+        std::chrono::steady_clock::time_point nextResolveTime;
+    };
+
+    bool readInterface() noexcept;
+    bool loadProgram() noexcept;
+    bool attachProgram() noexcept;
+    bool createSocket() noexcept;
+    bool mapRing(
+        Ring_t& ring, uint32_t size, off_t offset, const xdp_ring_offset& offsets, size_t descriptorSize) noexcept;
+    void unmapRing(Ring_t& ring) noexcept;
+    bool bindSocket() noexcept;
+    void closeAll() noexcept;
+
+    bool resolve(uint32_t deviceIndex, const asio::ip::address& address) noexcept;
+    void reclaimSentFrames() noexcept;
+
+    void receiveWorker() noexcept;
+    uint32_t receive() noexcept;
+    void handleFrame(const uint8_t* frame, uint32_t size) noexcept;
+
+    const XDPTransportConfig_t m_config;
+    uint32_t m_ifindex{0U};
+    std::array<uint8_t, ETH_ALEN> m_localMac;
+    in_addr m_localAddress{};
+    uint32_t m_mtu{0U};
+    bool m_isZeroCopy{false};
+
+    int m_mapFd{-1};
+    int m_programFd{-1};
+    int m_linkFd{-1};
+    int m_socket{-1};
+    // Kernel socket which makes the kernel resolve the MAC address of a device
+    int m_resolveSocket{-1};
+    // Wakes up the receiving thread for termination
+    int m_wakeEvent{-1};
+
+    uint8_t* m_umem{nullptr};
+    size_t m_umemSize{0U};
+    Ring_t m_fillRing;
+    Ring_t m_completionRing;
+    Ring_t m_rxRing;
+    Ring_t m_txRing;
+
+    // Discovery socket shared with the UDP, TCP and SCTP transports
+    std::shared_ptr<SocketDiscovery> m_discovery;
+
+    std::atomic<bool> m_isRunning{true};
+    std::thread m_receiveThread;
+
+    // Protects the TX and completion rings, the free TX frames and the neighbors
+    std::mutex m_sendMutex;
+    std::vector<uint64_t> m_freeTxFrames;
+    std::array<Neighbor_t, MAX_DEVICE_COUNT> m_neighbors;
+    uint16_t m_ipIdentification{0U};
+
+    std::atomic<uint64_t> m_receivedMessages{0U};
+    std::atomic<uint64_t> m_receivedBytes{0U};
+    std::atomic<uint64_t> m_receiveWakeups{0U};
+    std::atomic<uint64_t> m_sentMessages{0U};
+    std::atomic<uint64_t> m_sentBytes{0U};
+    std::atomic<uint64_t> m_sendCalls{0U};
+    std::atomic<uint64_t> m_droppedMessages{0U};
+    LatencyHistogram m_receiveLatency;
+
+    userDataCallback_t m_userDataCallback;
+};
+
+} // namespace xdp
+} // namespace p3com
+} // namespace iox
+
+#endif // IOX_XDP_TRANSPORT_HPP
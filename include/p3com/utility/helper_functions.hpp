@@ -12,6 +12,10 @@
 #include <cstring>
 #include <thread>
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 namespace iox
 {
 namespace p3com
@@ -166,6 +170,48 @@ inline void neonMemcpy(void* destination, const void* source, const uint64_t siz
 }
 #endif
 
+/**
+ * @brief XOR the source bytes into the destination bytes, used to compute the FEC parity. Neon processes 64 bytes per
+ * iteration, otherwise whole 64 bit words are processed, which compilers are able to vectorize.
+ *
+ * @param destination
+ * @param source
+ * @param size
+ */
+inline void neonXor(void* destination, const void* source, const uint64_t size) noexcept
+{
+    auto* destinationBytes = static_cast<uint8_t*>(destination);
+    const auto* sourceBytes = static_cast<const uint8_t*>(source);
+    uint64_t offset{0U};
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    constexpr uint64_t ITERATION_SIZE{64U};
+    for (; offset + ITERATION_SIZE <= size; offset += ITERATION_SIZE)
+    {
+        const uint8x16x4_t a = vld1q_u8_x4(destinationBytes + offset);
+        const uint8x16x4_t b = vld1q_u8_x4(sourceBytes + offset);
+        uint8x16x4_t result;
+        result.val[0] = veorq_u8(a.val[0], b.val[0]);
+        result.val[1] = veorq_u8(a.val[1], b.val[1]);
+        result.val[2] = veorq_u8(a.val[2], b.val[2]);
+        result.val[3] = veorq_u8(a.val[3], b.val[3]);
+        vst1q_u8_x4(destinationBytes + offset, result);
+    }
+#endif
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+    {
+        uint64_t a;
+        uint64_t b;
+        std::memcpy(&a, destinationBytes + offset, sizeof(a));
+        std::memcpy(&b, sourceBytes + offset, sizeof(b));
+        a ^= b;
+        std::memcpy(destinationBytes + offset, &a, sizeof(a));
+    }
+    for (; offset < size; ++offset)
+    {
+        destinationBytes[offset] ^= sourceBytes[offset];
+    }
+}
+
 } // namespace p3com
 } // namespace iox
 
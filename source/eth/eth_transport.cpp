@@ -0,0 +1,553 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/eth/eth_transport.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+constexpr uint32_t iox::p3com::eth::EthernetTransport::MAX_DISCOVERY_SIZE;
+
+namespace
+{
+// Only checked by the kernel for the layout of the receive ring, TPACKET_V3 packs the frames of a block by their size
+constexpr uint32_t RX_FRAME_SIZE = 2048U;
+// The data of a frame in the send ring follows the frame header, without the address of the receive ring
+constexpr uint32_t TX_DATA_OFFSET = TPACKET3_HDRLEN - sizeof(sockaddr_ll);
+constexpr std::array<uint8_t, ETH_ALEN> BROADCAST_MAC{{0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU}};
+
+std::string macToString(const uint8_t* mac) noexcept
+{
+    std::array<char, 18U> result;
+    std::snprintf(result.data(),
+                  result.size(),
+                  "%02x:%02x:%02x:%02x:%02x:%02x",
+                  mac[0U],
+                  mac[1U],
+                  mac[2U],
+                  mac[3U],
+                  mac[4U],
+                  mac[5U]);
+    return result.data();
+}
+
+} // anonymous namespace
+
+iox::p3com::eth::EthernetTransport::EthernetTransport(const iox::p3com::EthernetTransportConfig_t& config) noexcept
+    : m_config(config)
+{
+    static_assert(MAX_DISCOVERY_SIZE <= std::numeric_limits<uint16_t>::max(),
+                  "The discovery message sizes have to fit into the frame header");
+
+    // The socket receives nothing until it is bound to the EtherType, after the rings are set up
+    m_socket = ::socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (m_socket < 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not create the packet socket: " << std::strerror(errno);
+        setFailed();
+        return;
+    }
+    if (!readInterface() || !setUpRings())
+    {
+        closeAll();
+        setFailed();
+        return;
+    }
+
+    if (m_config.qdiscBypass)
+    {
+        const int enable = 1;
+        if (::setsockopt(m_socket, SOL_PACKET, PACKET_QDISC_BYPASS, &enable, sizeof(enable)) != 0)
+        {
+            iox::p3com::LogWarn() << "[EthernetTransport] Could not bypass the queueing discipline: "
+                                  << std::strerror(errno);
+        }
+    }
+
+    sockaddr_ll address{};
+    address.sll_family = AF_PACKET;
+    address.sll_protocol = htons(m_config.etherType);
+    address.sll_ifindex = static_cast<int>(m_ifindex);
+    if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not bind to " << m_config.interfaceName << ": "
+                               << std::strerror(errno);
+        closeAll();
+        setFailed();
+        return;
+    }
+
+    m_wakeEvent = ::eventfd(0U, EFD_CLOEXEC);
+    if (m_wakeEvent < 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not create the wake event: " << std::strerror(errno);
+        closeAll();
+        setFailed();
+        return;
+    }
+
+    iox::p3com::LogInfo() << "[EthernetTransport] Sending with MAC address " << macToString(m_localMac.data())
+                          << " on " << m_config.interfaceName << ", maximum message size " << maxMessageSize(0U)
+                          << " B";
+
+    m_receiveThread = std::thread([this]() { receiveWorker(); });
+}
+
+iox::p3com::eth::EthernetTransport::~EthernetTransport()
+{
+    m_isRunning.store(false);
+    if (m_receiveThread.joinable())
+    {
+        const uint64_t wake = 1U;
+        static_cast<void>(::write(m_wakeEvent, &wake, sizeof(wake)));
+        m_receiveThread.join();
+    }
+    closeAll();
+}
+
+void iox::p3com::eth::EthernetTransport::closeAll() noexcept
+{
+    if (m_ring != nullptr)
+    {
+        static_cast<void>(::munmap(m_ring, m_ringSize));
+        m_ring = nullptr;
+        m_txRing = nullptr;
+    }
+    if (m_socket >= 0)
+    {
+        static_cast<void>(::close(m_socket));
+        m_socket = -1;
+    }
+    if (m_wakeEvent >= 0)
+    {
+        static_cast<void>(::close(m_wakeEvent));
+        m_wakeEvent = -1;
+    }
+}
+
+bool iox::p3com::eth::EthernetTransport::readInterface() noexcept
+{
+    m_ifindex = ::if_nametoindex(m_config.interfaceName.c_str());
+    if (m_ifindex == 0U)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Unknown interface '" << m_config.interfaceName
+                               << "', set the interface key in the [ethernet] table";
+        return false;
+    }
+
+    ifreq request{};
+    std::strncpy(request.ifr_name, m_config.interfaceName.c_str(), IFNAMSIZ - 1);
+    if (::ioctl(m_socket, SIOCGIFHWADDR, &request) != 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not read the MAC address: " << std::strerror(errno);
+        return false;
+    }
+    std::memcpy(m_localMac.data(), request.ifr_hwaddr.sa_data, ETH_ALEN);
+    if (::ioctl(m_socket, SIOCGIFMTU, &request) != 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not read the MTU: " << std::strerror(errno);
+        return false;
+    }
+    m_mtu = static_cast<uint32_t>(request.ifr_mtu);
+    if (m_mtu <= sizeof(FrameHeader_t))
+    {
+        iox::p3com::LogError() << "[EthernetTransport] The MTU of " << m_config.interfaceName << " is too small";
+        return false;
+    }
+    return true;
+}
+
+bool iox::p3com::eth::EthernetTransport::setUpRings() noexcept
+{
+    const int version = TPACKET_V3;
+    if (::setsockopt(m_socket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] TPACKET_V3 is not supported: " << std::strerror(errno);
+        return false;
+    }
+    // Skip a malformed frame in the send ring instead of stopping at it
+    const int loss = 1;
+    static_cast<void>(::setsockopt(m_socket, SOL_PACKET, PACKET_LOSS, &loss, sizeof(loss)));
+
+    tpacket_req3 rxRequest{};
+    rxRequest.tp_block_size = m_config.blockSize;
+    rxRequest.tp_block_nr = m_config.blockCount;
+    rxRequest.tp_frame_size = RX_FRAME_SIZE;
+    rxRequest.tp_frame_nr = m_config.blockSize / RX_FRAME_SIZE * m_config.blockCount;
+    rxRequest.tp_retire_blk_tov = static_cast<uint32_t>(m_config.blockTimeout.count());
+    if (::setsockopt(m_socket, SOL_PACKET, PACKET_RX_RING, &rxRequest, sizeof(rxRequest)) != 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not set up the receive ring (the block size has to be a "
+                                  "multiple of the page size): "
+                               << std::strerror(errno);
+        return false;
+    }
+
+    // Every frame of the send ring holds a frame of the MTU, the blocks are whole pages
+    m_txFrameSize = TPACKET_ALIGNMENT;
+    while (m_txFrameSize < TX_DATA_OFFSET + ETH_HLEN + m_mtu)
+    {
+        m_txFrameSize *= 2U;
+    }
+    const auto pageSize = static_cast<uint32_t>(::sysconf(_SC_PAGESIZE));
+    const uint32_t txBlockSize = std::max(m_txFrameSize, pageSize);
+    const uint32_t framesPerBlock = txBlockSize / m_txFrameSize;
+    tpacket_req3 txRequest{};
+    txRequest.tp_block_size = txBlockSize;
+    txRequest.tp_block_nr = (std::max(m_config.txFrameCount, 1U) + framesPerBlock - 1U) / framesPerBlock;
+    txRequest.tp_frame_size = m_txFrameSize;
+    txRequest.tp_frame_nr = txRequest.tp_block_nr * framesPerBlock;
+    if (::setsockopt(m_socket, SOL_PACKET, PACKET_TX_RING, &txRequest, sizeof(txRequest)) != 0)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Could not set up the send ring: " << std::strerror(errno);
+        return false;
+    }
+    m_txFrameCount = txRequest.tp_frame_nr;
+
+    const size_t rxSize = static_cast<size_t>(m_config.blockSize) * m_config.blockCount;
+    m_ringSize = rxSize + static_cast<size_t>(txBlockSize) * txRequest.tp_block_nr;
+    void* ring = ::mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, m_socket, 0);
+    if (ring == MAP_FAILED)
+    {
+        // Locking the rings into memory fails above RLIMIT_MEMLOCK, they are mapped anyway
+        ring = ::mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_socket, 0);
+        if (ring == MAP_FAILED)
+        {
+            iox::p3com::LogError() << "[EthernetTransport] Could not map the rings: " << std::strerror(errno);
+            return false;
+        }
+    }
+    m_ring = static_cast<uint8_t*>(ring);
+    m_txRing = m_ring + rxSize;
+    return true;
+}
+
+void iox::p3com::eth::EthernetTransport::registerDiscoveryCallback(
+    iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    m_remoteDiscoveryCallback = std::move(callback);
+}
+
+void iox::p3com::eth::EthernetTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
+{
+    m_userDataCallback = std::move(callback);
+}
+
+void iox::p3com::eth::EthernetTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    if (size > MAX_DISCOVERY_SIZE)
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Discovery message is too large! Discarding!";
+        return;
+    }
+
+    // All fragments are queued before the kernel is asked to send them
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    const uint8_t sequence = m_discoverySequence++;
+    const size_t fragmentSize = maxMessageSize(0U);
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t offset = 0U; offset < size; offset += fragmentSize)
+    {
+        const size_t chunk = std::min(fragmentSize, size - offset);
+        const FrameHeader_t header{FrameKind::DISCOVERY,
+                                   sequence,
+                                   static_cast<uint16_t>(chunk),
+                                   static_cast<uint16_t>(offset),
+                                   static_cast<uint16_t>(size)};
+        if (!queueFrame(BROADCAST_MAC.data(), header, bytes + offset, chunk, nullptr, 0U))
+        {
+            iox::p3com::LogWarn() << "[EthernetTransport] The send ring is full, discovery message is incomplete";
+            break;
+        }
+    }
+    flush();
+}
+
+bool iox::p3com::eth::EthernetTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    const size_t size = size1 + size2;
+    if (size > maxMessageSize(deviceIndex))
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Message does not fit into a frame! Discarding!";
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    if (deviceIndex >= m_deviceCount.load(std::memory_order_acquire))
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Invalid device index when sending user data";
+        return false;
+    }
+
+    const FrameHeader_t header{
+        FrameKind::USER_DATA, 0U, static_cast<uint16_t>(size), 0U, static_cast<uint16_t>(size)};
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (!queueFrame(m_devices[deviceIndex].mac.data(), header, data1, size1, data2, size2))
+    {
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    flush();
+    m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+    m_sentBytes.fetch_add(size, std::memory_order_relaxed);
+    return false;
+}
+
+bool iox::p3com::eth::EthernetTransport::queueFrame(const uint8_t* destination,
+                                                    const FrameHeader_t& header,
+                                                    const void* data1,
+                                                    size_t size1,
+                                                    const void* data2,
+                                                    size_t size2) noexcept
+{
+    uint8_t* slot = m_txRing + static_cast<size_t>(m_txFrame) * m_txFrameSize;
+    auto* slotHeader = reinterpret_cast<tpacket3_hdr*>(slot);
+    const uint32_t status = __atomic_load_n(&slotHeader->tp_status, __ATOMIC_ACQUIRE);
+    if ((status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) != 0U)
+    {
+        return false;
+    }
+    if ((status & TP_STATUS_WRONG_FORMAT) != 0U)
+    {
+        iox::p3com::LogWarn() << "[EthernetTransport] The kernel rejected a frame of the send ring";
+    }
+
+    uint8_t* frame = slot + TX_DATA_OFFSET;
+    auto* ethernetHeader = reinterpret_cast<ethhdr*>(frame);
+    std::memcpy(ethernetHeader->h_dest, destination, ETH_ALEN);
+    std::memcpy(ethernetHeader->h_source, m_localMac.data(), ETH_ALEN);
+    ethernetHeader->h_proto = htons(m_config.etherType);
+
+    FrameHeader_t networkHeader = header;
+    networkHeader.size = htons(header.size);
+    networkHeader.offset = htons(header.offset);
+    networkHeader.totalSize = htons(header.totalSize);
+    std::memcpy(frame + ETH_HLEN, &networkHeader, sizeof(networkHeader));
+    uint8_t* data = frame + ETH_HLEN + sizeof(FrameHeader_t);
+    std::memcpy(data, data1, size1);
+    if (size2 != 0U)
+    {
+        std::memcpy(data + size1, data2, size2);
+    }
+
+    // The driver pads the frame to the minimum frame size, which is why the frame header carries the size
+    slotHeader->tp_len = static_cast<uint32_t>(ETH_HLEN + sizeof(FrameHeader_t) + size1 + size2);
+    __atomic_store_n(&slotHeader->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+    m_txFrame = (m_txFrame + 1U) % m_txFrameCount;
+    return true;
+}
+
+void iox::p3com::eth::EthernetTransport::flush() noexcept
+{
+    // Sends all frames of the send ring which are requested, without waiting for the driver
+    m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+    if (::send(m_socket, nullptr, 0U, MSG_DONTWAIT) < 0 && errno != EAGAIN && errno != ENOBUFS)
+    {
+        iox::p3com::LogWarn() << "[EthernetTransport] Could not send the frames: " << std::strerror(errno);
+    }
+}
+
+void iox::p3com::eth::EthernetTransport::receiveWorker() noexcept
+{
+    std::array<pollfd, 2U> pollFds{{{m_socket, POLLIN, 0}, {m_wakeEvent, POLLIN, 0}}};
+    uint32_t blockIndex = 0U;
+    while (m_isRunning.load())
+    {
+        // Wakes up when a block is handed over, either full or after the block timeout
+        if (::poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            iox::p3com::LogError() << "[EthernetTransport] Could not poll the socket: " << std::strerror(errno);
+            setFailed();
+            break;
+        }
+        if (pollFds[1U].revents != 0)
+        {
+            break;
+        }
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+
+        for (uint32_t i = 0U; i < m_config.blockCount && m_isRunning.load(); ++i)
+        {
+            uint8_t* block = m_ring + static_cast<size_t>(blockIndex) * m_config.blockSize;
+            auto* descriptor = reinterpret_cast<tpacket_block_desc*>(block);
+            if ((__atomic_load_n(&descriptor->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0U)
+            {
+                break;
+            }
+            receiveBlock(block);
+            __atomic_store_n(&descriptor->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            blockIndex = (blockIndex + 1U) % m_config.blockCount;
+        }
+    }
+    iox::p3com::LogInfo() << "[EthernetTransport] Receive thread has exited";
+}
+
+void iox::p3com::eth::EthernetTransport::receiveBlock(const uint8_t* block) noexcept
+{
+    const auto* descriptor = reinterpret_cast<const tpacket_block_desc*>(block);
+    const uint8_t* packet = block + descriptor->hdr.bh1.offset_to_first_pkt;
+    for (uint32_t i = 0U; i < descriptor->hdr.bh1.num_pkts; ++i)
+    {
+        const auto* packetHeader = reinterpret_cast<const tpacket3_hdr*>(packet);
+        const auto* address = reinterpret_cast<const sockaddr_ll*>(packet + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+        // Frames sent by other sockets on this host are seen as well
+        if (address->sll_pkttype != PACKET_OUTGOING)
+        {
+            handleFrame(packet + packetHeader->tp_mac, packetHeader->tp_snaplen);
+        }
+        packet += packetHeader->tp_next_offset;
+    }
+}
+
+void iox::p3com::eth::EthernetTransport::handleFrame(const uint8_t* frame, uint32_t size) noexcept
+{
+    const auto receiveTime = std::chrono::steady_clock::now();
+
+    if (size < ETH_HLEN + sizeof(FrameHeader_t))
+    {
+        return;
+    }
+    FrameHeader_t header;
+    std::memcpy(&header, frame + ETH_HLEN, sizeof(header));
+    header.size = ntohs(header.size);
+    header.offset = ntohs(header.offset);
+    header.totalSize = ntohs(header.totalSize);
+    const uint8_t* data = frame + ETH_HLEN + sizeof(FrameHeader_t);
+    if (header.size > size - ETH_HLEN - sizeof(FrameHeader_t))
+    {
+        iox::p3com::LogWarn() << "[EthernetTransport] Received a truncated frame! Discarding!";
+        return;
+    }
+
+    const uint8_t* source = frame + ETH_ALEN;
+    if (header.kind == FrameKind::DISCOVERY)
+    {
+        const auto index = findDevice(source, true);
+        if (index.has_value())
+        {
+            handleDiscovery(m_devices[*index], *index, header, data);
+        }
+        return;
+    }
+    if (header.kind != FrameKind::USER_DATA)
+    {
+        return;
+    }
+
+    m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+    m_receivedBytes.fetch_add(header.size, std::memory_order_relaxed);
+    const auto index = findDevice(source, false);
+    if (!index.has_value())
+    {
+        iox::p3com::LogError() << "[EthernetTransport] Received user data message from an unknown device! Discarding!";
+        return;
+    }
+    if (m_userDataCallback)
+    {
+        m_userDataCallback(data, header.size, {iox::p3com::TransportType::ETH, *index});
+    }
+    m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+}
+
+void iox::p3com::eth::EthernetTransport::handleDiscovery(Device_t& device,
+                                                         uint32_t deviceIndex,
+                                                         const FrameHeader_t& header,
+                                                         const uint8_t* data) noexcept
+{
+    // A lost fragment leaves the message incomplete, it is dropped when the next one starts
+    if (header.offset == 0U || header.sequence != device.discoverySequence)
+    {
+        device.discoverySequence = header.sequence;
+        device.discoveryReceivedSize = 0U;
+    }
+    if (header.totalSize > MAX_DISCOVERY_SIZE || header.offset + header.size > header.totalSize)
+    {
+        iox::p3com::LogWarn() << "[EthernetTransport] Received an invalid discovery fragment! Discarding!";
+        return;
+    }
+    std::memcpy(device.discoveryBuffer.data() + header.offset, data, header.size);
+    device.discoveryReceivedSize += header.size;
+    if (device.discoveryReceivedSize == header.totalSize)
+    {
+        device.discoveryReceivedSize = 0U;
+        if (m_remoteDiscoveryCallback)
+        {
+            m_remoteDiscoveryCallback(
+                device.discoveryBuffer.data(), header.totalSize, {iox::p3com::TransportType::ETH, deviceIndex});
+        }
+    }
+}
+
+iox::cxx::optional<uint32_t> iox::p3com::eth::EthernetTransport::findDevice(const uint8_t* mac,
+                                                                             bool addIfUnknown) noexcept
+{
+    const uint32_t count = m_deviceCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        if (std::memcmp(m_devices[i].mac.data(), mac, ETH_ALEN) == 0)
+        {
+            return {i};
+        }
+    }
+    if (!addIfUnknown)
+    {
+        return iox::cxx::nullopt;
+    }
+    if (count == MAX_DEVICE_COUNT)
+    {
+        iox::p3com::LogWarn() << "[EthernetTransport] Too many devices, ignoring " << macToString(mac);
+        return iox::cxx::nullopt;
+    }
+
+    // Only the receiving thread adds devices, the sending threads see them after the count is updated
+    std::memcpy(m_devices[count].mac.data(), mac, ETH_ALEN);
+    m_deviceCount.store(count + 1U, std::memory_order_release);
+    iox::p3com::LogInfo() << "[EthernetTransport] Discovered device " << count << " with MAC address "
+                          << macToString(mac);
+    return {count};
+}
+
+size_t iox::p3com::eth::EthernetTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    static_cast<void>(deviceIndex);
+    return m_mtu - sizeof(FrameHeader_t);
+}
+
+iox::p3com::TransportType iox::p3com::eth::EthernetTransport::getType() const noexcept
+{
+    return iox::p3com::TransportType::ETH;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::eth::EthernetTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
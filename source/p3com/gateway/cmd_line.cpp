@@ -14,14 +14,32 @@ void printHelp() noexcept
               << "  options:\n"
               << "    -h, --help                Print help and exit\n"
               << "    -l, --log-level <LEVEL>   Set log level\n"
-#if defined(PCIE_GATEWAY)
+#if defined(PCIE_TRANSPORT)
               << "    -p, --pcie                Enable PCIe transport\n"
 #endif
-#if defined(UDP_GATEWAY)
+#if defined(UDP_TRANSPORT)
               << "    -u, --udp                 Enable UDP transport\n"
 #endif
-#if defined(TCP_GATEWAY)
+#if defined(TCP_TRANSPORT)
               << "    -t, --tcp                 Enable TCP transport\n"
+#endif
+#if defined(SHM_TRANSPORT)
+              << "    -s, --shm                 Enable shared memory transport\n"
+#endif
+#if defined(UDS_TRANSPORT)
+              << "    -d, --uds                 Enable Unix domain socket transport\n"
+#endif
+#if defined(VSOCK_TRANSPORT)
+              << "    -v, --vsock               Enable virtio-vsock transport\n"
+#endif
+#if defined(SCTP_TRANSPORT)
+              << "    -x, --sctp                Enable SCTP transport\n"
+#endif
+#if defined(XDP_TRANSPORT)
+              << "    -a, --af-xdp              Enable AF_XDP transport\n"
+#endif
+#if defined(ETH_TRANSPORT)
+              << "    -e, --ethernet            Enable raw Ethernet transport\n"
 #endif
               << "    -c, --config-file <PATH>  Path to the gateway config file\n";
 }
@@ -35,17 +53,21 @@ iox::p3com::CmdLineArgs_t iox::p3com::CmdLineParser::parse(int argc, char** argv
                                        {"pcie", no_argument, nullptr, 'p'},
                                        {"udp", no_argument, nullptr, 'u'},
                                        {"tcp", no_argument, nullptr, 't'},
+                                       {"shm", no_argument, nullptr, 's'},
+                                       {"uds", no_argument, nullptr, 'd'},
+                                       {"vsock", no_argument, nullptr, 'v'},
+                                       {"sctp", no_argument, nullptr, 'x'},
+                                       {"af-xdp", no_argument, nullptr, 'a'},
+                                       {"ethernet", no_argument, nullptr, 'e'},
                                        {"log-level", required_argument, nullptr, 'l'},
                                        {"config", required_argument, nullptr, 'c'},
                                        {nullptr, 0, nullptr, 0}};
 
     // colon after shortOption means it requires an argument, two colons mean optional argument
-    constexpr const char* SHORT_OPTIONS = "hpuitLl:c:";
+    constexpr const char* SHORT_OPTIONS = "hpuitsdvxaeLl:c:";
     int32_t index;
     int32_t opt{-1};
 
-    bool wasUdp = false;
-    bool wasTcp = false;
     while ((opt = getopt_long(argc, argv, SHORT_OPTIONS, LONG_OPTIONS, &index), opt != -1))
     {
         switch (opt)
@@ -59,26 +81,36 @@ iox::p3com::CmdLineArgs_t iox::p3com::CmdLineParser::parse(int argc, char** argv
             config.enabledTransportSpecified = true;
             break;
         case 'u':
-            if (wasTcp)
-            {
-                iox::p3com::LogError() << "[TransportInfo] UDP & TCP flags can't be used together, choose only one.";
-                config.run = false;
-                break;
-            }
             config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::UDP)] = true;
             config.enabledTransportSpecified = true;
-            wasUdp = true;
             break;
         case 't':
-            if (wasUdp)
-            {
-                iox::p3com::LogError() << "[TransportInfo] UDP & TCP flags can't be used together, choose only one.";
-                config.run = false;
-                break;
-            }
             config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::TCP)] = true;
             config.enabledTransportSpecified = true;
-            wasTcp = true;
+            break;
+        case 's':
+            config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::SHM)] = true;
+            config.enabledTransportSpecified = true;
+            break;
+        case 'd':
+            config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::UDS)] = true;
+            config.enabledTransportSpecified = true;
+            break;
+        case 'v':
+            config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::VSOCK)] = true;
+            config.enabledTransportSpecified = true;
+            break;
+        case 'x':
+            config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::SCTP)] = true;
+            config.enabledTransportSpecified = true;
+            break;
+        case 'a':
+            config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::XDP)] = true;
+            config.enabledTransportSpecified = true;
+            break;
+        case 'e':
+            config.enabledTransports[iox::p3com::index(iox::p3com::TransportType::ETH)] = true;
+            config.enabledTransportSpecified = true;
             break;
         case 'l':
             if (strcmp(optarg, "off") == 0)
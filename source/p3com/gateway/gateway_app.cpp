@@ -6,12 +6,14 @@
 #include "iceoryx_posh/runtime/posh_runtime.hpp"
 
 #include "p3com/generic/config.hpp"
+#include "p3com/generic/fec.hpp"
 #include "p3com/generic/pending_messages.hpp"
 #include "p3com/generic/segmented_messages.hpp"
 #include "p3com/generic/transport_forwarder.hpp"
 #include "p3com/gateway/gateway_app.hpp"
 #include "p3com/gateway/iox_to_transport.hpp"
 #include "p3com/gateway/transport_to_iox.hpp"
+#include "p3com/introspection/gw_introspection_types.hpp"
 #include "p3com/transport/transport.hpp"
 #include "p3com/transport/transport_info.hpp"
 
@@ -47,13 +49,13 @@ void iox::p3com::GatewayApp::enableTransports() noexcept
         {
             if (m_cmdLineArgs.enabledTransports[i])
             {
-                iox::p3com::TransportInfo::enable(iox::p3com::type(i));
+                iox::p3com::TransportInfo::enable(iox::p3com::type(i), m_gwConfig.transportConfig);
             }
         }
     }
     else
     {
-        iox::p3com::TransportInfo::enableAll();
+        iox::p3com::TransportInfo::enableAll(m_gwConfig.transportConfig);
     }
 }
 
@@ -63,12 +65,13 @@ void iox::p3com::GatewayApp::run() noexcept
     auto discovery = std::make_unique<iox::p3com::DiscoveryManager>(m_gwConfig);
     auto pendingMessageManager = std::make_unique<iox::p3com::PendingMessageManager>();
     auto segmentedMessageManager = std::make_unique<iox::p3com::SegmentedMessageManager>();
+    auto fecManager = std::make_unique<iox::p3com::FecManager>();
     auto transportForwarder = std::make_unique<iox::p3com::TransportForwarder>(
-        *discovery, *pendingMessageManager, m_gwConfig.forwardedServices);
+        *discovery, *pendingMessageManager, m_gwConfig.forwardedServices, m_gwConfig.fecServices);
 
     // Initialize gateways in both directions
-    iox::p3com::Transport2Iceoryx tr2iox(*discovery, *transportForwarder, *segmentedMessageManager);
-    iox::p3com::Iceoryx2Transport iox2tr(*discovery, *pendingMessageManager);
+    iox::p3com::Transport2Iceoryx tr2iox(*discovery, *transportForwarder, *segmentedMessageManager, *fecManager);
+    iox::p3com::Iceoryx2Transport iox2tr(*discovery, *pendingMessageManager, m_gwConfig.fecServices);
 
     // Initialize discovery system
     auto updateCallback = [&](const iox::p3com::ServiceVector_t& neededChannels) {
@@ -77,6 +80,10 @@ void iox::p3com::GatewayApp::run() noexcept
     };
     discovery->initialize(updateCallback);
 
+    // Publisher of the transport layer runtime statistics
+    iox::popo::Publisher<iox::p3com::GwTransportStatisticsData> statisticsPublisher{
+        iox::p3com::IntrospectionGwStatisticsService, {1U}};
+
     // Run thread that monitors periodic updates
     std::chrono::steady_clock::time_point lastLossyDiscovery{std::chrono::steady_clock::now()};
 #if defined(__FREERTOS__)
@@ -87,6 +94,7 @@ void iox::p3com::GatewayApp::run() noexcept
     {
         // Check the currently saved segmented messages for timeouts
         segmentedMessageManager->checkSegmentedMessages();
+        fecManager->checkMessages();
 
         // Send the discovery information to lossy transports, with certain period
         const auto now = std::chrono::steady_clock::now();
@@ -99,6 +107,20 @@ void iox::p3com::GatewayApp::run() noexcept
             lastLossyDiscovery = now;
         }
 
+        // Publish the current transport statistics
+        statisticsPublisher.loan()
+            .and_then([&fecManager](auto& sample) {
+                for (uint32_t i = 0U; i < iox::p3com::TRANSPORT_TYPE_COUNT; ++i)
+                {
+                    sample->transports[i] = iox::p3com::TransportInfo::statistics(iox::p3com::type(i));
+                }
+                sample->fec = fecManager->getStatistics();
+                sample.publish();
+            })
+            .or_else([](auto& error) {
+                iox::p3com::LogWarn() << "[p3comGateway] Unable to publish transport statistics, error: " << error;
+            });
+
         std::this_thread::sleep_for(iox::p3com::DISCOVERY_PERIOD);
     }
 
@@ -8,6 +8,7 @@
 #include "iceoryx_hoofs/internal/file_reader/file_reader.hpp"
 
 #include <cpptoml.h>
+#include <iterator>
 #include <limits>
 #endif
 
@@ -55,8 +56,10 @@ iox::p3com::TomlGatewayConfigParser::parse(roudi::ConfigFilePathString_t path) n
     auto preferredTransport = parsedToml->get_as<std::string>(PREFERRED_TRANSPORT_KEY);
     if (preferredTransport)
     {
-        const auto it = std::find(
-            iox::p3com::TRANSPORT_TYPE_NAMES.begin(), iox::p3com::TRANSPORT_TYPE_NAMES.end(), *preferredTransport);
+        // The first name is a placeholder, the transport types start at 1
+        const auto it = std::find(std::next(iox::p3com::TRANSPORT_TYPE_NAMES.begin()),
+                                  iox::p3com::TRANSPORT_TYPE_NAMES.end(),
+                                  *preferredTransport);
         if (it != iox::p3com::TRANSPORT_TYPE_NAMES.end())
         {
             const auto index = std::distance(iox::p3com::TRANSPORT_TYPE_NAMES.begin(), it);
@@ -80,6 +83,588 @@ iox::p3com::TomlGatewayConfigParser::parse(roudi::ConfigFilePathString_t path) n
             config.forwardedServices.push_back({serviceValue, instanceValue, eventValue});
         }
     }
+
+    constexpr const char FEC_SERVICE_KEY[] = "fec-service";
+    auto fecServices = parsedToml->get_table_array(FEC_SERVICE_KEY);
+    if (fecServices)
+    {
+        for (const auto& service : *fecServices)
+        {
+            constexpr const char SERVICE_KEY[] = "service";
+            constexpr const char INSTANCE_KEY[] = "instance";
+            constexpr const char EVENT_KEY[] = "event";
+            constexpr const char GROUP_SIZE_KEY[] = "group-size";
+            constexpr const char PARITY_COUNT_KEY[] = "parity-count";
+            const capro::IdString_t serviceValue{cxx::TruncateToCapacity, *service->get_as<std::string>(SERVICE_KEY)};
+            const capro::IdString_t instanceValue{cxx::TruncateToCapacity, *service->get_as<std::string>(INSTANCE_KEY)};
+            const capro::IdString_t eventValue{cxx::TruncateToCapacity, *service->get_as<std::string>(EVENT_KEY)};
+            iox::p3com::FecConfig_t fecConfig;
+            fecConfig.groupSize = service->get_as<uint32_t>(GROUP_SIZE_KEY).value_or(fecConfig.groupSize);
+            fecConfig.parityCount = service->get_as<uint32_t>(PARITY_COUNT_KEY).value_or(fecConfig.parityCount);
+            if (fecConfig.parityCount > iox::p3com::MAX_FEC_PARITY_COUNT)
+            {
+                iox::p3com::LogWarn() << "[GatewayConfig] FEC parity count " << fecConfig.parityCount
+                                      << " exceeds the maximum, using " << iox::p3com::MAX_FEC_PARITY_COUNT;
+                fecConfig.parityCount = iox::p3com::MAX_FEC_PARITY_COUNT;
+            }
+            const capro::ServiceDescription serviceDescription{serviceValue, instanceValue, eventValue};
+            if (config.fecServices.emplace(serviceDescription.getClassHash(), fecConfig))
+            {
+                iox::p3com::LogInfo() << "[GatewayConfig] Read FEC group size " << fecConfig.groupSize
+                                      << " with parity count " << fecConfig.parityCount
+                                      << " for service: " << serviceDescription;
+            }
+            else
+            {
+                iox::p3com::LogWarn() << "[GatewayConfig] Too many FEC services, ignoring service: "
+                                      << serviceDescription;
+            }
+        }
+    }
+
+    constexpr const char UDP_KEY[] = "udp";
+    auto udpTable = parsedToml->get_table(UDP_KEY);
+    if (udpTable)
+    {
+        constexpr const char RECEIVE_BATCH_SIZE_KEY[] = "receive-batch-size";
+        auto receiveBatchSize = udpTable->get_as<uint32_t>(RECEIVE_BATCH_SIZE_KEY);
+        if (receiveBatchSize)
+        {
+            config.transportConfig.udp.receiveBatchSize = *receiveBatchSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP receive batch size: " << *receiveBatchSize;
+        }
+
+        constexpr const char SEGMENTATION_OFFLOAD_KEY[] = "segmentation-offload";
+        auto segmentationOffload = udpTable->get_as<bool>(SEGMENTATION_OFFLOAD_KEY);
+        if (segmentationOffload)
+        {
+            config.transportConfig.udp.segmentationOffload = *segmentationOffload;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP segmentation offload: " << *segmentationOffload;
+        }
+
+        constexpr const char DATA_WORKERS_KEY[] = "data-workers";
+        auto dataWorkers = udpTable->get_as<uint32_t>(DATA_WORKERS_KEY);
+        if (dataWorkers)
+        {
+            config.transportConfig.udp.dataWorkerCount = *dataWorkers;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP data workers: " << *dataWorkers;
+        }
+
+        constexpr const char ZERO_COPY_THRESHOLD_KEY[] = "zerocopy-threshold";
+        auto zeroCopyThreshold = udpTable->get_as<uint32_t>(ZERO_COPY_THRESHOLD_KEY);
+        if (zeroCopyThreshold)
+        {
+            config.transportConfig.udp.zeroCopyThreshold = *zeroCopyThreshold;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP zero-copy threshold: " << *zeroCopyThreshold;
+        }
+
+        constexpr const char DIRECT_RECEIVE_KEY[] = "direct-receive";
+        auto directReceive = udpTable->get_as<bool>(DIRECT_RECEIVE_KEY);
+        if (directReceive)
+        {
+            config.transportConfig.udp.directReceive = *directReceive;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP direct receive: " << *directReceive;
+        }
+
+        constexpr const char IO_URING_KEY[] = "io-uring";
+        auto ioUring = udpTable->get_as<bool>(IO_URING_KEY);
+        if (ioUring)
+        {
+            config.transportConfig.udp.ioUring = *ioUring;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP io_uring: " << *ioUring;
+        }
+
+        constexpr const char BUSY_POLL_KEY[] = "busy-poll-us";
+        auto busyPoll = udpTable->get_as<uint32_t>(BUSY_POLL_KEY);
+        if (busyPoll)
+        {
+            config.transportConfig.udp.busyPollBudget = std::chrono::microseconds(*busyPoll);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP busy poll budget: " << *busyPoll << " us";
+        }
+
+        constexpr const char SOCKET_BUSY_POLL_KEY[] = "socket-busy-poll-us";
+        auto socketBusyPoll = udpTable->get_as<uint32_t>(SOCKET_BUSY_POLL_KEY);
+        if (socketBusyPoll)
+        {
+            config.transportConfig.udp.socketBusyPoll = std::chrono::microseconds(*socketBusyPoll);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP socket busy poll: " << *socketBusyPoll << " us";
+        }
+
+        constexpr const char MTU_KEY[] = "mtu";
+        auto mtu = udpTable->get_as<uint32_t>(MTU_KEY);
+        if (mtu)
+        {
+            config.transportConfig.udp.mtu = *mtu;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP MTU: " << *mtu;
+        }
+
+        constexpr const char PACING_KEY[] = "pacing";
+        auto pacing = udpTable->get_as<bool>(PACING_KEY);
+        if (pacing)
+        {
+            config.transportConfig.udp.pacing = *pacing;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP pacing: " << *pacing;
+        }
+
+        constexpr const char MAX_RATE_KEY[] = "max-rate-mbps";
+        auto maxRate = udpTable->get_as<uint32_t>(MAX_RATE_KEY);
+        if (maxRate)
+        {
+            config.transportConfig.udp.maxRateMbps = *maxRate;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP maximum rate: " << *maxRate << " Mbit/s";
+        }
+
+        constexpr const char MULTICAST_KEY[] = "multicast";
+        auto multicast = udpTable->get_as<bool>(MULTICAST_KEY);
+        if (multicast)
+        {
+            config.transportConfig.udp.multicast = *multicast;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP multicast: " << *multicast;
+        }
+
+        constexpr const char RELIABILITY_KEY[] = "reliability";
+        auto reliability = udpTable->get_as<bool>(RELIABILITY_KEY);
+        if (reliability)
+        {
+            config.transportConfig.udp.reliability = *reliability;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP reliability: " << *reliability;
+        }
+
+        constexpr const char RETRANSMIT_BUDGET_KEY[] = "retransmit-budget";
+        auto retransmitBudget = udpTable->get_as<uint32_t>(RETRANSMIT_BUDGET_KEY);
+        if (retransmitBudget)
+        {
+            config.transportConfig.udp.retransmitBudget = *retransmitBudget;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP retransmit budget: " << *retransmitBudget;
+        }
+
+        constexpr const char NACK_DELAY_KEY[] = "nack-delay-ms";
+        auto nackDelay = udpTable->get_as<uint32_t>(NACK_DELAY_KEY);
+        if (nackDelay)
+        {
+            config.transportConfig.udp.nackDelay = std::chrono::milliseconds(*nackDelay);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP NACK delay: " << *nackDelay << " ms";
+        }
+
+        constexpr const char RETENTION_TIMEOUT_KEY[] = "retention-timeout-ms";
+        auto retentionTimeout = udpTable->get_as<uint32_t>(RETENTION_TIMEOUT_KEY);
+        if (retentionTimeout)
+        {
+            config.transportConfig.udp.retentionTimeout = std::chrono::milliseconds(*retentionTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDP retention timeout: " << *retentionTimeout << " ms";
+        }
+    }
+
+    constexpr const char TCP_KEY[] = "tcp";
+    auto tcpTable = parsedToml->get_table(TCP_KEY);
+    if (tcpTable)
+    {
+        constexpr const char SEND_QUEUE_SIZE_KEY[] = "send-queue-size";
+        auto sendQueueSize = tcpTable->get_as<uint32_t>(SEND_QUEUE_SIZE_KEY);
+        if (sendQueueSize)
+        {
+            config.transportConfig.tcp.sendQueueSize = *sendQueueSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP send queue size: " << *sendQueueSize << " B";
+        }
+
+        constexpr const char SEND_QUEUE_TIMEOUT_KEY[] = "send-queue-timeout-ms";
+        auto sendQueueTimeout = tcpTable->get_as<uint32_t>(SEND_QUEUE_TIMEOUT_KEY);
+        if (sendQueueTimeout)
+        {
+            config.transportConfig.tcp.sendQueueTimeout = std::chrono::milliseconds(*sendQueueTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP send queue timeout: " << *sendQueueTimeout << " ms";
+        }
+
+        constexpr const char BULK_CONNECTIONS_KEY[] = "bulk-connections";
+        auto bulkConnections = tcpTable->get_as<uint32_t>(BULK_CONNECTIONS_KEY);
+        if (bulkConnections)
+        {
+            config.transportConfig.tcp.bulkConnectionCount = *bulkConnections;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP bulk connection count: " << *bulkConnections;
+        }
+
+        constexpr const char BULK_THRESHOLD_KEY[] = "bulk-threshold";
+        auto bulkThreshold = tcpTable->get_as<uint32_t>(BULK_THRESHOLD_KEY);
+        if (bulkThreshold)
+        {
+            config.transportConfig.tcp.bulkThreshold = *bulkThreshold;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP bulk threshold: " << *bulkThreshold << " B";
+        }
+
+        constexpr const char STRIPE_SIZE_KEY[] = "stripe-size";
+        auto stripeSize = tcpTable->get_as<uint32_t>(STRIPE_SIZE_KEY);
+        if (stripeSize)
+        {
+            config.transportConfig.tcp.stripeSize = *stripeSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP stripe size: " << *stripeSize << " B";
+        }
+
+        constexpr const char ZERO_COPY_THRESHOLD_KEY[] = "zerocopy-threshold";
+        auto zeroCopyThreshold = tcpTable->get_as<uint32_t>(ZERO_COPY_THRESHOLD_KEY);
+        if (zeroCopyThreshold)
+        {
+            config.transportConfig.tcp.zeroCopyThreshold = *zeroCopyThreshold;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP zero-copy threshold: " << *zeroCopyThreshold;
+        }
+
+        constexpr const char USER_TIMEOUT_KEY[] = "user-timeout-ms";
+        auto userTimeout = tcpTable->get_as<uint32_t>(USER_TIMEOUT_KEY);
+        if (userTimeout)
+        {
+            config.transportConfig.tcp.userTimeout = std::chrono::milliseconds(*userTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP user timeout: " << *userTimeout << " ms";
+        }
+
+        constexpr const char KEEP_ALIVE_KEY[] = "keepalive-s";
+        auto keepAlive = tcpTable->get_as<uint32_t>(KEEP_ALIVE_KEY);
+        if (keepAlive)
+        {
+            config.transportConfig.tcp.keepAlive = std::chrono::seconds(*keepAlive);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP keepalive: " << *keepAlive << " s";
+        }
+
+        constexpr const char HEARTBEAT_INTERVAL_KEY[] = "heartbeat-interval-ms";
+        auto heartbeatInterval = tcpTable->get_as<uint32_t>(HEARTBEAT_INTERVAL_KEY);
+        if (heartbeatInterval)
+        {
+            config.transportConfig.tcp.heartbeatInterval = std::chrono::milliseconds(*heartbeatInterval);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP heartbeat interval: " << *heartbeatInterval << " ms";
+        }
+
+        constexpr const char IO_URING_KEY[] = "io-uring";
+        auto ioUring = tcpTable->get_as<bool>(IO_URING_KEY);
+        if (ioUring)
+        {
+            config.transportConfig.tcp.ioUring = *ioUring;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP io_uring: " << *ioUring;
+        }
+
+        constexpr const char BUSY_POLL_KEY[] = "busy-poll-us";
+        auto busyPoll = tcpTable->get_as<uint32_t>(BUSY_POLL_KEY);
+        if (busyPoll)
+        {
+            config.transportConfig.tcp.busyPollBudget = std::chrono::microseconds(*busyPoll);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP busy poll budget: " << *busyPoll << " us";
+        }
+
+        constexpr const char SOCKET_BUSY_POLL_KEY[] = "socket-busy-poll-us";
+        auto socketBusyPoll = tcpTable->get_as<uint32_t>(SOCKET_BUSY_POLL_KEY);
+        if (socketBusyPoll)
+        {
+            config.transportConfig.tcp.socketBusyPoll = std::chrono::microseconds(*socketBusyPoll);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read TCP socket busy poll: " << *socketBusyPoll << " us";
+        }
+    }
+
+    constexpr const char SHM_KEY[] = "shm";
+    auto shmTable = parsedToml->get_table(SHM_KEY);
+    if (shmTable)
+    {
+        constexpr const char NAME_KEY[] = "name";
+        auto regionName = shmTable->get_as<std::string>(NAME_KEY);
+        if (regionName)
+        {
+            config.transportConfig.shm.regionName = *regionName;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SHM region name: " << *regionName;
+        }
+
+        constexpr const char SLOT_COUNT_KEY[] = "slot-count";
+        auto slotCount = shmTable->get_as<uint32_t>(SLOT_COUNT_KEY);
+        if (slotCount)
+        {
+            config.transportConfig.shm.slotCount = *slotCount;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SHM slot count: " << *slotCount;
+        }
+
+        constexpr const char SLOT_SIZE_KEY[] = "slot-size";
+        auto slotSize = shmTable->get_as<uint32_t>(SLOT_SIZE_KEY);
+        if (slotSize)
+        {
+            config.transportConfig.shm.slotSize = *slotSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SHM slot size: " << *slotSize << " B";
+        }
+
+        constexpr const char ASYNC_COPY_THRESHOLD_KEY[] = "async-copy-threshold";
+        auto asyncCopyThreshold = shmTable->get_as<uint32_t>(ASYNC_COPY_THRESHOLD_KEY);
+        if (asyncCopyThreshold)
+        {
+            config.transportConfig.shm.asyncCopyThreshold = *asyncCopyThreshold;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SHM async copy threshold: " << *asyncCopyThreshold << " B";
+        }
+    }
+
+    constexpr const char UDS_KEY[] = "uds";
+    auto udsTable = parsedToml->get_table(UDS_KEY);
+    if (udsTable)
+    {
+        constexpr const char NAME_KEY[] = "name";
+        auto name = udsTable->get_as<std::string>(NAME_KEY);
+        if (name)
+        {
+            config.transportConfig.uds.name = *name;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDS socket name: " << *name;
+        }
+
+        constexpr const char SOCKET_BUFFER_SIZE_KEY[] = "socket-buffer-size";
+        auto socketBufferSize = udsTable->get_as<uint32_t>(SOCKET_BUFFER_SIZE_KEY);
+        if (socketBufferSize)
+        {
+            config.transportConfig.uds.socketBufferSize = *socketBufferSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDS socket buffer size: " << *socketBufferSize << " B";
+        }
+
+        constexpr const char MEMFD_THRESHOLD_KEY[] = "memfd-threshold";
+        auto memfdThreshold = udsTable->get_as<uint32_t>(MEMFD_THRESHOLD_KEY);
+        if (memfdThreshold)
+        {
+            config.transportConfig.uds.memfdThreshold = *memfdThreshold;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDS memfd threshold: " << *memfdThreshold << " B";
+        }
+
+        constexpr const char SEND_TIMEOUT_KEY[] = "send-timeout-ms";
+        auto sendTimeout = udsTable->get_as<uint32_t>(SEND_TIMEOUT_KEY);
+        if (sendTimeout)
+        {
+            config.transportConfig.uds.sendTimeout = std::chrono::milliseconds(*sendTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read UDS send timeout: " << *sendTimeout << " ms";
+        }
+    }
+
+    constexpr const char VSOCK_KEY[] = "vsock";
+    auto vsockTable = parsedToml->get_table(VSOCK_KEY);
+    if (vsockTable)
+    {
+        constexpr const char PORT_KEY[] = "port";
+        auto port = vsockTable->get_as<uint32_t>(PORT_KEY);
+        if (port)
+        {
+            config.transportConfig.vsock.port = *port;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read vsock port: " << *port;
+        }
+
+        constexpr const char SEQPACKET_KEY[] = "seqpacket";
+        auto seqpacket = vsockTable->get_as<bool>(SEQPACKET_KEY);
+        if (seqpacket)
+        {
+            config.transportConfig.vsock.seqpacket = *seqpacket;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read vsock seqpacket: " << *seqpacket;
+        }
+
+        constexpr const char PEER_KEY[] = "peer";
+        auto peers = vsockTable->get_table_array(PEER_KEY);
+        if (peers)
+        {
+            for (const auto& peer : *peers)
+            {
+                constexpr const char CID_KEY[] = "cid";
+                iox::p3com::VSOCKPeer_t peerConfig;
+                peerConfig.cid = peer->get_as<uint32_t>(CID_KEY).value_or(peerConfig.cid);
+                peerConfig.port = peer->get_as<uint32_t>(PORT_KEY).value_or(config.transportConfig.vsock.port);
+                config.transportConfig.vsock.peers.push_back(peerConfig);
+                iox::p3com::LogInfo() << "[GatewayConfig] Read vsock peer: CID " << peerConfig.cid << " port "
+                                      << peerConfig.port;
+            }
+        }
+
+        constexpr const char SCAN_CID_COUNT_KEY[] = "scan-cid-count";
+        auto scanCidCount = vsockTable->get_as<uint32_t>(SCAN_CID_COUNT_KEY);
+        if (scanCidCount)
+        {
+            config.transportConfig.vsock.scanCidCount = *scanCidCount;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read vsock scan CID count: " << *scanCidCount;
+        }
+
+        constexpr const char BUFFER_SIZE_KEY[] = "buffer-size";
+        auto bufferSize = vsockTable->get_as<uint32_t>(BUFFER_SIZE_KEY);
+        if (bufferSize)
+        {
+            config.transportConfig.vsock.bufferSize = *bufferSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read vsock buffer size: " << *bufferSize << " B";
+        }
+
+        constexpr const char SEND_TIMEOUT_KEY[] = "send-timeout-ms";
+        auto sendTimeout = vsockTable->get_as<uint32_t>(SEND_TIMEOUT_KEY);
+        if (sendTimeout)
+        {
+            config.transportConfig.vsock.sendTimeout = std::chrono::milliseconds(*sendTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read vsock send timeout: " << *sendTimeout << " ms";
+        }
+    }
+
+    constexpr const char SCTP_KEY[] = "sctp";
+    auto sctpTable = parsedToml->get_table(SCTP_KEY);
+    if (sctpTable)
+    {
+        constexpr const char STREAM_COUNT_KEY[] = "stream-count";
+        auto streamCount = sctpTable->get_as<uint32_t>(STREAM_COUNT_KEY);
+        if (streamCount)
+        {
+            config.transportConfig.sctp.streamCount = *streamCount;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP stream count: " << *streamCount;
+        }
+
+        constexpr const char MAX_MESSAGE_SIZE_KEY[] = "max-message-size";
+        auto maxMessageSize = sctpTable->get_as<uint32_t>(MAX_MESSAGE_SIZE_KEY);
+        if (maxMessageSize)
+        {
+            config.transportConfig.sctp.maxMessageSize = *maxMessageSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP maximum message size: " << *maxMessageSize << " B";
+        }
+
+        constexpr const char SOCKET_BUFFER_SIZE_KEY[] = "socket-buffer-size";
+        auto socketBufferSize = sctpTable->get_as<uint32_t>(SOCKET_BUFFER_SIZE_KEY);
+        if (socketBufferSize)
+        {
+            config.transportConfig.sctp.socketBufferSize = *socketBufferSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP socket buffer size: " << *socketBufferSize << " B";
+        }
+
+        constexpr const char HEARTBEAT_INTERVAL_KEY[] = "heartbeat-interval-ms";
+        auto heartbeatInterval = sctpTable->get_as<uint32_t>(HEARTBEAT_INTERVAL_KEY);
+        if (heartbeatInterval)
+        {
+            config.transportConfig.sctp.heartbeatInterval = std::chrono::milliseconds(*heartbeatInterval);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP heartbeat interval: " << *heartbeatInterval << " ms";
+        }
+
+        constexpr const char PATH_MAX_RETRANSMISSIONS_KEY[] = "path-max-retransmissions";
+        auto pathMaxRetransmissions = sctpTable->get_as<uint32_t>(PATH_MAX_RETRANSMISSIONS_KEY);
+        if (pathMaxRetransmissions)
+        {
+            config.transportConfig.sctp.pathMaxRetransmissions = *pathMaxRetransmissions;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP path max retransmissions: " << *pathMaxRetransmissions;
+        }
+
+        constexpr const char RTO_MAX_KEY[] = "rto-max-ms";
+        auto rtoMax = sctpTable->get_as<uint32_t>(RTO_MAX_KEY);
+        if (rtoMax)
+        {
+            config.transportConfig.sctp.rtoMax = std::chrono::milliseconds(*rtoMax);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP maximum retransmission timeout: " << *rtoMax << " ms";
+        }
+
+        constexpr const char SEND_TIMEOUT_KEY[] = "send-timeout-ms";
+        auto sendTimeout = sctpTable->get_as<uint32_t>(SEND_TIMEOUT_KEY);
+        if (sendTimeout)
+        {
+            config.transportConfig.sctp.sendTimeout = std::chrono::milliseconds(*sendTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read SCTP send timeout: " << *sendTimeout << " ms";
+        }
+    }
+
+    constexpr const char XDP_KEY[] = "xdp";
+    auto xdpTable = parsedToml->get_table(XDP_KEY);
+    if (xdpTable)
+    {
+        constexpr const char INTERFACE_KEY[] = "interface";
+        auto interfaceName = xdpTable->get_as<std::string>(INTERFACE_KEY);
+        if (interfaceName)
+        {
+            config.transportConfig.xdp.interfaceName = *interfaceName;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read XDP interface: " << *interfaceName;
+        }
+
+        constexpr const char QUEUE_ID_KEY[] = "queue-id";
+        auto queueId = xdpTable->get_as<uint32_t>(QUEUE_ID_KEY);
+        if (queueId)
+        {
+            config.transportConfig.xdp.queueId = *queueId;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read XDP queue ID: " << *queueId;
+        }
+
+        constexpr const char FRAME_COUNT_KEY[] = "frame-count";
+        auto frameCount = xdpTable->get_as<uint32_t>(FRAME_COUNT_KEY);
+        if (frameCount)
+        {
+            config.transportConfig.xdp.frameCount = *frameCount;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read XDP frame count: " << *frameCount;
+        }
+
+        constexpr const char FRAME_SIZE_KEY[] = "frame-size";
+        auto frameSize = xdpTable->get_as<uint32_t>(FRAME_SIZE_KEY);
+        if (frameSize)
+        {
+            config.transportConfig.xdp.frameSize = *frameSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read XDP frame size: " << *frameSize << " B";
+        }
+
+        constexpr const char ZERO_COPY_KEY[] = "zero-copy";
+        auto zeroCopy = xdpTable->get_as<bool>(ZERO_COPY_KEY);
+        if (zeroCopy)
+        {
+            config.transportConfig.xdp.zeroCopy = *zeroCopy;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read XDP zero-copy: " << *zeroCopy;
+        }
+
+        constexpr const char GENERIC_XDP_KEY[] = "generic-xdp";
+        auto genericXdp = xdpTable->get_as<bool>(GENERIC_XDP_KEY);
+        if (genericXdp)
+        {
+            config.transportConfig.xdp.genericXdp = *genericXdp;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read XDP generic mode: " << *genericXdp;
+        }
+    }
+
+    constexpr const char ETHERNET_KEY[] = "ethernet";
+    auto ethernetTable = parsedToml->get_table(ETHERNET_KEY);
+    if (ethernetTable)
+    {
+        constexpr const char INTERFACE_KEY[] = "interface";
+        auto interfaceName = ethernetTable->get_as<std::string>(INTERFACE_KEY);
+        if (interfaceName)
+        {
+            config.transportConfig.ethernet.interfaceName = *interfaceName;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet interface: " << *interfaceName;
+        }
+
+        constexpr const char ETHER_TYPE_KEY[] = "ether-type";
+        auto etherType = ethernetTable->get_as<uint16_t>(ETHER_TYPE_KEY);
+        if (etherType)
+        {
+            config.transportConfig.ethernet.etherType = *etherType;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet EtherType: " << *etherType;
+        }
+
+        constexpr const char BLOCK_SIZE_KEY[] = "block-size";
+        auto blockSize = ethernetTable->get_as<uint32_t>(BLOCK_SIZE_KEY);
+        if (blockSize)
+        {
+            config.transportConfig.ethernet.blockSize = *blockSize;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet block size: " << *blockSize << " B";
+        }
+
+        constexpr const char BLOCK_COUNT_KEY[] = "block-count";
+        auto blockCount = ethernetTable->get_as<uint32_t>(BLOCK_COUNT_KEY);
+        if (blockCount)
+        {
+            config.transportConfig.ethernet.blockCount = *blockCount;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet block count: " << *blockCount;
+        }
+
+        constexpr const char BLOCK_TIMEOUT_KEY[] = "block-timeout-ms";
+        auto blockTimeout = ethernetTable->get_as<uint32_t>(BLOCK_TIMEOUT_KEY);
+        if (blockTimeout)
+        {
+            config.transportConfig.ethernet.blockTimeout = std::chrono::milliseconds(*blockTimeout);
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet block timeout: " << *blockTimeout << " ms";
+        }
+
+        constexpr const char TX_FRAME_COUNT_KEY[] = "tx-frame-count";
+        auto txFrameCount = ethernetTable->get_as<uint32_t>(TX_FRAME_COUNT_KEY);
+        if (txFrameCount)
+        {
+            config.transportConfig.ethernet.txFrameCount = *txFrameCount;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet send frame count: " << *txFrameCount;
+        }
+
+        constexpr const char QDISC_BYPASS_KEY[] = "qdisc-bypass";
+        auto qdiscBypass = ethernetTable->get_as<bool>(QDISC_BYPASS_KEY);
+        if (qdiscBypass)
+        {
+            config.transportConfig.ethernet.qdiscBypass = *qdiscBypass;
+            iox::p3com::LogInfo() << "[GatewayConfig] Read Ethernet qdisc bypass: " << *qdiscBypass;
+        }
+    }
 #endif
 
     return config;
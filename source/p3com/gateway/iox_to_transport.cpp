@@ -12,9 +12,11 @@
 #include "p3com/internal/log/logging.hpp"
 
 iox::p3com::Iceoryx2Transport::Iceoryx2Transport(iox::p3com::DiscoveryManager& discovery,
-                                                 iox::p3com::PendingMessageManager& pendingMessageManager) noexcept
+                                                 iox::p3com::PendingMessageManager& pendingMessageManager,
+                                                 const iox::p3com::FecServiceMap_t& fecServices) noexcept
     : m_discovery(discovery)
     , m_pendingMessageManager(pendingMessageManager)
+    , m_fecServices(fecServices)
     , m_terminateFlag(false)
     , m_suspendFlag(false)
     , m_waitsetThread(&Iceoryx2Transport::waitsetLoop, this)
@@ -148,12 +150,15 @@ void iox::p3com::Iceoryx2Transport::waitsetLoop() noexcept
                             : chunkHeader->userHeaderSize();
                     // m_submessage* fields will be filled for every submessage individually inside writeSegmented
 
+                    const auto* fecConfig = m_fecServices.find(hash);
                     iox::p3com::writeSegmented(datagramHeader,
                                              *chunkHeader,
                                              deviceIndices,
                                              m_pendingMessageManager,
                                              endpointsMutex(),
-                                             subscriber);
+                                             subscriber,
+                                             (fecConfig != m_fecServices.end()) ? *fecConfig : iox::p3com::FecConfig_t{},
+                                             m_fecParityBuffer);
                 }
             }
         }
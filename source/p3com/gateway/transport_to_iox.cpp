@@ -7,6 +7,7 @@
 #include "p3com/gateway/transport_to_iox.hpp"
 #include "p3com/generic/config.hpp"
 #include "p3com/generic/data_writer.hpp"
+#include "p3com/generic/fec.hpp"
 #include "p3com/generic/segmented_messages.hpp"
 #include "p3com/generic/serialization.hpp"
 #include "p3com/generic/types.hpp"
@@ -20,10 +21,12 @@ constexpr std::chrono::nanoseconds NS_PER_BYTE{500U};
 
 iox::p3com::Transport2Iceoryx::Transport2Iceoryx(iox::p3com::DiscoveryManager& discovery,
                                                  iox::p3com::TransportForwarder& transportForwarder,
-                                                 iox::p3com::SegmentedMessageManager& segmentedMessageManager) noexcept
+                                                 iox::p3com::SegmentedMessageManager& segmentedMessageManager,
+                                                 iox::p3com::FecManager& fecManager) noexcept
     : m_discovery(discovery)
     , m_transportForwarder(transportForwarder)
     , m_segmentedMessageManager(segmentedMessageManager)
+    , m_fecManager(fecManager)
 {
     iox::p3com::TransportInfo::doForAllEnabled([this](iox::p3com::TransportLayer& transport) {
         // Register callback for user data received over transport
@@ -71,86 +74,138 @@ void iox::p3com::Transport2Iceoryx::receive(const void* serializedUserPayload,
     }
 
     doForChannel(datagramHeader.serviceHash, [&](iox::popo::UntypedPublisher& publisher) {
-        void* userPayload = nullptr;
-        void* userHeader = nullptr;
-        bool shouldPublish = false;
-        iox::p3com::LogInfo() << "[Transport2Iceoryx] Forwarding user message for service: "
-                            << publisher.getServiceDescription()
-                            << ", submessage offset: " << datagramHeader.submessageOffset;
-
-        const bool isPushed = m_segmentedMessageManager.findAndDecrement(
-            datagramHeader.messageHash, userHeader, userPayload, shouldPublish);
-        if (!isPushed)
+        if (datagramHeader.fecGroupSize == 0U)
         {
-            const bool hasUserHeader = datagramHeader.userHeaderSize != 0U;
+            deliver(datagramHeader, serializedUserPayloadPtr, deviceIndex, publisher);
+            return;
+        }
 
-            // Need to allocate new buffer
-            publisher
-                .loan(datagramHeader.userPayloadSize,
-                      datagramHeader.userPayloadAlignment,
-                      hasUserHeader ? datagramHeader.userHeaderSize : iox::CHUNK_NO_USER_HEADER_SIZE,
-                      hasUserHeader ? iox::p3com::USER_HEADER_ALIGNMENT : iox::CHUNK_NO_USER_HEADER_ALIGNMENT)
-                .and_then([&](auto* p) {
-                    userHeader = hasUserHeader ? iox::mepoo::ChunkHeader::fromUserPayload(p)->userHeader() : nullptr;
-                    userPayload = p;
-                })
-                .or_else([](auto& error) {
-                    if (error == iox::popo::AllocationError::TOO_MANY_CHUNKS_ALLOCATED_IN_PARALLEL)
-                    {
-                        iox::p3com::LogWarn()
-                            << "[Transport2Iceoryx] Too many chunks allocated in parallel, discarding!";
-                    }
-                    else if (error == iox::popo::AllocationError::RUNNING_OUT_OF_CHUNKS)
-                    {
-                        iox::p3com::LogWarn() << "[Transport2Iceoryx] Running out of chunks, discarding!";
-                    }
-                    else
-                    {
-                        iox::p3com::LogError() << "[Transport2Iceoryx] Could not loan chunk, discarding! Error code: "
-                                             << static_cast<uint64_t>(error);
-                    }
-                });
-            if (userPayload == nullptr)
+        // The forward error correction state is kept for as long as the segmented message itself
+        const auto deadline = std::chrono::steady_clock::now()
+                              + NS_PER_BYTE * (datagramHeader.userHeaderSize + datagramHeader.userPayloadSize);
+        bool isPublished = false;
+        if (datagramHeader.fecParityIndex == iox::p3com::FEC_DATA_INDEX)
+        {
+            if (!m_fecManager.acceptData(datagramHeader, deadline))
             {
+                iox::p3com::LogDebug() << "[Transport2Iceoryx] Received already known user message, discarding!";
                 return;
             }
+            isPublished = deliver(datagramHeader, serializedUserPayloadPtr, deviceIndex, publisher);
+        }
+        else
+        {
+            m_fecManager.acceptParity(datagramHeader, serializedUserPayloadPtr, deadline);
+        }
 
-            if (datagramHeader.submessageCount > 1U)
-            {
-                // Compute the deadline of this message
-                const auto deadline = std::chrono::steady_clock::now()
-                                      + NS_PER_BYTE * (datagramHeader.userHeaderSize + datagramHeader.userPayloadSize);
-
-                m_segmentedMessageManager.push(datagramHeader.messageHash,
-                                               datagramHeader.submessageCount - 1U,
-                                               userHeader,
-                                               userPayload,
-                                               endpointsMutex(),
-                                               publisher,
-                                               deadline);
-                shouldPublish = false;
-            }
-            else
+        // Rebuild as many lost submessages as possible from the parity submessages received so far
+        iox::p3com::IoxChunkDatagramHeader_t recoveredDatagramHeader;
+        iox::p3com::FecSubmessageBuffer_t recoveredData;
+        while (!isPublished)
+        {
+            void* userHeader = nullptr;
+            void* userPayload = nullptr;
+            m_segmentedMessageManager.find(datagramHeader.messageHash, userHeader, userPayload);
+            if (!m_fecManager.recoverNext(datagramHeader.messageHash,
+                                          static_cast<const uint8_t*>(userPayload),
+                                          recoveredDatagramHeader,
+                                          recoveredData))
             {
-                shouldPublish = true;
+                break;
             }
+            iox::p3com::LogInfo() << "[Transport2Iceoryx] Recovered lost user message for service: "
+                                << publisher.getServiceDescription()
+                                << ", submessage offset: " << recoveredDatagramHeader.submessageOffset;
+            isPublished = deliver(recoveredDatagramHeader, recoveredData.data(), deviceIndex, publisher);
         }
 
-        if (userPayload != nullptr)
+        if (isPublished)
         {
-            iox::p3com::takeNext(datagramHeader,
-                               serializedUserPayloadPtr,
-                               static_cast<uint8_t*>(userHeader),
-                               static_cast<uint8_t*>(userPayload));
-            if (shouldPublish)
-            {
-                m_transportForwarder.push(userPayload, datagramHeader.serviceHash, deviceIndex);
-                publisher.publish(userPayload);
-            }
+            m_fecManager.complete(datagramHeader.messageHash);
         }
     });
 }
 
+bool iox::p3com::Transport2Iceoryx::deliver(const iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
+                                           const void* data,
+                                           iox::p3com::DeviceIndex_t deviceIndex,
+                                           iox::popo::UntypedPublisher& publisher) noexcept
+{
+    void* userPayload = nullptr;
+    void* userHeader = nullptr;
+    bool shouldPublish = false;
+    iox::p3com::LogInfo() << "[Transport2Iceoryx] Forwarding user message for service: "
+                        << publisher.getServiceDescription()
+                        << ", submessage offset: " << datagramHeader.submessageOffset;
+
+    const bool isPushed = m_segmentedMessageManager.findAndDecrement(
+        datagramHeader.messageHash, userHeader, userPayload, shouldPublish);
+    if (!isPushed)
+    {
+        const bool hasUserHeader = datagramHeader.userHeaderSize != 0U;
+
+        // Need to allocate new buffer
+        publisher
+            .loan(datagramHeader.userPayloadSize,
+                  datagramHeader.userPayloadAlignment,
+                  hasUserHeader ? datagramHeader.userHeaderSize : iox::CHUNK_NO_USER_HEADER_SIZE,
+                  hasUserHeader ? iox::p3com::USER_HEADER_ALIGNMENT : iox::CHUNK_NO_USER_HEADER_ALIGNMENT)
+            .and_then([&](auto* p) {
+                userHeader = hasUserHeader ? iox::mepoo::ChunkHeader::fromUserPayload(p)->userHeader() : nullptr;
+                userPayload = p;
+            })
+            .or_else([](auto& error) {
+                if (error == iox::popo::AllocationError::TOO_MANY_CHUNKS_ALLOCATED_IN_PARALLEL)
+                {
+                    iox::p3com::LogWarn()
+                        << "[Transport2Iceoryx] Too many chunks allocated in parallel, discarding!";
+                }
+                else if (error == iox::popo::AllocationError::RUNNING_OUT_OF_CHUNKS)
+                {
+                    iox::p3com::LogWarn() << "[Transport2Iceoryx] Running out of chunks, discarding!";
+                }
+                else
+                {
+                    iox::p3com::LogError() << "[Transport2Iceoryx] Could not loan chunk, discarding! Error code: "
+                                         << static_cast<uint64_t>(error);
+                }
+            });
+        if (userPayload == nullptr)
+        {
+            return false;
+        }
+
+        if (datagramHeader.submessageCount > 1U)
+        {
+            // Compute the deadline of this message
+            const auto deadline = std::chrono::steady_clock::now()
+                                  + NS_PER_BYTE * (datagramHeader.userHeaderSize + datagramHeader.userPayloadSize);
+
+            m_segmentedMessageManager.push(datagramHeader.messageHash,
+                                           datagramHeader.submessageCount - 1U,
+                                           userHeader,
+                                           userPayload,
+                                           endpointsMutex(),
+                                           publisher,
+                                           deadline);
+            shouldPublish = false;
+        }
+        else
+        {
+            shouldPublish = true;
+        }
+    }
+
+    iox::p3com::takeNext(
+        datagramHeader, data, static_cast<uint8_t*>(userHeader), static_cast<uint8_t*>(userPayload));
+    if (shouldPublish)
+    {
+        m_transportForwarder.push(userPayload, datagramHeader.serviceHash, deviceIndex);
+        publisher.publish(userPayload);
+    }
+    return shouldPublish;
+}
+
 void* iox::p3com::Transport2Iceoryx::loanBuffer(const void* serializedDatagramHeader, size_t size) noexcept
 {
     // Obtain the datagram header
@@ -6,7 +6,9 @@
 #include "p3com/generic/types.hpp"
 #include "p3com/internal/log/logging.hpp"
 #include "p3com/transport/transport_info.hpp"
+#include "p3com/utility/helper_functions.hpp"
 
+#include <algorithm>
 #include <array>
 #include <mutex>
 
@@ -14,66 +16,200 @@ namespace
 {
 uint32_t divideAndRoundUp(uint32_t divident, uint32_t divisor) noexcept
 {
-    return static_cast<uint32_t>((divident + divisor - 1U) / divisor);
+    // Computed without the sum of both, which overflows for transports without a message size limit
+    return divident / divisor + static_cast<uint32_t>(divident % divisor != 0U);
 }
 
+/**
+ * @brief Submessages of a single message which are collected before they are handed over to the transport at once
+ */
+class SegmentBatch
+{
+  public:
+    SegmentBatch(iox::p3com::TransportLayer& transport, uint32_t deviceIndex) noexcept
+        : m_transport(transport)
+        , m_deviceIndex(deviceIndex)
+    {
+    }
+
+    void push(const iox::p3com::IoxChunkDatagramHeader_t& datagramHeader, const uint8_t* data) noexcept
+    {
+        if (m_segments.size() == m_segments.capacity())
+        {
+            flush();
+        }
+        auto& serializedDatagramHeaderBytes = m_serializedDatagramHeaders[m_segments.size()];
+        const uint32_t serializedDatagramHeaderSize =
+            iox::p3com::serialize(datagramHeader, serializedDatagramHeaderBytes.data());
+        m_segments.push_back({serializedDatagramHeaderBytes.data(),
+                              serializedDatagramHeaderSize,
+                              data,
+                              static_cast<size_t>(datagramHeader.submessageSize)});
+    }
+
+    void flush() noexcept
+    {
+        if (!m_segments.empty())
+        {
+            m_pendingCount +=
+                m_transport.sendUserDataBatch(m_segments.data(), static_cast<uint32_t>(m_segments.size()), m_deviceIndex);
+            m_segments.clear();
+        }
+    }
+
+    uint32_t pendingCount() const noexcept
+    {
+        return m_pendingCount;
+    }
+
+  private:
+    iox::p3com::TransportLayer& m_transport;
+    const uint32_t m_deviceIndex;
+    uint32_t m_pendingCount{0U};
+    std::array<std::array<char, iox::p3com::maxIoxChunkDatagramHeaderSerializationSize()>,
+               iox::p3com::MAX_SEND_BATCH_SIZE>
+        m_serializedDatagramHeaders;
+    iox::cxx::vector<iox::p3com::UserDataSegment_t, iox::p3com::MAX_SEND_BATCH_SIZE> m_segments;
+};
+
+/**
+ * @brief Interleaved XOR parity of a group of user payload submessages
+ */
+class ParityGroup
+{
+  public:
+    ParityGroup(const iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
+                uint32_t submessageSize,
+                iox::p3com::FecParityBuffer_t& parity) noexcept
+        : m_datagramHeader(datagramHeader)
+        // All parity submessages have the size of a full submessage, unless the whole payload is smaller
+        , m_paritySize(std::min(submessageSize, datagramHeader.userPayloadSize))
+        , m_parity(parity)
+    {
+    }
+
+    /**
+     * @brief Add a user payload submessage to the parity.
+     *
+     * @return True if the group is complete and the parity should be sent now.
+     */
+    bool add(uint32_t submessageOffset, const uint8_t* data, uint32_t size, bool isLast) noexcept
+    {
+        if (m_memberCount == 0U)
+        {
+            std::fill_n(m_parity.begin(), static_cast<size_t>(m_datagramHeader.fecParityCount) * m_paritySize, 0U);
+            m_groupOffset = submessageOffset;
+        }
+        const uint32_t parityIndex = m_memberCount % m_datagramHeader.fecParityCount;
+        iox::p3com::neonXor(&m_parity[static_cast<size_t>(parityIndex) * m_paritySize], data, size);
+        m_memberCount++;
+        return m_memberCount == m_datagramHeader.fecGroupSize || isLast;
+    }
+
+    void pushTo(SegmentBatch& batch) noexcept
+    {
+        auto datagramHeader = m_datagramHeader;
+        datagramHeader.submessageOffset = m_groupOffset;
+        datagramHeader.submessageSize = m_paritySize;
+        // A short last group does not need the parities which would not cover any submessage
+        const uint32_t parityCount = std::min(m_memberCount, m_datagramHeader.fecParityCount);
+        for (uint32_t i = 0U; i < parityCount; ++i)
+        {
+            datagramHeader.fecParityIndex = i;
+            batch.push(datagramHeader, &m_parity[static_cast<size_t>(i) * m_paritySize]);
+        }
+        m_memberCount = 0U;
+    }
+
+  private:
+    const iox::p3com::IoxChunkDatagramHeader_t& m_datagramHeader;
+    const uint32_t m_paritySize;
+    // Preallocated by the caller, only the first parity count times parity size bytes are used
+    iox::p3com::FecParityBuffer_t& m_parity;
+    uint32_t m_groupOffset{0U};
+    uint32_t m_memberCount{0U};
+};
+
 bool writeSegmentedInternal(iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
                             const uint8_t* const userHeaderBytes,
                             const uint8_t* const userPayloadBytes,
-                            const iox::p3com::DeviceIndex_t& deviceIndex) noexcept
+                            const iox::p3com::DeviceIndex_t& deviceIndex,
+                            const iox::p3com::FecConfig_t& fecConfig,
+                            iox::p3com::FecParityBuffer_t& fecParityBuffer) noexcept
 {
-    // Obtain the corresponding transport and its maximum message size
+    // Obtain the corresponding transport and its maximum message size towards this device
     uint32_t pendingCount = 0U;
     iox::p3com::TransportInfo::doFor(deviceIndex.type, [&](iox::p3com::TransportLayer& transport) {
-        std::array<char, iox::p3com::maxIoxChunkDatagramHeaderSerializationSize()> serializedDatagramHeaderBytes;
-        const uint32_t maxTransportPayloadSize =
-            static_cast<uint32_t>(transport.maxMessageSize() - iox::p3com::maxIoxChunkDatagramHeaderSerializationSize());
+        uint32_t maxTransportPayloadSize = static_cast<uint32_t>(
+            transport.maxMessageSize(deviceIndex.device) - iox::p3com::maxIoxChunkDatagramHeaderSerializationSize());
+
+        // Parity submessages are only needed if the transport can lose submessages. They are built in the preallocated
+        // parity buffer, so the submessages of such messages are limited in size and number.
+        bool useFec = fecConfig.groupSize != 0U && fecConfig.parityCount != 0U && transport.mayDropSubmessages()
+                      && datagramHeader.userPayloadSize != 0U;
+        if (useFec)
+        {
+            maxTransportPayloadSize = std::min(maxTransportPayloadSize, iox::p3com::MAX_FEC_SUBMESSAGE_SIZE);
+        }
         datagramHeader.submessageCount = divideAndRoundUp(datagramHeader.userHeaderSize, maxTransportPayloadSize)
                                          + divideAndRoundUp(datagramHeader.userPayloadSize, maxTransportPayloadSize);
+        useFec = useFec && datagramHeader.submessageCount <= iox::p3com::MAX_FEC_SUBMESSAGE_COUNT;
+        datagramHeader.fecGroupSize = useFec ? fecConfig.groupSize : 0U;
+        datagramHeader.fecParityCount =
+            useFec ? std::min(std::min(fecConfig.parityCount, fecConfig.groupSize), iox::p3com::MAX_FEC_PARITY_COUNT)
+                   : 0U;
+        datagramHeader.fecParityIndex = iox::p3com::FEC_DATA_INDEX;
 
         // Send individual submessages
         uint32_t remainingUserHeaderSize = datagramHeader.userHeaderSize;
         uint32_t remainingUserPayloadSize = datagramHeader.userPayloadSize;
 
         datagramHeader.submessageOffset = 0U;
-        while (remainingUserHeaderSize != 0U)
+        if (remainingUserHeaderSize != 0U)
         {
-            datagramHeader.submessageSize = std::min(maxTransportPayloadSize, remainingUserHeaderSize);
-            const uint32_t serializedDatagramHeaderSize =
-                iox::p3com::serialize(datagramHeader, serializedDatagramHeaderBytes.data());
-
-            const bool isPending = transport.sendUserData(serializedDatagramHeaderBytes.data(),
-                                                          serializedDatagramHeaderSize,
-                                                          userHeaderBytes + datagramHeader.submessageOffset,
-                                                          datagramHeader.submessageSize,
-                                                          deviceIndex.device);
-            if (isPending)
+            SegmentBatch userHeaderBatch{transport, deviceIndex.device};
+            while (remainingUserHeaderSize != 0U)
+            {
+                datagramHeader.submessageSize = std::min(maxTransportPayloadSize, remainingUserHeaderSize);
+                userHeaderBatch.push(datagramHeader, userHeaderBytes + datagramHeader.submessageOffset);
+
+                datagramHeader.submessageOffset += datagramHeader.submessageSize;
+                remainingUserHeaderSize -= datagramHeader.submessageSize;
+            }
+            userHeaderBatch.flush();
+
+            if (userHeaderBatch.pendingCount() != 0U)
             {
                 iox::p3com::LogFatal()
                     << "[DataWriter] Pending messages for user headers are not supported in this p3com gateway "
                        "version! Please make your user headers smaller!";
             }
-
-            datagramHeader.submessageOffset += datagramHeader.submessageSize;
-            remainingUserHeaderSize -= datagramHeader.submessageSize;
         }
 
+        // Hand over all user payload submessages of this message at once
+        SegmentBatch userPayloadBatch{transport, deviceIndex.device};
+        ParityGroup parityGroup{datagramHeader, maxTransportPayloadSize, fecParityBuffer};
         while (remainingUserPayloadSize != 0U)
         {
             datagramHeader.submessageSize = std::min(maxTransportPayloadSize, remainingUserPayloadSize);
-
-            const uint32_t serializedDatagramHeaderSize =
-                iox::p3com::serialize(datagramHeader, serializedDatagramHeaderBytes.data());
-            pendingCount += static_cast<uint32_t>(transport.sendUserData(
-                serializedDatagramHeaderBytes.data(),
-                serializedDatagramHeaderSize,
-                userPayloadBytes + datagramHeader.submessageOffset - datagramHeader.userHeaderSize,
-                datagramHeader.submessageSize,
-                deviceIndex.device));
+            const uint8_t* data = userPayloadBytes + datagramHeader.submessageOffset - datagramHeader.userHeaderSize;
+            userPayloadBatch.push(datagramHeader, data);
 
             datagramHeader.submessageOffset += datagramHeader.submessageSize;
             remainingUserPayloadSize -= datagramHeader.submessageSize;
+
+            if (useFec && parityGroup.add(datagramHeader.submessageOffset - datagramHeader.submessageSize,
+                                          data,
+                                          datagramHeader.submessageSize,
+                                          remainingUserPayloadSize == 0U))
+            {
+                // Send the parity right after its group, so that the receiver can rebuild lost submessages early
+                parityGroup.pushTo(userPayloadBatch);
+                userPayloadBatch.flush();
+            }
         }
+        userPayloadBatch.flush();
+        pendingCount = userPayloadBatch.pendingCount();
     });
 
     if (pendingCount > 1U)
@@ -92,50 +228,65 @@ void iox::p3com::writeSegmented(
     const iox::cxx::vector<iox::p3com::DeviceIndex_t, iox::p3com::MAX_DEVICE_COUNT>& deviceIndices,
     iox::p3com::PendingMessageManager& pendingMessageManager,
     std::mutex& mutex,
-    iox::popo::UntypedSubscriber& subscriber) noexcept
+    iox::popo::UntypedSubscriber& subscriber,
+    const iox::p3com::FecConfig_t& fecConfig,
+    iox::p3com::FecParityBuffer_t& fecParityBuffer) noexcept
 {
+    // If the message can become pending for any of the devices, the pending message manager holds an additional
+    // reference to the chunk until the message has been handed over to all devices. Otherwise, a pending send to one
+    // device could finish and release the chunk while it is still being sent to the next device.
+    bool anyPending = false;
+    for (const auto& i : deviceIndices)
+    {
+        iox::p3com::TransportInfo::doFor(i.type, [&](auto& transport) {
+            anyPending = anyPending || transport.willBePending(datagramHeader.userPayloadSize);
+        });
+    }
+    if (anyPending && !pendingMessageManager.push(chunkHeader.userPayload(), mutex, subscriber))
+    {
+        iox::p3com::LogWarn() << "[DataWriter] Exceeded maximum number of pending messages! Discarding!";
+        std::lock_guard<std::mutex> lock{mutex};
+        subscriber.release(chunkHeader.userPayload());
+        return;
+    }
+
     for (const auto& i : deviceIndices)
     {
         bool shouldBePending = false;
-        bool shouldDiscard = false;
         iox::p3com::TransportInfo::doFor(i.type, [&](auto& transport) {
             shouldBePending = transport.willBePending(datagramHeader.userPayloadSize);
-            if (shouldBePending)
-            {
-                const bool pushed = pendingMessageManager.push(chunkHeader.userPayload(), mutex, subscriber);
-                if (!pushed)
-                {
-                    iox::p3com::LogWarn() << "[DataWriter] Exceeded maximum number of pending messages! Discarding!";
-                    shouldDiscard = true;
-                }
-            }
         });
-        if (shouldDiscard)
+        if (shouldBePending)
         {
-            std::lock_guard<std::mutex> lock{mutex};
-            subscriber.release(chunkHeader.userPayload());
-            return;
+            // Add a reference for this particular device. Since the manager already holds the guard reference, this
+            // cannot exceed its capacity.
+            pendingMessageManager.push(chunkHeader.userPayload(), mutex, subscriber);
         }
 
         const bool isPending = writeSegmentedInternal(datagramHeader,
                                                       static_cast<const uint8_t*>(chunkHeader.userHeader()),
                                                       static_cast<const uint8_t*>(chunkHeader.userPayload()),
-                                                      i);
-        if (!isPending)
+                                                      i,
+                                                      fecConfig,
+                                                      fecParityBuffer);
+        if (!isPending && shouldBePending)
         {
-            if (shouldBePending)
-            {
-                // This likely means that the message should have been pending,
-                // but sending failed so it isnt pending. Note that mutex is
-                // locked inside the release function, so we dont need to lock
-                // it here.
-                pendingMessageManager.release(chunkHeader.userPayload());
-            }
-            else
-            {
-                std::lock_guard<std::mutex> lock{mutex};
-                subscriber.release(chunkHeader.userPayload());
-            }
+            // This likely means that the message should have been pending,
+            // but sending failed so it isnt pending. Note that mutex is
+            // locked inside the release function, so we dont need to lock
+            // it here.
+            pendingMessageManager.release(chunkHeader.userPayload());
         }
     }
+
+    if (anyPending)
+    {
+        // Drop the guard reference, the chunk is released once the last pending send has finished
+        pendingMessageManager.release(chunkHeader.userPayload());
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        subscriber.release(chunkHeader.userPayload());
+    }
 }
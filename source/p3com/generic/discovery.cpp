@@ -13,6 +13,7 @@
 #include "p3com/transport/transport_info.hpp"
 #include "p3com/utility/helper_functions.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <functional>
@@ -214,6 +215,14 @@ void iox::p3com::DiscoveryManager::readPortSubscriber() noexcept
 
         m_localState = newLocalState;
 
+        // Let the transport layers join the device groups of the subscribed services
+        if (!oldUserSubscribers.empty() || !newUserSubscribers.empty())
+        {
+            iox::p3com::TransportInfo::doForAllEnabled([this](iox::p3com::TransportLayer& transport) {
+                transport.setSubscribedServices(m_localState.userSubscribers);
+            });
+        }
+
         // If nothing changed, we wrap up now...
         if (oldUserPublishers.empty() && oldUserSubscribers.empty() && newUserPublishers.empty()
             && newUserSubscribers.empty())
@@ -393,9 +402,57 @@ iox::p3com::DeviceIndexVector_t iox::p3com::DiscoveryManager::computeDeviceIndic
         }
     }
 
+    replaceByDeviceGroups(serviceHash, deviceIndices);
     return deviceIndices;
 }
 
+void iox::p3com::DiscoveryManager::replaceByDeviceGroups(const iox::capro::ServiceDescription::ClassHash& serviceHash,
+                                                         iox::p3com::DeviceIndexVector_t& deviceIndices) const noexcept
+{
+    const auto localBitset = iox::p3com::TransportInfo::bitset();
+    for (uint32_t i = 0U; i < iox::p3com::TRANSPORT_TYPE_COUNT; ++i)
+    {
+        const auto type = iox::p3com::type(i);
+        const auto count = std::count_if(
+            deviceIndices.begin(), deviceIndices.end(), [type](const auto& index) { return index.type == type; });
+        if (count < 2)
+        {
+            continue;
+        }
+
+        // Every subscribed device which is reachable over this transport joins the group, so it must not be served
+        // over another transport as well
+        const bool allReachedOverType = std::all_of(
+            m_remoteState.records.begin(), m_remoteState.records.end(), [&](const iox::p3com::DeviceRecord_t& r) {
+                if (!(r.info.gatewayBitset & localBitset)[i]
+                    || !iox::p3com::containsElement(r.info.userSubscribers, serviceHash))
+                {
+                    return true;
+                }
+                return iox::p3com::TransportInfo::findMatchingType(r.info.gatewayBitset, m_preferredType) == type;
+            });
+        if (!allReachedOverType)
+        {
+            continue;
+        }
+
+        iox::cxx::optional<uint32_t> groupIndex{iox::cxx::nullopt};
+        iox::p3com::TransportInfo::doFor(type, [&](iox::p3com::TransportLayer& transport) {
+            groupIndex = transport.groupDeviceIndex(serviceHash);
+        });
+        if (groupIndex.has_value())
+        {
+            auto* it = std::remove_if(
+                deviceIndices.begin(), deviceIndices.end(), [type](const auto& index) { return index.type == type; });
+            while (deviceIndices.end() != it)
+            {
+                deviceIndices.pop_back();
+            }
+            deviceIndices.push_back({type, *groupIndex});
+        }
+    }
+}
+
 iox::p3com::DeviceIndexVector_t iox::p3com::DiscoveryManager::generateDeviceIndicesForwarding(
     const iox::capro::ServiceDescription::ClassHash& serviceHash, iox::p3com::DeviceIndex_t fromDeviceIndex) noexcept
 {
@@ -0,0 +1,277 @@
+// Copyright 2023 NXP
+
+#include "p3com/generic/fec.hpp"
+#include "p3com/internal/log/logging.hpp"
+#include "p3com/utility/helper_functions.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr uint32_t iox::p3com::FecManager::COMPLETED_HISTORY_SIZE;
+constexpr uint32_t iox::p3com::FecManager::MAX_FEC_MESSAGE_COUNT;
+
+namespace
+{
+uint32_t divideAndRoundUp(uint32_t divident, uint32_t divisor) noexcept
+{
+    return static_cast<uint32_t>((divident + divisor - 1U) / divisor);
+}
+} // anonymous namespace
+
+bool iox::p3com::FecManager::acceptData(const iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
+                                        std::chrono::steady_clock::time_point deadline) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (wasCompleted(datagramHeader.messageHash))
+    {
+        return false;
+    }
+
+    auto* message = findOrCreate(datagramHeader, deadline);
+    if (message == nullptr)
+    {
+        // Not tracked, so just pass it through
+        return true;
+    }
+    if (isReceived(*message, datagramHeader.submessageOffset))
+    {
+        return false;
+    }
+    markReceived(*message, datagramHeader.submessageOffset);
+
+    // Any user payload submessage except for the last one has the full size
+    const uint32_t userPayloadEnd = datagramHeader.userHeaderSize + datagramHeader.userPayloadSize;
+    if (message->submessageSize == 0U && datagramHeader.submessageOffset >= datagramHeader.userHeaderSize
+        && (datagramHeader.submessageOffset + datagramHeader.submessageSize < userPayloadEnd
+            || datagramHeader.submessageOffset == datagramHeader.userHeaderSize))
+    {
+        message->submessageSize = datagramHeader.submessageSize;
+    }
+    return true;
+}
+
+void iox::p3com::FecManager::acceptParity(const iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
+                                          const void* data,
+                                          std::chrono::steady_clock::time_point deadline) noexcept
+{
+    if (datagramHeader.submessageSize == 0U || datagramHeader.submessageSize > iox::p3com::MAX_FEC_SUBMESSAGE_SIZE
+        || datagramHeader.fecParityCount == 0U || datagramHeader.fecParityIndex >= datagramHeader.fecParityCount
+        || datagramHeader.submessageOffset < datagramHeader.userHeaderSize
+        || (datagramHeader.submessageOffset - datagramHeader.userHeaderSize) % datagramHeader.submessageSize != 0U)
+    {
+        iox::p3com::LogInfo() << "[FecManager] Received invalid parity submessage, discarding!";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (wasCompleted(datagramHeader.messageHash))
+    {
+        return;
+    }
+
+    auto* message = findOrCreate(datagramHeader, deadline);
+    if (message == nullptr)
+    {
+        return;
+    }
+
+    // Parity submessages have the size of the full user payload submessages, unless the whole payload is smaller
+    if (message->submessageSize == 0U)
+    {
+        message->submessageSize = datagramHeader.submessageSize;
+    }
+    const bool isDuplicate =
+        std::any_of(m_parities.begin(), m_parities.end(), [&datagramHeader](const Parity_t& parity) {
+            return parity.isUsed && parity.messageHash == datagramHeader.messageHash
+                   && parity.groupOffset == datagramHeader.submessageOffset
+                   && parity.index == datagramHeader.fecParityIndex;
+        });
+    if (message->submessageSize != datagramHeader.submessageSize || isDuplicate)
+    {
+        return;
+    }
+
+    auto parityIt =
+        std::find_if(m_parities.begin(), m_parities.end(), [](const Parity_t& parity) { return !parity.isUsed; });
+    if (parityIt == m_parities.end())
+    {
+        iox::p3com::LogWarn() << "[FecManager] Too many parity submessages kept at the same time, discarding!";
+        return;
+    }
+    parityIt->isUsed = true;
+    parityIt->messageHash = datagramHeader.messageHash;
+    parityIt->groupOffset = datagramHeader.submessageOffset;
+    parityIt->index = datagramHeader.fecParityIndex;
+    std::memcpy(parityIt->data.data(), data, datagramHeader.submessageSize);
+}
+
+bool iox::p3com::FecManager::recoverNext(iox::p3com::hash_t messageHash,
+                                         const uint8_t* userPayload,
+                                         iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
+                                         iox::p3com::FecSubmessageBuffer_t& data) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto* message = m_messages.find(messageHash);
+    if (message == m_messages.end() || message->submessageSize == 0U)
+    {
+        return false;
+    }
+
+    const auto& header = message->datagramHeader;
+    const uint32_t submessageSize = message->submessageSize;
+    const uint32_t submessageCount = divideAndRoundUp(header.userPayloadSize, submessageSize);
+    for (auto& parity : m_parities)
+    {
+        if (!parity.isUsed || parity.messageHash != messageHash)
+        {
+            continue;
+        }
+
+        // The parity with index j covers every parity count-th submessage of the group, starting with the j-th one
+        const uint32_t groupBegin = (parity.groupOffset - header.userHeaderSize) / submessageSize;
+        const uint32_t groupEnd = std::min(groupBegin + header.fecGroupSize, submessageCount);
+        uint32_t memberCount = 0U;
+        uint32_t missingCount = 0U;
+        uint32_t missingIndex = 0U;
+        for (uint32_t i = groupBegin + parity.index; i < groupEnd; i += header.fecParityCount)
+        {
+            memberCount++;
+            if (!isReceived(*message, header.userHeaderSize + i * submessageSize))
+            {
+                missingCount++;
+                missingIndex = i;
+            }
+        }
+
+        if (missingCount == 0U)
+        {
+            // All covered submessages have arrived, the parity is not needed anymore
+            parity.isUsed = false;
+            continue;
+        }
+        if (missingCount > 1U || (memberCount > 1U && userPayload == nullptr))
+        {
+            continue;
+        }
+
+        // XOR the parity with all received submessages it covers, the parity has the size of a full submessage
+        std::memcpy(data.data(), parity.data.data(), submessageSize);
+        for (uint32_t i = groupBegin + parity.index; i < groupEnd; i += header.fecParityCount)
+        {
+            if (i != missingIndex)
+            {
+                const uint32_t offset = i * submessageSize;
+                iox::p3com::neonXor(
+                    data.data(), userPayload + offset, std::min(submessageSize, header.userPayloadSize - offset));
+            }
+        }
+        const uint32_t missingOffset = missingIndex * submessageSize;
+        const uint32_t missingSize = std::min(submessageSize, header.userPayloadSize - missingOffset);
+
+        datagramHeader = header;
+        datagramHeader.submessageOffset = header.userHeaderSize + missingOffset;
+        datagramHeader.submessageSize = missingSize;
+        datagramHeader.fecParityIndex = iox::p3com::FEC_DATA_INDEX;
+
+        markReceived(*message, datagramHeader.submessageOffset);
+        parity.isUsed = false;
+        m_statistics.recoveredSubmessages++;
+        return true;
+    }
+    return false;
+}
+
+void iox::p3com::FecManager::complete(iox::p3com::hash_t messageHash) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto* message = m_messages.find(messageHash);
+    if (message != m_messages.end())
+    {
+        m_messages.erase(message);
+        releaseParities(messageHash);
+    }
+    m_completedMessages[m_completedIndex] = messageHash;
+    m_completedIndex = (m_completedIndex + 1U) % COMPLETED_HISTORY_SIZE;
+}
+
+void iox::p3com::FecManager::checkMessages() noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Remove elements in reverse order, to maintain validity of the iterator.
+    for (auto it = m_messages.end(); it != m_messages.begin(); --it)
+    {
+        auto messageIt = it - 1;
+        if (messageIt->deadline < now)
+        {
+            iox::p3com::LogWarn() << "[FecManager] Could not recover message, discarding!";
+            m_statistics.lostMessages++;
+            releaseParities(messageIt->datagramHeader.messageHash);
+            m_messages.erase(messageIt);
+        }
+    }
+}
+
+iox::p3com::FecStatistics_t iox::p3com::FecManager::getStatistics() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+iox::p3com::FecManager::FecMessage_t*
+iox::p3com::FecManager::findOrCreate(const iox::p3com::IoxChunkDatagramHeader_t& datagramHeader,
+                                     std::chrono::steady_clock::time_point deadline) noexcept
+{
+    auto* message = m_messages.find(datagramHeader.messageHash);
+    if (message != m_messages.end())
+    {
+        return message;
+    }
+    if (datagramHeader.submessageCount > iox::p3com::MAX_FEC_SUBMESSAGE_COUNT)
+    {
+        iox::p3com::LogWarn() << "[FecManager] Too many submessages in a message using FEC, not recovering!";
+        return nullptr;
+    }
+
+    const bool emplaced = m_messages.emplace(
+        datagramHeader.messageHash, iox::p3com::FecManager::FecMessage_t{datagramHeader, 0U, {}, deadline});
+    if (!emplaced)
+    {
+        iox::p3com::LogWarn() << "[FecManager] Too many messages using FEC at the same time, not recovering!";
+        return nullptr;
+    }
+    return m_messages.find(datagramHeader.messageHash);
+}
+
+bool iox::p3com::FecManager::wasCompleted(iox::p3com::hash_t messageHash) const noexcept
+{
+    return std::find(m_completedMessages.begin(), m_completedMessages.end(), messageHash)
+           != m_completedMessages.end();
+}
+
+void iox::p3com::FecManager::releaseParities(iox::p3com::hash_t messageHash) noexcept
+{
+    for (auto& parity : m_parities)
+    {
+        if (parity.messageHash == messageHash)
+        {
+            parity.isUsed = false;
+        }
+    }
+}
+
+bool iox::p3com::FecManager::isReceived(const FecMessage_t& message, uint32_t offset) noexcept
+{
+    return std::binary_search(message.receivedOffsets.begin(), message.receivedOffsets.end(), offset);
+}
+
+void iox::p3com::FecManager::markReceived(FecMessage_t& message, uint32_t offset) noexcept
+{
+    const auto it = std::lower_bound(message.receivedOffsets.begin(), message.receivedOffsets.end(), offset);
+    if ((it == message.receivedOffsets.end() || *it != offset) && message.receivedOffsets.push_back(offset))
+    {
+        // The storage is fixed, so the iterator stays valid. Rotate the appended offset into its place.
+        std::rotate(it, message.receivedOffsets.end() - 1, message.receivedOffsets.end());
+    }
+}
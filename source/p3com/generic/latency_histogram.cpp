@@ -0,0 +1,82 @@
+// Copyright 2023 NXP
+
+#include "p3com/generic/latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr uint32_t iox::p3com::LatencyHistogram::SUB_BUCKET_BITS;
+constexpr uint32_t iox::p3com::LatencyHistogram::SUB_BUCKET_COUNT;
+constexpr uint32_t iox::p3com::LatencyHistogram::BUCKET_COUNT;
+
+void iox::p3com::LatencyHistogram::record(std::chrono::nanoseconds latency) noexcept
+{
+    const uint64_t value = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0U;
+    m_counts[bucketIndex(value)].fetch_add(1U, std::memory_order_relaxed);
+}
+
+iox::p3com::LatencyHistogram::Counts_t iox::p3com::LatencyHistogram::counts() const noexcept
+{
+    Counts_t result{};
+    for (uint32_t i = 0U; i < BUCKET_COUNT; ++i)
+    {
+        result[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+uint64_t iox::p3com::LatencyHistogram::percentile(const Counts_t& counts, double fraction) noexcept
+{
+    uint64_t total = 0U;
+    for (const auto count : counts)
+    {
+        total += count;
+    }
+    if (total == 0U)
+    {
+        return 0U;
+    }
+
+    const auto rank = std::max<uint64_t>(
+        1U, static_cast<uint64_t>(std::ceil(std::min(std::max(fraction, 0.0), 1.0) * static_cast<double>(total))));
+    uint64_t cumulative = 0U;
+    for (uint32_t i = 0U; i < BUCKET_COUNT; ++i)
+    {
+        cumulative += counts[i];
+        if (cumulative >= rank)
+        {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(BUCKET_COUNT - 1U);
+}
+
+uint32_t iox::p3com::LatencyHistogram::bucketIndex(uint64_t value) noexcept
+{
+    // The first buckets hold the small values exactly
+    if (value < SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    // Otherwise the most significant bit selects the power of two and the following bits the linear sub-bucket
+    uint32_t msb = 0U;
+    while ((value >> (msb + 1U)) != 0U)
+    {
+        msb++;
+    }
+    const uint32_t shift = msb - SUB_BUCKET_BITS;
+    const auto subBucket = static_cast<uint32_t>((value >> shift) & (SUB_BUCKET_COUNT - 1U));
+    return std::min((shift + 1U) * SUB_BUCKET_COUNT + subBucket, BUCKET_COUNT - 1U);
+}
+
+uint64_t iox::p3com::LatencyHistogram::bucketUpperBound(uint32_t index) noexcept
+{
+    if (index < SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+    const uint32_t shift = index / SUB_BUCKET_COUNT - 1U;
+    const uint64_t subBucket = index % SUB_BUCKET_COUNT;
+    return ((SUB_BUCKET_COUNT + subBucket + 1U) << shift) - 1U;
+}
@@ -70,7 +70,8 @@ bool iox::p3com::PendingMessageManager::push(const void* userPayload, std::mutex
     }
     else
     {
-        iox::p3com::LogFatal() << "[PendingMessageManager] Attempted to push a pending message which laready exists!";
-        return false;
+        // The same message is pending for multiple devices, it is released after the last one has finished
+        msgIt->counter++;
+        return true;
     }
 }
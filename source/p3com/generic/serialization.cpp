@@ -95,6 +95,9 @@ uint32_t iox::p3com::serialize(const iox::p3com::IoxChunkDatagramHeader_t& datag
     pushPrimitive(datagramHeader.userPayloadSize);
     pushPrimitive(datagramHeader.userPayloadAlignment);
     pushPrimitive(datagramHeader.userHeaderSize);
+    pushPrimitive(datagramHeader.fecGroupSize);
+    pushPrimitive(datagramHeader.fecParityCount);
+    pushPrimitive(datagramHeader.fecParityIndex);
 
     iox::cxx::Expects(offset <= maxIoxChunkDatagramHeaderSerializationSize());
     return static_cast<uint32_t>(offset);
@@ -120,6 +123,9 @@ uint32_t iox::p3com::deserialize(iox::p3com::IoxChunkDatagramHeader_t& datagramH
     loadPrimitive(&datagramHeader.userPayloadSize);
     loadPrimitive(&datagramHeader.userPayloadAlignment);
     loadPrimitive(&datagramHeader.userHeaderSize);
+    loadPrimitive(&datagramHeader.fecGroupSize);
+    loadPrimitive(&datagramHeader.fecParityCount);
+    loadPrimitive(&datagramHeader.fecParityIndex);
 
     iox::cxx::Expects(offset <= maxIoxChunkDatagramHeaderSerializationSize());
     return static_cast<uint32_t>(offset);
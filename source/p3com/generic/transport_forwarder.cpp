@@ -9,9 +9,11 @@
 iox::p3com::TransportForwarder::TransportForwarder(
     iox::p3com::DiscoveryManager& discovery,
     iox::p3com::PendingMessageManager& pendingMessageManager,
-    const iox::cxx::vector<capro::ServiceDescription, iox::p3com::MAX_FORWARDED_SERVICES>& forwardedServices) noexcept
+    const iox::cxx::vector<capro::ServiceDescription, iox::p3com::MAX_FORWARDED_SERVICES>& forwardedServices,
+    const iox::p3com::FecServiceMap_t& fecServices) noexcept
     : m_discovery(discovery)
     , m_pendingMessageManager(pendingMessageManager)
+    , m_fecServices(fecServices)
     , m_terminateFlag(false)
 {
     for (auto& service : forwardedServices)
@@ -127,12 +129,15 @@ void iox::p3com::TransportForwarder::waitsetLoop() noexcept
                             : chunkHeader->userHeaderSize();
                     // submessage* fields will be filled for every submessage individually inside writeSegmented
 
+                    const auto* fecConfig = m_fecServices.find(hash);
                     iox::p3com::writeSegmented(datagramHeader,
                                              *chunkHeader,
                                              deviceIndices,
                                              m_pendingMessageManager,
                                              m_forwardedServiceSubscribersMutex,
-                                             subscriber);
+                                             subscriber,
+                                             (fecConfig != m_fecServices.end()) ? *fecConfig : iox::p3com::FecConfig_t{},
+                                             m_fecParityBuffer);
                 }
             }
         }
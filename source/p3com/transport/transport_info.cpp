@@ -7,7 +7,8 @@ std::array<std::unique_ptr<iox::p3com::TransportLayer>, iox::p3com::TRANSPORT_TY
 iox::p3com::bitset_t iox::p3com::TransportInfo::s_bitset;
 iox::p3com::TransportInfo::transportFailCallback_t iox::p3com::TransportInfo::s_failCallback;
 
-void iox::p3com::TransportInfo::enable(iox::p3com::TransportType type) noexcept
+void iox::p3com::TransportInfo::enable(iox::p3com::TransportType type,
+                                         const iox::p3com::TransportConfig_t& config) noexcept
 {
     const auto i = index(type);
     s_bitset[i] = true;
@@ -16,24 +17,66 @@ void iox::p3com::TransportInfo::enable(iox::p3com::TransportType type) noexcept
     switch (type)
     {
     case iox::p3com::TransportType::PCIE:
-#if defined(PCIE_GATEWAY)
+#if defined(PCIE_TRANSPORT)
         s_transports[i] = std::make_unique<iox::p3com::pcie::PCIeTransport>();
 #else
         iox::p3com::LogError() << "[TransportInfo] Invalid transport type: PCIe";
 #endif
         break;
     case iox::p3com::TransportType::UDP:
-#if defined(UDP_GATEWAY)
-        s_transports[i] = std::make_unique<iox::p3com::udp::UDPTransport>();
+#if defined(UDP_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::udp::UDPTransport>(config.udp);
 #else
         iox::p3com::LogError() << "[TransportInfo] Invalid transport type: UDP";
 #endif
         break;
     case iox::p3com::TransportType::TCP:
-#if defined(TCP_GATEWAY)
-        s_transports[i] = std::make_unique<iox::p3com::tcp::TCPTransport>();
+#if defined(TCP_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::tcp::TCPTransport>(config.tcp);
 #else
         iox::p3com::LogError() << "[TransportInfo] Invalid transport type: TCP";
+#endif
+        break;
+    case iox::p3com::TransportType::SHM:
+#if defined(SHM_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::shm::SHMTransport>(config.shm);
+#else
+        iox::p3com::LogError() << "[TransportInfo] Invalid transport type: SHM";
+#endif
+        break;
+    case iox::p3com::TransportType::UDS:
+#if defined(UDS_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::uds::UDSTransport>(config.uds);
+#else
+        iox::p3com::LogError() << "[TransportInfo] Invalid transport type: UDS";
+#endif
+        break;
+    case iox::p3com::TransportType::VSOCK:
+#if defined(VSOCK_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::vsock::VSOCKTransport>(config.vsock);
+#else
+        iox::p3com::LogError() << "[TransportInfo] Invalid transport type: VSOCK";
+#endif
+        break;
+    case iox::p3com::TransportType::SCTP:
+#if defined(SCTP_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::sctp::SCTPTransport>(config.sctp);
+#else
+        iox::p3com::LogError() << "[TransportInfo] Invalid transport type: SCTP";
+#endif
+        break;
+    case iox::p3com::TransportType::XDP:
+#if defined(XDP_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::xdp::XDPTransport>(config.xdp);
+#else
+        iox::p3com::LogError() << "[TransportInfo] Invalid transport type: XDP";
+#endif
+        break;
+    case iox::p3com::TransportType::ETH:
+#if defined(ETH_TRANSPORT)
+        s_transports[i] = std::make_unique<iox::p3com::eth::EthernetTransport>(config.ethernet);
+#else
+        iox::p3com::LogError() << "[TransportInfo] Invalid transport type: ETH";
 #endif
         break;
     default:
@@ -42,16 +85,34 @@ void iox::p3com::TransportInfo::enable(iox::p3com::TransportType type) noexcept
     }
 }
 
-void iox::p3com::TransportInfo::enableAll() noexcept
+void iox::p3com::TransportInfo::enableAll(const iox::p3com::TransportConfig_t& config) noexcept
 {
-#if defined(PCIE_GATEWAY)
-    enable(iox::p3com::TransportType::PCIE);
+#if defined(PCIE_TRANSPORT)
+    enable(iox::p3com::TransportType::PCIE, config);
+#endif
+#if defined(UDP_TRANSPORT)
+    enable(iox::p3com::TransportType::UDP, config);
+#endif
+#if defined(TCP_TRANSPORT)
+    enable(iox::p3com::TransportType::TCP, config);
+#endif
+#if defined(SHM_TRANSPORT)
+    enable(iox::p3com::TransportType::SHM, config);
+#endif
+#if defined(UDS_TRANSPORT)
+    enable(iox::p3com::TransportType::UDS, config);
+#endif
+#if defined(VSOCK_TRANSPORT)
+    enable(iox::p3com::TransportType::VSOCK, config);
+#endif
+#if defined(SCTP_TRANSPORT)
+    enable(iox::p3com::TransportType::SCTP, config);
 #endif
-#if defined(UDP_GATEWAY) && !defined(TCP_GATEWAY)
-    enable(iox::p3com::TransportType::UDP);
+#if defined(XDP_TRANSPORT)
+    enable(iox::p3com::TransportType::XDP, config);
 #endif
-#if defined(TCP_GATEWAY)
-    enable(iox::p3com::TransportType::TCP);
+#if defined(ETH_TRANSPORT)
+    enable(iox::p3com::TransportType::ETH, config);
 #endif
 }
 
@@ -0,0 +1,540 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/sctp/sctp_transport.hpp"
+#include "p3com/generic/serialization.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+constexpr uint16_t iox::p3com::sctp::SCTPTransport::DATA_PORT;
+constexpr uint32_t iox::p3com::sctp::SCTPTransport::MAX_STREAM_COUNT;
+constexpr uint32_t iox::p3com::sctp::SCTPTransport::MAX_RECEIVE_BATCH;
+constexpr uint32_t iox::p3com::sctp::SCTPTransport::MIN_RECEIVE_BUFFER_SIZE;
+
+namespace
+{
+sockaddr_in toSockaddr(const asio::ip::address& address, uint16_t port) noexcept
+{
+    sockaddr_in result{};
+    result.sin_family = AF_INET;
+    result.sin_port = htons(port);
+    result.sin_addr.s_addr = htonl(address.to_v4().to_ulong());
+    return result;
+}
+
+asio::ip::address toAddress(const sockaddr_in& address) noexcept
+{
+    return asio::ip::address_v4(ntohl(address.sin_addr.s_addr));
+}
+
+void closeSocket(int& socket) noexcept
+{
+    if (socket >= 0)
+    {
+        static_cast<void>(::close(socket));
+        socket = -1;
+    }
+}
+
+} // anonymous namespace
+
+iox::p3com::sctp::SCTPTransport::SCTPTransport(const iox::p3com::SCTPTransportConfig_t& config) noexcept
+    : m_config(config)
+    , m_streamCount(std::max(std::min(config.streamCount, MAX_STREAM_COUNT), 1U))
+    , m_discovery(iox::p3com::SocketDiscovery::acquire())
+{
+    if (m_streamCount != m_config.streamCount)
+    {
+        iox::p3com::LogWarn() << "[SCTPTransport] Limiting the number of streams to " << m_streamCount;
+    }
+    if (!m_discovery->isGood() || !openSocket())
+    {
+        closeSocket(m_socket);
+        setFailed();
+        return;
+    }
+
+    m_wakeEvent = ::eventfd(0U, EFD_CLOEXEC);
+    if (m_wakeEvent < 0)
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Could not create the wake event: " << std::strerror(errno);
+        closeSocket(m_socket);
+        setFailed();
+        return;
+    }
+
+    // Messages from a remote gateway with a larger limit are discarded
+    m_receiveBuffer.resize(std::max(m_config.maxMessageSize, MIN_RECEIVE_BUFFER_SIZE));
+    iox::p3com::LogInfo() << "[SCTPTransport] Listening on port " << DATA_PORT << " with " << m_streamCount
+                          << " streams per association, maximum message size " << m_maxMessageSize << " B";
+
+    m_receiveThread = std::thread([this]() { receiveWorker(); });
+}
+
+iox::p3com::sctp::SCTPTransport::~SCTPTransport()
+{
+    // The discovery outlives this transport if the UDP or TCP transport still uses it
+    m_discovery->unregisterDiscoveryCallback(iox::p3com::TransportType::SCTP);
+    m_isRunning.store(false);
+    if (m_receiveThread.joinable())
+    {
+        const uint64_t wake = 1U;
+        static_cast<void>(::write(m_wakeEvent, &wake, sizeof(wake)));
+        m_receiveThread.join();
+    }
+    closeSocket(m_socket);
+    closeSocket(m_wakeEvent);
+}
+
+bool iox::p3com::sctp::SCTPTransport::openSocket() noexcept
+{
+    m_socket = ::socket(AF_INET, SOCK_SEQPACKET | SOCK_CLOEXEC, IPPROTO_SCTP);
+    if (m_socket < 0)
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Could not create the SCTP socket: " << std::strerror(errno);
+        return false;
+    }
+
+    // The streams are negotiated when an association is set up, so they have to be requested before
+    sctp_initmsg initMessage{};
+    initMessage.sinit_num_ostreams = static_cast<uint16_t>(m_streamCount);
+    initMessage.sinit_max_instreams = static_cast<uint16_t>(m_streamCount);
+    // The stream and the association of every message, the association changes and the path failovers are reported
+    sctp_event_subscribe events{};
+    events.sctp_data_io_event = 1U;
+    events.sctp_association_event = 1U;
+    events.sctp_address_event = 1U;
+    // Parts of different messages are never mixed up, so that a message can be put together in a single buffer
+    const int interleave = 0;
+    if (::setsockopt(m_socket, IPPROTO_SCTP, SCTP_INITMSG, &initMessage, sizeof(initMessage)) != 0
+        || ::setsockopt(m_socket, IPPROTO_SCTP, SCTP_EVENTS, &events, sizeof(events)) != 0
+        || ::setsockopt(m_socket, IPPROTO_SCTP, SCTP_FRAGMENT_INTERLEAVE, &interleave, sizeof(interleave)) != 0)
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Could not configure the SCTP socket: " << std::strerror(errno);
+        return false;
+    }
+
+    const int bufferSize = static_cast<int>(m_config.socketBufferSize);
+    static_cast<void>(::setsockopt(m_socket, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize)));
+    static_cast<void>(::setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize)));
+    if (m_config.sendTimeout.count() > 0)
+    {
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(m_config.sendTimeout);
+        timeval sendTimeout{};
+        sendTimeout.tv_sec = static_cast<time_t>(seconds.count());
+        sendTimeout.tv_usec = static_cast<suseconds_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(m_config.sendTimeout - seconds).count());
+        static_cast<void>(::setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout)));
+    }
+
+    // A message larger than the send buffer is rejected by the kernel, so the data writer has to segment it
+    int sendBufferSize = 0;
+    socklen_t length = sizeof(sendBufferSize);
+    if (::getsockopt(m_socket, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, &length) != 0)
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Could not read the send buffer size: " << std::strerror(errno);
+        return false;
+    }
+    m_maxMessageSize = std::min(m_config.maxMessageSize, static_cast<uint32_t>(sendBufferSize));
+    if (m_maxMessageSize <= iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        iox::p3com::LogError() << "[SCTPTransport] The maximum message size is too small for a message";
+        return false;
+    }
+    if (m_maxMessageSize != m_config.maxMessageSize)
+    {
+        iox::p3com::LogWarn() << "[SCTPTransport] Limiting the message size to the send buffer size of "
+                              << m_maxMessageSize << " B, check net.core.wmem_max";
+    }
+
+    configureAssociations();
+    if (!bindInterfaces() || ::listen(m_socket, SOMAXCONN) != 0)
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Could not listen on port " << DATA_PORT << ": "
+                               << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool iox::p3com::sctp::SCTPTransport::bindInterfaces() noexcept
+{
+    const auto addresses = m_discovery->interfaceAddresses();
+    if (addresses.empty())
+    {
+        const sockaddr_in any = toSockaddr(asio::ip::address_v4::any(), DATA_PORT);
+        return ::bind(m_socket, reinterpret_cast<const sockaddr*>(&any), sizeof(any)) == 0;
+    }
+
+    // Every interface is a path of the associations, which are announced to the remote gateways on setup
+    std::vector<sockaddr_in> interfaces;
+    for (const auto& address : addresses)
+    {
+        interfaces.push_back(toSockaddr(address, DATA_PORT));
+        iox::p3com::LogInfo() << "[SCTPTransport] Binding to interface address " << address.to_string();
+    }
+    return ::setsockopt(m_socket,
+                        IPPROTO_SCTP,
+                        SCTP_SOCKOPT_BINDX_ADD,
+                        interfaces.data(),
+                        static_cast<socklen_t>(interfaces.size() * sizeof(sockaddr_in)))
+           == 0;
+}
+
+void iox::p3com::sctp::SCTPTransport::configureAssociations() noexcept
+{
+    // The defaults apply to all associations which are set up later on
+    sctp_paddrparams pathParameters{};
+    pathParameters.spp_assoc_id = SCTP_FUTURE_ASSOC;
+    pathParameters.spp_hbinterval = static_cast<uint32_t>(m_config.heartbeatInterval.count());
+    pathParameters.spp_pathmaxrxt = static_cast<uint16_t>(m_config.pathMaxRetransmissions);
+    pathParameters.spp_flags = m_config.heartbeatInterval.count() > 0 ? static_cast<uint32_t>(SPP_HB_ENABLE) : 0U;
+    if (::setsockopt(m_socket, IPPROTO_SCTP, SCTP_PEER_ADDR_PARAMS, &pathParameters, sizeof(pathParameters)) != 0)
+    {
+        iox::p3com::LogWarn() << "[SCTPTransport] Could not set the heartbeat parameters: " << std::strerror(errno);
+    }
+
+    if (m_config.rtoMax.count() > 0)
+    {
+        // The initial and minimum timeouts must not exceed the maximum one
+        sctp_rtoinfo rtoInfo{};
+        rtoInfo.srto_assoc_id = SCTP_FUTURE_ASSOC;
+        socklen_t length = sizeof(rtoInfo);
+        const auto rtoMax = static_cast<uint32_t>(m_config.rtoMax.count());
+        if (::getsockopt(m_socket, IPPROTO_SCTP, SCTP_RTOINFO, &rtoInfo, &length) == 0)
+        {
+            rtoInfo.srto_max = rtoMax;
+            rtoInfo.srto_min = std::min(rtoInfo.srto_min, rtoMax);
+            rtoInfo.srto_initial = std::min(rtoInfo.srto_initial, rtoMax);
+        }
+        if (::setsockopt(m_socket, IPPROTO_SCTP, SCTP_RTOINFO, &rtoInfo, sizeof(rtoInfo)) != 0)
+        {
+            iox::p3com::LogWarn() << "[SCTPTransport] Could not set the retransmission timeout: "
+                                  << std::strerror(errno);
+        }
+    }
+}
+
+void iox::p3com::sctp::SCTPTransport::registerDiscoveryCallback(
+    iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    m_discovery->registerDiscoveryCallback(iox::p3com::TransportType::SCTP, std::move(callback));
+}
+
+void iox::p3com::sctp::SCTPTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
+{
+    m_userDataCallback = std::move(callback);
+}
+
+void iox::p3com::sctp::SCTPTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    m_discovery->sendBroadcast(data, size);
+}
+
+uint16_t iox::p3com::sctp::SCTPTransport::selectStream(const void* serializedDatagramHeader,
+                                                       size_t size) const noexcept
+{
+    // The messages of a service class always use the same stream, so that they stay in order
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader, static_cast<const char*>(serializedDatagramHeader), size);
+    uint32_t hash = 0U;
+    for (uint32_t i = 0U; i < iox::capro::CLASS_HASH_ELEMENT_COUNT; ++i)
+    {
+        hash = hash * 31U + datagramHeader.serviceHash[i];
+    }
+    return static_cast<uint16_t>(hash % m_streamCount);
+}
+
+bool iox::p3com::sctp::SCTPTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    const auto address = m_discovery->getAddress(deviceIndex);
+    if (!address.has_value())
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Invalid device index when sending user data";
+        return false;
+    }
+
+    // The association to the remote gateway is set up by the first message sent to it
+    sockaddr_in destination = toSockaddr(*address, DATA_PORT);
+    std::array<iovec, 2U> iov{{{const_cast<void*>(data1), size1}, {const_cast<void*>(data2), size2}}};
+    std::array<uint8_t, CMSG_SPACE(sizeof(sctp_sndrcvinfo))> control{};
+    msghdr message{};
+    message.msg_name = &destination;
+    message.msg_namelen = sizeof(destination);
+    message.msg_iov = iov.data();
+    message.msg_iovlen = size2 != 0U ? 2U : 1U;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+    controlMessage->cmsg_level = IPPROTO_SCTP;
+    controlMessage->cmsg_type = SCTP_SNDRCV;
+    controlMessage->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
+    sctp_sndrcvinfo sendInfo{};
+    sendInfo.sinfo_stream = selectStream(data1, size1);
+    std::memcpy(CMSG_DATA(controlMessage), &sendInfo, sizeof(sendInfo));
+
+    const int flags = MSG_NOSIGNAL | (m_config.sendTimeout.count() > 0 ? 0 : MSG_DONTWAIT);
+    m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+    if (::sendmsg(m_socket, &message, flags) >= 0)
+    {
+        m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_sentBytes.fetch_add(size1 + size2, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+        iox::p3com::LogWarn() << "[SCTPTransport] Send timeout, discarding message!";
+    }
+    else if (errno == EINVAL)
+    {
+        // The stream does not exist if the remote gateway was configured with fewer streams
+        iox::p3com::LogError() << "[SCTPTransport] Could not send on stream " << sendInfo.sinfo_stream
+                               << ", check the stream count of " << address->to_string();
+    }
+    else
+    {
+        iox::p3com::LogWarn() << "[SCTPTransport] Could not send to " << address->to_string() << ": "
+                              << std::strerror(errno);
+    }
+    return false;
+}
+
+void iox::p3com::sctp::SCTPTransport::receiveWorker() noexcept
+{
+    std::array<pollfd, 2U> pollFds{{{m_socket, POLLIN, 0}, {m_wakeEvent, POLLIN, 0}}};
+    while (m_isRunning.load())
+    {
+        if (::poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            iox::p3com::LogError() << "[SCTPTransport] Could not poll the socket: " << std::strerror(errno);
+            setFailed();
+            break;
+        }
+        if (pollFds[1U].revents != 0)
+        {
+            break;
+        }
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+        for (uint32_t i = 0U; i < MAX_RECEIVE_BATCH && receive(); ++i)
+        {
+        }
+    }
+    iox::p3com::LogInfo() << "[SCTPTransport] Receive thread has exited";
+}
+
+bool iox::p3com::sctp::SCTPTransport::receive() noexcept
+{
+    // A message which did not fit is read to its end and discarded
+    uint8_t* const buffer = m_isDiscarding ? m_receiveBuffer.data() : m_receiveBuffer.data() + m_receivedSize;
+    const size_t capacity = m_isDiscarding ? m_receiveBuffer.size() : m_receiveBuffer.size() - m_receivedSize;
+    sockaddr_in sender{};
+    iovec iov{buffer, capacity};
+    std::array<uint8_t, CMSG_SPACE(sizeof(sctp_sndrcvinfo))> control{};
+    msghdr message{};
+    message.msg_name = &sender;
+    message.msg_namelen = sizeof(sender);
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1U;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    const ssize_t received = ::recvmsg(m_socket, &message, MSG_DONTWAIT);
+    if (received < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            iox::p3com::LogWarn() << "[SCTPTransport] Could not receive: " << std::strerror(errno);
+        }
+        return false;
+    }
+    const auto receiveTime = std::chrono::steady_clock::now();
+
+    const bool isEnd = (message.msg_flags & MSG_EOR) != 0;
+    if (m_isDiscarding)
+    {
+        m_isDiscarding = !isEnd;
+        return true;
+    }
+    m_receivedSize += static_cast<size_t>(received);
+    if (!isEnd)
+    {
+        if (m_receivedSize == m_receiveBuffer.size())
+        {
+            iox::p3com::LogError() << "[SCTPTransport] Received too large message! Discarding!";
+            m_receivedSize = 0U;
+            m_isDiscarding = true;
+        }
+        return true;
+    }
+
+    const size_t size = m_receivedSize;
+    m_receivedSize = 0U;
+    if ((message.msg_flags & MSG_NOTIFICATION) != 0)
+    {
+        handleNotification(m_receiveBuffer.data(), size);
+        return true;
+    }
+
+    sctp_assoc_t association = 0;
+    for (cmsghdr* controlMessage = CMSG_FIRSTHDR(&message); controlMessage != nullptr;
+         controlMessage = CMSG_NXTHDR(&message, controlMessage))
+    {
+        if (controlMessage->cmsg_level == IPPROTO_SCTP && controlMessage->cmsg_type == SCTP_SNDRCV)
+        {
+            sctp_sndrcvinfo receiveInfo{};
+            std::memcpy(&receiveInfo, CMSG_DATA(controlMessage), sizeof(receiveInfo));
+            association = receiveInfo.sinfo_assoc_id;
+        }
+    }
+    handleUserData(m_receiveBuffer.data(), size, sender, association);
+    m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+    return true;
+}
+
+void iox::p3com::sctp::SCTPTransport::handleUserData(const void* data,
+                                                     size_t size,
+                                                     const sockaddr_in& sender,
+                                                     sctp_assoc_t association) noexcept
+{
+    m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+    m_receivedBytes.fetch_add(size, std::memory_order_relaxed);
+    const auto index = findDevice(sender, association);
+    if (!index.has_value())
+    {
+        iox::p3com::LogError() << "[SCTPTransport] Received user data message from an unknown device! Discarding!";
+        return;
+    }
+    if (m_userDataCallback)
+    {
+        m_userDataCallback(data, size, {iox::p3com::TransportType::SCTP, *index});
+    }
+}
+
+iox::cxx::optional<uint32_t> iox::p3com::sctp::SCTPTransport::findDevice(const sockaddr_in& sender,
+                                                                         sctp_assoc_t association) noexcept
+{
+    const auto iter = m_associationDevices.find(association);
+    if (iter != m_associationDevices.end())
+    {
+        return {iter->second};
+    }
+
+    // After a failover, the sender address may be another address of the remote gateway than the discovered one
+    auto index = m_discovery->getIndex(toAddress(sender));
+    if (!index.has_value())
+    {
+        std::vector<uint8_t> buffer(sizeof(sctp_getaddrs) + MAX_NETWORK_IFACE_COUNT * sizeof(sockaddr_in6));
+        auto* peerAddresses = reinterpret_cast<sctp_getaddrs*>(buffer.data());
+        peerAddresses->assoc_id = association;
+        socklen_t length = static_cast<socklen_t>(buffer.size());
+        if (::getsockopt(m_socket, IPPROTO_SCTP, SCTP_GET_PEER_ADDRS, peerAddresses, &length) == 0)
+        {
+            const uint8_t* address = buffer.data() + sizeof(sctp_getaddrs);
+            for (uint32_t i = 0U; i < peerAddresses->addr_num && !index.has_value(); ++i)
+            {
+                const auto family = reinterpret_cast<const sockaddr*>(address)->sa_family;
+                if (family == AF_INET)
+                {
+                    sockaddr_in peerAddress{};
+                    std::memcpy(&peerAddress, address, sizeof(peerAddress));
+                    index = m_discovery->getIndex(toAddress(peerAddress));
+                }
+                address += family == AF_INET ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+            }
+        }
+    }
+    if (index.has_value())
+    {
+        m_associationDevices.emplace(association, *index);
+    }
+    return index;
+}
+
+void iox::p3com::sctp::SCTPTransport::handleNotification(const void* data, size_t size) noexcept
+{
+    sctp_notification notification{};
+    std::memcpy(&notification, data, std::min(size, sizeof(notification)));
+    switch (notification.sn_header.sn_type)
+    {
+    case SCTP_ASSOC_CHANGE:
+    {
+        const auto& change = notification.sn_assoc_change;
+        if (change.sac_state == SCTP_COMM_UP)
+        {
+            iox::p3com::LogInfo() << "[SCTPTransport] Association " << change.sac_assoc_id << " is up with "
+                                  << change.sac_outbound_streams << " outbound streams";
+            if (change.sac_outbound_streams < m_streamCount)
+            {
+                iox::p3com::LogWarn() << "[SCTPTransport] The remote gateway of association " << change.sac_assoc_id
+                                      << " has fewer streams, check its stream count";
+            }
+        }
+        else if (change.sac_state == SCTP_COMM_LOST || change.sac_state == SCTP_SHUTDOWN_COMP)
+        {
+            // A new association to the same gateway is set up by the next message
+            iox::p3com::LogWarn() << "[SCTPTransport] Association " << change.sac_assoc_id << " is down";
+            m_associationDevices.erase(change.sac_assoc_id);
+        }
+        break;
+    }
+    case SCTP_PEER_ADDR_CHANGE:
+    {
+        // The association keeps running over its other paths
+        const auto& change = notification.sn_paddr_change;
+        sockaddr_in address{};
+        std::memcpy(&address, &change.spc_aaddr, sizeof(address));
+        if (address.sin_family == AF_INET)
+        {
+            iox::p3com::LogInfo() << "[SCTPTransport] Path to " << toAddress(address).to_string()
+                                  << " of association " << change.spc_assoc_id << " changed to state "
+                                  << change.spc_state;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+size_t iox::p3com::sctp::SCTPTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    static_cast<void>(deviceIndex);
+    return m_maxMessageSize;
+}
+
+iox::p3com::TransportType iox::p3com::sctp::SCTPTransport::getType() const noexcept
+{
+    return iox::p3com::TransportType::SCTP;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::sctp::SCTPTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
@@ -0,0 +1,344 @@
+// Copyright 2023 NXP
+
+#include "p3com/internal/log/logging.hpp"
+
+#include "p3com/transport/shm/shm_region.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+constexpr size_t CACHE_LINE_SIZE{64U};
+
+size_t alignToCacheLine(size_t size) noexcept
+{
+    return (size + CACHE_LINE_SIZE - 1U) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+#if defined(__linux__)
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout) noexcept
+{
+    struct timespec waitTime{};
+    waitTime.tv_sec = timeout.count() / 1000;
+    waitTime.tv_nsec = (timeout.count() % 1000) * 1000000;
+    // Not a private futex, since the word is shared with the other gateway
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &waitTime, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>& word) noexcept
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+#endif
+} // namespace
+
+// The atomics are placed in memory shared by two processes, which only works if they do not need a lock
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "");
+
+constexpr std::chrono::milliseconds iox::p3com::shm::SHMRegion::PEER_TIMEOUT;
+constexpr uint32_t iox::p3com::shm::SHMRegion::SIDE_COUNT;
+constexpr uint32_t iox::p3com::shm::SHMRegion::MAGIC;
+constexpr uint32_t iox::p3com::shm::SHMRegion::VERSION;
+constexpr std::chrono::milliseconds iox::p3com::shm::SHMRegion::INITIALIZATION_TIMEOUT;
+
+struct iox::p3com::shm::SHMRing::Control_t
+{
+    // Written by the producer: position after the last committed message
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+    // Written by the consumer: position of the oldest message which was not popped yet
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+    // Incremented with every commit, the consumer sleeps on it while the ring is empty
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> doorbell;
+    std::atomic<uint32_t> isSleeping;
+};
+
+struct iox::p3com::shm::SHMRegion::Header_t
+{
+    // 0 for a new region, 1 while it is initialized and 2 once it can be used
+    std::atomic<uint32_t> state;
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    // Last heartbeat of the gateway which claimed the side, 0 if the side is free
+    std::array<std::atomic<uint64_t>, SIDE_COUNT> heartbeats;
+};
+
+size_t iox::p3com::shm::SHMRing::requiredSize(uint32_t slotCount, uint32_t slotSize) noexcept
+{
+    return alignToCacheLine(sizeof(Control_t)) + alignToCacheLine(sizeof(Descriptor_t) * slotCount)
+           + static_cast<size_t>(slotCount) * slotSize;
+}
+
+void iox::p3com::shm::SHMRing::attach(void* memory, uint32_t slotCount, uint32_t slotSize) noexcept
+{
+    auto* bytes = static_cast<uint8_t*>(memory);
+    m_control = reinterpret_cast<Control_t*>(bytes);
+    bytes += alignToCacheLine(sizeof(Control_t));
+    m_descriptors = reinterpret_cast<Descriptor_t*>(bytes);
+    bytes += alignToCacheLine(sizeof(Descriptor_t) * slotCount);
+    m_slots = bytes;
+    m_slotCount = slotCount;
+    m_slotSize = slotSize;
+}
+
+uint8_t* iox::p3com::shm::SHMRing::reserve() noexcept
+{
+    // Only the producer writes the head
+    const uint64_t head = m_control->head.load(std::memory_order_relaxed);
+    if (head - m_control->tail.load(std::memory_order_acquire) >= m_slotCount)
+    {
+        return nullptr;
+    }
+    return m_slots + (head % m_slotCount) * m_slotSize;
+}
+
+bool iox::p3com::shm::SHMRing::commit(Kind kind, uint32_t size) noexcept
+{
+    const uint64_t head = m_control->head.load(std::memory_order_relaxed);
+    m_descriptors[head % m_slotCount] = {kind, size};
+    m_control->head.store(head + 1U, std::memory_order_release);
+
+    // The consumer announces that it sleeps before it checks the ring for the last time, so either it sees this
+    // message or it is woken up
+    m_control->doorbell.fetch_add(1U, std::memory_order_seq_cst);
+    if (m_control->isSleeping.load(std::memory_order_seq_cst) == 0U)
+    {
+        return false;
+    }
+#if defined(__linux__)
+    futexWake(m_control->doorbell);
+#endif
+    return true;
+}
+
+const uint8_t* iox::p3com::shm::SHMRing::peek(Descriptor_t& descriptor) const noexcept
+{
+    // Only the consumer writes the tail
+    const uint64_t tail = m_control->tail.load(std::memory_order_relaxed);
+    if (tail == m_control->head.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    descriptor = m_descriptors[tail % m_slotCount];
+    return m_slots + (tail % m_slotCount) * m_slotSize;
+}
+
+void iox::p3com::shm::SHMRing::pop() noexcept
+{
+    const uint64_t tail = m_control->tail.load(std::memory_order_relaxed);
+    m_control->tail.store(tail + 1U, std::memory_order_release);
+}
+
+void iox::p3com::shm::SHMRing::discard() noexcept
+{
+    m_control->tail.store(m_control->head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+void iox::p3com::shm::SHMRing::wait(std::chrono::milliseconds timeout) noexcept
+{
+#if defined(__linux__)
+    m_control->isSleeping.store(1U, std::memory_order_seq_cst);
+    const uint32_t doorbell = m_control->doorbell.load(std::memory_order_seq_cst);
+    if (m_control->tail.load(std::memory_order_relaxed) == m_control->head.load(std::memory_order_seq_cst))
+    {
+        // Returns right away if the doorbell was rung in the meantime
+        futexWait(m_control->doorbell, doorbell, timeout);
+    }
+    m_control->isSleeping.store(0U, std::memory_order_relaxed);
+#else
+    static_cast<void>(timeout);
+    std::this_thread::sleep_for(std::chrono::microseconds(100U));
+#endif
+}
+
+void iox::p3com::shm::SHMRing::wake() noexcept
+{
+    m_control->doorbell.fetch_add(1U, std::memory_order_seq_cst);
+#if defined(__linux__)
+    futexWake(m_control->doorbell);
+#endif
+}
+
+iox::p3com::shm::SHMRegion::~SHMRegion()
+{
+    if (m_side < SIDE_COUNT)
+    {
+        // Free the side right away, instead of letting the other gateway wait for the heartbeat timeout
+        m_header->heartbeats[m_side].store(0U);
+    }
+    if (m_memory != nullptr)
+    {
+        munmap(m_memory, m_size);
+    }
+}
+
+bool iox::p3com::shm::SHMRegion::open(const std::string& name, uint32_t slotCount, uint32_t slotSize) noexcept
+{
+    // Keep every slot aligned to a cache line
+    const auto alignedSlotSize = static_cast<uint32_t>(alignToCacheLine(slotSize));
+    const size_t ringSize = alignToCacheLine(iox::p3com::shm::SHMRing::requiredSize(slotCount, alignedSlotSize));
+    const size_t size = alignToCacheLine(sizeof(Header_t)) + SIDE_COUNT * ringSize;
+    const std::string path = "/" + name;
+
+    const int fd = shm_open(path.c_str(), O_RDWR | O_CREAT, 0660);
+    if (fd < 0)
+    {
+        iox::p3com::LogError() << "[SHMRegion] Could not open shared memory " << path << ": " << std::strerror(errno);
+        return false;
+    }
+
+    // Both gateways size a new region, the kernel fills it with zeros
+    struct stat status{};
+    bool isSized = fstat(fd, &status) == 0;
+    if (isSized && status.st_size == 0)
+    {
+        isSized = ftruncate(fd, static_cast<off_t>(size)) == 0;
+    }
+    else if (isSized && static_cast<size_t>(status.st_size) != size)
+    {
+        iox::p3com::LogError() << "[SHMRegion] Shared memory " << path
+                               << " has a different size, the slot count and size have to be the same for both "
+                                  "gateways";
+        close(fd);
+        return false;
+    }
+    if (!isSized)
+    {
+        iox::p3com::LogError() << "[SHMRegion] Could not size shared memory " << path << ": " << std::strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        iox::p3com::LogError() << "[SHMRegion] Could not map shared memory " << path << ": " << std::strerror(errno);
+        return false;
+    }
+    m_memory = memory;
+    m_size = size;
+    m_header = static_cast<Header_t*>(memory);
+
+    if (!initialize(slotCount, alignedSlotSize))
+    {
+        iox::p3com::LogError() << "[SHMRegion] Shared memory " << path
+                               << " was created with a different configuration or is corrupted, remove it from "
+                                  "/dev/shm if no gateway is using it";
+        return false;
+    }
+
+    auto* rings = static_cast<uint8_t*>(memory) + alignToCacheLine(sizeof(Header_t));
+    for (uint32_t i = 0U; i < SIDE_COUNT; ++i)
+    {
+        m_rings[i].attach(rings + i * ringSize, slotCount, alignedSlotSize);
+    }
+
+    if (!claimSide())
+    {
+        iox::p3com::LogError() << "[SHMRegion] Both sides of shared memory " << path << " are in use";
+        return false;
+    }
+
+    // Drop what was sent to a previous gateway on this side
+    inbound().discard();
+    iox::p3com::LogInfo() << "[SHMRegion] Claimed side " << m_side << " of shared memory " << path;
+    return true;
+}
+
+bool iox::p3com::shm::SHMRegion::initialize(uint32_t slotCount, uint32_t slotSize) noexcept
+{
+    uint32_t state = 0U;
+    if (m_header->state.compare_exchange_strong(state, 1U))
+    {
+        // The zeroed memory is a valid initial state of all atomics, only the layout has to be recorded
+        m_header->magic = MAGIC;
+        m_header->version = VERSION;
+        m_header->slotCount = slotCount;
+        m_header->slotSize = slotSize;
+        m_header->state.store(2U, std::memory_order_release);
+        return true;
+    }
+
+    // Another gateway is initializing the region right now
+    const auto deadline = std::chrono::steady_clock::now() + INITIALIZATION_TIMEOUT;
+    while (m_header->state.load(std::memory_order_acquire) != 2U)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1U));
+    }
+    return m_header->magic == MAGIC && m_header->version == VERSION && m_header->slotCount == slotCount
+           && m_header->slotSize == slotSize;
+}
+
+bool iox::p3com::shm::SHMRegion::claimSide() noexcept
+{
+    const uint64_t timestamp = now();
+    for (uint32_t i = 0U; i < SIDE_COUNT; ++i)
+    {
+        // A free side has no heartbeat, the side of a gateway which has died has an old one. The exchange decides
+        // between two gateways claiming the same side at once.
+        uint64_t heartbeat = m_header->heartbeats[i].load();
+        if (!isAlive(heartbeat, timestamp) && m_header->heartbeats[i].compare_exchange_strong(heartbeat, timestamp))
+        {
+            m_side = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void iox::p3com::shm::SHMRegion::heartbeat() noexcept
+{
+    m_header->heartbeats[m_side].store(now(), std::memory_order_relaxed);
+}
+
+bool iox::p3com::shm::SHMRegion::isPeerAlive() const noexcept
+{
+    return isAlive(m_header->heartbeats[SIDE_COUNT - 1U - m_side].load(std::memory_order_relaxed), now());
+}
+
+iox::p3com::shm::SHMRing& iox::p3com::shm::SHMRegion::inbound() noexcept
+{
+    return m_rings[m_side];
+}
+
+iox::p3com::shm::SHMRing& iox::p3com::shm::SHMRegion::outbound() noexcept
+{
+    return m_rings[SIDE_COUNT - 1U - m_side];
+}
+
+uint64_t iox::p3com::shm::SHMRegion::now() noexcept
+{
+    // CLOCK_MONOTONIC is the same for all processes on the host, 0 is reserved for free sides
+    return static_cast<uint64_t>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                   .count())
+           + 1U;
+}
+
+bool iox::p3com::shm::SHMRegion::isAlive(uint64_t heartbeat, uint64_t timestamp) noexcept
+{
+    if (heartbeat == 0U)
+    {
+        return false;
+    }
+    // The heartbeat may have been published after the timestamp was taken
+    return heartbeat >= timestamp
+           || timestamp - heartbeat <= static_cast<uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(PEER_TIMEOUT).count());
+}
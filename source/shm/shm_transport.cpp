@@ -0,0 +1,410 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/shm/shm_transport.hpp"
+#include "p3com/generic/serialization.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <cstring>
+
+constexpr uint32_t iox::p3com::shm::SHMTransport::PEER_DEVICE_INDEX;
+constexpr uint32_t iox::p3com::shm::SHMTransport::MAX_COPY_JOB_COUNT;
+constexpr std::chrono::milliseconds iox::p3com::shm::SHMTransport::HEARTBEAT_INTERVAL;
+constexpr std::chrono::microseconds iox::p3com::shm::SHMTransport::FULL_RING_POLL_INTERVAL;
+
+iox::p3com::shm::SHMTransport::SHMTransport(const iox::p3com::SHMTransportConfig_t& config) noexcept
+    : m_slotSize(config.slotSize)
+    , m_asyncCopyThreshold(config.asyncCopyThreshold)
+{
+    if (config.slotCount == 0U || m_slotSize <= iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        iox::p3com::LogError() << "[SHMTransport] The slots have to hold at least a datagram header";
+        setFailed();
+        return;
+    }
+    if (!m_region.open(config.regionName, config.slotCount, m_slotSize))
+    {
+        setFailed();
+        return;
+    }
+
+    iox::p3com::LogInfo() << "[SHMTransport] Using " << config.slotCount << " slots of " << m_slotSize
+                          << " B per direction";
+    if (m_asyncCopyThreshold != 0U)
+    {
+        iox::p3com::LogInfo() << "[SHMTransport] Copying user payloads of at least " << m_asyncCopyThreshold
+                              << " B with the copy worker";
+    }
+
+    m_receiveThread = std::thread([this]() { receiveWorker(); });
+    m_copyThread = std::thread([this]() { copyWorker(); });
+}
+
+iox::p3com::shm::SHMTransport::~SHMTransport()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_isRunning.store(false);
+    }
+    m_jobsCondition.notify_all();
+    if (m_copyThread.joinable())
+    {
+        // Releases the chunks of the messages which were not copied yet
+        m_copyThread.join();
+    }
+    if (m_receiveThread.joinable())
+    {
+        m_region.inbound().wake();
+        m_receiveThread.join();
+    }
+}
+
+void iox::p3com::shm::SHMTransport::registerDiscoveryCallback(iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    m_remoteDiscoveryCallback = std::move(callback);
+}
+
+void iox::p3com::shm::SHMTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
+{
+    m_userDataCallback = std::move(callback);
+}
+
+void iox::p3com::shm::SHMTransport::registerBufferNeededCallback(iox::p3com::bufferNeededCallback_t callback) noexcept
+{
+    m_bufferNeededCallback = std::move(callback);
+}
+
+void iox::p3com::shm::SHMTransport::registerBufferReleasedCallback(
+    iox::p3com::bufferReleasedCallback_t callback) noexcept
+{
+    m_bufferReleasedCallback = std::move(callback);
+}
+
+void iox::p3com::shm::SHMTransport::registerBufferSentCallback(iox::p3com::bufferSentCallback_t callback) noexcept
+{
+    m_bufferSentCallback = std::move(callback);
+}
+
+void iox::p3com::shm::SHMTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    // The other gateway sends its own discovery info once it has claimed its side, which is then answered
+    if (m_region.isPeerAlive())
+    {
+        send(iox::p3com::shm::SHMRing::Kind::DISCOVERY, data, size, nullptr, 0U, false);
+    }
+}
+
+bool iox::p3com::shm::SHMTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    if (deviceIndex != PEER_DEVICE_INDEX)
+    {
+        iox::p3com::LogError() << "[SHMTransport] Invalid device index when sending user data";
+        return false;
+    }
+    if (!m_region.isPeerAlive())
+    {
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    const bool isPending = willBePending(size2) && isWholeUserPayload(data1, size1, size2);
+    return send(iox::p3com::shm::SHMRing::Kind::USER_DATA, data1, size1, data2, size2, isPending);
+}
+
+bool iox::p3com::shm::SHMTransport::isWholeUserPayload(const void* serializedDatagramHeader,
+                                                       size_t size,
+                                                       size_t userDataSize) const noexcept
+{
+    if (!m_bufferSentCallback)
+    {
+        return false;
+    }
+
+    // The chunk is released by its user payload, so only a message with the whole user payload can be pending. User
+    // header submessages, parity submessages and the submessages of a segmented payload are copied right away.
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader, static_cast<const char*>(serializedDatagramHeader), size);
+    return datagramHeader.fecParityIndex == iox::p3com::FEC_DATA_INDEX
+           && datagramHeader.submessageOffset == datagramHeader.userHeaderSize
+           && datagramHeader.submessageSize == datagramHeader.userPayloadSize
+           && userDataSize == datagramHeader.userPayloadSize;
+}
+
+bool iox::p3com::shm::SHMTransport::send(iox::p3com::shm::SHMRing::Kind kind,
+                                         const void* data1,
+                                         size_t size1,
+                                         const void* data2,
+                                         size_t size2,
+                                         bool isPending) noexcept
+{
+    if (size1 + size2 > m_slotSize)
+    {
+        iox::p3com::LogError() << "[SHMTransport] Message does not fit into a slot! Discarding!";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (!isPending && !m_isCopying && m_jobs.empty())
+    {
+        uint8_t* slot = m_region.outbound().reserve();
+        if (slot != nullptr)
+        {
+            std::memcpy(slot, data1, size1);
+            if (size2 != 0U)
+            {
+                std::memcpy(slot + size1, data2, size2);
+            }
+            commit(kind, size1 + size2);
+            return false;
+        }
+    }
+
+    // The ring is full or the message has to stay behind the messages of the copy worker
+    if (m_jobs.size() >= MAX_COPY_JOB_COUNT)
+    {
+        if (kind != iox::p3com::shm::SHMRing::Kind::DISCOVERY)
+        {
+            m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        }
+        iox::p3com::LogWarn() << "[SHMTransport] Too many messages waiting for the copy worker! Discarding!";
+        return false;
+    }
+    const auto* bytes1 = static_cast<const uint8_t*>(data1);
+    const auto* bytes2 = static_cast<const uint8_t*>(data2);
+    iox::p3com::shm::SHMTransport::CopyJob_t job{kind, {bytes1, bytes1 + size1}, nullptr, 0U};
+    if (isPending)
+    {
+        job.userPayload = data2;
+        job.userPayloadSize = size2;
+    }
+    else if (size2 != 0U)
+    {
+        job.data.insert(job.data.end(), bytes2, bytes2 + size2);
+    }
+    m_jobs.push_back(std::move(job));
+    m_jobsCondition.notify_one();
+    return isPending;
+}
+
+void iox::p3com::shm::SHMTransport::commit(iox::p3com::shm::SHMRing::Kind kind, size_t size) noexcept
+{
+    if (m_region.outbound().commit(kind, static_cast<uint32_t>(size)))
+    {
+        m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+    }
+    if (kind != iox::p3com::shm::SHMRing::Kind::DISCOVERY)
+    {
+        m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_sentBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+uint8_t* iox::p3com::shm::SHMTransport::waitForSlot() noexcept
+{
+    while (m_isRunning.load())
+    {
+        uint8_t* slot = m_region.outbound().reserve();
+        if (slot != nullptr)
+        {
+            return slot;
+        }
+        if (!m_region.isPeerAlive())
+        {
+            return nullptr;
+        }
+        std::this_thread::sleep_for(FULL_RING_POLL_INTERVAL);
+    }
+    return nullptr;
+}
+
+void iox::p3com::shm::SHMTransport::copyWorker() noexcept
+{
+    while (true)
+    {
+        iox::p3com::shm::SHMTransport::CopyJob_t job;
+        {
+            std::unique_lock<std::mutex> lock(m_sendMutex);
+            m_isCopying = false;
+            m_jobsCondition.wait(lock, [this]() { return !m_jobs.empty() || !m_isRunning.load(); });
+            if (m_jobs.empty())
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_isCopying = true;
+        }
+
+        // Wait for the other gateway to free a slot, like a DMA engine waiting for a free descriptor. The messages are
+        // dropped once the other gateway is gone or this transport is destroyed.
+        uint8_t* slot = waitForSlot();
+        if (slot == nullptr)
+        {
+            if (job.kind != iox::p3com::shm::SHMRing::Kind::DISCOVERY)
+            {
+                m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            const size_t headerSize = job.data.size();
+            std::memcpy(slot, job.data.data(), headerSize);
+            if (job.userPayload != nullptr)
+            {
+                std::memcpy(slot + headerSize, job.userPayload, job.userPayloadSize);
+                commit(iox::p3com::shm::SHMRing::Kind::USER_DATA_DIRECT, headerSize + job.userPayloadSize);
+            }
+            else
+            {
+                commit(job.kind, headerSize);
+            }
+        }
+
+        if (job.userPayload != nullptr && m_bufferSentCallback)
+        {
+            m_bufferSentCallback(job.userPayload);
+        }
+    }
+}
+
+void iox::p3com::shm::SHMTransport::receiveWorker() noexcept
+{
+    auto& inbound = m_region.inbound();
+    bool isWokenUp = true;
+    while (m_isRunning.load())
+    {
+        m_region.heartbeat();
+
+        iox::p3com::shm::SHMRing::Descriptor_t descriptor{};
+        const uint8_t* data = inbound.peek(descriptor);
+        if (data == nullptr)
+        {
+            inbound.wait(HEARTBEAT_INTERVAL);
+            isWokenUp = true;
+            continue;
+        }
+        if (isWokenUp)
+        {
+            m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+            isWokenUp = false;
+        }
+
+        const auto receiveTime = std::chrono::steady_clock::now();
+        receive(descriptor, data);
+        inbound.pop();
+        if (descriptor.kind != iox::p3com::shm::SHMRing::Kind::DISCOVERY)
+        {
+            m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+        }
+    }
+    iox::p3com::LogInfo() << "[SHMTransport] Receive thread has exited";
+}
+
+void iox::p3com::shm::SHMTransport::receive(const iox::p3com::shm::SHMRing::Descriptor_t& descriptor,
+                                            const uint8_t* data) noexcept
+{
+    if (descriptor.size > m_slotSize)
+    {
+        iox::p3com::LogError() << "[SHMTransport] Received invalid message! Discarding!";
+        return;
+    }
+
+    switch (descriptor.kind)
+    {
+    case iox::p3com::shm::SHMRing::Kind::DISCOVERY:
+        if (m_remoteDiscoveryCallback)
+        {
+            m_remoteDiscoveryCallback(data, descriptor.size, {iox::p3com::TransportType::SHM, PEER_DEVICE_INDEX});
+        }
+        return;
+    case iox::p3com::shm::SHMRing::Kind::USER_DATA:
+    case iox::p3com::shm::SHMRing::Kind::USER_DATA_DIRECT:
+        m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_receivedBytes.fetch_add(descriptor.size, std::memory_order_relaxed);
+        if (descriptor.kind == iox::p3com::shm::SHMRing::Kind::USER_DATA_DIRECT && receiveDirect(data, descriptor.size))
+        {
+            return;
+        }
+        if (m_userDataCallback)
+        {
+            m_userDataCallback(data, descriptor.size, {iox::p3com::TransportType::SHM, PEER_DEVICE_INDEX});
+        }
+        return;
+    default:
+        iox::p3com::LogError() << "[SHMTransport] Received message of unknown kind! Discarding!";
+        return;
+    }
+}
+
+bool iox::p3com::shm::SHMTransport::receiveDirect(const uint8_t* data, size_t size) noexcept
+{
+    // Everything which needs more than a plain copy of the user data is left to the regular receive path
+    if (!m_bufferNeededCallback || !m_bufferReleasedCallback
+        || size < iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        return false;
+    }
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    const uint32_t headerSize = iox::p3com::deserialize(datagramHeader, reinterpret_cast<const char*>(data), size);
+    if (datagramHeader.fecGroupSize != 0U || size != headerSize + datagramHeader.submessageSize)
+    {
+        return false;
+    }
+
+    // The submessage must not write beyond the user header or the user payload of the loaned chunk
+    const uint64_t submessageEnd =
+        static_cast<uint64_t>(datagramHeader.submessageOffset) + datagramHeader.submessageSize;
+    const bool isUserHeader = datagramHeader.submessageOffset < datagramHeader.userHeaderSize;
+    const bool isValid = isUserHeader ? submessageEnd <= datagramHeader.userHeaderSize
+                                      : submessageEnd <= static_cast<uint64_t>(datagramHeader.userHeaderSize)
+                                                             + datagramHeader.userPayloadSize;
+    if (!isValid)
+    {
+        iox::p3com::LogError() << "[SHMTransport] Received invalid user data message! Discarding!";
+        return true;
+    }
+
+    void* buffer = m_bufferNeededCallback(data, headerSize);
+    if (buffer == nullptr)
+    {
+        return true;
+    }
+    const uint32_t offset = isUserHeader ? datagramHeader.submessageOffset
+                                         : datagramHeader.submessageOffset - datagramHeader.userHeaderSize;
+    std::memcpy(static_cast<uint8_t*>(buffer) + offset, data + headerSize, datagramHeader.submessageSize);
+    m_bufferReleasedCallback(data, headerSize, false, {iox::p3com::TransportType::SHM, PEER_DEVICE_INDEX});
+    return true;
+}
+
+size_t iox::p3com::shm::SHMTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    static_cast<void>(deviceIndex);
+    return m_slotSize;
+}
+
+bool iox::p3com::shm::SHMTransport::willBePending(size_t userPayloadSize) const noexcept
+{
+    // Only a user payload which fits into a single submessage can be pending
+    return m_asyncCopyThreshold != 0U && userPayloadSize >= m_asyncCopyThreshold
+           && userPayloadSize + iox::p3com::maxIoxChunkDatagramHeaderSerializationSize() <= m_slotSize;
+}
+
+iox::p3com::TransportType iox::p3com::shm::SHMTransport::getType() const noexcept
+{
+    return iox::p3com::TransportType::SHM;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::shm::SHMTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
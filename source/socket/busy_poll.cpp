@@ -0,0 +1,53 @@
+// Copyright 2023 NXP
+
+#include "p3com/internal/log/logging.hpp"
+
+#include "p3com/transport/socket/busy_poll.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+void iox::p3com::BusyPoll::enableSocket(int fd, std::chrono::microseconds socketBusyPoll) noexcept
+{
+#if defined(SO_BUSY_POLL)
+    // Values above net.core.busy_read require CAP_NET_ADMIN
+    const int busyPoll = static_cast<int>(socketBusyPoll.count());
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busyPoll, sizeof(busyPoll)) != 0)
+    {
+        iox::p3com::LogWarn() << "[BusyPoll] Could not set SO_BUSY_POLL: " << std::strerror(errno);
+        return;
+    }
+#if defined(SO_PREFER_BUSY_POLL)
+    const int one = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &one, sizeof(one)) != 0)
+    {
+        iox::p3com::LogWarn() << "[BusyPoll] Could not set SO_PREFER_BUSY_POLL: " << std::strerror(errno);
+    }
+#endif
+#else
+    static_cast<void>(fd);
+    static_cast<void>(socketBusyPoll);
+    iox::p3com::LogWarn() << "[BusyPoll] SO_BUSY_POLL is not supported on this platform";
+#endif
+}
+
+void iox::p3com::BusyPoll::run(asio::io_service& context, std::chrono::microseconds idleBudget)
+{
+    auto lastWork = std::chrono::steady_clock::now();
+    while (!context.stopped())
+    {
+        // Every poll checks the sockets for readiness without blocking and runs the handlers which became ready
+        if (context.poll() > 0U)
+        {
+            lastWork = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (std::chrono::steady_clock::now() - lastWork >= idleBudget)
+        {
+            // Nothing arrived within the budget, so sleep until the next event
+            context.run_one();
+            lastWork = std::chrono::steady_clock::now();
+        }
+    }
+}
@@ -0,0 +1,541 @@
+// Copyright 2023 NXP
+
+#include "p3com/internal/log/logging.hpp"
+
+#include "p3com/transport/socket/io_uring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#if defined(IO_URING)
+#include <liburing.h>
+#endif
+
+#if defined(IO_URING)
+struct iox::p3com::IoUring::Ring_t
+{
+    struct io_uring ring{};
+    // Provided buffers of the multishot receive, nullptr for sending rings
+    struct io_uring_buf_ring* bufferRing{nullptr};
+    // Results of the linked sends, indexed by the position of the message in the batch
+    std::vector<int32_t> results;
+};
+
+namespace
+{
+constexpr int BUFFER_GROUP{0};
+// User data of the SQEs of a stream socket, which tells their completions apart
+constexpr uint64_t RECEIVE_DATA{0U};
+constexpr uint64_t SEND_DATA{1U};
+constexpr uint64_t CANCEL_DATA{2U};
+} // namespace
+#else
+struct iox::p3com::IoUring::Ring_t
+{
+};
+#endif
+
+iox::p3com::IoUring::IoUring() noexcept = default;
+
+iox::p3com::IoUring::~IoUring()
+{
+#if defined(IO_URING)
+    if (m_ring)
+    {
+        if (m_ring->bufferRing != nullptr)
+        {
+            io_uring_free_buf_ring(&m_ring->ring, m_ring->bufferRing, m_bufferCount, BUFFER_GROUP);
+        }
+        io_uring_queue_exit(&m_ring->ring);
+    }
+#endif
+}
+
+bool iox::p3com::IoUring::initialize(uint32_t entryCount) noexcept
+{
+#if defined(IO_URING)
+    auto ring = std::make_unique<Ring_t>();
+    const int ret = io_uring_queue_init(entryCount, &ring->ring, 0U);
+    if (ret < 0)
+    {
+        iox::p3com::LogWarn() << "[IoUring] io_uring is not available: " << std::strerror(-ret);
+        return false;
+    }
+    ring->results.resize(entryCount);
+    m_ring = std::move(ring);
+    m_entryCount = entryCount;
+    return true;
+#else
+    static_cast<void>(entryCount);
+    iox::p3com::LogWarn() << "[IoUring] The gateway was built without io_uring support";
+    return false;
+#endif
+}
+
+bool iox::p3com::IoUring::receiveMultishot(int fd, uint32_t bufferCount, size_t bufferSize) noexcept
+{
+#if defined(IO_URING)
+    if (!setupBuffers(bufferCount, bufferSize))
+    {
+        return false;
+    }
+
+    // Every buffer starts with the recvmsg metadata and the source address, followed by the datagram
+    m_receiveFd = fd;
+    m_isStream = false;
+    m_receiveMessage = {};
+    m_receiveMessage.msg_namelen = sizeof(struct sockaddr_in);
+    return armReceive();
+#else
+    static_cast<void>(fd);
+    static_cast<void>(bufferCount);
+    static_cast<void>(bufferSize);
+    return false;
+#endif
+}
+
+bool iox::p3com::IoUring::receiveStreamMultishot(int fd, uint32_t bufferCount, size_t bufferSize) noexcept
+{
+#if defined(IO_URING)
+    if (!setupBuffers(bufferCount, bufferSize))
+    {
+        return false;
+    }
+
+    // The buffers hold nothing but the stream
+    m_receiveFd = fd;
+    m_isStream = true;
+    return armReceive();
+#else
+    static_cast<void>(fd);
+    static_cast<void>(bufferCount);
+    static_cast<void>(bufferSize);
+    return false;
+#endif
+}
+
+bool iox::p3com::IoUring::setupBuffers(uint32_t bufferCount, size_t bufferSize) noexcept
+{
+#if defined(IO_URING)
+    if (!m_ring || m_ring->bufferRing != nullptr)
+    {
+        return false;
+    }
+
+    // The buffer ring is indexed with a mask, so its size has to be a power of two
+    uint32_t count = 1U;
+    while (count < bufferCount)
+    {
+        count *= 2U;
+    }
+    int ret = 0;
+    m_ring->bufferRing = io_uring_setup_buf_ring(&m_ring->ring, count, BUFFER_GROUP, 0U, &ret);
+    if (m_ring->bufferRing == nullptr)
+    {
+        iox::p3com::LogWarn() << "[IoUring] Provided buffer rings are not supported: " << std::strerror(-ret);
+        return false;
+    }
+    m_bufferCount = count;
+    m_bufferSize = bufferSize;
+    m_buffers.resize(static_cast<size_t>(count) * bufferSize);
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        io_uring_buf_ring_add(m_ring->bufferRing,
+                              &m_buffers[static_cast<size_t>(i) * bufferSize],
+                              static_cast<unsigned int>(bufferSize),
+                              static_cast<unsigned short>(i),
+                              io_uring_buf_ring_mask(count),
+                              static_cast<int>(i));
+    }
+    io_uring_buf_ring_advance(m_ring->bufferRing, static_cast<int>(count));
+    return true;
+#else
+    static_cast<void>(bufferCount);
+    static_cast<void>(bufferSize);
+    return false;
+#endif
+}
+
+bool iox::p3com::IoUring::armReceive() noexcept
+{
+#if defined(IO_URING)
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&m_ring->ring);
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+    if (m_isStream)
+    {
+        io_uring_prep_recv_multishot(sqe, m_receiveFd, nullptr, 0U, 0);
+    }
+    else
+    {
+        io_uring_prep_recvmsg_multishot(sqe, m_receiveFd, &m_receiveMessage, 0U);
+    }
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    io_uring_sqe_set_data64(sqe, RECEIVE_DATA);
+    const int ret = io_uring_submit(&m_ring->ring);
+    if (ret < 0)
+    {
+        iox::p3com::LogError() << "[IoUring] Could not arm the multishot receive: " << std::strerror(-ret);
+        return false;
+    }
+    m_isReceiveArmed = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+int32_t iox::p3com::IoUring::processReceived(const receiveCallback_t& callback,
+                                             std::chrono::milliseconds timeout) noexcept
+{
+#if defined(IO_URING)
+    if (!m_ring || m_ring->bufferRing == nullptr)
+    {
+        return -1;
+    }
+
+    struct __kernel_timespec waitTime{};
+    waitTime.tv_sec = timeout.count() / 1000;
+    waitTime.tv_nsec = (timeout.count() % 1000) * 1000000;
+    struct io_uring_cqe* cqe = nullptr;
+    const int ret = io_uring_wait_cqe_timeout(&m_ring->ring, &cqe, &waitTime);
+    if (ret == -ETIME || ret == -EINTR)
+    {
+        return 0;
+    }
+    if (ret < 0)
+    {
+        iox::p3com::LogError() << "[IoUring] Waiting for completions failed: " << std::strerror(-ret);
+        return -1;
+    }
+
+    int32_t count = 0;
+    bool isArmed = true;
+    bool isFailed = false;
+    unsigned int head = 0U;
+    io_uring_for_each_cqe(&m_ring->ring, head, cqe)
+    {
+        count++;
+        if ((cqe->flags & IORING_CQE_F_MORE) == 0U)
+        {
+            // The kernel has stopped the multishot receive, e.g. because all buffers were in use
+            isArmed = false;
+        }
+        if (cqe->res < 0)
+        {
+            if (cqe->res != -ENOBUFS)
+            {
+                iox::p3com::LogError() << "[IoUring] Receive failed: " << std::strerror(-cqe->res);
+                isFailed = true;
+            }
+            continue;
+        }
+        if ((cqe->flags & IORING_CQE_F_BUFFER) == 0U)
+        {
+            continue;
+        }
+
+        const auto bufferId = static_cast<unsigned short>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        uint8_t* buffer = &m_buffers[static_cast<size_t>(bufferId) * m_bufferSize];
+        struct io_uring_recvmsg_out* out = io_uring_recvmsg_validate(buffer, cqe->res, &m_receiveMessage);
+        if (out == nullptr || (out->flags & MSG_TRUNC) != 0U || out->namelen < sizeof(struct sockaddr_in))
+        {
+            iox::p3com::LogError() << "[IoUring] Received truncated message! Discarding!";
+        }
+        else
+        {
+            struct sockaddr_in address{};
+            std::memcpy(&address, io_uring_recvmsg_name(out), sizeof(address));
+            callback(io_uring_recvmsg_payload(out, &m_receiveMessage),
+                     io_uring_recvmsg_payload_length(out, cqe->res, &m_receiveMessage),
+                     address);
+        }
+
+        // Hand the buffer back to the kernel right away
+        io_uring_buf_ring_add(m_ring->bufferRing,
+                              buffer,
+                              static_cast<unsigned int>(m_bufferSize),
+                              bufferId,
+                              io_uring_buf_ring_mask(m_bufferCount),
+                              0);
+        io_uring_buf_ring_advance(m_ring->bufferRing, 1);
+    }
+    io_uring_cq_advance(&m_ring->ring, static_cast<unsigned int>(count));
+
+    if (isFailed || (!isArmed && !armReceive()))
+    {
+        return -1;
+    }
+    return count;
+#else
+    static_cast<void>(callback);
+    static_cast<void>(timeout);
+    return -1;
+#endif
+}
+
+int iox::p3com::IoUring::sendMessages(int fd, struct mmsghdr* messages, uint32_t messageCount, int flags) noexcept
+{
+#if defined(IO_URING)
+    if (!m_ring || messageCount == 0U)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Link the sends, so that the kernel sends them in order and cancels the rest after the first failure
+    const uint32_t count = std::min(messageCount, m_entryCount);
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&m_ring->ring);
+        io_uring_prep_sendmsg(sqe, fd, &messages[i].msg_hdr, static_cast<unsigned int>(flags));
+        if (i + 1U < count)
+        {
+            sqe->flags |= IOSQE_IO_LINK;
+        }
+        io_uring_sqe_set_data64(sqe, i);
+    }
+
+    // Submitting and waiting for the whole batch is a single io_uring_enter
+    const int ret = io_uring_submit_and_wait(&m_ring->ring, count);
+    if (ret < 0)
+    {
+        errno = -ret;
+        return -1;
+    }
+
+    uint32_t reapedCount = 0U;
+    while (reapedCount < count)
+    {
+        struct io_uring_cqe* cqe = nullptr;
+        const int waitRet = io_uring_wait_cqe(&m_ring->ring, &cqe);
+        if (waitRet < 0)
+        {
+            if (waitRet == -EINTR)
+            {
+                continue;
+            }
+            errno = -waitRet;
+            return -1;
+        }
+        const auto index = static_cast<uint32_t>(io_uring_cqe_get_data64(cqe));
+        if (index < count)
+        {
+            m_ring->results[index] = cqe->res;
+        }
+        io_uring_cqe_seen(&m_ring->ring, cqe);
+        reapedCount++;
+    }
+
+    int sentCount = 0;
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        if (m_ring->results[i] < 0)
+        {
+            if (sentCount == 0)
+            {
+                errno = -m_ring->results[i];
+                return -1;
+            }
+            break;
+        }
+        messages[i].msg_len = static_cast<unsigned int>(m_ring->results[i]);
+        sentCount++;
+    }
+    return sentCount;
+#else
+    static_cast<void>(fd);
+    static_cast<void>(messages);
+    static_cast<void>(messageCount);
+    static_cast<void>(flags);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+bool iox::p3com::IoUring::submitSend(int fd, const struct msghdr* message, int flags) noexcept
+{
+#if defined(IO_URING)
+    if (!m_ring || m_isSending)
+    {
+        errno = EINVAL;
+        return false;
+    }
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&m_ring->ring);
+    if (sqe == nullptr)
+    {
+        errno = EBUSY;
+        return false;
+    }
+    io_uring_prep_sendmsg(sqe, fd, message, static_cast<unsigned int>(flags));
+    io_uring_sqe_set_data64(sqe, SEND_DATA);
+    const int ret = io_uring_submit(&m_ring->ring);
+    if (ret < 0)
+    {
+        errno = -ret;
+        return false;
+    }
+    m_isSending = true;
+    return true;
+#else
+    static_cast<void>(fd);
+    static_cast<void>(message);
+    static_cast<void>(flags);
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+int32_t iox::p3com::IoUring::processStreamCompletions(const streamCallback_t& receiveCallback,
+                                                      const sendCallback_t& sendCallback) noexcept
+{
+#if defined(IO_URING)
+    if (!m_ring || m_ring->bufferRing == nullptr)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int32_t count = 0;
+    bool isEnded = false;
+    int error = 0;
+    unsigned int head = 0U;
+    struct io_uring_cqe* cqe = nullptr;
+    io_uring_for_each_cqe(&m_ring->ring, head, cqe)
+    {
+        count++;
+        const uint64_t data = io_uring_cqe_get_data64(cqe);
+        if (data == SEND_DATA)
+        {
+            // The callback may submit the next send right away
+            m_isSending = false;
+            sendCallback(cqe->res);
+            continue;
+        }
+        if (data != RECEIVE_DATA)
+        {
+            continue;
+        }
+        if ((cqe->flags & IORING_CQE_F_MORE) == 0U)
+        {
+            // The kernel has stopped the multishot receive, e.g. because all buffers were in use
+            m_isReceiveArmed = false;
+        }
+        if (cqe->res < 0)
+        {
+            if (cqe->res != -ENOBUFS)
+            {
+                isEnded = true;
+                error = -cqe->res;
+            }
+            continue;
+        }
+        if ((cqe->flags & IORING_CQE_F_BUFFER) == 0U)
+        {
+            // An empty receive is the end of the stream
+            isEnded = true;
+            continue;
+        }
+
+        const auto bufferId = static_cast<unsigned short>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        uint8_t* buffer = &m_buffers[static_cast<size_t>(bufferId) * m_bufferSize];
+        if (cqe->res == 0)
+        {
+            isEnded = true;
+        }
+        else if (!isEnded)
+        {
+            receiveCallback(buffer, static_cast<size_t>(cqe->res));
+        }
+
+        // Hand the buffer back to the kernel right away
+        io_uring_buf_ring_add(m_ring->bufferRing,
+                              buffer,
+                              static_cast<unsigned int>(m_bufferSize),
+                              bufferId,
+                              io_uring_buf_ring_mask(m_bufferCount),
+                              0);
+        io_uring_buf_ring_advance(m_ring->bufferRing, 1);
+    }
+    io_uring_cq_advance(&m_ring->ring, static_cast<unsigned int>(count));
+
+    if (isEnded)
+    {
+        errno = error;
+        return -1;
+    }
+    if (!m_isReceiveArmed && !armReceive())
+    {
+        errno = EIO;
+        return -1;
+    }
+    return count;
+#else
+    static_cast<void>(receiveCallback);
+    static_cast<void>(sendCallback);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+void iox::p3com::IoUring::cancel() noexcept
+{
+#if defined(IO_URING)
+    if (!m_ring || (!m_isReceiveArmed && !m_isSending))
+    {
+        return;
+    }
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&m_ring->ring);
+    if (sqe == nullptr)
+    {
+        return;
+    }
+    io_uring_prep_cancel64(sqe, 0U, IORING_ASYNC_CANCEL_ANY);
+    io_uring_sqe_set_data64(sqe, CANCEL_DATA);
+    const int ret = io_uring_submit(&m_ring->ring);
+    if (ret < 0)
+    {
+        iox::p3com::LogError() << "[IoUring] Could not cancel the pending requests: " << std::strerror(-ret);
+        return;
+    }
+
+    // The receive ends with a completion without IORING_CQE_F_MORE, the send with its only completion
+    while (m_isReceiveArmed || m_isSending)
+    {
+        struct io_uring_cqe* cqe = nullptr;
+        const int waitRet = io_uring_wait_cqe(&m_ring->ring, &cqe);
+        if (waitRet == -EINTR)
+        {
+            continue;
+        }
+        if (waitRet < 0)
+        {
+            iox::p3com::LogError() << "[IoUring] Waiting for the cancelled requests failed: "
+                                   << std::strerror(-waitRet);
+            return;
+        }
+        const uint64_t data = io_uring_cqe_get_data64(cqe);
+        if (data == SEND_DATA)
+        {
+            m_isSending = false;
+        }
+        else if (data == RECEIVE_DATA && (cqe->flags & IORING_CQE_F_MORE) == 0U)
+        {
+            m_isReceiveArmed = false;
+        }
+        io_uring_cqe_seen(&m_ring->ring, cqe);
+    }
+#endif
+}
+
+int iox::p3com::IoUring::fd() const noexcept
+{
+#if defined(IO_URING)
+    return m_ring ? m_ring->ring.ring_fd : -1;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,299 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/socket/socket_discovery.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <ifaddrs.h>
+#include <stdexcept>
+
+constexpr uint16_t iox::p3com::SocketDiscovery::DISCOVERY_PORT;
+constexpr uint32_t iox::p3com::SocketDiscovery::MAX_DATAGRAM_SIZE;
+
+std::shared_ptr<iox::p3com::SocketDiscovery> iox::p3com::SocketDiscovery::acquire() noexcept
+{
+    static std::mutex s_mutex;
+    static std::weak_ptr<iox::p3com::SocketDiscovery> s_discovery;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto discovery = s_discovery.lock();
+    if (!discovery)
+    {
+        discovery = std::make_shared<iox::p3com::SocketDiscovery>();
+        s_discovery = discovery;
+    }
+    return discovery;
+}
+
+iox::p3com::SocketDiscovery::SocketDiscovery() noexcept
+    : m_context()
+    , m_discoverySocket(m_context)
+    , m_outputBuffer()
+{
+    discoverBroadcastAddresses();
+    try
+    {
+        // The address has to be reusable before binding, so that other gateways on this host can bind the port too.
+        // This is taken from https://stackoverflow.com/questions/9310231/boostasio-udp-broadcasting
+        m_discoverySocket.open(asio::ip::udp::v4());
+        m_discoverySocket.set_option(asio::ip::udp::socket::reuse_address(true));
+        m_discoverySocket.set_option(asio::socket_base::broadcast(true));
+        m_discoverySocket.bind(asio::ip::udp::endpoint(asio::ip::address_v4::any(), DISCOVERY_PORT));
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[SocketDiscovery] " << e.what();
+        setFailed();
+        return;
+    }
+    discoveryAsyncReceive();
+
+    // The discovery runs on its own thread, so that it is not delayed by the user data traffic of any transport
+    m_thread = std::thread([this]() {
+        try
+        {
+            m_work.emplace(m_context);
+            m_context.run();
+            iox::p3com::LogInfo() << "[SocketDiscovery] Discovery thread has exited";
+        }
+        catch (std::exception& e)
+        {
+            iox::p3com::LogError() << "[SocketDiscovery] " << e.what();
+            setFailed();
+            return;
+        }
+    });
+}
+
+iox::p3com::SocketDiscovery::~SocketDiscovery()
+{
+    m_work.reset();
+    m_context.stop();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void iox::p3com::SocketDiscovery::discoverBroadcastAddresses() noexcept
+{
+    struct ifaddrs* ifap;
+    if (getifaddrs(&ifap) == 0)
+    {
+        uint32_t iface_n = 0;
+        for (struct ifaddrs* iface = ifap; iface != nullptr && iface_n < MAX_NETWORK_IFACE_COUNT;
+             iface = iface->ifa_next)
+        {
+            uint32_t ifaAddr = sockAddrToUint32(iface->ifa_addr);
+            uint32_t maskAddr = sockAddrToUint32(iface->ifa_netmask);
+            uint32_t dstAddr = sockAddrToUint32(iface->ifa_dstaddr);
+            if (ifaAddr > 0)
+            {
+                auto ifaAddrStr = inetNtoA(ifaAddr);
+                auto maskAddrStr = inetNtoA(maskAddr);
+                auto dstAddrStr = inetNtoA(dstAddr);
+                iox::p3com::LogInfo() << "[SocketDiscovery] Found interface:"
+                                    << "name=[" << iface->ifa_name << "]"
+                                    << "address=[" << ifaAddrStr << "]"
+                                    << "netmask=[" << maskAddrStr << "]"
+                                    << "broadcastAddr=[" << dstAddrStr << "]";
+                auto ifEp = asio::ip::udp::endpoint(asio::ip::address_v4(ifaAddr), DISCOVERY_PORT);
+                auto bcEp = asio::ip::udp::endpoint(asio::ip::address_v4(dstAddr), DISCOVERY_PORT);
+                if (!bcEp.address().is_loopback())
+                {
+                    m_interfaceEndpoints.push_back(ifEp);
+                    m_broadcastEndpoints.push_back(bcEp);
+                    iface_n++;
+                }
+            }
+        }
+        freeifaddrs(ifap);
+    }
+}
+
+
+uint32_t iox::p3com::SocketDiscovery::sockAddrToUint32(struct sockaddr* address) noexcept
+{
+    if ((address != nullptr) && (address->sa_family == AF_INET))
+    {
+        return ntohl((reinterpret_cast<struct sockaddr_in*>(address))->sin_addr.s_addr);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+
+// convert a numeric IP address into its string representation
+std::string iox::p3com::SocketDiscovery::inetNtoA(uint32_t addr) noexcept
+{
+    return iox::cxx::convert::toString((addr >> 24) & 0xFF) + "." + iox::cxx::convert::toString((addr >> 16) & 0xFF)
+           + "." + iox::cxx::convert::toString((addr >> 8) & 0xFF) + "."
+           + iox::cxx::convert::toString((addr >> 0) & 0xFF);
+}
+
+void iox::p3com::SocketDiscovery::discoverySocketCallback(asio::error_code ec, size_t bytes) noexcept
+{
+    if (ec)
+    {
+        iox::p3com::LogError() << "[SocketDiscovery] " << ec.message();
+        setFailed();
+        return;
+    }
+
+    auto* local_it = std::find(m_interfaceEndpoints.begin(), m_interfaceEndpoints.end(), m_outputEndpoint);
+    // We assume that the first received discovery message was actually from the
+    // ego device. So, m_outputEndpoint has not to be amongst m_interfaceEndpoints => local endpoint is ignored
+    if (local_it == m_interfaceEndpoints.end())
+    {
+        uint32_t device;
+        {
+            std::lock_guard<std::mutex> lock(m_devicesMutex);
+            // Find index of the endpoint. If iter is not registered, add iter.
+            auto* iter = std::find(m_devices.begin(), m_devices.end(), m_outputEndpoint);
+            if (iter == m_devices.end() && m_devices.size() < MAX_DEVICE_COUNT)
+            {
+                m_devices.push_back(m_outputEndpoint);
+                iter = &m_devices.back();
+            }
+            device = static_cast<uint32_t>(std::distance(m_devices.begin(), iter));
+        }
+        iox::p3com::LogDebug() << "[SocketDiscovery] Received discovery message from IP "
+                             << m_outputEndpoint.address().to_string() << " with index " << device;
+
+        // Every transport gets the message with its own type, the device index is shared by all of them
+        std::lock_guard<std::mutex> lock(m_callbacksMutex);
+        for (uint32_t i = 0U; i < iox::p3com::TRANSPORT_TYPE_COUNT; ++i)
+        {
+            if (m_callbacks[i])
+            {
+                m_callbacks[i](m_outputBuffer.data(), bytes, {iox::p3com::type(i), device});
+            }
+        }
+    }
+    else
+    {
+        iox::p3com::LogDebug() << "[SocketDiscovery] Received discovery message from myself: "
+                             << m_outputEndpoint.address().to_string() << " ignoring";
+    }
+    discoveryAsyncReceive();
+}
+
+void iox::p3com::SocketDiscovery::registerDiscoveryCallback(iox::p3com::TransportType transport,
+                                                            iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_callbacks[iox::p3com::index(transport)] = std::move(callback);
+}
+
+void iox::p3com::SocketDiscovery::unregisterDiscoveryCallback(iox::p3com::TransportType transport) noexcept
+{
+    // Waits for a running callback, since the mutex is held while calling it
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_callbacks[iox::p3com::index(transport)] = {};
+}
+
+void iox::p3com::SocketDiscovery::discoveryAsyncReceive() noexcept
+{
+    try
+    {
+        m_discoverySocket.async_receive_from(
+            asio::buffer(m_outputBuffer), m_outputEndpoint, [this](asio::error_code ec, size_t bytes) {
+                discoverySocketCallback(ec, bytes);
+            });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[SocketDiscovery] " << e.what();
+        setFailed();
+    }
+}
+
+void iox::p3com::SocketDiscovery::sendBroadcast(const void* data, size_t size) noexcept
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (m_lastBroadcast.size() == size && std::equal(bytes, bytes + size, m_lastBroadcast.begin()))
+    {
+        // Already sent for another transport, every message carries a new info hash otherwise
+        iox::p3com::LogDebug() << "[SocketDiscovery] Discovery info was already broadcast";
+        return;
+    }
+
+    try
+    {
+        for (auto&& m_broadcastEndpoint : m_broadcastEndpoints)
+        {
+            m_discoverySocket.send_to(asio::buffer(data, size), m_broadcastEndpoint);
+        }
+        m_lastBroadcast.assign(bytes, bytes + size);
+
+        iox::p3com::LogDebug() << "[SocketDiscovery] Broadcast discovery info";
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[SocketDiscovery] " << e.what();
+        setFailed();
+    }
+}
+
+uint64_t iox::p3com::SocketDiscovery::discoveredEndpoints() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_devicesMutex);
+    return m_devices.size();
+}
+
+asio::ip::udp::endpoint iox::p3com::SocketDiscovery::getEndpoint(uint32_t deviceIndex) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_devicesMutex);
+    if (deviceIndex >= m_devices.size())
+    {
+        iox::p3com::LogError() << "[SocketDiscovery] Invalid device index when sending user data";
+        setFailed();
+        return asio::ip::udp::endpoint();
+    }
+    return m_devices[deviceIndex];
+}
+
+iox::cxx::optional<asio::ip::address> iox::p3com::SocketDiscovery::getAddress(uint32_t deviceIndex) const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_devicesMutex);
+    if (deviceIndex >= m_devices.size())
+    {
+        return iox::cxx::nullopt;
+    }
+    return {m_devices[deviceIndex].address()};
+}
+
+iox::cxx::optional<uint32_t> iox::p3com::SocketDiscovery::getIndex(asio::ip::address address) const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_devicesMutex);
+    // Find index of the endpoint. If iter is not registered, add iter.
+    auto* iter =
+        std::find_if(m_devices.begin(), m_devices.end(), [&address](auto& dev) { return dev.address() == address; });
+    if (iter != m_devices.end())
+    {
+        const auto device = static_cast<uint32_t>(std::distance(m_devices.begin(), iter));
+        return {device};
+    }
+    else
+    {
+        return iox::cxx::nullopt;
+    }
+}
+
+iox::cxx::vector<asio::ip::address, iox::p3com::MAX_NETWORK_IFACE_COUNT>
+iox::p3com::SocketDiscovery::interfaceAddresses() const noexcept
+{
+    // Only written by the constructor
+    iox::cxx::vector<asio::ip::address, iox::p3com::MAX_NETWORK_IFACE_COUNT> addresses;
+    for (const auto& endpoint : m_interfaceEndpoints)
+    {
+        addresses.push_back(endpoint.address());
+    }
+    return addresses;
+}
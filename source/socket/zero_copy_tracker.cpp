@@ -0,0 +1,184 @@
+// Copyright 2023 NXP
+
+#include "p3com/internal/log/logging.hpp"
+
+#include "p3com/transport/socket/zero_copy_tracker.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+#include <linux/errqueue.h>
+#endif
+
+constexpr int iox::p3com::ZeroCopyTracker::SEND_FLAG;
+
+iox::p3com::ZeroCopyTracker::ZeroCopyTracker(completionCallback_t completionCallback,
+                                             uint32_t maxFreeDataCount) noexcept
+    : m_maxFreeDataCount(maxFreeDataCount)
+    , m_completionCallback(std::move(completionCallback))
+{
+    m_freeData.reserve(m_maxFreeDataCount);
+}
+
+bool iox::p3com::ZeroCopyTracker::enable(int fd) noexcept
+{
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    const int one = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) != 0)
+    {
+        iox::p3com::LogWarn() << "[ZeroCopyTracker] MSG_ZEROCOPY is not supported: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    static_cast<void>(fd);
+    iox::p3com::LogWarn() << "[ZeroCopyTracker] MSG_ZEROCOPY is not supported on this platform";
+    return false;
+#endif
+}
+
+bool iox::p3com::ZeroCopyTracker::track(uint64_t key, uint32_t sendCount, std::vector<uint8_t>&& data) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (sendCount == 0U)
+    {
+        releaseData(std::move(data));
+        return false;
+    }
+
+    m_sends.push_back({key, m_nextId, sendCount, sendCount, std::move(data)});
+    m_nextId += sendCount;
+    return true;
+}
+
+std::vector<uint8_t> iox::p3com::ZeroCopyTracker::acquireData() noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_freeData.empty())
+    {
+        return {};
+    }
+    auto data = std::move(m_freeData.back());
+    m_freeData.pop_back();
+    return data;
+}
+
+void iox::p3com::ZeroCopyTracker::releaseData(std::vector<uint8_t>&& data) noexcept
+{
+    if (m_freeData.size() < m_maxFreeDataCount && data.capacity() != 0U)
+    {
+        data.clear();
+        m_freeData.push_back(std::move(data));
+    }
+}
+
+void iox::p3com::ZeroCopyTracker::drain(int fd) noexcept
+{
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    std::vector<uint64_t> completedKeys;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            std::array<char, CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))> control{};
+            struct msghdr message{};
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+            if (recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            {
+                // EAGAIN once the error queue is empty
+                break;
+            }
+
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+            {
+                const bool isRecvErr = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+                                       || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+                if (!isRecvErr)
+                {
+                    continue;
+                }
+                struct sock_extended_err error{};
+                std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+                if (error.ee_errno != 0U || error.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                {
+                    continue;
+                }
+                if ((error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0U)
+                {
+                    m_copiedSends.fetch_add(error.ee_data - error.ee_info + 1U, std::memory_order_relaxed);
+                }
+                complete(error.ee_info, error.ee_data);
+            }
+        }
+
+        // Completions may be reported out of order, so look at all sends in flight
+        for (auto it = m_sends.begin(); it != m_sends.end();)
+        {
+            if (it->remaining == 0U)
+            {
+                completedKeys.push_back(it->key);
+                releaseData(std::move(it->data));
+                it = m_sends.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // The completion callback may release iceoryx chunks, so it must not be called with the mutex held
+    for (const auto key : completedKeys)
+    {
+        m_completionCallback(key);
+    }
+#else
+    static_cast<void>(fd);
+#endif
+}
+
+void iox::p3com::ZeroCopyTracker::complete(uint32_t firstId, uint32_t lastId) noexcept
+{
+    // The numbers wrap around, so all comparisons are made relative to the start of the completed range
+    const uint32_t rangeSize = lastId - firstId;
+    for (auto& send : m_sends)
+    {
+        for (uint32_t i = 0U; i < send.count && send.remaining != 0U; ++i)
+        {
+            if (send.firstId + i - firstId <= rangeSize)
+            {
+                send.remaining--;
+            }
+        }
+    }
+}
+
+void iox::p3com::ZeroCopyTracker::releaseAll() noexcept
+{
+    std::deque<Send_t> sends;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sends.swap(m_sends);
+        // A new socket starts numbering its sends from zero again
+        m_nextId = 0U;
+    }
+
+    for (const auto& send : sends)
+    {
+        m_completionCallback(send.key);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& send : sends)
+    {
+        releaseData(std::move(send.data));
+    }
+}
+
+uint64_t iox::p3com::ZeroCopyTracker::copiedSends() const noexcept
+{
+    return m_copiedSends.load(std::memory_order_relaxed);
+}
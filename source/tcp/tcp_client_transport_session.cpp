@@ -2,20 +2,32 @@
 
 #include "p3com/transport/tcp/tcp_client_transport_session.hpp"
 
-constexpr std::chrono::seconds iox::p3com::tcp::TCPClientTransportSession::M_RETRY_TIMEOUT;
+#include <algorithm>
+
+constexpr std::chrono::milliseconds iox::p3com::tcp::TCPClientTransportSession::MIN_RETRY_TIMEOUT;
+constexpr std::chrono::milliseconds iox::p3com::tcp::TCPClientTransportSession::MAX_RETRY_TIMEOUT;
 
 iox::p3com::tcp::TCPClientTransportSession::TCPClientTransportSession(
     asio::io_service& io_service,
+    const iox::p3com::TCPTransportConfig_t& config,
     const iox::p3com::tcp::TCPTransportSession::dataCallback_t& dataCallbackHandler,
+    const iox::p3com::tcp::TCPTransportSession::largeMessageCallback_t& largeMessageHandler,
+    const iox::p3com::tcp::TCPTransportSession::largeMessageReadCallback_t& largeMessageReadHandler,
+    const iox::p3com::tcp::TCPTransportSession::zeroCopySentCallback_t& zeroCopySentHandler,
     const iox::p3com::tcp::TCPTransportSession::sessionClosedCallback_t& sessionClosedHandler,
     const sessionOpenCallback_t& sessionOpenHandler,
-    asio::ip::tcp::endpoint remote_endpoint,
-    int max_reconnection_attempts) noexcept
-    : TCPTransportSession(io_service, dataCallbackHandler, sessionClosedHandler)
+    asio::ip::tcp::endpoint remote_endpoint) noexcept
+    : TCPTransportSession(io_service,
+                          config,
+                          dataCallbackHandler,
+                          largeMessageHandler,
+                          largeMessageReadHandler,
+                          zeroCopySentHandler,
+                          sessionClosedHandler)
     , m_resolver(io_service)
     , m_remoteEndpoint(remote_endpoint)
-    , m_retriesLeft(max_reconnection_attempts)
-    , m_retryTimer(io_service, M_RETRY_TIMEOUT)
+    , m_retryTimeout(MIN_RETRY_TIMEOUT)
+    , m_retryTimer(io_service)
     , m_sessionOpenCallback(std::move(sessionOpenHandler))
 {
 }
@@ -30,9 +42,25 @@ void iox::p3com::tcp::TCPClientTransportSession::start() noexcept
     connectToEndpoint();
 }
 
+void iox::p3com::tcp::TCPClientTransportSession::stop() noexcept
+{
+    if (m_isStopped)
+    {
+        return;
+    }
+    m_isStopped = true;
+    asio::error_code ec;
+    m_retryTimer.cancel(ec);
+    TCPTransportSession::stop();
+}
+
 void iox::p3com::tcp::TCPClientTransportSession::connectToEndpoint() noexcept
 {
-    getSocket().async_connect(m_remoteEndpoint, [this](std::error_code ec) {
+    getSocket().async_connect(m_remoteEndpoint, [this, self = shared_from_this()](std::error_code ec) {
+        if (m_isStopped)
+        {
+            return;
+        }
         if (ec)
         {
             iox::p3com::LogError() << "[TCPTransport] " << ec.message();
@@ -40,8 +68,10 @@ void iox::p3com::tcp::TCPClientTransportSession::connectToEndpoint() noexcept
         }
         else
         {
+            m_retryTimeout = MIN_RETRY_TIMEOUT;
+            getSocket().set_option(asio::ip::tcp::no_delay(true), ec);
+            sessionOpened();
             m_sessionOpenCallback(this);
-            receiveTcpData();
         }
     });
 }
@@ -55,24 +85,36 @@ void iox::p3com::tcp::TCPClientTransportSession::connectionFailedHandler() noexc
         iox::p3com::LogError() << "[TCPTransport] " << ec.message();
     }
 
-    if (m_retriesLeft > 0)
+    // Retry with an exponential backoff until the session is stopped, which happens once the remote gateway has
+    // announced its termination, so the device keeps its index while it is unreachable
+    m_retryTimer.expires_from_now(m_retryTimeout);
+    m_retryTimer.async_wait([this, self = shared_from_this()](std::error_code ec) {
+        if (!ec && !m_isStopped)
+        {
+            connectToEndpoint();
+        }
+    });
+    m_retryTimeout = std::min(2 * m_retryTimeout, MAX_RETRY_TIMEOUT);
+}
+
+void iox::p3com::tcp::TCPClientTransportSession::connectionLost(std::error_code ec) noexcept
+{
+    if (m_isStopped)
     {
-        m_retriesLeft--;
-        // Retry connection after a short time
-        m_retryTimer.async_wait([this](std::error_code ec) {
-            if (ec)
-            {
-                iox::p3com::LogError() << "[TCPTransport] " << ec.message();
-                sessionClosedHandler();
-            }
-            else
-            {
-                connectToEndpoint();
-            }
-        });
+        return;
     }
-    else
+
+    // The remote gateway closes a connection without sending the empty frame of an opened session when it rejects
+    // it, e.g. because it has connected to this gateway itself in the meantime
+    if (!isConfirmed())
     {
         sessionClosedHandler();
+        return;
     }
+
+    // Resume the session: it keeps its lane and device index, and messages are dropped until it is connected again
+    iox::p3com::LogWarn() << "[TCPTransport] Lost connection to " << remoteEndpointToString() << " (" << ec.message()
+                          << "), reconnecting";
+    disconnect();
+    connectionFailedHandler();
 }
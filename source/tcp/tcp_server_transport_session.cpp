@@ -5,9 +5,19 @@
 
 iox::p3com::tcp::TCPServerTransportSession::TCPServerTransportSession(
     asio::io_service& io_service,
+    const iox::p3com::TCPTransportConfig_t& config,
     const dataCallback_t& dataCallbackHandler,
+    const largeMessageCallback_t& largeMessageHandler,
+    const largeMessageReadCallback_t& largeMessageReadHandler,
+    const zeroCopySentCallback_t& zeroCopySentHandler,
     const sessionClosedCallback_t& sessionClosedHandler) noexcept
-    : TCPTransportSession(io_service, dataCallbackHandler, sessionClosedHandler)
+    : TCPTransportSession(io_service,
+                          config,
+                          dataCallbackHandler,
+                          largeMessageHandler,
+                          largeMessageReadHandler,
+                          zeroCopySentHandler,
+                          sessionClosedHandler)
 {
 }
 
@@ -31,7 +41,7 @@ void iox::p3com::tcp::TCPServerTransportSession::start() noexcept
     {
         // server side of connection
         getSocket().set_option(asio::ip::tcp::no_delay(true));
-        receiveTcpData();
+        sessionOpened();
     }
     catch (std::exception& e)
     {
@@ -6,19 +6,39 @@
 #include "p3com/transport/transport.hpp"
 #include <p3com/transport/tcp/tcp_client_transport_session.hpp>
 #include <p3com/transport/tcp/tcp_server_transport_session.hpp>
+#include "p3com/transport/socket/busy_poll.hpp"
 
 #include <asio.hpp>
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
-iox::p3com::tcp::TCPTransport::TCPTransport() noexcept
-    : m_context()
+constexpr uint32_t iox::p3com::tcp::TCPTransport::MAX_BULK_CONNECTION_COUNT;
+
+iox::p3com::tcp::TCPTransport::TCPTransport(const iox::p3com::TCPTransportConfig_t& config) noexcept
+    : m_config(config)
+    , m_bulkConnectionCount(std::min(config.bulkConnectionCount, MAX_BULK_CONNECTION_COUNT))
+    , m_context()
     , m_dataAcceptor(m_context)
-    , m_broadcast(m_context)
+    , m_discovery(iox::p3com::SocketDiscovery::acquire())
     , m_serverListeningSession(nullptr)
 {
+    if (m_bulkConnectionCount != m_config.bulkConnectionCount)
+    {
+        iox::p3com::LogWarn() << "[TCPTransport] Limiting the number of bulk connections to "
+                              << MAX_BULK_CONNECTION_COUNT;
+    }
+    if (m_config.zeroCopyThreshold != 0U)
+    {
+        iox::p3com::LogInfo() << "[TCPTransport] Sending user payloads of at least " << m_config.zeroCopyThreshold
+                              << " B with MSG_ZEROCOPY";
+    }
+
     auto endpoint = asio::ip::tcp::endpoint(asio::ip::tcp::v4(), DATA_PORT);
     try
     {
@@ -37,7 +57,14 @@ iox::p3com::tcp::TCPTransport::TCPTransport() noexcept
         try
         {
             m_work.emplace(m_context);
-            m_context.run();
+            if (m_config.busyPollBudget.count() > 0)
+            {
+                iox::p3com::BusyPoll::run(m_context, m_config.busyPollBudget);
+            }
+            else
+            {
+                m_context.run();
+            }
 
             iox::p3com::LogInfo() << "[TCPTransport] Worker thread has exited";
         }
@@ -50,9 +77,14 @@ iox::p3com::tcp::TCPTransport::TCPTransport() noexcept
     });
 
     startAccept();
-    m_broadcast.registerDiscoveryCallback([this](const void* data, size_t size, DeviceIndex_t deviceIndex) {
-        udpDiscoveryCallback(data, size, deviceIndex);
-    });
+    m_discovery->registerDiscoveryCallback(iox::p3com::TransportType::TCP,
+                                           [this](const void* data, size_t size, DeviceIndex_t deviceIndex) {
+                                               udpDiscoveryCallback(data, size, deviceIndex);
+                                           });
+    if (!m_discovery->isGood())
+    {
+        setFailed();
+    }
 
     iox::p3com::LogInfo() << "[TCPTransport] Created TCP listener and waiting for clients on endpoint "
                         << endpoint.address().to_string() << ":" << std::to_string(endpoint.port());
@@ -60,31 +92,130 @@ iox::p3com::tcp::TCPTransport::TCPTransport() noexcept
 
 iox::p3com::tcp::TCPTransport::~TCPTransport()
 {
+    // The discovery outlives this transport if the UDP transport still uses it
+    m_discovery->unregisterDiscoveryCallback(iox::p3com::TransportType::TCP);
     m_work.reset();
     m_context.stop();
-    m_thread.join();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    // The handlers which are still pending keep their sessions alive until the io service is destroyed, so the
+    // sessions are closed and release their pending messages while the callbacks are still valid
+    asio::error_code ec;
+    m_dataAcceptor.close(ec);
+    std::vector<std::shared_ptr<TCPTransportSession>> sessions;
+    {
+        std::lock_guard<std::mutex> peersLock(m_peersMutex);
+        for (const auto& peer : m_peers)
+        {
+            sessions.insert(sessions.end(), peer.sessions.begin(), peer.sessions.end());
+        }
+    }
+    for (const auto& session : sessions)
+    {
+        session->stop();
+    }
 }
 
 
-void iox::p3com::tcp::TCPTransport::addSession(asio::ip::tcp::endpoint& endpoint) noexcept
+iox::p3com::tcp::TCPTransport::Peer_t*
+iox::p3com::tcp::TCPTransport::allocatePeer(const asio::ip::address& address) noexcept
 {
-    // Add the session to the session list
-    m_transportSessions.emplace_back(std::make_unique<TCPClientTransportSession>(
-        m_context, handleUserDataCallback(this), handleSessionClose(this), handleSessionOpen(this), endpoint));
-    m_transportSessions.back()->start();
+    // Prefer the former slot of the gateway, then a slot which was never used
+    auto peer = std::find_if(m_peers.begin(), m_peers.end(), [&address](const Peer_t& p) {
+        return !p.isUsed && p.address == address;
+    });
+    if (peer == m_peers.end())
+    {
+        peer = std::find_if(m_peers.begin(), m_peers.end(), [](const Peer_t& p) {
+            return !p.isUsed && p.address.is_unspecified();
+        });
+    }
+    if (peer == m_peers.end())
+    {
+        peer = std::find_if(m_peers.begin(), m_peers.end(), [](const Peer_t& p) { return !p.isUsed; });
+    }
+    if (peer == m_peers.end())
+    {
+        return nullptr;
+    }
+    peer->isUsed = true;
+    peer->address = address;
+    peer->isClient = false;
+    return &*peer;
 }
 
-void iox::p3com::tcp::TCPTransport::addSession() noexcept
+void iox::p3com::tcp::TCPTransport::addPeer(asio::ip::tcp::endpoint& endpoint) noexcept
 {
-    m_transportSessions.push_back(std::move(m_serverListeningSession));
-    m_transportSessions.back()->start();
-    handleSessionOpen(this)(m_transportSessions.back().get());
+    auto* peer = allocatePeer(endpoint.address());
+    if (peer == nullptr)
+    {
+        iox::p3com::LogWarn() << "[TCPTransport] Too many remote gateways, not connecting to "
+                              << endpoint.address().to_string();
+        return;
+    }
+
+    // Open the connections of all lanes
+    peer->isClient = true;
+    for (uint32_t i = 0U; i <= m_bulkConnectionCount; ++i)
+    {
+        peer->sessions.emplace_back(std::make_shared<TCPClientTransportSession>(m_context,
+                                                                               m_config,
+                                                                               handleUserDataCallback(this),
+                                                                               handleLargeMessage(this),
+                                                                               handleLargeMessageRead(this),
+                                                                               handleZeroCopySent(this),
+                                                                               handleSessionClose(this),
+                                                                               handleSessionOpen(this),
+                                                                               endpoint));
+        peer->sessions.back()->start();
+    }
+}
+
+bool iox::p3com::tcp::TCPTransport::acceptSession() noexcept
+{
+    const auto address = m_serverListeningSession->remoteEndpoint().address();
+    auto* peer = findPeer(address);
+    if (peer == nullptr)
+    {
+        peer = allocatePeer(address);
+        if (peer == nullptr)
+        {
+            iox::p3com::LogWarn() << "[TCPTransport] Too many remote gateways, closing server connection.";
+            return false;
+        }
+    }
+    else if (peer->isClient)
+    {
+        iox::p3com::LogWarn() << "[TCPTransport] Already connected to "
+                              << m_serverListeningSession->remoteEndpointToString()
+                              << " as client, closing server connection.";
+        return false;
+    }
+    else if (peer->sessions.size() > MAX_BULK_CONNECTION_COUNT)
+    {
+        iox::p3com::LogWarn() << "[TCPTransport] Too many connections from "
+                              << m_serverListeningSession->remoteEndpointToString() << ", closing server connection.";
+        return false;
+    }
+
+    // The remote gateway opens the connections of all lanes, they are used for sending in the order of accepting
+    peer->sessions.push_back(std::move(m_serverListeningSession));
+    peer->sessions.back()->start();
+    return true;
 }
 
 void iox::p3com::tcp::TCPTransport::startAccept() noexcept
 {
-    m_serverListeningSession =
-        std::make_unique<TCPServerTransportSession>(m_context, handleUserDataCallback(this), handleSessionClose(this));
+    m_serverListeningSession = std::make_shared<TCPServerTransportSession>(m_context,
+                                                                           m_config,
+                                                                           handleUserDataCallback(this),
+                                                                           handleLargeMessage(this),
+                                                                           handleLargeMessageRead(this),
+                                                                           handleZeroCopySent(this),
+                                                                           handleSessionClose(this));
 
 
     m_dataAcceptor.async_accept(m_serverListeningSession->getSocket(), [this](asio::error_code ec) {
@@ -97,19 +228,15 @@ void iox::p3com::tcp::TCPTransport::startAccept() noexcept
         {
             iox::p3com::LogInfo() << "[TCPTransport] New connection request from client "
                                 << m_serverListeningSession->remoteEndpointToString();
-            std::lock_guard<std::mutex> transportSessionsLock(m_transportSessionsMutex);
-
-            auto iter = findSession(m_serverListeningSession->remoteEndpoint());
-            if (iter == m_transportSessions.end())
+            TCPTransportSession* session = m_serverListeningSession.get();
+            bool isAccepted = false;
             {
-                // device not found, add it
-                addSession();
+                std::lock_guard<std::mutex> peersLock(m_peersMutex);
+                isAccepted = acceptSession();
             }
-            else
+            if (isAccepted)
             {
-                iox::p3com::LogWarn() << "[TCPTransport] Already connected to "
-                                    << m_serverListeningSession->remoteEndpointToString()
-                                    << " as client, closing server connection.";
+                handleSessionOpen(this)(session);
             }
             startAccept();
         }
@@ -117,18 +244,52 @@ void iox::p3com::tcp::TCPTransport::startAccept() noexcept
 }
 
 
+iox::p3com::tcp::TCPTransportSession::zeroCopySentCallback_t
+iox::p3com::tcp::TCPTransport::handleZeroCopySent(iox::p3com::tcp::TCPTransport* self) noexcept
+{
+    return [self](const void* userPayload) {
+        if (self->m_bufferSentCallback)
+        {
+            self->m_bufferSentCallback(userPayload);
+        }
+    };
+}
+
 iox::p3com::tcp::TCPServerTransportSession::sessionClosedCallback_t
 iox::p3com::tcp::TCPTransport::handleSessionClose(iox::p3com::tcp::TCPTransport* self) noexcept
 {
     return [self](TCPTransportSession* session) {
-        std::lock_guard<std::mutex> transportSessionsLock(self->m_transportSessionsMutex);
-        auto session_it = std::find_if(self->m_transportSessions.begin(),
-                                       self->m_transportSessions.end(),
-                                       [session](const auto& iter) { return iter.get() == session; });
-        if (session_it != self->m_transportSessions.end())
+        std::lock_guard<std::mutex> peersLock(self->m_peersMutex);
+        for (auto peer = self->m_peers.begin(); peer != self->m_peers.end(); ++peer)
         {
-            iox::p3com::LogInfo() << "[TCPTransport] Successfully removed session " << session->remoteEndpointToString();
-            self->m_transportSessions.erase(session_it);
+            auto session_it = std::find_if(peer->sessions.begin(),
+                                           peer->sessions.end(),
+                                           [session](const auto& iter) { return iter.get() == session; });
+            if (session_it == peer->sessions.end())
+            {
+                continue;
+            }
+            session->addStatistics(self->m_closedSessionStatistics);
+            iox::p3com::LogInfo() << "[TCPTransport] Successfully removed session "
+                                  << session->remoteEndpointToString();
+            peer->sessions.erase(session_it);
+
+            // The device is gone once the connections of all of its lanes are closed, its slot is kept free for it
+            if (peer->sessions.empty())
+            {
+                peer->isUsed = false;
+                // A device which was never connected has not been reported yet
+                const auto& address = peer->address;
+                auto infoToReportIt = std::find_if(
+                    self->m_infoToReport.begin(), self->m_infoToReport.end(), [&address](const auto& iter) {
+                        return iter.first.address() == address;
+                    });
+                if (infoToReportIt != self->m_infoToReport.end())
+                {
+                    self->m_infoToReport.erase(infoToReportIt);
+                }
+            }
+            return;
         }
     };
 }
@@ -137,32 +298,73 @@ void iox::p3com::tcp::TCPTransport::udpDiscoveryCallback(const void* data,
                                                        size_t size,
                                                        DeviceIndex_t deviceIndex) noexcept
 {
-    auto endpoint = m_broadcast.getEndpoint(deviceIndex.device);
-    std::lock_guard<std::mutex> transportSessionsLock(m_transportSessionsMutex);
+    // The discovery is shared with the UDP transport, so only connect to gateways which have TCP enabled as well
+    auto info = std::make_unique<iox::p3com::PubSubInfo_t>();
+    iox::p3com::deserialize(*info, static_cast<const char*>(data), size);
+    if (!info->gatewayBitset[iox::p3com::index(iox::p3com::TransportType::TCP)])
+    {
+        return;
+    }
+
+    // The discovery runs on its own thread, while the sessions are only touched by the worker thread
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    std::vector<uint8_t> serializedInfo(bytes, bytes + size);
+    const bool isTermination = info->isTermination;
+    m_context.post([this, serializedInfo = std::move(serializedInfo), deviceIndex, isTermination]() {
+        handleDiscoveryInfo(serializedInfo.data(), serializedInfo.size(), deviceIndex, isTermination);
+    });
+}
+
+void iox::p3com::tcp::TCPTransport::handleDiscoveryInfo(const void* data,
+                                                      size_t size,
+                                                      DeviceIndex_t deviceIndex,
+                                                      bool isTermination) noexcept
+{
+    auto endpoint = m_discovery->getEndpoint(deviceIndex.device);
+    std::unique_lock<std::mutex> peersLock(m_peersMutex);
     auto tcpEndpoint = asio::ip::tcp::endpoint(endpoint.address(), DATA_PORT);
-    auto iter = findSession(tcpEndpoint);
-    if (iter == m_transportSessions.end())
+    auto* peer = findPeer(tcpEndpoint.address());
+    if (peer == nullptr)
     {
+        if (isTermination)
+        {
+            return;
+        }
+
         // device not found, add it
         iox::p3com::LogInfo() << "[TCPTransport] Discovered remote GW, not yet registered, adding "
                             << endpoint.address().to_string();
         iox::cxx::vector<uint8_t, iox::p3com::maxPubSubInfoSerializationSize()> serializedInfo(size);
         std::memcpy(serializedInfo.data(), data, size);
         m_infoToReport.emplace_back(tcpEndpoint, serializedInfo);
-        addSession(tcpEndpoint);
+        addPeer(tcpEndpoint);
     }
     else
     {
-        remoteDiscoveryHandler(data, size, static_cast<uint32_t>(std::distance(m_transportSessions.begin(), iter)));
+        remoteDiscoveryHandler(data, size, static_cast<uint32_t>(peer - m_peers.data()));
+        if (isTermination && peer->isClient)
+        {
+            // The terminated gateway is not reconnected, closing the sessions frees the slot of the device. They are
+            // closed without the lock, since the session close handler takes it.
+            const auto sessions = peer->sessions;
+            peersLock.unlock();
+            for (const auto& session : sessions)
+            {
+                session->stop();
+            }
+        }
     }
 }
-std::unique_ptr<iox::p3com::tcp::TCPTransportSession>*
-iox::p3com::tcp::TCPTransport::findSession(const asio::ip::tcp::endpoint& endpoint) noexcept
+
+iox::p3com::tcp::TCPTransport::Peer_t*
+iox::p3com::tcp::TCPTransport::findPeer(const asio::ip::address& address) noexcept
 {
-    return std::find_if(m_transportSessions.begin(), m_transportSessions.end(), [&endpoint](auto& iter) {
-        return iter->remoteEndpoint().address() == endpoint.address();
+    auto iter = std::find_if(m_peers.begin(), m_peers.end(), [&address](const auto& peer) {
+        return peer.isUsed && peer.address == address;
     });
+    return iter == m_peers.end() ? nullptr : &*iter;
 }
+
 void iox::p3com::tcp::TCPTransport::remoteDiscoveryHandler(const void* data,
                                                          size_t size,
                                                          const uint32_t device) const noexcept
@@ -183,28 +385,115 @@ void iox::p3com::tcp::TCPTransport::registerUserDataCallback(iox::p3com::userDat
     m_userDataCallback = std::move(callback);
 }
 
+void iox::p3com::tcp::TCPTransport::registerBufferNeededCallback(iox::p3com::bufferNeededCallback_t callback) noexcept
+{
+    m_bufferNeededCallback = std::move(callback);
+}
+
+void iox::p3com::tcp::TCPTransport::registerBufferReleasedCallback(
+    iox::p3com::bufferReleasedCallback_t callback) noexcept
+{
+    m_bufferReleasedCallback = std::move(callback);
+}
+
+void iox::p3com::tcp::TCPTransport::registerBufferSentCallback(iox::p3com::bufferSentCallback_t callback) noexcept
+{
+    m_bufferSentCallback = std::move(callback);
+}
+
 
 void iox::p3com::tcp::TCPTransport::sendBroadcast(const void* data, size_t size) noexcept
 {
-    m_broadcast.sendBroadcast(data, size);
+    m_discovery->sendBroadcast(data, size);
 }
 
 bool iox::p3com::tcp::TCPTransport::sendUserData(
     const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
 {
-    if (deviceIndex >= m_transportSessions.size())
+    std::shared_ptr<TCPTransportSession> session;
+    {
+        // The session is sent to without the lock, since sending may wait for space in its send queue
+        std::lock_guard<std::mutex> peersLock(m_peersMutex);
+        if (deviceIndex < m_peers.size() && !m_peers[deviceIndex].sessions.empty())
+        {
+            session = selectLane(m_peers[deviceIndex], data1, size1);
+        }
+    }
+    if (!session)
     {
         iox::p3com::LogWarn() << "[TCPTransport] Invalid device index when sending user data";
         return false;
     }
-    iox::p3com::LogInfo() << "[TCPTransport] Sending data to "
-                        << m_transportSessions[deviceIndex]->remoteEndpointToString();
-    return m_transportSessions[deviceIndex]->sendData(data1, size1, data2, size2);
+    iox::p3com::LogInfo() << "[TCPTransport] Sending data to " << session->remoteEndpointToString();
+    return session->sendData(data1, size1, data2, size2, isZeroCopy(data1, size1, size2));
+}
+
+bool iox::p3com::tcp::TCPTransport::isZeroCopy(const void* serializedDatagramHeader,
+                                               size_t size,
+                                               size_t userDataSize) const noexcept
+{
+    if (m_config.zeroCopyThreshold == 0U || userDataSize < m_config.zeroCopyThreshold || !m_bufferSentCallback)
+    {
+        return false;
+    }
+
+    // The chunk is released by its user payload, so only a message with the whole user payload can be pending
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader, static_cast<const char*>(serializedDatagramHeader), size);
+    return datagramHeader.submessageOffset == datagramHeader.userHeaderSize
+           && datagramHeader.submessageSize == datagramHeader.userPayloadSize;
 }
 
-size_t iox::p3com::tcp::TCPTransport::maxMessageSize() const noexcept
+const std::shared_ptr<iox::p3com::tcp::TCPTransportSession>& iox::p3com::tcp::TCPTransport::selectLane(
+    const Peer_t& peer, const void* serializedDatagramHeader, size_t size) const noexcept
 {
-    return TCPTransportSession::MAX_PACKET_SIZE;
+    const auto bulkLaneCount = static_cast<uint32_t>(peer.sessions.size() - 1U);
+    if (bulkLaneCount == 0U)
+    {
+        return peer.sessions[0];
+    }
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader, static_cast<const char*>(serializedDatagramHeader), size);
+    if (datagramHeader.userPayloadSize < m_config.bulkThreshold)
+    {
+        return peer.sessions[0];
+    }
+
+    // Keep the messages of a service on the same bulk lane, so that they stay in order, and spread the stripes of a
+    // message over all bulk lanes, the receiver puts them together by their offsets
+    uint32_t hash = 0U;
+    for (uint32_t i = 0U; i < iox::capro::CLASS_HASH_ELEMENT_COUNT; ++i)
+    {
+        hash = hash * 31U + datagramHeader.serviceHash[i];
+    }
+    if (m_config.stripeSize != 0U && datagramHeader.submessageOffset >= datagramHeader.userHeaderSize)
+    {
+        hash += (datagramHeader.submessageOffset - datagramHeader.userHeaderSize) / m_config.stripeSize;
+    }
+    return peer.sessions[1U + hash % bulkLaneCount];
+}
+
+size_t iox::p3com::tcp::TCPTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    // Striping needs at least two bulk lanes, the data writer then splits large messages into stripes
+    bool isStriped = false;
+    if (m_config.stripeSize != 0U && deviceIndex < m_peers.size())
+    {
+        std::lock_guard<std::mutex> peersLock(m_peersMutex);
+        isStriped = m_peers[deviceIndex].sessions.size() > 2U;
+    }
+    if (isStriped)
+    {
+        return static_cast<size_t>(m_config.stripeSize) + iox::p3com::maxIoxChunkDatagramHeaderSerializationSize();
+    }
+
+    // TCP is a byte stream, so every message is sent as a single frame regardless of its size
+    return std::numeric_limits<uint32_t>::max();
+}
+
+bool iox::p3com::tcp::TCPTransport::willBePending(size_t userPayloadSize) const noexcept
+{
+    return m_config.zeroCopyThreshold != 0U && userPayloadSize >= m_config.zeroCopyThreshold;
 }
 
 iox::p3com::TransportType iox::p3com::tcp::TCPTransport::getType() const noexcept
@@ -212,17 +501,45 @@ iox::p3com::TransportType iox::p3com::tcp::TCPTransport::getType() const noexcep
     return iox::p3com::TransportType::TCP;
 }
 
+iox::p3com::TransportStatistics_t iox::p3com::tcp::TCPTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    {
+        std::lock_guard<std::mutex> peersLock(m_peersMutex);
+        stats = m_closedSessionStatistics;
+        for (const auto& peer : m_peers)
+        {
+            for (const auto& session : peer.sessions)
+            {
+                session->addStatistics(stats);
+            }
+        }
+    }
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
+
 iox::p3com::tcp::TCPTransportSession::dataCallback_t
 iox::p3com::tcp::TCPTransport::handleUserDataCallback(iox::p3com::tcp::TCPTransport* self) noexcept
 {
-    return [self](const void* data, size_t size, asio::ip::tcp::endpoint endpoint) {
-        const auto index = self->m_broadcast.getIndex(endpoint.address());
+    return [self](const void* data,
+                  size_t size,
+                  asio::ip::tcp::endpoint endpoint,
+                  std::chrono::steady_clock::time_point receiveTime) {
+        self->m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+        self->m_receivedBytes.fetch_add(size, std::memory_order_relaxed);
+        const auto index = self->m_discovery->getIndex(endpoint.address());
         if (index.has_value())
         {
             if (self->m_userDataCallback)
             {
                 self->m_userDataCallback(data, size, {iox::p3com::TransportType::TCP, *index});
             }
+            self->m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
         }
         else
         {
@@ -231,21 +548,98 @@ iox::p3com::tcp::TCPTransport::handleUserDataCallback(iox::p3com::tcp::TCPTransp
     };
 }
 
+iox::p3com::tcp::TCPTransportSession::largeMessageCallback_t
+iox::p3com::tcp::TCPTransport::handleLargeMessage(iox::p3com::tcp::TCPTransport* self) noexcept
+{
+    return [self](const void* data, size_t size, size_t messageSize, asio::ip::tcp::endpoint endpoint) {
+        const TCPTransportSession::MessageBuffer_t discard{nullptr, 0U, 0U};
+        if (!self->m_bufferNeededCallback || !self->m_bufferReleasedCallback)
+        {
+            iox::p3com::LogError() << "[TCPTransport] Received too large user data message! Discarding!";
+            return discard;
+        }
+        const auto index = self->m_discovery->getIndex(endpoint.address());
+        if (!index.has_value())
+        {
+            iox::p3com::LogError() << "[TCPTransport] Received user data message from an unknown device! Discarding!";
+            return discard;
+        }
+
+        // The message must not write beyond the user header or the user payload of the loaned chunk
+        iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+        const uint32_t headerSize = iox::p3com::deserialize(datagramHeader, static_cast<const char*>(data), size);
+        const uint64_t submessageEnd =
+            static_cast<uint64_t>(datagramHeader.submessageOffset) + datagramHeader.submessageSize;
+        const bool isUserHeader = datagramHeader.submessageOffset < datagramHeader.userHeaderSize;
+        const bool isValid = messageSize == headerSize + static_cast<size_t>(datagramHeader.submessageSize)
+                             && (isUserHeader ? submessageEnd <= datagramHeader.userHeaderSize
+                                              : submessageEnd <= static_cast<uint64_t>(datagramHeader.userHeaderSize)
+                                                                     + datagramHeader.userPayloadSize);
+        if (!isValid)
+        {
+            iox::p3com::LogError() << "[TCPTransport] Received invalid user data message! Discarding!";
+            return discard;
+        }
+
+        void* buffer = self->m_bufferNeededCallback(data, headerSize);
+        if (buffer == nullptr)
+        {
+            return discard;
+        }
+        const uint32_t offset = isUserHeader ? datagramHeader.submessageOffset
+                                             : datagramHeader.submessageOffset - datagramHeader.userHeaderSize;
+        return TCPTransportSession::MessageBuffer_t{static_cast<uint8_t*>(buffer) + offset, headerSize, *index};
+    };
+}
+
+iox::p3com::tcp::TCPTransportSession::largeMessageReadCallback_t
+iox::p3com::tcp::TCPTransport::handleLargeMessageRead(iox::p3com::tcp::TCPTransport* self) noexcept
+{
+    return [self](const void* header,
+                  size_t headerSize,
+                  bool isComplete,
+                  uint32_t deviceIndex,
+                  std::chrono::steady_clock::time_point receiveTime) {
+        if (isComplete)
+        {
+            iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+            iox::p3com::deserialize(datagramHeader, static_cast<const char*>(header), headerSize);
+            self->m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+            self->m_receivedBytes.fetch_add(headerSize + datagramHeader.submessageSize, std::memory_order_relaxed);
+        }
+        else
+        {
+            iox::p3com::LogError() << "[TCPTransport] Could not receive user data message! Discarding!";
+        }
+        self->m_bufferReleasedCallback(
+            header, headerSize, !isComplete, {iox::p3com::TransportType::TCP, deviceIndex});
+        if (isComplete)
+        {
+            self->m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+        }
+    };
+}
+
 iox::p3com::tcp::TCPClientTransportSession::sessionOpenCallback_t
 iox::p3com::tcp::TCPTransport::handleSessionOpen(iox::p3com::tcp::TCPTransport* self) noexcept
 {
     return [self](TCPTransportSession* session) {
-        LogInfo() << "[TCPTransport] New connection established: " << session->endpointToString()
-                  << " Sessions: " << self->m_transportSessions.size();
+        std::lock_guard<std::mutex> peersLock(self->m_peersMutex);
+        LogInfo() << "[TCPTransport] New connection established: " << session->endpointToString() << " Devices: "
+                  << std::count_if(self->m_peers.begin(), self->m_peers.end(), [](const Peer_t& p) {
+                         return p.isUsed;
+                     });
+        const auto address = session->remoteEndpoint().address();
         auto infoToReportIt =
-            std::find_if(self->m_infoToReport.begin(), self->m_infoToReport.end(), [session](const auto& iter) {
-                return iter.first.address() == session->remoteEndpoint().address();
+            std::find_if(self->m_infoToReport.begin(), self->m_infoToReport.end(), [&address](const auto& iter) {
+                return iter.first.address() == address;
             });
 
-        if (infoToReportIt != self->m_infoToReport.end())
+        // The discovery info is reported once the first lane to the device is connected
+        auto* peer = self->findPeer(address);
+        if (infoToReportIt != self->m_infoToReport.end() && peer != nullptr)
         {
-            auto iter = self->findSession(session->remoteEndpoint());
-            const auto deviceIdx = static_cast<uint32_t>(std::distance(self->m_transportSessions.begin(), iter));
+            const auto deviceIdx = static_cast<uint32_t>(peer - self->m_peers.data());
             const auto& vec = infoToReportIt->second;
             self->remoteDiscoveryHandler(vec.data(), vec.size(), deviceIdx);
             self->m_infoToReport.erase(infoToReportIt);
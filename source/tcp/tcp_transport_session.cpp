@@ -2,23 +2,123 @@
 
 #include "p3com/transport/tcp/tcp_transport_session.hpp"
 #include "p3com/internal/log/logging.hpp"
+#include "p3com/transport/socket/busy_poll.hpp"
 
 #include <asio.hpp>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
 #include <thread>
+#include <unistd.h>
+#include <vector>
+
+constexpr uint32_t iox::p3com::tcp::TCPTransportSession::MAX_GATHER_FRAMES;
+constexpr uint32_t iox::p3com::tcp::TCPTransportSession::MAX_FREE_FRAMES;
+constexpr size_t iox::p3com::tcp::TCPTransportSession::MAX_FRAME_SIZE;
+constexpr size_t iox::p3com::tcp::TCPTransportSession::LARGE_MESSAGE_PEEK_SIZE;
+constexpr uint32_t iox::p3com::tcp::TCPTransportSession::HEARTBEAT_TIMEOUT_FACTOR;
+constexpr uint32_t iox::p3com::tcp::TCPTransportSession::IO_URING_ENTRY_COUNT;
+constexpr uint32_t iox::p3com::tcp::TCPTransportSession::IO_URING_BUFFER_COUNT;
+constexpr size_t iox::p3com::tcp::TCPTransportSession::IO_URING_BUFFER_SIZE;
+
+namespace
+{
+// Buffers which remain after the given number of bytes has been written
+std::vector<asio::const_buffer> consumeBuffers(const std::vector<asio::const_buffer>& buffers, size_t writtenSize)
+{
+    std::vector<asio::const_buffer> remaining;
+    for (const auto& buffer : buffers)
+    {
+        if (writtenSize >= buffer.size())
+        {
+            writtenSize -= buffer.size();
+            continue;
+        }
+        remaining.push_back(buffer + writtenSize);
+        writtenSize = 0U;
+    }
+    return remaining;
+}
+} // namespace
 
 iox::p3com::tcp::TCPTransportSession::TCPTransportSession(asio::io_service& io_service,
+                                                        const iox::p3com::TCPTransportConfig_t& config,
                                                         const dataCallback_t& dataCallbackHandler,
+                                                        const largeMessageCallback_t& largeMessageHandler,
+                                                        const largeMessageReadCallback_t& largeMessageReadHandler,
+                                                        const zeroCopySentCallback_t& zeroCopySentHandler,
                                                         const sessionClosedCallback_t& sessionClosedHandler) noexcept
-    : m_sessionClosedCallback(std::move(sessionClosedHandler))
+    : m_ioService(io_service)
+    , m_socketBusyPoll(config.socketBusyPoll)
+    , m_sendQueueSize(config.sendQueueSize)
+    , m_sendQueueTimeout(config.sendQueueTimeout)
+    , m_userTimeout(config.userTimeout)
+    , m_keepAlive(config.keepAlive)
+    , m_heartbeatInterval(config.heartbeatInterval)
+    , m_isIoUring(config.ioUring)
+    , m_sessionClosedCallback(std::move(sessionClosedHandler))
     , m_dataCallback(std::move(dataCallbackHandler))
+    , m_largeMessageCallback(largeMessageHandler)
+    , m_largeMessageReadCallback(largeMessageReadHandler)
+    , m_zeroCopySentCallback(zeroCopySentHandler)
     , m_dataSocket(io_service)
+    , m_heartbeatTimer(io_service)
+    , m_sendQueue(std::make_shared<SendQueue_t>())
+    , m_ringDescriptor(io_service)
 {
+    if (config.zeroCopyThreshold != 0U)
+    {
+        m_zeroCopy = std::make_unique<iox::p3com::ZeroCopyTracker>(
+            [this](uint64_t key) { m_zeroCopySentCallback(reinterpret_cast<const void*>(key)); });
+    }
 }
 
 iox::p3com::tcp::TCPTransportSession::~TCPTransportSession()
 {
+    // The kernel must not touch the frames and receive buffers of a send or receive in flight anymore
+    if (m_ring)
+    {
+        m_ring->cancel();
+    }
+
+    // Pending write handlers and waiting senders must not touch the session anymore
+    std::vector<const void*> unsentZeroCopyData;
+    {
+        std::lock_guard<std::mutex> lock(m_sendQueue->mutex);
+        m_sendQueue->isOpen = false;
+        for (const auto& frame : m_sendQueue->writing)
+        {
+            if (frame.zeroCopyData != nullptr)
+            {
+                unsentZeroCopyData.push_back(frame.zeroCopyData);
+            }
+        }
+        for (const auto& frame : m_sendQueue->frames)
+        {
+            if (frame.zeroCopyData != nullptr)
+            {
+                unsentZeroCopyData.push_back(frame.zeroCopyData);
+            }
+        }
+        m_sendQueue->writing.clear();
+        m_sendQueue->frames.clear();
+        m_sendQueue->spaceAvailable.notify_all();
+    }
+
+    // The pending messages are released, whether their sends have completed or not
+    for (const auto* data : unsentZeroCopyData)
+    {
+        m_zeroCopySentCallback(data);
+    }
+    if (m_zeroCopy)
+    {
+        m_zeroCopy->releaseAll();
+    }
 }
 
 asio::ip::tcp::socket& iox::p3com::tcp::TCPTransportSession::getSocket() noexcept
@@ -40,72 +140,831 @@ std::string iox::p3com::tcp::TCPTransportSession::remoteEndpointToString() noexc
     return sstream.str();
 }
 
-bool iox::p3com::tcp::TCPTransportSession::sendData(const void* data1,
-                                                  size_t size1,
-                                                  const void* data2,
-                                                  size_t size2) noexcept
+bool iox::p3com::tcp::TCPTransportSession::sendData(
+    const void* data1, size_t size1, const void* data2, size_t size2, bool isZeroCopy) noexcept
 {
-    try
+    // Keep the queue alive, even if the session is closed while waiting for space
+    const auto queue = m_sendQueue;
+    const size_t totalSize = size1 + size2;
+    Frame_t frame;
+    frame.size = sizeof(totalSize) + totalSize;
+    if (isZeroCopy && size2 != 0U && m_isZeroCopy.load(std::memory_order_relaxed))
     {
-        // First, we write a size_t integer with the size of the following message
-        const size_t totalSize = size1 + size2;
-        const auto writtenSize = asio::write(m_dataSocket, asio::const_buffer{&totalSize, sizeof(totalSize)});
-        cxx::Expects(writtenSize == sizeof(totalSize));
+        frame.zeroCopyData = data2;
+        frame.zeroCopySize = size2;
+    }
 
-        // Next, we actually write the message
-        constexpr uint32_t BUFFER_COUNT = 2U;
-        std::array<asio::const_buffer, BUFFER_COUNT> buffers{asio::const_buffer{data1, size1},
-                                                             asio::const_buffer{data2, size2}};
-        const auto writtenData = asio::write(m_dataSocket, buffers);
-        cxx::Expects(writtenData == totalSize);
+    // Reserve the space of the frame, a frame larger than the whole queue is only accepted into an empty queue
+    {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        const auto hasSpace = [&queue, &frame, this]() {
+            return !queue->isOpen || !queue->isConnected || queue->queuedBytes == 0U
+                   || queue->queuedBytes + frame.size <= m_sendQueueSize;
+        };
+        if (!queue->spaceAvailable.wait_for(lock, m_sendQueueTimeout, hasSpace))
+        {
+            m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            iox::p3com::LogWarn() << "[TCPTransport] Send queue towards " << remoteEndpointToString()
+                                  << " is full! Discarding!";
+            return false;
+        }
+        if (!queue->isOpen)
+        {
+            return false;
+        }
+        if (!queue->isConnected)
+        {
+            // Do not keep the sender waiting for a device which is gone, the message could not be delivered anyway
+            m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+        queue->queuedBytes += frame.size;
+        if (!queue->freeFrames.empty())
+        {
+            frame.data = std::move(queue->freeFrames.back());
+            queue->freeFrames.pop_back();
+        }
     }
-    catch (std::exception& e)
+
+    // The length prefix and the message are copied into a single frame without holding the lock
+    frame.data.resize(frame.size - frame.zeroCopySize);
+    std::memcpy(frame.data.data(), &totalSize, sizeof(totalSize));
+    if (size1 != 0U)
     {
-        iox::p3com::LogWarn() << "[TCPTransport] " << e.what();
+        std::memcpy(&frame.data[sizeof(totalSize)], data1, size1);
     }
-    return false;
+    if (size2 != 0U && frame.zeroCopyData == nullptr)
+    {
+        std::memcpy(&frame.data[sizeof(totalSize) + size1], data2, size2);
+    }
+
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (!queue->isOpen)
+    {
+        return false;
+    }
+    if (!queue->isConnected)
+    {
+        queue->queuedBytes -= frame.size;
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    const bool isPending = frame.zeroCopyData != nullptr;
+    queue->frames.push_back(std::move(frame));
+    if (!queue->isWriting)
+    {
+        // The socket is only ever written from the io thread, which also reads from it
+        queue->isWriting = true;
+        asio::post(m_ioService, [this, self = shared_from_this(), queue]() { startWrite(queue); });
+    }
+    return isPending;
+}
+
+void iox::p3com::tcp::TCPTransportSession::addStatistics(iox::p3com::TransportStatistics_t& stats) const noexcept
+{
+    stats.sentMessages += m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes += m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls += m_sendCalls.load(std::memory_order_relaxed);
+    stats.zeroCopySends += m_zeroCopySends.load(std::memory_order_relaxed);
+    stats.zeroCopyCopiedSends += m_zeroCopy ? m_zeroCopy->copiedSends() : 0U;
+    stats.droppedMessages += m_droppedMessages.load(std::memory_order_relaxed);
+    stats.receiveWakeups += m_receiveWakeups.load(std::memory_order_relaxed);
+}
+
+void iox::p3com::tcp::TCPTransportSession::startWrite(const std::shared_ptr<SendQueue_t>& queue) noexcept
+{
+    // Coalesce the queued frames into a single gather write
+    std::vector<asio::const_buffer> buffers;
+    bool isZeroCopy = false;
+    uint32_t connection = 0U;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->isOpen)
+        {
+            return;
+        }
+        connection = queue->connection;
+        while (!queue->frames.empty() && queue->writing.size() < MAX_GATHER_FRAMES)
+        {
+            // The sends of a zero-copy frame are tracked for its message, so it is written on its own
+            isZeroCopy = queue->frames.front().zeroCopyData != nullptr;
+            if (isZeroCopy && !queue->writing.empty())
+            {
+                isZeroCopy = false;
+                break;
+            }
+            queue->writing.push_back(std::move(queue->frames.front()));
+            queue->frames.pop_front();
+            if (isZeroCopy)
+            {
+                break;
+            }
+        }
+        if (queue->writing.empty())
+        {
+            queue->isWriting = false;
+            return;
+        }
+        buffers.reserve(queue->writing.size() + 1U);
+        for (const auto& frame : queue->writing)
+        {
+            buffers.emplace_back(frame.data.data(), frame.data.size());
+            if (frame.zeroCopyData != nullptr)
+            {
+                buffers.emplace_back(frame.zeroCopyData, frame.zeroCopySize);
+            }
+        }
+    }
+
+    if (isZeroCopy)
+    {
+        writeZeroCopy(queue, connection, std::move(buffers), 0U);
+        return;
+    }
+
+    // The frames are only modified by the io thread, so they can be written without holding the lock
+    m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+    if (m_ring)
+    {
+        ringWrite(queue, connection, std::move(buffers));
+        return;
+    }
+    asio::async_write(
+        m_dataSocket, buffers, [this, self = shared_from_this(), queue, connection](std::error_code ec, std::size_t) {
+            writeCompleted(queue, connection, ec);
+        });
+}
+
+void iox::p3com::tcp::TCPTransportSession::writeZeroCopy(const std::shared_ptr<SendQueue_t>& queue,
+                                                        uint32_t connection,
+                                                        std::vector<asio::const_buffer> buffers,
+                                                        uint32_t sendCount) noexcept
+{
+    // Every send call with MSG_ZEROCOPY gets its own completion, so the frame is written call by call
+    m_dataSocket.async_send(
+        buffers,
+        iox::p3com::ZeroCopyTracker::SEND_FLAG,
+        [this, self = shared_from_this(), queue, connection, buffers, sendCount](std::error_code ec,
+                                                                                 std::size_t size) mutable {
+            const void* key = nullptr;
+            std::vector<uint8_t> data;
+            {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                if (!queue->isOpen || queue->connection != connection)
+                {
+                    // The frame has already been released with the lost connection
+                    return;
+                }
+                m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+                if (!ec && size != 0U)
+                {
+                    sendCount++;
+                }
+                buffers = consumeBuffers(buffers, size);
+                if (!ec && !buffers.empty())
+                {
+                    writeZeroCopy(queue, connection, std::move(buffers), sendCount);
+                    return;
+                }
+
+                // The kernel may still reference the length prefix and the first part of the message
+                auto& frame = queue->writing.front();
+                key = frame.zeroCopyData;
+                data = std::move(frame.data);
+                frame.zeroCopyData = nullptr;
+            }
+
+            m_zeroCopySends.fetch_add(sendCount, std::memory_order_relaxed);
+            if (!m_zeroCopy->track(reinterpret_cast<uint64_t>(key), sendCount, std::move(data)))
+            {
+                m_zeroCopySentCallback(key);
+            }
+            // Pick up the completions of the previous sends, so that their chunks are released early
+            m_zeroCopy->drain(m_dataSocket.native_handle());
+            writeCompleted(queue, connection, ec);
+        });
+}
+
+void iox::p3com::tcp::TCPTransportSession::zeroCopyErrorAsyncWait() noexcept
+{
+    // The completions of the zero-copy sends arrive on the error queue of the socket, errors of the connection itself
+    // are handled by the reading side
+    m_dataSocket.async_wait(asio::ip::tcp::socket::wait_error, [this, self = shared_from_this()](std::error_code ec) {
+        if (ec)
+        {
+            return;
+        }
+        m_zeroCopy->drain(m_dataSocket.native_handle());
+        zeroCopyErrorAsyncWait();
+    });
+}
+
+void iox::p3com::tcp::TCPTransportSession::writeCompleted(const std::shared_ptr<SendQueue_t>& queue,
+                                                         uint32_t connection,
+                                                         std::error_code ec) noexcept
+{
+    std::vector<const void*> unsentZeroCopyData;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->isOpen || queue->connection != connection)
+        {
+            return;
+        }
+        for (auto& frame : queue->writing)
+        {
+            queue->queuedBytes -= frame.size;
+            if (frame.size == sizeof(size_t))
+            {
+                // Heartbeats are not counted as messages
+            }
+            else if (ec)
+            {
+                m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            }
+            else
+            {
+                m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+                m_sentBytes.fetch_add(frame.size - sizeof(size_t), std::memory_order_relaxed);
+            }
+            if (queue->freeFrames.size() < MAX_FREE_FRAMES && frame.data.capacity() != 0U
+                && frame.data.capacity() <= MAX_FRAME_SIZE)
+            {
+                queue->freeFrames.push_back(std::move(frame.data));
+            }
+        }
+        queue->writing.clear();
+
+        if (ec)
+        {
+            // The session is closed by the reading side, the queued frames cannot be delivered anymore
+            for (const auto& frame : queue->frames)
+            {
+                queue->queuedBytes -= frame.size;
+                if (frame.zeroCopyData != nullptr)
+                {
+                    unsentZeroCopyData.push_back(frame.zeroCopyData);
+                }
+            }
+            m_droppedMessages.fetch_add(queue->frames.size(), std::memory_order_relaxed);
+            queue->frames.clear();
+            queue->isWriting = false;
+        }
+        queue->spaceAvailable.notify_all();
+    }
+
+    if (ec)
+    {
+        for (const auto* data : unsentZeroCopyData)
+        {
+            m_zeroCopySentCallback(data);
+        }
+        iox::p3com::LogWarn() << "[TCPTransport] " << ec.message() << ", could not send to "
+                              << remoteEndpointToString();
+
+        // The connection is broken, closing the socket lets the reading side handle its loss right away
+        abortConnection();
+        return;
+    }
+    startWrite(queue);
 }
 
 void iox::p3com::tcp::TCPTransportSession::receiveTcpData() noexcept
 {
-    const auto processErrorCode = [this](std::error_code ec) {
+    // Read as much as the socket has into the free space behind the incomplete frame
+    auto buffer = asio::buffer(&m_readBuffer[m_readEnd], READ_BUFFER_SIZE - m_readEnd);
+    m_dataSocket.async_read_some(buffer, [this, self = shared_from_this()](std::error_code ec, std::size_t size) {
         if (ec)
         {
             iox::p3com::LogInfo() << "[TCPTransport] " << ec.message() << ", going to close socket "
-                                << remoteEndpointToString();
-            sessionClosedHandler();
-            return true;
+                                  << remoteEndpointToString();
+            connectionLost(ec);
+            return;
         }
-        else
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+        if (processReadData(size))
         {
-            return false;
+            receiveTcpData();
         }
-    };
+    });
+}
+
+bool iox::p3com::tcp::TCPTransportSession::processReadData(size_t size) noexcept
+{
+    const auto readTime = std::chrono::steady_clock::now();
+    m_lastReceiveTime = readTime;
+    m_isConfirmed = true;
+    bool isContinued = m_readBegin != m_readEnd;
+    m_readEnd += size;
 
-    // After we have read the size of the full message, we read the actual message payload
-    auto readInner = [this, processErrorCode](std::error_code ec, std::size_t size) {
-        if (!processErrorCode(ec))
+    // Hand over every complete frame in place, every frame is a size_t length prefix followed by the message
+    size_t frameSize = MAX_FRAME_SIZE;
+    while (true)
+    {
+        // Skip the rest of a discarded large message
+        const size_t skippedSize = std::min(m_discardSize, m_readEnd - m_readBegin);
+        m_readBegin += skippedSize;
+        m_discardSize -= skippedSize;
+        if (m_discardSize != 0U || m_readEnd - m_readBegin < sizeof(size_t))
         {
-            iox::p3com::LogInfo() << "[TCPTransport] Received data from " << remoteEndpointToString();
-            m_dataCallback(m_readBuffer.data(), size, remoteEndpoint());
-            receiveTcpData();
+            break;
+        }
+
+        size_t messageSize = 0U;
+        std::memcpy(&messageSize, &m_readBuffer[m_readBegin], sizeof(messageSize));
+        if (messageSize == 0U)
+        {
+            // Heartbeat of the remote gateway, it only refreshes the receive time
+            m_readBegin += sizeof(messageSize);
+            continue;
+        }
+        if (messageSize > MAX_PACKET_SIZE)
+        {
+            // The datagram header of a large message is needed to request its buffer
+            frameSize = sizeof(messageSize) + std::min(messageSize, LARGE_MESSAGE_PEEK_SIZE);
+            if (m_readEnd - m_readBegin < frameSize)
+            {
+                break;
+            }
+            m_readBegin += sizeof(messageSize);
+            if (!readLargeMessage(messageSize, isContinued ? m_readTime : readTime))
+            {
+                return false;
+            }
+            isContinued = false;
+            frameSize = MAX_FRAME_SIZE;
+            continue;
+        }
+        frameSize = sizeof(messageSize) + messageSize;
+        if (m_readEnd - m_readBegin < frameSize)
+        {
+            break;
+        }
+
+        iox::p3com::LogInfo() << "[TCPTransport] Received data from " << remoteEndpointToString();
+        m_dataCallback(&m_readBuffer[m_readBegin + sizeof(messageSize)],
+                       messageSize,
+                       remoteEndpoint(),
+                       isContinued ? m_readTime : readTime);
+        isContinued = false;
+        m_readBegin += frameSize;
+        frameSize = MAX_FRAME_SIZE;
+    }
+    if (!isContinued)
+    {
+        m_readTime = readTime;
+    }
+
+    // Only move the incomplete frame to the front if it straddles the end of the buffer
+    if (m_readBegin == m_readEnd)
+    {
+        m_readBegin = 0U;
+        m_readEnd = 0U;
+    }
+    else if (m_readBegin + frameSize > READ_BUFFER_SIZE)
+    {
+        std::memmove(m_readBuffer.data(), &m_readBuffer[m_readBegin], m_readEnd - m_readBegin);
+        m_readEnd -= m_readBegin;
+        m_readBegin = 0U;
+    }
+    return true;
+}
+
+bool iox::p3com::tcp::TCPTransportSession::readLargeMessage(size_t messageSize,
+                                                           std::chrono::steady_clock::time_point readTime) noexcept
+{
+    const size_t bufferedSize = std::min(messageSize, m_readEnd - m_readBegin);
+    const auto buffer =
+        m_largeMessageCallback(&m_readBuffer[m_readBegin], bufferedSize, messageSize, remoteEndpoint());
+    if (buffer.data == nullptr || buffer.headerSize > bufferedSize)
+    {
+        m_discardSize = messageSize;
+        return true;
+    }
+
+    // Move the part of the message which has already been read into its buffer
+    m_largeMessageHeader.assign(&m_readBuffer[m_readBegin], &m_readBuffer[m_readBegin + buffer.headerSize]);
+    m_largeMessageDeviceIndex = buffer.deviceIndex;
+    const size_t bufferedDataSize = bufferedSize - buffer.headerSize;
+    std::memcpy(buffer.data, &m_readBuffer[m_readBegin + buffer.headerSize], bufferedDataSize);
+    m_readBegin += bufferedSize;
+    if (bufferedSize == messageSize)
+    {
+        m_largeMessageReadCallback(
+            m_largeMessageHeader.data(), m_largeMessageHeader.size(), true, m_largeMessageDeviceIndex, readTime);
+        return true;
+    }
+
+    // The read buffer is empty now, the rest of the message goes straight into its buffer
+    m_readBegin = 0U;
+    m_readEnd = 0U;
+    if (m_ring)
+    {
+        // The io_uring keeps receiving the stream into its own buffers, the rest is copied out of them as it arrives
+        m_largeMessageData = static_cast<uint8_t*>(buffer.data) + bufferedDataSize;
+        m_largeMessageSize = messageSize - bufferedSize;
+        m_largeMessageReadTime = readTime;
+        return true;
+    }
+    readLargeMessageData(static_cast<uint8_t*>(buffer.data) + bufferedDataSize, messageSize - bufferedSize, readTime);
+    return false;
+}
+
+void iox::p3com::tcp::TCPTransportSession::readLargeMessageData(
+    uint8_t* data, size_t size, std::chrono::steady_clock::time_point readTime) noexcept
+{
+    // Read piece by piece, so that the progress of a long message keeps the heartbeat timeout from expiring
+    auto buffer = asio::buffer(data, size);
+    auto self = shared_from_this();
+    m_dataSocket.async_read_some(buffer, [this, self, data, size, readTime](std::error_code ec, std::size_t readSize) {
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+        m_lastReceiveTime = std::chrono::steady_clock::now();
+        if (!ec && readSize < size)
+        {
+            readLargeMessageData(data + readSize, size - readSize, readTime);
+            return;
+        }
+        m_largeMessageReadCallback(
+            m_largeMessageHeader.data(), m_largeMessageHeader.size(), !ec, m_largeMessageDeviceIndex, readTime);
+        if (ec)
+        {
+            iox::p3com::LogInfo() << "[TCPTransport] " << ec.message() << ", going to close socket "
+                                  << remoteEndpointToString();
+            connectionLost(ec);
+            return;
+        }
+        receiveTcpData();
+    });
+}
+
+bool iox::p3com::tcp::TCPTransportSession::startRing() noexcept
+{
+    auto ring = std::make_unique<iox::p3com::IoUring>();
+    if (!ring->initialize(IO_URING_ENTRY_COUNT))
+    {
+        return false;
+    }
+
+    // The descriptor closes its own duplicate, the ring closes its file descriptor itself
+    const int ringFd = dup(ring->fd());
+    if (ringFd < 0)
+    {
+        iox::p3com::LogWarn() << "[TCPTransport] Could not duplicate the io_uring file descriptor: "
+                              << std::strerror(errno);
+        return false;
+    }
+    asio::error_code ec;
+    m_ringDescriptor.assign(ringFd, ec);
+    if (ec)
+    {
+        close(ringFd);
+        iox::p3com::LogWarn() << "[TCPTransport] Could not wait for the io_uring completions: " << ec.message();
+        return false;
+    }
+    if (!ring->receiveStreamMultishot(m_dataSocket.native_handle(), IO_URING_BUFFER_COUNT, IO_URING_BUFFER_SIZE))
+    {
+        m_ringDescriptor.close(ec);
+        iox::p3com::LogWarn() << "[TCPTransport] Multishot receives are not supported, receiving from "
+                              << remoteEndpointToString() << " with the io thread";
+        return false;
+    }
+    m_ring = std::move(ring);
+    ringAsyncWait();
+    return true;
+}
+
+void iox::p3com::tcp::TCPTransportSession::stopRing() noexcept
+{
+    if (!m_ring)
+    {
+        return;
+    }
+
+    // The receive and the send in flight reference the buffers of the session, so they have to end first
+    m_ring->cancel();
+    asio::error_code ec;
+    m_ringDescriptor.close(ec);
+    m_ring.reset();
+    m_ringSendQueue.reset();
+    m_ringSendBuffers.clear();
+    if (m_largeMessageData != nullptr)
+    {
+        m_largeMessageData = nullptr;
+        m_largeMessageReadCallback(m_largeMessageHeader.data(),
+                                   m_largeMessageHeader.size(),
+                                   false,
+                                   m_largeMessageDeviceIndex,
+                                   m_largeMessageReadTime);
+    }
+}
+
+void iox::p3com::tcp::TCPTransportSession::ringAsyncWait() noexcept
+{
+    // The ring is readable while completions are pending, which are all handled by a single wakeup
+    auto self = shared_from_this();
+    m_ringDescriptor.async_wait(asio::posix::stream_descriptor::wait_read, [this, self](std::error_code ec) {
+        if (ec)
+        {
+            // Cancelled because the connection is gone
+            return;
+        }
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+        const int32_t ret = m_ring->processStreamCompletions(
+            [this](const void* data, size_t size) { ringReceived(static_cast<const uint8_t*>(data), size); },
+            [this](int32_t result) { ringSendCompleted(result); });
+        if (ret < 0)
+        {
+            const int error = errno;
+            ec = error == 0 ? make_error_code(asio::error::eof) : std::error_code(error, std::system_category());
+            iox::p3com::LogInfo() << "[TCPTransport] " << ec.message() << ", going to close socket "
+                                  << remoteEndpointToString();
+            connectionLost(ec);
+            return;
+        }
+        ringAsyncWait();
+    });
+}
+
+void iox::p3com::tcp::TCPTransportSession::ringReceived(const uint8_t* data, size_t size) noexcept
+{
+    while (size != 0U)
+    {
+        if (m_largeMessageData != nullptr)
+        {
+            const size_t copiedSize = std::min(size, m_largeMessageSize);
+            std::memcpy(m_largeMessageData, data, copiedSize);
+            m_largeMessageData += copiedSize;
+            m_largeMessageSize -= copiedSize;
+            data += copiedSize;
+            size -= copiedSize;
+            m_lastReceiveTime = std::chrono::steady_clock::now();
+            if (m_largeMessageSize == 0U)
+            {
+                m_largeMessageData = nullptr;
+                m_largeMessageReadCallback(m_largeMessageHeader.data(),
+                                           m_largeMessageHeader.size(),
+                                           true,
+                                           m_largeMessageDeviceIndex,
+                                           m_largeMessageReadTime);
+            }
+            continue;
+        }
+
+        // The parser always leaves free space behind the incomplete frame
+        const size_t copiedSize = std::min(size, READ_BUFFER_SIZE - m_readEnd);
+        std::memcpy(&m_readBuffer[m_readEnd], data, copiedSize);
+        data += copiedSize;
+        size -= copiedSize;
+        processReadData(copiedSize);
+    }
+}
+
+void iox::p3com::tcp::TCPTransportSession::ringWrite(const std::shared_ptr<SendQueue_t>& queue,
+                                                    uint32_t connection,
+                                                    std::vector<asio::const_buffer> buffers) noexcept
+{
+    // All frames of the gather write go into a single sendmsg SQE, its completion arrives with the received data
+    m_ringSendQueue = queue;
+    m_ringSendConnection = connection;
+    m_ringSendBuffers = std::move(buffers);
+    m_ringSendIovecs.clear();
+    for (const auto& buffer : m_ringSendBuffers)
+    {
+        m_ringSendIovecs.push_back({const_cast<void*>(buffer.data()), buffer.size()});
+    }
+    m_ringSendMessage = {};
+    m_ringSendMessage.msg_iov = m_ringSendIovecs.data();
+    m_ringSendMessage.msg_iovlen = m_ringSendIovecs.size();
+    if (!m_ring->submitSend(m_dataSocket.native_handle(), &m_ringSendMessage, MSG_NOSIGNAL))
+    {
+        const std::error_code ec(errno, std::system_category());
+        m_ringSendQueue.reset();
+        writeCompleted(queue, connection, ec);
+    }
+}
+
+void iox::p3com::tcp::TCPTransportSession::ringSendCompleted(int32_t result) noexcept
+{
+    if (!m_ringSendQueue)
+    {
+        return;
+    }
+    const auto queue = std::move(m_ringSendQueue);
+    if (result < 0)
+    {
+        writeCompleted(queue, m_ringSendConnection, std::error_code(-result, std::system_category()));
+        return;
+    }
+
+    // A short send leaves the rest of the frames for the next SQE
+    auto remaining = consumeBuffers(m_ringSendBuffers, static_cast<size_t>(result));
+    if (!remaining.empty())
+    {
+        m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+        ringWrite(queue, m_ringSendConnection, std::move(remaining));
+        return;
+    }
+    writeCompleted(queue, m_ringSendConnection, {});
+}
+
+void iox::p3com::tcp::TCPTransportSession::abortConnection() noexcept
+{
+    // A receive on the io_uring holds its own reference to the socket and only ends once the socket is shut down
+    asio::error_code ec;
+    m_dataSocket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+    m_dataSocket.close(ec);
+}
+
+void iox::p3com::tcp::TCPTransportSession::enableBusyPoll() noexcept
+{
+    if (m_socketBusyPoll.count() > 0)
+    {
+        iox::p3com::BusyPoll::enableSocket(m_dataSocket.native_handle(), m_socketBusyPoll);
+    }
+}
+
+void iox::p3com::tcp::TCPTransportSession::enableZeroCopy() noexcept
+{
+    if (m_zeroCopy && iox::p3com::ZeroCopyTracker::enable(m_dataSocket.native_handle()))
+    {
+        m_isZeroCopy.store(true, std::memory_order_relaxed);
+        zeroCopyErrorAsyncWait();
+    }
+}
+
+void iox::p3com::tcp::TCPTransportSession::enableFailureDetection() noexcept
+{
+    const int fd = m_dataSocket.native_handle();
+#if defined(TCP_USER_TIMEOUT)
+    // Unacknowledged data older than the user timeout fails the connection, instead of the retransmissions taking
+    // several minutes
+    if (m_userTimeout.count() > 0)
+    {
+        const auto userTimeout = static_cast<unsigned int>(m_userTimeout.count());
+        if (setsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &userTimeout, sizeof(userTimeout)) != 0)
+        {
+            iox::p3com::LogWarn() << "[TCPTransport] Could not set TCP_USER_TIMEOUT: " << std::strerror(errno);
         }
-    };
+    }
+#else
+    if (m_userTimeout.count() > 0)
+    {
+        iox::p3com::LogWarn() << "[TCPTransport] TCP_USER_TIMEOUT is not supported on this platform";
+    }
+#endif
 
-    const auto readOuter = [this, processErrorCode, readInner = std::move(readInner)](std::error_code ec, std::size_t) {
-        if (!processErrorCode(ec))
+    // Keepalive probes detect a dead device while nothing is sent to it
+    if (m_keepAlive.count() > 0)
+    {
+        const int one = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one)) != 0)
         {
-            // m_readBufferSize now stores the size of the following message, we need to read exactly this many bytes
-            asio::async_read(m_dataSocket, asio::buffer(m_readBuffer, m_readBufferSize), std::move(readInner));
+            iox::p3com::LogWarn() << "[TCPTransport] Could not set SO_KEEPALIVE: " << std::strerror(errno);
+            return;
         }
-    };
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+        const int keepAlive = static_cast<int>(m_keepAlive.count());
+        const int probeCount = static_cast<int>(HEARTBEAT_TIMEOUT_FACTOR);
+        if (setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &keepAlive, sizeof(keepAlive)) != 0
+            || setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &keepAlive, sizeof(keepAlive)) != 0
+            || setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &probeCount, sizeof(probeCount)) != 0)
+        {
+            iox::p3com::LogWarn() << "[TCPTransport] Could not tune the keepalive probes: " << std::strerror(errno);
+        }
+#endif
+    }
+}
 
-    // We read a size_t integer with the size of the following message into m_readBufferSize
-    asio::async_read(m_dataSocket, asio::buffer(&m_readBufferSize, sizeof(m_readBufferSize)), std::move(readOuter));
+void iox::p3com::tcp::TCPTransportSession::startHeartbeat() noexcept
+{
+    if (m_heartbeatInterval.count() <= 0)
+    {
+        return;
+    }
+    m_heartbeatTimer.expires_from_now(m_heartbeatInterval);
+    m_heartbeatTimer.async_wait([this, self = shared_from_this()](std::error_code ec) {
+        if (ec)
+        {
+            // Cancelled because the connection is gone
+            return;
+        }
+        if (std::chrono::steady_clock::now() - m_lastReceiveTime > HEARTBEAT_TIMEOUT_FACTOR * m_heartbeatInterval)
+        {
+            iox::p3com::LogWarn() << "[TCPTransport] No heartbeat from " << remoteEndpointToString()
+                                  << ", going to close socket";
+            // The pending read is aborted, which handles the loss of the connection
+            abortConnection();
+            return;
+        }
+        sendHeartbeat();
+        startHeartbeat();
+    });
+}
+
+void iox::p3com::tcp::TCPTransportSession::sendHeartbeat() noexcept
+{
+    // A heartbeat is an empty frame, which is only needed while nothing else is sent
+    const auto queue = m_sendQueue;
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (!queue->isConnected || queue->isWriting)
+    {
+        return;
+    }
+    Frame_t frame;
+    frame.size = sizeof(size_t);
+    frame.data.resize(frame.size, 0U);
+    queue->queuedBytes += frame.size;
+    queue->frames.push_back(std::move(frame));
+    queue->isWriting = true;
+    asio::post(m_ioService, [this, self = shared_from_this(), queue]() { startWrite(queue); });
+}
+
+void iox::p3com::tcp::TCPTransportSession::sessionOpened() noexcept
+{
+    m_readBegin = 0U;
+    m_readEnd = 0U;
+    m_discardSize = 0U;
+    m_lastReceiveTime = std::chrono::steady_clock::now();
+    m_isConfirmed = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sendQueue->mutex);
+        m_sendQueue->isConnected = true;
+    }
+
+    enableBusyPoll();
+    enableZeroCopy();
+    enableFailureDetection();
+    if (!m_isIoUring || !startRing())
+    {
+        receiveTcpData();
+    }
+
+    // An empty frame is sent right away even without heartbeats, it tells the remote gateway that its connection has
+    // been accepted
+    sendHeartbeat();
+    startHeartbeat();
+}
+
+void iox::p3com::tcp::TCPTransportSession::disconnect() noexcept
+{
+    // No handler of this connection touches its frames or buffers once the socket is closed
+    asio::error_code ec;
+    m_dataSocket.close(ec);
+    m_heartbeatTimer.cancel(ec);
+    stopRing();
+
+    std::vector<const void*> unsentZeroCopyData;
+    {
+        std::lock_guard<std::mutex> lock(m_sendQueue->mutex);
+        m_sendQueue->isConnected = false;
+        m_sendQueue->connection++;
+        const auto dropFrame = [this, &unsentZeroCopyData](const Frame_t& frame) {
+            m_sendQueue->queuedBytes -= frame.size;
+            if (frame.size != sizeof(size_t))
+            {
+                m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            }
+            if (frame.zeroCopyData != nullptr)
+            {
+                unsentZeroCopyData.push_back(frame.zeroCopyData);
+            }
+        };
+        std::for_each(m_sendQueue->writing.begin(), m_sendQueue->writing.end(), dropFrame);
+        std::for_each(m_sendQueue->frames.begin(), m_sendQueue->frames.end(), dropFrame);
+        m_sendQueue->writing.clear();
+        m_sendQueue->frames.clear();
+        m_sendQueue->isWriting = false;
+        m_sendQueue->spaceAvailable.notify_all();
+    }
+
+    // The zero-copy sends of the closed socket never complete, so their messages are released right away
+    for (const auto* data : unsentZeroCopyData)
+    {
+        m_zeroCopySentCallback(data);
+    }
+    if (m_zeroCopy)
+    {
+        m_isZeroCopy.store(false, std::memory_order_relaxed);
+        m_zeroCopy->releaseAll();
+    }
+}
+
+bool iox::p3com::tcp::TCPTransportSession::isConfirmed() const noexcept
+{
+    return m_isConfirmed;
+}
+
+void iox::p3com::tcp::TCPTransportSession::stop() noexcept
+{
+    sessionClosedHandler();
+}
+
+void iox::p3com::tcp::TCPTransportSession::connectionLost(std::error_code) noexcept
+{
+    sessionClosedHandler();
 }
 
 void iox::p3com::tcp::TCPTransportSession::sessionClosedHandler() noexcept
 {
-    m_dataSocket.close();
+    disconnect();
     m_sessionClosedCallback(this);
 }
@@ -0,0 +1,988 @@
+// Copyright 2023 NXP
+
+#include "p3com/generic/serialization.hpp"
+#include "p3com/generic/types.hpp"
+#include "p3com/internal/log/logging.hpp"
+#include "p3com/transport/transport.hpp"
+
+#include "p3com/transport/udp/udp_data_worker.hpp"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+using reuse_port = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#if defined(IP_MULTICAST_ALL)
+using multicast_all = asio::detail::socket_option::boolean<IPPROTO_IP, IP_MULTICAST_ALL>;
+#endif
+#if defined(IP_MTU_DISCOVER)
+using pmtu_discover = asio::detail::socket_option::integer<IPPROTO_IP, IP_MTU_DISCOVER>;
+#endif
+#if defined(SO_TIMESTAMPNS)
+using timestamp_ns = asio::detail::socket_option::boolean<SOL_SOCKET, SO_TIMESTAMPNS>;
+#endif
+}
+
+constexpr uint16_t iox::p3com::udp::UDPDataWorker::DATA_PORT;
+constexpr uint16_t iox::p3com::udp::UDPDataWorker::MULTICAST_PORT;
+constexpr size_t iox::p3com::udp::UDPDataWorker::MAX_DATAGRAM_SIZE;
+constexpr uint32_t iox::p3com::udp::UDPDataWorker::MAX_RECEIVE_BATCH_SIZE;
+constexpr uint32_t iox::p3com::udp::UDPDataWorker::MAX_GSO_SEGMENT_COUNT;
+constexpr size_t iox::p3com::udp::UDPDataWorker::MAX_GSO_SIZE;
+constexpr size_t iox::p3com::udp::UDPDataWorker::MAX_GSO_SEGMENT_SIZE;
+constexpr std::chrono::milliseconds iox::p3com::udp::UDPDataWorker::SEND_TIMEOUT;
+constexpr uint32_t iox::p3com::udp::UDPDataWorker::IO_URING_ENTRY_COUNT;
+constexpr uint32_t iox::p3com::udp::UDPDataWorker::IO_URING_BUFFER_COUNT;
+constexpr size_t iox::p3com::udp::UDPDataWorker::IO_URING_BUFFER_HEADROOM;
+constexpr std::chrono::milliseconds iox::p3com::udp::UDPDataWorker::IO_URING_WAIT_TIMEOUT;
+constexpr uint32_t iox::p3com::udp::UDPDataWorker::MAX_FREE_ZERO_COPY_HEADERS;
+
+iox::p3com::LatencyHistogram::Counts_t iox::p3com::udp::UDPDataWorker::receiveLatencyCounts() const noexcept
+{
+    return m_receiveLatency.counts();
+}
+
+iox::p3com::udp::UDPDataWorker::UDPDataWorker(uint32_t workerIndex,
+                                              const iox::p3com::UDPTransportConfig_t& config,
+                                              dataCallback_t dataCallback,
+                                              failCallback_t failCallback,
+                                              zeroCopyCallback_t zeroCopyCallback,
+                                              receiveTargetCallback_t receiveTargetCallback,
+                                              receivedCallback_t receivedCallback) noexcept
+    : m_workerIndex(workerIndex)
+    , m_context()
+    , m_dataSocket(m_context)
+    , m_sendSocket(m_context)
+    , m_isDirectReceive(config.directReceive)
+    , m_busyPollBudget(config.busyPollBudget)
+    , m_multicastSocket(m_context)
+    , m_receiveBatchSize(std::min(std::max(config.receiveBatchSize, 1U), MAX_RECEIVE_BATCH_SIZE))
+    , m_segmentationOffload(config.segmentationOffload)
+    , m_dataCallback(std::move(dataCallback))
+    , m_failCallback(std::move(failCallback))
+    , m_zeroCopyCallback(std::move(zeroCopyCallback))
+    , m_receiveTargetCallback(std::move(receiveTargetCallback))
+    , m_receivedCallback(std::move(receivedCallback))
+{
+#if !defined(UDP_SEGMENT)
+    if (m_segmentationOffload.load())
+    {
+        iox::p3com::LogWarn() << "[UDPDataWorker] UDP segmentation offload is not supported on this platform";
+        m_segmentationOffload.store(false);
+    }
+#endif
+
+    try
+    {
+        // All workers share the data port, the kernel distributes the incoming datagrams among them by hashing the
+        // source address and port, so all datagrams from one sending socket end up in the same worker
+        m_dataSocket.open(asio::ip::udp::v4());
+        m_dataSocket.set_option(reuse_port(true));
+        m_dataSocket.bind(asio::ip::udp::endpoint(asio::ip::address_v4::any(), DATA_PORT));
+        m_sendSocket.open(asio::ip::udp::v4());
+
+        // TODO: What are the best values for send and receive buffer sizes?
+        constexpr uint32_t SEND_BUFFER_SIZE = 16 * 1024 * 1024;
+        constexpr uint32_t RECEIVE_BUFFER_SIZE = 32 * 1024 * 1024;
+        m_sendSocket.set_option(asio::socket_base::send_buffer_size(SEND_BUFFER_SIZE));
+        m_dataSocket.set_option(asio::socket_base::receive_buffer_size(RECEIVE_BUFFER_SIZE));
+#if defined(SO_TIMESTAMPNS)
+        // The receive latency is measured from the time the datagrams entered the network stack
+        m_dataSocket.set_option(timestamp_ns(true));
+#endif
+        if (config.socketBusyPoll.count() > 0)
+        {
+            iox::p3com::BusyPoll::enableSocket(m_dataSocket.native_handle(), config.socketBusyPoll);
+        }
+
+#if defined(IP_MTU_DISCOVER)
+        if (config.mtu == 0U)
+        {
+            // Set the DF bit, so that datagrams exceeding the path MTU are rejected instead of fragmented and the
+            // kernel learns about smaller path MTUs from ICMP "fragmentation needed" messages
+            m_sendSocket.set_option(pmtu_discover(IP_PMTUDISC_DO));
+        }
+#endif
+
+        if (config.zeroCopyThreshold != 0U && iox::p3com::ZeroCopyTracker::enable(m_sendSocket.native_handle()))
+        {
+            m_zeroCopy =
+                std::make_unique<iox::p3com::ZeroCopyTracker>(m_zeroCopyCallback, MAX_FREE_ZERO_COPY_HEADERS);
+            m_zeroCopySegments.reserve(MAX_SEND_BATCH_SIZE);
+        }
+
+        if (config.multicast)
+        {
+            // The own multicast datagrams must not come back to this device
+            m_sendSocket.set_option(asio::ip::multicast::enable_loopback(false));
+            if (m_workerIndex == 0U)
+            {
+                m_multicastSocket.open(asio::ip::udp::v4());
+                m_multicastSocket.set_option(asio::socket_base::reuse_address(true));
+#if defined(IP_MULTICAST_ALL)
+                // Only deliver the groups joined on this socket, not the ones joined by other sockets of the host
+                m_multicastSocket.set_option(multicast_all(false));
+#endif
+                m_multicastSocket.set_option(asio::socket_base::receive_buffer_size(RECEIVE_BUFFER_SIZE));
+                m_multicastSocket.bind(asio::ip::udp::endpoint(asio::ip::address_v4::any(), MULTICAST_PORT));
+                if (config.socketBusyPoll.count() > 0)
+                {
+                    iox::p3com::BusyPoll::enableSocket(m_multicastSocket.native_handle(), config.socketBusyPoll);
+                }
+                m_multicastBuffer.resize(MAX_DATAGRAM_SIZE);
+            }
+        }
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+        fail();
+        return;
+    }
+
+    if (config.ioUring)
+    {
+        setupIoUring();
+    }
+
+    if (m_receiveBatchSize > 1U && !m_isDirectReceive && !m_receiveRing)
+    {
+        // Every datagram of the batch gets its own preallocated buffer, so that a single recvmmsg call can fill all
+        // of them at once
+        m_batchBuffers.resize(static_cast<size_t>(m_receiveBatchSize) * MAX_DATAGRAM_SIZE);
+        m_batchIovecs.resize(m_receiveBatchSize);
+        m_batchAddresses.resize(m_receiveBatchSize);
+        m_batchMessages.resize(m_receiveBatchSize);
+        m_batchControls.resize(m_receiveBatchSize);
+        for (uint32_t i = 0U; i < m_receiveBatchSize; ++i)
+        {
+            m_batchIovecs[i].iov_base = &m_batchBuffers[i * MAX_DATAGRAM_SIZE];
+            m_batchIovecs[i].iov_len = MAX_DATAGRAM_SIZE;
+            std::memset(&m_batchMessages[i], 0, sizeof(m_batchMessages[i]));
+            m_batchMessages[i].msg_hdr.msg_iov = &m_batchIovecs[i];
+            m_batchMessages[i].msg_hdr.msg_iovlen = 1U;
+            m_batchMessages[i].msg_hdr.msg_name = &m_batchAddresses[i];
+        }
+    }
+
+    m_thread = std::thread([this]() {
+        try
+        {
+            m_work.emplace(m_context);
+            if (m_busyPollBudget.count() > 0)
+            {
+                iox::p3com::BusyPoll::run(m_context, m_busyPollBudget);
+            }
+            else
+            {
+                m_context.run();
+            }
+            iox::p3com::LogInfo() << "[UDPDataWorker] Worker thread " << m_workerIndex << " has exited";
+        }
+        catch (std::exception& e)
+        {
+            iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+            fail();
+            return;
+        }
+    });
+
+    if (m_receiveRing)
+    {
+        m_isRingRunning.store(true);
+        m_ringThread = std::thread([this]() { ringReceiveLoop(); });
+    }
+    else if (m_isDirectReceive)
+    {
+        dataAsyncReceiveDirect();
+    }
+    else if (m_receiveBatchSize > 1U)
+    {
+        dataAsyncReceiveBatch();
+    }
+    else
+    {
+        dataAsyncReceive();
+    }
+    if (m_multicastSocket.is_open())
+    {
+        multicastAsyncReceive();
+    }
+    if (m_zeroCopy)
+    {
+        errorAsyncWait();
+    }
+}
+
+iox::p3com::udp::UDPDataWorker::~UDPDataWorker()
+{
+    m_isRingRunning.store(false);
+    if (m_ringThread.joinable())
+    {
+        m_ringThread.join();
+    }
+    m_work.reset();
+    m_context.stop();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    if (m_zeroCopy)
+    {
+        m_zeroCopy->releaseAll();
+    }
+}
+
+void iox::p3com::udp::UDPDataWorker::fail() noexcept
+{
+    m_isGood.store(false);
+    if (m_failCallback)
+    {
+        m_failCallback();
+    }
+}
+
+void iox::p3com::udp::UDPDataWorker::setupIoUring() noexcept
+{
+    m_sendRing = std::make_unique<iox::p3com::IoUring>();
+    if (!m_sendRing->initialize(MAX_SEND_BATCH_SIZE))
+    {
+        m_sendRing.reset();
+        return;
+    }
+
+    // Direct receiving peeks at every datagram before choosing its destination, which a multishot receive cannot do
+    if (!m_isDirectReceive)
+    {
+        m_receiveRing = std::make_unique<iox::p3com::IoUring>();
+        if (!m_receiveRing->initialize(IO_URING_ENTRY_COUNT)
+            || !m_receiveRing->receiveMultishot(m_dataSocket.native_handle(),
+                                                IO_URING_BUFFER_COUNT,
+                                                MAX_DATAGRAM_SIZE + IO_URING_BUFFER_HEADROOM))
+        {
+            iox::p3com::LogWarn() << "[UDPDataWorker] Multishot receives are not supported, receiving with recvmmsg";
+            m_receiveRing.reset();
+        }
+    }
+    iox::p3com::LogInfo() << "[UDPDataWorker] Worker " << m_workerIndex << " sends"
+                          << (m_receiveRing ? " and receives" : "") << " user data with io_uring";
+}
+
+void iox::p3com::udp::UDPDataWorker::ringReceiveLoop() noexcept
+{
+    const auto callback = [this](const void* data, size_t size, const struct sockaddr_in& address) {
+        dispatchUserData(
+            data, size, asio::ip::address_v4(ntohl(address.sin_addr.s_addr)), false, std::chrono::system_clock::now());
+    };
+
+    auto lastReceive = std::chrono::steady_clock::now();
+    while (m_isRingRunning.load() && m_isGood.load())
+    {
+        // Only peek at the completion queue while busy polling, otherwise wake up regularly to notice the shutdown
+        const bool isBusy = std::chrono::steady_clock::now() - lastReceive < m_busyPollBudget;
+        const int32_t count =
+            m_receiveRing->processReceived(callback, isBusy ? std::chrono::milliseconds(0) : IO_URING_WAIT_TIMEOUT);
+        if (count < 0)
+        {
+            fail();
+            break;
+        }
+        if (count > 0)
+        {
+            m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+            lastReceive = std::chrono::steady_clock::now();
+        }
+    }
+    iox::p3com::LogInfo() << "[UDPDataWorker] io_uring thread " << m_workerIndex << " has exited";
+}
+
+void iox::p3com::udp::UDPDataWorker::dataSocketCallback(asio::error_code ec, size_t bytes) noexcept
+{
+    if (ec)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << ec.message();
+        fail();
+        return;
+    }
+    m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+    dispatchUserData(
+        m_outputBuffer.data(), bytes, m_outputEndpoint.address(), false, std::chrono::system_clock::now());
+
+    dataAsyncReceive();
+}
+
+void iox::p3com::udp::UDPDataWorker::dataBatchCallback(asio::error_code ec) noexcept
+{
+    if (ec)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << ec.message();
+        fail();
+        return;
+    }
+    m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+
+    // The kernel overwrites the address and control lengths, so they need to be reset before every call
+    for (uint32_t i = 0U; i < m_receiveBatchSize; ++i)
+    {
+        auto& message = m_batchMessages[i];
+        message.msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        message.msg_hdr.msg_control = m_batchControls[i].data();
+        message.msg_hdr.msg_controllen = m_batchControls[i].size();
+        message.msg_hdr.msg_flags = 0;
+    }
+
+    const int received =
+        recvmmsg(m_dataSocket.native_handle(), m_batchMessages.data(), m_receiveBatchSize, MSG_DONTWAIT, nullptr);
+    if (received < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            iox::p3com::LogError() << "[UDPDataWorker] recvmmsg failed: " << std::strerror(errno);
+            fail();
+            return;
+        }
+    }
+
+    for (int i = 0; i < received; ++i)
+    {
+        const auto& message = m_batchMessages[static_cast<uint32_t>(i)];
+        if ((message.msg_hdr.msg_flags & MSG_TRUNC) != 0)
+        {
+            iox::p3com::LogError() << "[UDPDataWorker] Received truncated user data message! Discarding!";
+            continue;
+        }
+        const auto& sourceAddress = m_batchAddresses[static_cast<uint32_t>(i)];
+        dispatchUserData(m_batchIovecs[static_cast<uint32_t>(i)].iov_base,
+                         message.msg_len,
+                         asio::ip::address_v4(ntohl(sourceAddress.sin_addr.s_addr)),
+                         false,
+                         receiveTimestamp(message.msg_hdr));
+    }
+
+    dataAsyncReceiveBatch();
+}
+
+void iox::p3com::udp::UDPDataWorker::dataDirectCallback(asio::error_code ec) noexcept
+{
+    if (ec)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << ec.message();
+        fail();
+        return;
+    }
+    m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+
+    for (uint32_t i = 0U; i < m_receiveBatchSize && m_isGood.load(); ++i)
+    {
+        if (!receiveDirect())
+        {
+            break;
+        }
+    }
+
+    dataAsyncReceiveDirect();
+}
+
+bool iox::p3com::udp::UDPDataWorker::receiveDirect() noexcept
+{
+    using Action = ReceiveTarget_t::Action;
+    const int fd = m_dataSocket.native_handle();
+
+    // Peek at the serialized datagram header only, MSG_TRUNC makes the kernel report the size of the whole datagram
+    struct sockaddr_in sourceAddress{};
+    socklen_t sourceAddressSize = sizeof(sourceAddress);
+    const ssize_t datagramSize = recvfrom(fd,
+                                          m_outputBuffer.data(),
+                                          iox::p3com::maxIoxChunkDatagramHeaderSerializationSize(),
+                                          MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT,
+                                          reinterpret_cast<struct sockaddr*>(&sourceAddress),
+                                          &sourceAddressSize);
+    if (datagramSize < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            iox::p3com::LogError() << "[UDPDataWorker] recvfrom failed: " << std::strerror(errno);
+            fail();
+        }
+        return false;
+    }
+    const auto receiveTime = std::chrono::system_clock::now();
+    const asio::ip::address address = asio::ip::address_v4(ntohl(sourceAddress.sin_addr.s_addr));
+    const size_t peekedSize = std::min(static_cast<size_t>(datagramSize),
+                                       static_cast<size_t>(iox::p3com::maxIoxChunkDatagramHeaderSerializationSize()));
+
+    ReceiveTarget_t target;
+    if (m_receiveTargetCallback)
+    {
+        target = m_receiveTargetCallback(m_outputBuffer.data(), peekedSize, static_cast<size_t>(datagramSize), address);
+    }
+
+    std::array<struct iovec, 2U> iovecs{};
+    struct msghdr message{};
+    message.msg_iov = iovecs.data();
+    switch (target.action)
+    {
+    case Action::DIRECT:
+        iovecs[0] = {m_outputBuffer.data(), target.headerSize};
+        iovecs[1] = {target.data, static_cast<size_t>(datagramSize) - target.headerSize};
+        message.msg_iovlen = 2U;
+        break;
+    case Action::DISCARD:
+        // Receiving into an empty buffer drops the datagram
+        message.msg_iovlen = 0U;
+        break;
+    case Action::COPY:
+    default:
+        iovecs[0] = {m_outputBuffer.data(), m_outputBuffer.size()};
+        message.msg_iovlen = 1U;
+        break;
+    }
+
+    const ssize_t received = recvmsg(fd, &message, MSG_DONTWAIT);
+    if (received < 0)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] recvmsg failed: " << std::strerror(errno);
+        if (target.action == Action::DIRECT && m_receivedCallback)
+        {
+            m_receivedCallback(m_outputBuffer.data(), target.headerSize, false, target.deviceIndex);
+        }
+        fail();
+        return false;
+    }
+
+    if (target.action == Action::DIRECT)
+    {
+        m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_receivedBytes.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+        if (m_receivedCallback)
+        {
+            const bool isComplete = received == datagramSize && (message.msg_flags & MSG_TRUNC) == 0;
+            m_receivedCallback(m_outputBuffer.data(), target.headerSize, isComplete, target.deviceIndex);
+        }
+        m_receiveLatency.record(std::chrono::system_clock::now() - receiveTime);
+    }
+    else if (target.action == Action::COPY)
+    {
+        if ((message.msg_flags & MSG_TRUNC) != 0)
+        {
+            iox::p3com::LogError() << "[UDPDataWorker] Received truncated user data message! Discarding!";
+            return true;
+        }
+        dispatchUserData(m_outputBuffer.data(), static_cast<size_t>(received), address, false, receiveTime);
+    }
+    return true;
+}
+
+void iox::p3com::udp::UDPDataWorker::dataAsyncReceiveDirect() noexcept
+{
+    try
+    {
+        // Only wait for readiness here, every datagram is then peeked at and received by hand
+        m_dataSocket.async_wait(asio::ip::udp::socket::wait_read,
+                                [this](asio::error_code ec) { dataDirectCallback(ec); });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+        fail();
+    }
+}
+
+void iox::p3com::udp::UDPDataWorker::multicastSocketCallback(asio::error_code ec, size_t bytes) noexcept
+{
+    if (ec)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << ec.message();
+        fail();
+        return;
+    }
+    m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+    dispatchUserData(
+        m_multicastBuffer.data(), bytes, m_multicastEndpoint.address(), true, std::chrono::system_clock::now());
+
+    multicastAsyncReceive();
+}
+
+void iox::p3com::udp::UDPDataWorker::multicastAsyncReceive() noexcept
+{
+    try
+    {
+        m_multicastSocket.async_receive_from(
+            asio::buffer(m_multicastBuffer), m_multicastEndpoint, [this](asio::error_code ec, size_t bytes) {
+                multicastSocketCallback(ec, bytes);
+            });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+        fail();
+    }
+}
+
+void iox::p3com::udp::UDPDataWorker::joinGroup(const asio::ip::address& group) noexcept
+{
+    if (!m_multicastSocket.is_open())
+    {
+        return;
+    }
+
+    asio::error_code ec;
+    m_multicastSocket.set_option(asio::ip::multicast::join_group(group), ec);
+    if (ec)
+    {
+        iox::p3com::LogWarn() << "[UDPDataWorker] Could not join multicast group " << group.to_string() << ": "
+                              << ec.message();
+        return;
+    }
+    iox::p3com::LogInfo() << "[UDPDataWorker] Joined multicast group " << group.to_string();
+}
+
+void iox::p3com::udp::UDPDataWorker::leaveGroup(const asio::ip::address& group) noexcept
+{
+    if (!m_multicastSocket.is_open())
+    {
+        return;
+    }
+
+    asio::error_code ec;
+    m_multicastSocket.set_option(asio::ip::multicast::leave_group(group), ec);
+    if (ec)
+    {
+        iox::p3com::LogWarn() << "[UDPDataWorker] Could not leave multicast group " << group.to_string() << ": "
+                              << ec.message();
+        return;
+    }
+    iox::p3com::LogInfo() << "[UDPDataWorker] Left multicast group " << group.to_string();
+}
+
+void iox::p3com::udp::UDPDataWorker::dispatchUserData(const void* data,
+                                                      size_t size,
+                                                      const asio::ip::address& address,
+                                                      bool isMulticast,
+                                                      std::chrono::system_clock::time_point receiveTime) noexcept
+{
+    m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+    m_receivedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (m_dataCallback)
+    {
+        m_dataCallback(data, size, address, isMulticast);
+    }
+    m_receiveLatency.record(std::chrono::system_clock::now() - receiveTime);
+}
+
+std::chrono::system_clock::time_point
+iox::p3com::udp::UDPDataWorker::receiveTimestamp(const struct msghdr& message) noexcept
+{
+#if defined(SCM_TIMESTAMPNS)
+    // The kernel stamps the datagrams with CLOCK_REALTIME when they enter the network stack
+    for (const struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&message), const_cast<struct cmsghdr*>(cmsg)))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            struct timespec timestamp{};
+            std::memcpy(&timestamp, CMSG_DATA(cmsg), sizeof(timestamp));
+            const auto sinceEpoch = std::chrono::seconds(timestamp.tv_sec) + std::chrono::nanoseconds(timestamp.tv_nsec);
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceEpoch));
+        }
+    }
+#else
+    static_cast<void>(message);
+#endif
+    return std::chrono::system_clock::now();
+}
+
+void iox::p3com::udp::UDPDataWorker::dataAsyncReceive() noexcept
+{
+    try
+    {
+        m_dataSocket.async_receive_from(
+            asio::buffer(m_outputBuffer), m_outputEndpoint, [this](asio::error_code ec, size_t bytes) {
+                dataSocketCallback(ec, bytes);
+            });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+        fail();
+    }
+}
+
+void iox::p3com::udp::UDPDataWorker::dataAsyncReceiveBatch() noexcept
+{
+    try
+    {
+        // Only wait for readiness here, the datagrams are then drained with a single recvmmsg call
+        m_dataSocket.async_wait(asio::ip::udp::socket::wait_read,
+                                [this](asio::error_code ec) { dataBatchCallback(ec); });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+        fail();
+    }
+}
+
+uint32_t iox::p3com::udp::UDPDataWorker::send(const iox::p3com::UserDataSegment_t* segments,
+                                              uint32_t segmentCount,
+                                              const asio::ip::udp::endpoint& endpoint) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_sendSocketMutex);
+    uint32_t zeroCopySendCount = 0U;
+    return sendLocked(segments, segmentCount, endpoint, 0, zeroCopySendCount);
+}
+
+uint32_t iox::p3com::udp::UDPDataWorker::sendZeroCopy(const iox::p3com::UserDataSegment_t* segments,
+                                                      uint32_t segmentCount,
+                                                      const asio::ip::udp::endpoint& endpoint,
+                                                      uint64_t key) noexcept
+{
+    if (!m_zeroCopy)
+    {
+        const uint32_t sentCount = send(segments, segmentCount, endpoint);
+        m_zeroCopyCallback(key);
+        return sentCount;
+    }
+
+    // Pick up the completions of the previous sends, so that their chunks are released early under steady traffic
+    m_zeroCopy->drain(m_sendSocket.native_handle());
+
+    // The kernel references the sent memory until the send has completed, but the serialized datagram headers are
+    // only valid during this call, so they are kept in a copy. Its buffer is reused once the sends have completed.
+    size_t headerSize = 0U;
+    for (uint32_t i = 0U; i < segmentCount; ++i)
+    {
+        headerSize += segments[i].serializedDatagramHeaderSize;
+    }
+    auto headers = m_zeroCopy->acquireData();
+    headers.resize(headerSize);
+
+    uint32_t sentCount = 0U;
+    bool isTracked = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sendSocketMutex);
+        m_zeroCopySegments.assign(segments, segments + segmentCount);
+        size_t headerOffset = 0U;
+        for (auto& segment : m_zeroCopySegments)
+        {
+            std::memcpy(
+                &headers[headerOffset], segment.serializedDatagramHeader, segment.serializedDatagramHeaderSize);
+            segment.serializedDatagramHeader = &headers[headerOffset];
+            headerOffset += segment.serializedDatagramHeaderSize;
+        }
+
+        uint32_t zeroCopySendCount = 0U;
+        sentCount = sendLocked(m_zeroCopySegments.data(),
+                               segmentCount,
+                               endpoint,
+                               iox::p3com::ZeroCopyTracker::SEND_FLAG,
+                               zeroCopySendCount);
+        // The sends are numbered by the kernel in the order of the calls, so they have to be tracked under the lock
+        isTracked = m_zeroCopy->track(key, zeroCopySendCount, std::move(headers));
+        m_zeroCopySends.fetch_add(zeroCopySendCount, std::memory_order_relaxed);
+    }
+    if (!isTracked)
+    {
+        m_zeroCopyCallback(key);
+    }
+    return sentCount;
+}
+
+bool iox::p3com::udp::UDPDataWorker::isZeroCopy() const noexcept
+{
+    return m_zeroCopy != nullptr;
+}
+
+void iox::p3com::udp::UDPDataWorker::errorAsyncWait() noexcept
+{
+    try
+    {
+        // The completions of the zero-copy sends arrive on the error queue of the send socket
+        m_sendSocket.async_wait(asio::ip::udp::socket::wait_error, [this](asio::error_code ec) {
+            if (ec)
+            {
+                if (ec != asio::error::operation_aborted)
+                {
+                    iox::p3com::LogError() << "[UDPDataWorker] " << ec.message();
+                    fail();
+                }
+                return;
+            }
+            m_zeroCopy->drain(m_sendSocket.native_handle());
+            errorAsyncWait();
+        });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPDataWorker] " << e.what();
+        fail();
+    }
+}
+
+uint32_t iox::p3com::udp::UDPDataWorker::sendLocked(const iox::p3com::UserDataSegment_t* segments,
+                                                    uint32_t segmentCount,
+                                                    const asio::ip::udp::endpoint& endpoint,
+                                                    int flags,
+                                                    uint32_t& zeroCopySendCount) noexcept
+{
+    uint32_t sentCount = 0U;
+    while (sentCount < segmentCount && m_isGood.load())
+    {
+        const uint32_t remainingCount = segmentCount - sentCount;
+        if (m_segmentationOffload.load())
+        {
+            const uint32_t runLength = gsoRunLength(segments + sentCount, remainingCount);
+            if (runLength > 1U)
+            {
+                const auto result = sendSegmentsGso(segments + sentCount, runLength, endpoint, flags);
+                if (result == GsoResult::SENT)
+                {
+                    sentCount += runLength;
+                    if (flags != 0)
+                    {
+                        zeroCopySendCount++;
+                    }
+                    continue;
+                }
+                if (result == GsoResult::DROPPED)
+                {
+                    break;
+                }
+            }
+        }
+
+        const uint32_t batchSize = std::min(remainingCount, MAX_SEND_BATCH_SIZE);
+        const uint32_t sent = sendSegmentsMmsg(segments + sentCount, batchSize, endpoint, flags, zeroCopySendCount);
+        sentCount += sent;
+        if (sent < batchSize)
+        {
+            // The rest of the message has been dropped
+            break;
+        }
+    }
+    return sentCount;
+}
+
+uint32_t iox::p3com::udp::UDPDataWorker::gsoRunLength(const iox::p3com::UserDataSegment_t* segments,
+                                                      uint32_t segmentCount) const noexcept
+{
+    // The kernel splits the concatenated buffers into datagrams of equal size, only the last one can be shorter
+    const size_t segmentSize = segments[0].serializedDatagramHeaderSize + segments[0].userPayloadSize;
+    if (segmentSize > MAX_GSO_SEGMENT_SIZE)
+    {
+        // The datagrams must fit into the MTU of the path, larger ones are rejected by the kernel. They are only
+        // MTU-sized if the transport sizes them to the path MTU, not with a large configured MTU.
+        return 0U;
+    }
+    size_t totalSize = 0U;
+    uint32_t runLength = 0U;
+    const uint32_t maxRunLength = std::min(std::min(segmentCount, MAX_GSO_SEGMENT_COUNT), MAX_SEND_BATCH_SIZE);
+    while (runLength < maxRunLength)
+    {
+        const auto& segment = segments[runLength];
+        const size_t size = segment.serializedDatagramHeaderSize + segment.userPayloadSize;
+        if (size > segmentSize || totalSize + size > MAX_GSO_SIZE)
+        {
+            break;
+        }
+        totalSize += size;
+        runLength++;
+        if (size < segmentSize)
+        {
+            break;
+        }
+    }
+    return runLength;
+}
+
+iox::p3com::udp::UDPDataWorker::GsoResult
+iox::p3com::udp::UDPDataWorker::sendSegmentsGso(const iox::p3com::UserDataSegment_t* segments,
+                                                     uint32_t segmentCount,
+                                                     const asio::ip::udp::endpoint& endpoint,
+                                                     int flags) noexcept
+{
+#if defined(UDP_SEGMENT)
+    size_t totalSize = 0U;
+    for (uint32_t i = 0U; i < segmentCount; ++i)
+    {
+        m_sendIovecs[2U * i] = {const_cast<void*>(segments[i].serializedDatagramHeader),
+                                segments[i].serializedDatagramHeaderSize};
+        m_sendIovecs[2U * i + 1U] = {const_cast<void*>(segments[i].userPayload), segments[i].userPayloadSize};
+        totalSize += segments[i].serializedDatagramHeaderSize + segments[i].userPayloadSize;
+    }
+
+    std::array<char, CMSG_SPACE(sizeof(uint16_t))> control{};
+    struct msghdr message{};
+    message.msg_name = const_cast<struct sockaddr*>(endpoint.data());
+    message.msg_namelen = static_cast<socklen_t>(endpoint.size());
+    message.msg_iov = m_sendIovecs.data();
+    message.msg_iovlen = 2U * segmentCount;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const auto segmentSize =
+        static_cast<uint16_t>(segments[0].serializedDatagramHeaderSize + segments[0].userPayloadSize);
+    std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+
+    while (true)
+    {
+        const ssize_t sent = sendmsg(m_sendSocket.native_handle(), &message, flags);
+        m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+        if (sent >= 0)
+        {
+            m_sentMessages.fetch_add(segmentCount, std::memory_order_relaxed);
+            m_sentBytes.fetch_add(totalSize, std::memory_order_relaxed);
+            return GsoResult::SENT;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        {
+            if (waitWritable())
+            {
+                continue;
+            }
+            m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            return GsoResult::DROPPED;
+        }
+        if (errno == EMSGSIZE || errno == EINVAL || (errno == ENOBUFS && flags != 0))
+        {
+            // The datagrams exceed the path MTU or the kernel is out of memory for pinning the zero-copy pages, this
+            // is not a problem of the segmentation offload
+            return GsoResult::NOT_SENT;
+        }
+        break;
+    }
+
+    // Segmentation offload is not available for this socket or path, fall back to sendmmsg for good
+    iox::p3com::LogWarn() << "[UDPDataWorker] UDP segmentation offload failed, disabling it: " << std::strerror(errno);
+    m_segmentationOffload.store(false);
+#else
+    static_cast<void>(segments);
+    static_cast<void>(segmentCount);
+    static_cast<void>(endpoint);
+    static_cast<void>(flags);
+#endif
+    return GsoResult::NOT_SENT;
+}
+
+uint32_t iox::p3com::udp::UDPDataWorker::sendSegmentsMmsg(const iox::p3com::UserDataSegment_t* segments,
+                                                          uint32_t segmentCount,
+                                                          const asio::ip::udp::endpoint& endpoint,
+                                                          int flags,
+                                                          uint32_t& zeroCopySendCount) noexcept
+{
+    for (uint32_t i = 0U; i < segmentCount; ++i)
+    {
+        m_sendIovecs[2U * i] = {const_cast<void*>(segments[i].serializedDatagramHeader),
+                                segments[i].serializedDatagramHeaderSize};
+        m_sendIovecs[2U * i + 1U] = {const_cast<void*>(segments[i].userPayload), segments[i].userPayloadSize};
+
+        auto& message = m_sendMessages[i];
+        std::memset(&message, 0, sizeof(message));
+        message.msg_hdr.msg_name = const_cast<struct sockaddr*>(endpoint.data());
+        message.msg_hdr.msg_namelen = static_cast<socklen_t>(endpoint.size());
+        message.msg_hdr.msg_iov = &m_sendIovecs[2U * i];
+        message.msg_hdr.msg_iovlen = 2U;
+    }
+
+    uint32_t sentCount = 0U;
+    while (sentCount < segmentCount)
+    {
+        // The zero-copy sends are tracked by the send calls of the socket, so they never go through io_uring
+        const int sent = (m_sendRing && flags == 0)
+                             ? m_sendRing->sendMessages(
+                                 m_sendSocket.native_handle(), &m_sendMessages[sentCount], segmentCount - sentCount)
+                             : sendmmsg(m_sendSocket.native_handle(),
+                                        &m_sendMessages[sentCount],
+                                        segmentCount - sentCount,
+                                        flags);
+        m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+        if (sent < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                if (waitWritable())
+                {
+                    continue;
+                }
+                // The receiver does not keep up, drop the rest of the message but keep the transport running
+                m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+                break;
+            }
+            if (errno == ENOBUFS && flags != 0)
+            {
+                // Out of memory for pinning the pages of the zero-copy sends, copy the rest of the message
+                flags = 0;
+                continue;
+            }
+            if (errno == EMSGSIZE)
+            {
+                // The path MTU has shrunk below the datagram size, the rest of the message is lost
+                iox::p3com::LogWarn() << "[UDPDataWorker] User data message exceeds the path MTU, discarding!";
+                m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+                break;
+            }
+            iox::p3com::LogError() << "[UDPDataWorker] sendmmsg failed: " << std::strerror(errno);
+            fail();
+            break;
+        }
+
+        for (uint32_t i = sentCount; i < sentCount + static_cast<uint32_t>(sent); ++i)
+        {
+            m_sentBytes.fetch_add(m_sendMessages[i].msg_len, std::memory_order_relaxed);
+        }
+        m_sentMessages.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+        sentCount += static_cast<uint32_t>(sent);
+        if (flags != 0)
+        {
+            // Every message of the batch counts as a separate zero-copy send
+            zeroCopySendCount += static_cast<uint32_t>(sent);
+        }
+    }
+    return sentCount;
+}
+
+bool iox::p3com::udp::UDPDataWorker::waitWritable() noexcept
+{
+    // Wait for space in the send buffer explicitly, in case the socket was switched to non-blocking mode
+    struct pollfd pfd{};
+    pfd.fd = m_sendSocket.native_handle();
+    pfd.events = POLLOUT;
+    const int ready = poll(&pfd, 1U, static_cast<int>(SEND_TIMEOUT.count()));
+    if (ready <= 0)
+    {
+        iox::p3com::LogWarn() << "[UDPDataWorker] Timed out waiting for the send buffer, discarding user data!";
+        return false;
+    }
+    return true;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::udp::UDPDataWorker::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    stats.zeroCopySends = m_zeroCopySends.load(std::memory_order_relaxed);
+    stats.zeroCopyCopiedSends = m_zeroCopy ? m_zeroCopy->copiedSends() : 0U;
+    return stats;
+}
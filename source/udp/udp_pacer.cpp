@@ -0,0 +1,177 @@
+// Copyright 2023 NXP
+
+#include "p3com/internal/log/logging.hpp"
+
+#include "p3com/transport/udp/udp_pacer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+constexpr double iox::p3com::udp::UDPPacer::MIN_RATE;
+constexpr double iox::p3com::udp::UDPPacer::INITIAL_RATE_FRACTION;
+constexpr double iox::p3com::udp::UDPPacer::SLOW_START_FACTOR;
+constexpr double iox::p3com::udp::UDPPacer::INCREASE_FRACTION;
+constexpr double iox::p3com::udp::UDPPacer::LOSS_DECREASE_FACTOR;
+constexpr double iox::p3com::udp::UDPPacer::DELAY_DECREASE_FACTOR;
+constexpr size_t iox::p3com::udp::UDPPacer::MIN_BURST_SIZE;
+constexpr std::chrono::microseconds iox::p3com::udp::UDPPacer::BURST_DURATION;
+constexpr std::chrono::microseconds iox::p3com::udp::UDPPacer::DELAY_MARGIN;
+constexpr std::chrono::microseconds iox::p3com::udp::UDPPacer::MIN_ADAPTATION_PERIOD;
+
+iox::p3com::udp::UDPPacer::UDPPacer(const iox::p3com::UDPTransportConfig_t& config) noexcept
+    // The rate is configured in Mbit/s, but handled in bytes per second
+    : m_maxRate(std::max(static_cast<double>(config.maxRateMbps) * 125000.0, MIN_RATE))
+    , m_isAdaptive(config.reliability)
+{
+    iox::p3com::LogInfo() << "[UDPPacer] Pacing user data with at most " << config.maxRateMbps << " Mbit/s per device"
+                          << (m_isAdaptive ? ", adapted to the receiver feedback" : "");
+}
+
+void iox::p3com::udp::UDPPacer::initialize(Peer_t& peer, std::chrono::steady_clock::time_point now) const noexcept
+{
+    peer.rate = m_isAdaptive ? std::max(m_maxRate * INITIAL_RATE_FRACTION, MIN_RATE) : m_maxRate;
+    peer.tokens = static_cast<double>(peerBurstSize(peer));
+    peer.lastRefill = now;
+    peer.lastAdaptation = now;
+}
+
+size_t iox::p3com::udp::UDPPacer::peerBurstSize(const Peer_t& peer) noexcept
+{
+    const auto burstDuration = std::chrono::duration_cast<std::chrono::duration<double>>(BURST_DURATION);
+    return std::max(MIN_BURST_SIZE, static_cast<size_t>(peer.rate * burstDuration.count()));
+}
+
+void iox::p3com::udp::UDPPacer::acquire(uint32_t deviceIndex, size_t bytes) noexcept
+{
+    const auto delay = take(deviceIndex, bytes);
+    if (delay.count() > 0)
+    {
+        std::this_thread::sleep_for(delay);
+    }
+}
+
+void iox::p3com::udp::UDPPacer::consume(uint32_t deviceIndex, size_t bytes) noexcept
+{
+    static_cast<void>(take(deviceIndex, bytes));
+}
+
+std::chrono::nanoseconds iox::p3com::udp::UDPPacer::take(uint32_t deviceIndex, size_t bytes) noexcept
+{
+    std::chrono::nanoseconds delay{0};
+    if (deviceIndex >= MAX_DEVICE_COUNT)
+    {
+        return delay;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& peer = m_peers[deviceIndex];
+        const auto now = std::chrono::steady_clock::now();
+        if (peer.rate == 0.0)
+        {
+            initialize(peer, now);
+        }
+
+        // Refill the bucket, but never beyond a single burst
+        const std::chrono::duration<double> elapsed = now - peer.lastRefill;
+        peer.tokens = std::min(peer.tokens + peer.rate * elapsed.count(), static_cast<double>(peerBurstSize(peer)));
+        peer.lastRefill = now;
+
+        // Take the tokens right away, concurrent senders queue up behind the debt
+        peer.tokens -= static_cast<double>(bytes);
+        if (peer.tokens < 0.0)
+        {
+            delay = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::duration<double>(-peer.tokens / peer.rate));
+        }
+    }
+    return delay;
+}
+
+size_t iox::p3com::udp::UDPPacer::burstSize(uint32_t deviceIndex) const noexcept
+{
+    if (deviceIndex >= MAX_DEVICE_COUNT)
+    {
+        return MIN_BURST_SIZE;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto& peer = m_peers[deviceIndex];
+    return (peer.rate == 0.0) ? MIN_BURST_SIZE : peerBurstSize(peer);
+}
+
+void iox::p3com::udp::UDPPacer::feedback(uint32_t deviceIndex,
+                                         bool isLoss,
+                                         std::chrono::steady_clock::duration roundTripTime,
+                                         size_t bytes) noexcept
+{
+    if (!m_isAdaptive || deviceIndex >= MAX_DEVICE_COUNT)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& peer = m_peers[deviceIndex];
+    if (peer.rate == 0.0)
+    {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (roundTripTime.count() > 0)
+    {
+        // Only the queueing delay on the path is a congestion signal, not the time needed to send the message itself
+        const auto sendTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(bytes) / peer.rate));
+        const auto pathTime = std::max(roundTripTime - sendTime, std::chrono::steady_clock::duration::zero());
+        peer.minRoundTripTime = std::min(peer.minRoundTripTime, pathTime);
+        peer.smoothedRoundTripTime = (peer.smoothedRoundTripTime.count() == 0)
+                                         ? pathTime
+                                         : (7 * peer.smoothedRoundTripTime + pathTime) / 8;
+    }
+
+    // React at most once per round trip, so that a single congestion event does not shrink the rate repeatedly
+    const auto adaptationPeriod = std::max<std::chrono::steady_clock::duration>(peer.smoothedRoundTripTime,
+                                                                                 MIN_ADAPTATION_PERIOD);
+    if (now < peer.lastAdaptation + adaptationPeriod)
+    {
+        return;
+    }
+
+    const bool isDelayed = peer.minRoundTripTime != std::chrono::steady_clock::duration::max()
+                           && peer.smoothedRoundTripTime > 2 * peer.minRoundTripTime + DELAY_MARGIN;
+    const double previousRate = peer.rate;
+    if (isLoss || isDelayed)
+    {
+        peer.rate *= isLoss ? LOSS_DECREASE_FACTOR : DELAY_DECREASE_FACTOR;
+        peer.isSlowStart = false;
+    }
+    else if (peer.isSlowStart)
+    {
+        peer.rate *= SLOW_START_FACTOR;
+    }
+    else
+    {
+        peer.rate += m_maxRate * INCREASE_FRACTION;
+    }
+    peer.rate = std::min(std::max(peer.rate, MIN_RATE), m_maxRate);
+    peer.lastAdaptation = now;
+
+    if (peer.rate < previousRate)
+    {
+        iox::p3com::LogDebug() << "[UDPPacer] Reduced the send rate to device " << deviceIndex << " to "
+                               << static_cast<uint64_t>(peer.rate) << " B/s";
+    }
+}
+
+uint64_t iox::p3com::udp::UDPPacer::rate(uint32_t deviceIndex) const noexcept
+{
+    if (deviceIndex >= MAX_DEVICE_COUNT)
+    {
+        return 0U;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint64_t>(m_peers[deviceIndex].rate);
+}
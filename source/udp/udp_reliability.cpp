@@ -0,0 +1,756 @@
+// Copyright 2023 NXP
+
+#include "p3com/generic/serialization.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include "p3com/transport/udp/udp_reliability.hpp"
+
+#include "iceoryx_posh/mepoo/chunk_header.hpp"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+constexpr uint32_t iox::p3com::udp::UDPRangeList::MAX_RANGE_COUNT;
+constexpr uint16_t iox::p3com::udp::UDPReliability::FEEDBACK_PORT;
+constexpr uint32_t iox::p3com::udp::UDPReliability::FEEDBACK_MAGIC;
+constexpr uint32_t iox::p3com::udp::UDPReliability::MAX_NACK_RANGES;
+constexpr uint32_t iox::p3com::udp::UDPReliability::COMPLETED_HISTORY_SIZE;
+constexpr std::chrono::milliseconds iox::p3com::udp::UDPReliability::HELLO_PERIOD;
+constexpr uint32_t iox::p3com::udp::UDPReliability::MAX_RETAINED_MESSAGE_COUNT;
+constexpr uint32_t iox::p3com::udp::UDPReliability::MAX_TRACKED_MESSAGE_COUNT;
+constexpr size_t iox::p3com::udp::UDPReliability::FEEDBACK_HEADER_SIZE;
+constexpr size_t iox::p3com::udp::UDPReliability::MAX_FEEDBACK_SIZE;
+
+bool iox::p3com::udp::UDPRangeList::insert(Range_t range) noexcept
+{
+    // The ranges are kept sorted and disjoint, so merge the new range with all ranges it overlaps or touches
+    auto first =
+        std::lower_bound(m_ranges.begin(), m_ranges.end(), range.offset, [](const Range_t& r, uint32_t offset) {
+            return r.offset + r.size < offset;
+        });
+    auto last = first;
+    uint32_t end = range.offset + range.size;
+    while (last != m_ranges.end() && last->offset <= end)
+    {
+        range.offset = std::min(range.offset, last->offset);
+        end = std::max(end, last->offset + last->size);
+        ++last;
+    }
+    range.size = end - range.offset;
+
+    if (first != last)
+    {
+        // Replace the merged ranges by the new one and close the gap they leave behind
+        *first = range;
+        const auto newEnd = std::move(last, m_ranges.end(), first + 1);
+        while (m_ranges.end() != newEnd)
+        {
+            m_ranges.pop_back();
+        }
+        return true;
+    }
+
+    // Insert in place, the storage is fixed so the iterator stays valid
+    if (!m_ranges.push_back(range))
+    {
+        return false;
+    }
+    std::rotate(first, m_ranges.end() - 1, m_ranges.end());
+    return true;
+}
+
+bool iox::p3com::udp::UDPRangeList::isCovered(Range_t range) const noexcept
+{
+    return std::any_of(m_ranges.begin(), m_ranges.end(), [&range](const Range_t& r) {
+        return r.offset <= range.offset && r.offset + r.size >= range.offset + range.size;
+    });
+}
+
+uint32_t iox::p3com::udp::UDPRangeList::coveredSize() const noexcept
+{
+    uint32_t size = 0U;
+    for (const auto& r : m_ranges)
+    {
+        size += r.size;
+    }
+    return size;
+}
+
+uint32_t iox::p3com::udp::UDPRangeList::missingRanges(uint32_t totalSize,
+                                                      Range_t* ranges,
+                                                      uint32_t maxCount) const noexcept
+{
+    uint32_t count = 0U;
+    uint32_t position = 0U;
+    for (const auto& r : m_ranges)
+    {
+        if (r.offset > position && count < maxCount)
+        {
+            ranges[count++] = {position, r.offset - position};
+        }
+        position = r.offset + r.size;
+    }
+    if (position < totalSize && count < maxCount)
+    {
+        ranges[count++] = {position, totalSize - position};
+    }
+    return count;
+}
+
+uint32_t iox::p3com::udp::UDPRangeList::size() const noexcept
+{
+    return static_cast<uint32_t>(m_ranges.size());
+}
+
+const iox::p3com::udp::UDPRangeList::Range_t&
+iox::p3com::udp::UDPRangeList::operator[](uint32_t index) const noexcept
+{
+    return m_ranges[index];
+}
+
+iox::p3com::udp::UDPReliability::UDPReliability(asio::io_service& context,
+                                                iox::p3com::SocketDiscovery& discovery,
+                                                const iox::p3com::UDPTransportConfig_t& config,
+                                                sendCallback_t sendCallback,
+                                                failCallback_t failCallback) noexcept
+    : m_discovery(discovery)
+    , m_retransmitBudget(config.retransmitBudget)
+    , m_nackDelay(std::max(config.nackDelay, std::chrono::milliseconds(1U)))
+    , m_retentionTimeout(config.retentionTimeout)
+    , m_feedbackSocket(context)
+    , m_timer(context)
+    , m_sendCallback(std::move(sendCallback))
+    , m_failCallback(std::move(failCallback))
+{
+    try
+    {
+        m_feedbackSocket.open(asio::ip::udp::v4());
+        m_feedbackSocket.bind(asio::ip::udp::endpoint(asio::ip::address_v4::any(), FEEDBACK_PORT));
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPReliability] " << e.what();
+        m_failCallback();
+        return;
+    }
+
+    iox::p3com::LogInfo() << "[UDPReliability] Retransmitting lost submessages, NACK delay " << m_nackDelay.count()
+                          << " ms, retransmit budget " << m_retransmitBudget;
+    feedbackAsyncReceive();
+    timerAsyncWait();
+}
+
+void iox::p3com::udp::UDPReliability::registerReleaseCallback(releaseCallback_t callback) noexcept
+{
+    m_releaseCallback = std::move(callback);
+}
+
+void iox::p3com::udp::UDPReliability::registerFeedbackCallback(feedbackCallback_t callback) noexcept
+{
+    m_feedbackCallback = std::move(callback);
+}
+
+uint64_t iox::p3com::udp::UDPReliability::makeKey(uint32_t deviceIndex, iox::p3com::hash_t messageHash) noexcept
+{
+    return (static_cast<uint64_t>(deviceIndex) << 32U) | static_cast<uint64_t>(messageHash);
+}
+
+bool iox::p3com::udp::UDPReliability::retain(const iox::p3com::UserDataSegment_t* segments,
+                                             uint32_t segmentCount,
+                                             uint32_t deviceIndex) noexcept
+{
+    if (deviceIndex >= iox::p3com::MAX_DEVICE_COUNT || !m_isReliablePeer[deviceIndex].load(std::memory_order_relaxed))
+    {
+        // The device would never acknowledge the message
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    bool isComplete = false;
+
+    std::lock_guard<std::mutex> lock(m_retainedMutex);
+    RetainedMessage_t* message = nullptr;
+    for (uint32_t i = 0U; i < segmentCount; ++i)
+    {
+        iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+        iox::p3com::deserialize(datagramHeader,
+                                static_cast<const char*>(segments[i].serializedDatagramHeader),
+                                segments[i].serializedDatagramHeaderSize);
+        if (datagramHeader.userPayloadSize == 0U || datagramHeader.fecParityIndex != iox::p3com::FEC_DATA_INDEX)
+        {
+            // Only the user payload is kept pending and parity submessages are never retransmitted
+            continue;
+        }
+
+        if (message == nullptr)
+        {
+            const uint64_t key = makeKey(deviceIndex, datagramHeader.messageHash);
+            message = m_retainedMessages.find(key);
+            if (message == m_retainedMessages.end())
+            {
+                const bool emplaced = m_retainedMessages.emplace(
+                    key,
+                    iox::p3com::udp::UDPReliability::RetainedMessage_t{
+                        key, datagramHeader, nullptr, 0U, deviceIndex, 0U, false, now, now});
+                if (!emplaced)
+                {
+                    iox::p3com::LogWarn()
+                        << "[UDPReliability] Too many unacknowledged messages, sending without retransmissions!";
+                    return false;
+                }
+                message = m_retainedMessages.find(key);
+            }
+        }
+
+        const uint32_t offset = datagramHeader.submessageOffset;
+        const uint32_t size = datagramHeader.submessageSize;
+        const auto* bytes = static_cast<const uint8_t*>(segments[i].userPayload);
+        message->submessageSize = std::max(message->submessageSize, size);
+        if (offset >= datagramHeader.userHeaderSize && message->userPayload == nullptr)
+        {
+            message->userPayload = bytes - (offset - datagramHeader.userHeaderSize);
+        }
+        isComplete = isComplete
+                     || offset + size == datagramHeader.userHeaderSize + datagramHeader.userPayloadSize;
+    }
+
+    if (message == nullptr)
+    {
+        return false;
+    }
+    message->lastActivity = now;
+    message->isPending = isComplete;
+    return isComplete;
+}
+
+bool iox::p3com::udp::UDPReliability::accept(const void* data,
+                                             size_t size,
+                                             uint32_t deviceIndex,
+                                             const asio::ip::address& address) noexcept
+{
+    if (size < iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        return true;
+    }
+
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader, static_cast<const char*>(data), size);
+    if (datagramHeader.fecParityIndex != iox::p3com::FEC_DATA_INDEX)
+    {
+        // Parity submessages are not part of the message data, lost ones are never requested
+        return true;
+    }
+
+    const uint64_t key = makeKey(deviceIndex, datagramHeader.messageHash);
+    const uint32_t totalSize = datagramHeader.userHeaderSize + datagramHeader.userPayloadSize;
+    const Range_t range{datagramHeader.submessageOffset, datagramHeader.submessageSize};
+
+    bool isComplete = false;
+    bool isDuplicate = false;
+    {
+        std::lock_guard<std::mutex> lock(m_trackedMutex);
+        if (wasCompleted(key))
+        {
+            // The acknowledgment was probably lost, so send it again
+            isDuplicate = true;
+            isComplete = true;
+        }
+        else
+        {
+            auto* messageIt = m_trackedMessages.find(key);
+            if (messageIt == m_trackedMessages.end())
+            {
+                if (range.size == totalSize)
+                {
+                    isComplete = true;
+                }
+                else
+                {
+                    UDPRangeList receivedRanges;
+                    receivedRanges.insert(range);
+                    const bool emplaced = m_trackedMessages.emplace(
+                        key,
+                        iox::p3com::udp::UDPReliability::TrackedMessage_t{key,
+                                                                          datagramHeader.messageHash,
+                                                                          address,
+                                                                          totalSize,
+                                                                          receivedRanges,
+                                                                          0U,
+                                                                          std::chrono::steady_clock::now()});
+                    if (!emplaced)
+                    {
+                        iox::p3com::LogWarn()
+                            << "[UDPReliability] Too many incomplete messages, not tracking lost submessages!";
+                    }
+                }
+            }
+            else if (messageIt->receivedRanges.isCovered(range))
+            {
+                isDuplicate = true;
+            }
+            else if (!messageIt->receivedRanges.insert(range))
+            {
+                // Not recorded, so treat it as lost. It is requested again once the gaps before it are filled.
+                isDuplicate = true;
+            }
+            else
+            {
+                messageIt->lastActivity = std::chrono::steady_clock::now();
+                if (messageIt->receivedRanges.coveredSize() >= totalSize)
+                {
+                    m_trackedMessages.erase(messageIt);
+                    isComplete = true;
+                }
+            }
+
+            if (isComplete)
+            {
+                markCompleted(key);
+            }
+        }
+    }
+
+    if (isComplete)
+    {
+        sendFeedback(FeedbackType::ACK, datagramHeader.messageHash, nullptr, 0U, address);
+    }
+    return !isDuplicate;
+}
+
+void iox::p3com::udp::UDPReliability::markCompleted(uint64_t key) noexcept
+{
+    m_completedMessages[m_completedIndex] = key;
+    m_completedIndex = (m_completedIndex + 1U) % COMPLETED_HISTORY_SIZE;
+}
+
+bool iox::p3com::udp::UDPReliability::wasCompleted(uint64_t key) const noexcept
+{
+    return std::find(m_completedMessages.begin(), m_completedMessages.end(), key) != m_completedMessages.end();
+}
+
+void iox::p3com::udp::UDPReliability::sendFeedback(FeedbackType type,
+                                                   iox::p3com::hash_t messageHash,
+                                                   const Range_t* ranges,
+                                                   uint32_t rangeCount,
+                                                   const asio::ip::address& address) noexcept
+{
+    std::array<uint8_t, MAX_FEEDBACK_SIZE> buffer;
+    size_t offset = 0U;
+    const auto pushPrimitive = [&buffer, &offset](const auto& elem) noexcept {
+        std::memcpy(buffer.data() + offset, &elem, sizeof(elem));
+        offset += sizeof(elem);
+    };
+
+    rangeCount = std::min(rangeCount, MAX_NACK_RANGES);
+    pushPrimitive(FEEDBACK_MAGIC);
+    pushPrimitive(static_cast<uint8_t>(type));
+    pushPrimitive(rangeCount);
+    pushPrimitive(messageHash);
+    for (uint32_t i = 0U; i < rangeCount; ++i)
+    {
+        pushPrimitive(ranges[i].offset);
+        pushPrimitive(ranges[i].size);
+    }
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(m_feedbackSocketMutex);
+        m_feedbackSocket.send_to(asio::buffer(buffer.data(), offset), asio::ip::udp::endpoint(address, FEEDBACK_PORT));
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogWarn() << "[UDPReliability] Could not send feedback: " << e.what();
+    }
+}
+
+void iox::p3com::udp::UDPReliability::feedbackAsyncReceive() noexcept
+{
+    try
+    {
+        m_feedbackSocket.async_receive_from(
+            asio::buffer(m_feedbackBuffer), m_feedbackEndpoint, [this](asio::error_code ec, size_t bytes) {
+                feedbackSocketCallback(ec, bytes);
+            });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPReliability] " << e.what();
+        m_failCallback();
+    }
+}
+
+void iox::p3com::udp::UDPReliability::feedbackSocketCallback(asio::error_code ec, size_t bytes) noexcept
+{
+    if (ec)
+    {
+        iox::p3com::LogError() << "[UDPReliability] " << ec.message();
+        m_failCallback();
+        return;
+    }
+
+    size_t offset = 0U;
+    const auto loadPrimitive = [this, &offset, bytes](auto* elem) noexcept {
+        if (offset + sizeof(*elem) > bytes)
+        {
+            return false;
+        }
+        std::memcpy(elem, m_feedbackBuffer.data() + offset, sizeof(*elem));
+        offset += sizeof(*elem);
+        return true;
+    };
+
+    uint32_t magic{0U};
+    uint8_t type{0U};
+    uint32_t rangeCount{0U};
+    iox::p3com::hash_t messageHash{0U};
+    std::array<Range_t, MAX_NACK_RANGES> ranges;
+    bool isValid = loadPrimitive(&magic) && loadPrimitive(&type) && loadPrimitive(&rangeCount)
+                   && loadPrimitive(&messageHash) && magic == FEEDBACK_MAGIC && rangeCount <= MAX_NACK_RANGES;
+    for (uint32_t i = 0U; isValid && i < rangeCount; ++i)
+    {
+        isValid = loadPrimitive(&ranges[i].offset) && loadPrimitive(&ranges[i].size);
+    }
+
+    const auto index = m_discovery.getIndex(m_feedbackEndpoint.address());
+    if (!isValid)
+    {
+        iox::p3com::LogWarn() << "[UDPReliability] Received invalid feedback message! Discarding!";
+    }
+    else if (!index.has_value())
+    {
+        iox::p3com::LogWarn() << "[UDPReliability] Received feedback message from an unknown device! Discarding!";
+    }
+    else
+    {
+        // Any feedback shows that the device retransmits as well
+        confirmPeer(*index, m_feedbackEndpoint.address());
+        if (type == static_cast<uint8_t>(FeedbackType::ACK))
+        {
+            handleAck(*index, messageHash);
+        }
+        else if (type == static_cast<uint8_t>(FeedbackType::NACK))
+        {
+            handleNack(*index, messageHash, ranges.data(), rangeCount);
+        }
+        else if (type == static_cast<uint8_t>(FeedbackType::HELLO))
+        {
+            sendFeedback(FeedbackType::ACK, 0U, nullptr, 0U, m_feedbackEndpoint.address());
+        }
+    }
+
+    feedbackAsyncReceive();
+}
+
+void iox::p3com::udp::UDPReliability::handleAck(uint32_t deviceIndex, iox::p3com::hash_t messageHash) noexcept
+{
+    const void* userPayload = nullptr;
+    std::chrono::steady_clock::duration roundTripTime{std::chrono::steady_clock::duration::zero()};
+    size_t messageSize = 0U;
+    {
+        std::lock_guard<std::mutex> lock(m_retainedMutex);
+        auto* messageIt = m_retainedMessages.find(makeKey(deviceIndex, messageHash));
+        if (messageIt == m_retainedMessages.end())
+        {
+            return;
+        }
+        if (messageIt->isPending)
+        {
+            userPayload = messageIt->userPayload;
+        }
+        // The round trip time is ambiguous for retransmitted messages
+        if (messageIt->retransmitCount == 0U)
+        {
+            roundTripTime = std::chrono::steady_clock::now() - messageIt->sendTime;
+        }
+        messageSize = messageIt->datagramHeader.userHeaderSize + messageIt->datagramHeader.userPayloadSize;
+        m_retainedMessages.erase(messageIt);
+    }
+
+    if (m_feedbackCallback)
+    {
+        m_feedbackCallback(deviceIndex, false, roundTripTime, messageSize);
+    }
+
+    // The release callback locks the gateway mutexes, so it must not be called with m_retainedMutex held
+    if (userPayload != nullptr && m_releaseCallback)
+    {
+        m_releaseCallback(userPayload, deviceIndex, messageHash);
+    }
+}
+
+void iox::p3com::udp::UDPReliability::handleNack(uint32_t deviceIndex,
+                                                 iox::p3com::hash_t messageHash,
+                                                 const Range_t* ranges,
+                                                 uint32_t rangeCount) noexcept
+{
+    const void* userPayload = nullptr;
+    {
+        // The retransmission reads the retained message in place, so the lock is held while it is sent. The sending
+        // threads only wait for it when retaining the next message.
+        std::lock_guard<std::mutex> lock(m_retainedMutex);
+        auto* messageIt = m_retainedMessages.find(makeKey(deviceIndex, messageHash));
+        if (messageIt == m_retainedMessages.end())
+        {
+            return;
+        }
+        if (messageIt->retransmitCount >= m_retransmitBudget)
+        {
+            iox::p3com::LogWarn() << "[UDPReliability] Retransmit budget exhausted, releasing message!";
+            if (messageIt->isPending)
+            {
+                userPayload = messageIt->userPayload;
+            }
+            m_retainedMessages.erase(messageIt);
+        }
+        else
+        {
+            messageIt->retransmitCount++;
+            messageIt->lastActivity = std::chrono::steady_clock::now();
+            retransmit(*messageIt, ranges, rangeCount);
+        }
+    }
+
+    if (m_feedbackCallback)
+    {
+        m_feedbackCallback(deviceIndex, true, std::chrono::steady_clock::duration::zero(), 0U);
+    }
+
+    if (userPayload != nullptr && m_releaseCallback)
+    {
+        m_releaseCallback(userPayload, deviceIndex, messageHash);
+    }
+}
+
+void iox::p3com::udp::UDPReliability::retransmit(const RetainedMessage_t& message,
+                                                 const Range_t* ranges,
+                                                 uint32_t rangeCount) noexcept
+{
+    if (message.submessageSize == 0U || !message.isPending)
+    {
+        return;
+    }
+    // The chunk is only ever released from this thread, so the user payload and header stay valid while retransmitting
+    const auto* userHeader = static_cast<const uint8_t*>(
+        iox::mepoo::ChunkHeader::fromUserPayload(message.userPayload)->userHeader());
+
+    auto datagramHeader = message.datagramHeader;
+    const uint32_t userHeaderSize = datagramHeader.userHeaderSize;
+    const uint32_t totalSize = userHeaderSize + datagramHeader.userPayloadSize;
+
+    std::array<std::array<char, iox::p3com::maxIoxChunkDatagramHeaderSerializationSize()>,
+               iox::p3com::MAX_SEND_BATCH_SIZE>
+        serializedDatagramHeaders;
+    std::array<iox::p3com::UserDataSegment_t, iox::p3com::MAX_SEND_BATCH_SIZE> segments;
+    uint32_t segmentCount = 0U;
+    uint64_t retransmittedCount = 0U;
+
+    for (uint32_t i = 0U; i < rangeCount; ++i)
+    {
+        uint32_t offset = ranges[i].offset;
+        const uint32_t end = std::min(ranges[i].offset + ranges[i].size, totalSize);
+        while (offset < end)
+        {
+            // The user header and the user payload are split into submessages separately
+            const bool isUserHeader = offset < userHeaderSize;
+            const uint32_t regionStart = isUserHeader ? 0U : userHeaderSize;
+            const uint32_t regionEnd = isUserHeader ? userHeaderSize : totalSize;
+            const uint32_t submessageStart =
+                regionStart + ((offset - regionStart) / message.submessageSize) * message.submessageSize;
+            const uint32_t submessageSize = std::min(message.submessageSize, regionEnd - submessageStart);
+            offset = submessageStart + submessageSize;
+
+            const uint8_t* bytes = isUserHeader ? userHeader + submessageStart
+                                                : message.userPayload + (submessageStart - userHeaderSize);
+
+            datagramHeader.submessageOffset = submessageStart;
+            datagramHeader.submessageSize = submessageSize;
+            auto& serializedDatagramHeader = serializedDatagramHeaders[segmentCount];
+            const uint32_t serializedDatagramHeaderSize =
+                iox::p3com::serialize(datagramHeader, serializedDatagramHeader.data());
+            segments[segmentCount] = {
+                serializedDatagramHeader.data(), serializedDatagramHeaderSize, bytes, submessageSize};
+            segmentCount++;
+
+            if (segmentCount == iox::p3com::MAX_SEND_BATCH_SIZE)
+            {
+                m_sendCallback(segments.data(), segmentCount, message.deviceIndex);
+                retransmittedCount += segmentCount;
+                segmentCount = 0U;
+            }
+        }
+    }
+
+    if (segmentCount != 0U)
+    {
+        m_sendCallback(segments.data(), segmentCount, message.deviceIndex);
+        retransmittedCount += segmentCount;
+    }
+    m_retransmittedMessages.fetch_add(retransmittedCount, std::memory_order_relaxed);
+    iox::p3com::LogDebug() << "[UDPReliability] Retransmitted " << retransmittedCount << " submessages";
+}
+
+void iox::p3com::udp::UDPReliability::timerAsyncWait() noexcept
+{
+    try
+    {
+        m_timer.expires_from_now(m_nackDelay);
+        m_timer.async_wait([this](asio::error_code ec) { timerCallback(ec); });
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogError() << "[UDPReliability] " << e.what();
+        m_failCallback();
+    }
+}
+
+void iox::p3com::udp::UDPReliability::timerCallback(asio::error_code ec) noexcept
+{
+    if (ec)
+    {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    checkPeers(now);
+    checkTrackedMessages(now);
+    checkRetainedMessages(now);
+    timerAsyncWait();
+}
+
+void iox::p3com::udp::UDPReliability::confirmPeer(uint32_t deviceIndex, const asio::ip::address& address) noexcept
+{
+    if (deviceIndex < iox::p3com::MAX_DEVICE_COUNT && !m_isReliablePeer[deviceIndex].load(std::memory_order_relaxed))
+    {
+        iox::p3com::LogInfo() << "[UDPReliability] Retransmitting lost submessages to IP " << address.to_string()
+                              << " with index " << deviceIndex;
+        m_peerAddresses[deviceIndex] = address;
+        m_isReliablePeer[deviceIndex].store(true, std::memory_order_relaxed);
+    }
+}
+
+void iox::p3com::udp::UDPReliability::checkPeers(std::chrono::steady_clock::time_point now) noexcept
+{
+    const bool shouldSendHello = now - m_lastHello >= HELLO_PERIOD;
+    if (shouldSendHello)
+    {
+        m_lastHello = now;
+    }
+
+    for (uint32_t i = 0U; i < iox::p3com::MAX_DEVICE_COUNT; ++i)
+    {
+        const auto address = m_discovery.getAddress(i);
+        if (m_isReliablePeer[i].load(std::memory_order_relaxed)
+            && (!address.has_value() || *address != m_peerAddresses[i]))
+        {
+            // The device index has been given to another gateway, which has to answer again
+            m_isReliablePeer[i].store(false, std::memory_order_relaxed);
+        }
+        if (shouldSendHello && address.has_value() && !m_isReliablePeer[i].load(std::memory_order_relaxed))
+        {
+            sendFeedback(FeedbackType::HELLO, 0U, nullptr, 0U, *address);
+        }
+    }
+}
+
+void iox::p3com::udp::UDPReliability::checkTrackedMessages(std::chrono::steady_clock::time_point now) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_trackedMutex);
+
+    // Remove elements in reverse order, to maintain validity of the iterator.
+    for (auto it = m_trackedMessages.end(); it != m_trackedMessages.begin(); --it)
+    {
+        auto messageIt = it - 1;
+        if (now - messageIt->lastActivity < m_nackDelay)
+        {
+            continue;
+        }
+        if (messageIt->nackCount >= m_retransmitBudget)
+        {
+            iox::p3com::LogWarn() << "[UDPReliability] Submessages still missing after " << messageIt->nackCount
+                                  << " retransmission requests, giving up!";
+            m_trackedMessages.erase(messageIt);
+            continue;
+        }
+
+        // Request the gaps between the received ranges and the missing tail
+        std::array<Range_t, MAX_NACK_RANGES> missingRanges;
+        const uint32_t missingCount =
+            messageIt->receivedRanges.missingRanges(messageIt->totalSize, missingRanges.data(), MAX_NACK_RANGES);
+
+        sendFeedback(
+            FeedbackType::NACK, messageIt->messageHash, missingRanges.data(), missingCount, messageIt->address);
+        m_retransmitRequests.fetch_add(1U, std::memory_order_relaxed);
+        messageIt->nackCount++;
+        messageIt->lastActivity = now;
+    }
+}
+
+void iox::p3com::udp::UDPReliability::checkRetainedMessages(std::chrono::steady_clock::time_point now) noexcept
+{
+    iox::cxx::vector<Release_t, MAX_RETAINED_MESSAGE_COUNT> messagesToRelease;
+    {
+        std::lock_guard<std::mutex> lock(m_retainedMutex);
+
+        // Remove elements in reverse order, to maintain validity of the iterator.
+        for (auto it = m_retainedMessages.end(); it != m_retainedMessages.begin(); --it)
+        {
+            auto messageIt = it - 1;
+            if (now - messageIt->lastActivity >= m_retentionTimeout)
+            {
+                if (messageIt->isPending)
+                {
+                    messagesToRelease.push_back(
+                        {messageIt->userPayload, messageIt->deviceIndex, messageIt->datagramHeader.messageHash});
+                }
+                m_retainedMessages.erase(messageIt);
+            }
+        }
+    }
+
+    for (const auto& message : messagesToRelease)
+    {
+        if (m_releaseCallback)
+        {
+            m_releaseCallback(message.userPayload, message.deviceIndex, message.messageHash);
+        }
+    }
+}
+
+void iox::p3com::udp::UDPReliability::releaseAll() noexcept
+{
+    iox::cxx::vector<Release_t, MAX_RETAINED_MESSAGE_COUNT> messagesToRelease;
+    {
+        std::lock_guard<std::mutex> lock(m_retainedMutex);
+        for (auto& message : m_retainedMessages)
+        {
+            if (message.isPending)
+            {
+                messagesToRelease.push_back(
+                    {message.userPayload, message.deviceIndex, message.datagramHeader.messageHash});
+            }
+        }
+        m_retainedMessages.clear();
+    }
+
+    for (const auto& message : messagesToRelease)
+    {
+        if (m_releaseCallback)
+        {
+            m_releaseCallback(message.userPayload, message.deviceIndex, message.messageHash);
+        }
+    }
+}
+
+uint64_t iox::p3com::udp::UDPReliability::retransmittedMessages() const noexcept
+{
+    return m_retransmittedMessages.load(std::memory_order_relaxed);
+}
+
+uint64_t iox::p3com::udp::UDPReliability::retransmitRequests() const noexcept
+{
+    return m_retransmitRequests.load(std::memory_order_relaxed);
+}
@@ -1,5 +1,6 @@
 // Copyright 2023 NXP
 
+#include "p3com/generic/serialization.hpp"
 #include "p3com/generic/types.hpp"
 #include "p3com/internal/log/logging.hpp"
 #include "p3com/transport/transport.hpp"
@@ -8,38 +9,123 @@
 
 #include <asio.hpp>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
 #include <stdexcept>
 #include <thread>
 
+constexpr uint32_t iox::p3com::udp::UDPTransport::MAX_DATA_WORKER_COUNT;
+constexpr uint32_t iox::p3com::udp::UDPTransport::IP_UDP_HEADER_SIZE;
+constexpr uint32_t iox::p3com::udp::UDPTransport::DEFAULT_MTU;
+constexpr uint32_t iox::p3com::udp::UDPTransport::MIN_MTU;
+constexpr std::chrono::seconds iox::p3com::udp::UDPTransport::PATH_MTU_REFRESH_PERIOD;
+constexpr uint32_t iox::p3com::udp::UDPTransport::GROUP_DEVICE_INDEX_FLAG;
+constexpr uint32_t iox::p3com::udp::UDPTransport::MULTICAST_GROUP_BASE;
+constexpr uint32_t iox::p3com::udp::UDPTransport::MAX_PENDING_BUFFER_COUNT;
 
-iox::p3com::udp::UDPTransport::UDPTransport() noexcept
+iox::p3com::udp::UDPTransport::UDPTransport(const iox::p3com::UDPTransportConfig_t& config) noexcept
     : m_context()
-    , m_dataSocket(m_context, asio::ip::udp::endpoint(asio::ip::address_v4::any(), DATA_PORT))
-    , m_broadcast(m_context)
+    , m_discovery(iox::p3com::SocketDiscovery::acquire())
+    , m_configuredMtu(config.mtu)
+    , m_pathMtuTimer(m_context)
+    , m_zeroCopyThreshold(config.zeroCopyThreshold)
+    , m_isMulticast(config.multicast)
 {
-    try
+    if (config.pacing)
     {
-        // TODO: What are the best values for send and receive buffer sizes?
-        constexpr uint32_t SEND_BUFFER_SIZE = 16 * 1024 * 1024;
-        constexpr uint32_t RECEIVE_BUFFER_SIZE = 32 * 1024 * 1024;
-        m_dataSocket.set_option(asio::socket_base::send_buffer_size(SEND_BUFFER_SIZE));
-        m_dataSocket.set_option(asio::socket_base::receive_buffer_size(RECEIVE_BUFFER_SIZE));
+        m_pacer = std::make_unique<iox::p3com::udp::UDPPacer>(config);
     }
-    catch (std::exception& e)
+
+    // Set up the retransmissions first, since the workers start receiving right away
+    if (config.reliability)
+    {
+        m_reliability = std::make_unique<iox::p3com::udp::UDPReliability>(
+            m_context,
+            *m_discovery,
+            config,
+            [this](const iox::p3com::UserDataSegment_t* segments, uint32_t segmentCount, uint32_t deviceIndex) {
+                // The retransmissions are sent from the io thread, which must not wait for the pacer
+                sendSegments(segments, segmentCount, deviceIndex, iox::cxx::nullopt, false);
+            },
+            [this]() { setFailed(); });
+        m_reliability->registerReleaseCallback(
+            [this](const void* userPayload, uint32_t deviceIndex, iox::p3com::hash_t messageHash) {
+                releaseRetainedBuffer(userPayload, deviceIndex, messageHash);
+            });
+        if (m_pacer)
+        {
+            m_reliability->registerFeedbackCallback(
+                [this](uint32_t deviceIndex,
+                       bool isLoss,
+                       std::chrono::steady_clock::duration roundTripTime,
+                       size_t messageSize) { m_pacer->feedback(deviceIndex, isLoss, roundTripTime, messageSize); });
+        }
+    }
+
+    const uint32_t workerCount = std::min(std::max(config.dataWorkerCount, 1U), MAX_DATA_WORKER_COUNT);
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0U; i < workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<iox::p3com::udp::UDPDataWorker>(
+            i,
+            config,
+            [this](const void* data, size_t size, const asio::ip::address& address, bool isMulticast) {
+                dispatchUserData(data, size, address, isMulticast);
+            },
+            [this]() { setFailed(); },
+            [this](uint64_t key) { releaseBuffer(key); },
+            [this](const void* data, size_t size, size_t datagramSize, const asio::ip::address& address) {
+                return receiveTarget(data, size, datagramSize, address);
+            },
+            [this](const void* data, size_t size, bool isComplete, uint32_t deviceIndex) {
+                receivedDirect(data, size, isComplete, deviceIndex);
+            }));
+    }
+    iox::p3com::LogInfo() << "[UDPTransport] Using " << workerCount << " data plane workers with receive batch size "
+                          << config.receiveBatchSize;
+    if (m_configuredMtu != 0U)
+    {
+        iox::p3com::LogInfo() << "[UDPTransport] Sizing datagrams for a link MTU of " << m_configuredMtu;
+    }
+    else
+    {
+        refreshPathMtus();
+    }
+    if (m_isMulticast)
+    {
+        iox::p3com::LogInfo() << "[UDPTransport] Sending services with multiple subscribed devices over multicast";
+    }
+    if (m_zeroCopyThreshold != 0U && m_workers[0]->isZeroCopy())
+    {
+        iox::p3com::LogInfo() << "[UDPTransport] Sending user payloads of at least " << m_zeroCopyThreshold
+                              << " bytes with MSG_ZEROCOPY";
+    }
+    if (config.busyPollBudget.count() > 0)
+    {
+        iox::p3com::LogInfo() << "[UDPTransport] Busy polling for " << config.busyPollBudget.count()
+                              << " us after the last received data";
+    }
+    if (config.directReceive)
+    {
+        iox::p3com::LogInfo() << "[UDPTransport] Receiving user data straight into the loaned chunks";
+    }
+
+    if (!m_discovery->isGood())
     {
-        iox::p3com::LogError() << "[UDPTransport] " << e.what();
         setFailed();
-        return;
     }
 
+    // The retransmission feedback and the path MTU probes run on their own thread, so that they neither delay nor are
+    // delayed by the user data traffic
     m_thread = std::thread([this]() {
         try
         {
             m_work.emplace(m_context);
             m_context.run();
-
-            iox::p3com::LogInfo() << "[UDPTransport] Worker thread has exited";
+            iox::p3com::LogInfo() << "[UDPTransport] Feedback thread has exited";
         }
         catch (std::exception& e)
         {
@@ -48,46 +134,142 @@ iox::p3com::udp::UDPTransport::UDPTransport() noexcept
             return;
         }
     });
-
-    dataAsyncReceive();
 }
 
 iox::p3com::udp::UDPTransport::~UDPTransport()
 {
+    // The discovery outlives this transport if the TCP transport still uses it
+    m_discovery->unregisterDiscoveryCallback(iox::p3com::TransportType::UDP);
     m_work.reset();
     m_context.stop();
     m_thread.join();
+    // The workers have to be stopped before the discovery is released, since their threads look up the device indices
+    m_workers.clear();
+    if (m_reliability)
+    {
+        m_reliability->releaseAll();
+    }
 }
 
-void iox::p3com::udp::UDPTransport::dataSocketCallback(asio::error_code ec, size_t bytes) noexcept
+void iox::p3com::udp::UDPTransport::dispatchUserData(const void* data,
+                                                     size_t size,
+                                                     const asio::ip::address& address,
+                                                     bool isMulticast) noexcept
 {
-    if (ec)
+    iox::p3com::LogInfo() << "[UDPTransport] Received user data message from IP " << address.to_string();
+    if (isMulticast && !isSubscribed(data, size))
     {
-        iox::p3com::LogError() << "[UDPTransport] " << ec.message();
-        setFailed();
+        iox::p3com::LogDebug() << "[UDPTransport] Received multicast message of another service, discarding!";
         return;
     }
-    iox::p3com::LogInfo() << "[UDPTransport] Received user data message from IP "
-                        << m_outputEndpoint.address().to_string();
-    const auto index = m_broadcast.getIndex(m_outputEndpoint.address());
+    const auto index = m_discovery->getIndex(address);
     if (index.has_value())
     {
+        // The sender does not retain multicast messages, so their loss is not reported back
+        if (m_reliability && !isMulticast && !m_reliability->accept(data, size, *index, address))
+        {
+            iox::p3com::LogDebug() << "[UDPTransport] Received duplicate user data message, discarding!";
+            return;
+        }
         if (m_userDataCallback)
         {
-            m_userDataCallback(m_outputBuffer.data(), bytes, {iox::p3com::TransportType::UDP, *index});
+            m_userDataCallback(data, size, {iox::p3com::TransportType::UDP, *index});
         }
     }
     else
     {
         iox::p3com::LogError() << "[UDPTransport] Received user data message from an unknown device! Discarding!";
     }
+}
+
+bool iox::p3com::udp::UDPTransport::isSubscribed(const void* data, size_t size) noexcept
+{
+    if (size < iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        return false;
+    }
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader, static_cast<const char*>(data), size);
+    std::lock_guard<std::mutex> lock(m_groupMutex);
+    return std::find(m_subscribedServices.begin(), m_subscribedServices.end(), datagramHeader.serviceHash)
+           != m_subscribedServices.end();
+}
+
+iox::p3com::udp::UDPDataWorker::ReceiveTarget_t iox::p3com::udp::UDPTransport::receiveTarget(
+    const void* data, size_t size, size_t datagramSize, const asio::ip::address& address) noexcept
+{
+    using Action = iox::p3com::udp::UDPDataWorker::ReceiveTarget_t::Action;
+
+    // Everything which needs more than a plain copy of the user data is left to the regular receive path
+    if (!m_bufferNeededCallback || !m_bufferReleasedCallback
+        || size < iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        return {Action::COPY, nullptr, 0U};
+    }
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    const uint32_t headerSize = iox::p3com::deserialize(datagramHeader, static_cast<const char*>(data), size);
+    if (datagramHeader.fecGroupSize != 0U || datagramSize != headerSize + datagramHeader.submessageSize)
+    {
+        return {Action::COPY, nullptr, 0U};
+    }
+    const auto index = m_discovery->getIndex(address);
+    if (!index.has_value())
+    {
+        return {Action::COPY, nullptr, 0U};
+    }
 
-    dataAsyncReceive();
+    // The submessage must not write beyond the user header or the user payload of the loaned chunk
+    const uint64_t submessageEnd =
+        static_cast<uint64_t>(datagramHeader.submessageOffset) + datagramHeader.submessageSize;
+    const bool isUserHeader = datagramHeader.submessageOffset < datagramHeader.userHeaderSize;
+    const bool isValid = isUserHeader ? submessageEnd <= datagramHeader.userHeaderSize
+                                      : submessageEnd <= static_cast<uint64_t>(datagramHeader.userHeaderSize)
+                                                             + datagramHeader.userPayloadSize;
+    if (!isValid)
+    {
+        iox::p3com::LogError() << "[UDPTransport] Received invalid user data message! Discarding!";
+        return {Action::DISCARD, nullptr, 0U};
+    }
+
+    if (m_reliability && !m_reliability->accept(data, size, *index, address))
+    {
+        iox::p3com::LogDebug() << "[UDPTransport] Received duplicate user data message, discarding!";
+        return {Action::DISCARD, nullptr, 0U};
+    }
+
+    void* buffer = m_bufferNeededCallback(data, headerSize);
+    if (buffer == nullptr)
+    {
+        return {Action::DISCARD, nullptr, 0U};
+    }
+    const uint32_t offset = isUserHeader ? datagramHeader.submessageOffset
+                                         : datagramHeader.submessageOffset - datagramHeader.userHeaderSize;
+    return {Action::DIRECT, static_cast<uint8_t*>(buffer) + offset, headerSize, *index};
+}
+
+void iox::p3com::udp::UDPTransport::receivedDirect(const void* data,
+                                                   size_t size,
+                                                   bool isComplete,
+                                                   uint32_t deviceIndex) noexcept
+{
+    if (!isComplete)
+    {
+        iox::p3com::LogError() << "[UDPTransport] Could not receive user data message! Discarding!";
+    }
+    m_bufferReleasedCallback(data, size, !isComplete, {iox::p3com::TransportType::UDP, deviceIndex});
 }
 
 void iox::p3com::udp::UDPTransport::registerDiscoveryCallback(iox::p3com::remoteDiscoveryCallback_t callback) noexcept
 {
-    m_broadcast.registerDiscoveryCallback(callback);
+    m_discovery->registerDiscoveryCallback(
+        iox::p3com::TransportType::UDP,
+        [this, callback = std::move(callback)](const void* data, size_t size, iox::p3com::DeviceIndex_t deviceIndex) {
+            if (m_configuredMtu == 0U)
+            {
+                requestPathMtuProbe(deviceIndex.device);
+            }
+            callback(data, size, deviceIndex);
+        });
 }
 
 void iox::p3com::udp::UDPTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
@@ -95,57 +277,559 @@ void iox::p3com::udp::UDPTransport::registerUserDataCallback(iox::p3com::userDat
     m_userDataCallback = std::move(callback);
 }
 
-void iox::p3com::udp::UDPTransport::dataAsyncReceive() noexcept
+void iox::p3com::udp::UDPTransport::registerBufferSentCallback(iox::p3com::bufferSentCallback_t callback) noexcept
 {
-    try
+    m_bufferSentCallback = std::move(callback);
+}
+
+void iox::p3com::udp::UDPTransport::registerBufferNeededCallback(iox::p3com::bufferNeededCallback_t callback) noexcept
+{
+    m_bufferNeededCallback = std::move(callback);
+}
+
+void iox::p3com::udp::UDPTransport::registerBufferReleasedCallback(
+    iox::p3com::bufferReleasedCallback_t callback) noexcept
+{
+    m_bufferReleasedCallback = std::move(callback);
+}
+
+void iox::p3com::udp::UDPTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    m_discovery->sendBroadcast(data, size);
+}
+
+bool iox::p3com::udp::UDPTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    const iox::p3com::UserDataSegment_t segment{data1, size1, data2, size2};
+    return sendUserDataBatch(&segment, 1U, deviceIndex) != 0U;
+}
+
+uint32_t iox::p3com::udp::UDPTransport::sendUserDataBatch(const iox::p3com::UserDataSegment_t* segments,
+                                                          uint32_t segmentCount,
+                                                          uint32_t deviceIndex) noexcept
+{
+    if (segmentCount == 0U)
     {
-        m_dataSocket.async_receive_from(
-            asio::buffer(m_outputBuffer), m_outputEndpoint, [this](asio::error_code ec, size_t bytes) {
-                dataSocketCallback(ec, bytes);
-            });
+        return 0U;
     }
-    catch (std::exception& e)
+
+    if (m_zeroCopyThreshold != 0U && m_workers[0]->isZeroCopy() && segmentCount <= iox::p3com::MAX_SEND_BATCH_SIZE)
     {
-        iox::p3com::LogError() << "[UDPTransport] " << e.what();
-        setFailed();
+        const auto pendingCount = sendZeroCopy(segments, segmentCount, deviceIndex);
+        if (pendingCount.has_value())
+        {
+            return *pendingCount;
+        }
     }
+
+    // Retain the message before sending it, so that an early acknowledgment finds it. Multicast messages are not
+    // retransmitted, since the acknowledgments of all group members would have to be collected.
+    const bool isPending =
+        m_reliability && !isGroup(deviceIndex) && m_reliability->retain(segments, segmentCount, deviceIndex);
+    sendSegments(segments, segmentCount, deviceIndex, iox::cxx::nullopt);
+    return isPending ? 1U : 0U;
 }
 
-void iox::p3com::udp::UDPTransport::sendBroadcast(const void* data, size_t size) noexcept
+iox::cxx::optional<uint32_t> iox::p3com::udp::UDPTransport::sendZeroCopy(const iox::p3com::UserDataSegment_t* segments,
+                                                                         uint32_t segmentCount,
+                                                                         uint32_t deviceIndex) noexcept
 {
-    m_broadcast.sendBroadcast(data, size);
+    // Only the user data submessages reference the chunk, the FEC parity submessages are built in a buffer which is
+    // reused right after this call, so they are always copied
+    std::array<bool, iox::p3com::MAX_SEND_BATCH_SIZE> isUserData{};
+    bool hasUserData = false;
+    bool isLast = false;
+    iox::p3com::hash_t messageHash = 0U;
+    const void* userPayload = nullptr;
+    for (uint32_t i = 0U; i < segmentCount; ++i)
+    {
+        iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+        iox::p3com::deserialize(datagramHeader,
+                                static_cast<const char*>(segments[i].serializedDatagramHeader),
+                                segments[i].serializedDatagramHeaderSize);
+        isUserData[i] = datagramHeader.fecParityIndex == iox::p3com::FEC_DATA_INDEX
+                        && isZeroCopy(datagramHeader.userPayloadSize);
+        if (!isUserData[i])
+        {
+            continue;
+        }
+
+        hasUserData = true;
+        messageHash = datagramHeader.messageHash;
+        const uint32_t offset = datagramHeader.submessageOffset;
+        if (userPayload == nullptr && offset >= datagramHeader.userHeaderSize)
+        {
+            userPayload =
+                static_cast<const uint8_t*>(segments[i].userPayload) - (offset - datagramHeader.userHeaderSize);
+        }
+        isLast = isLast
+                 || offset + datagramHeader.submessageSize
+                        == datagramHeader.userHeaderSize + datagramHeader.userPayloadSize;
+    }
+    if (!hasUserData)
+    {
+        return iox::cxx::nullopt;
+    }
+
+    // The entry holds the chunk until the last submessage has been handed over to the kernel, the zero-copy sends
+    // and the retransmissions hold it further until they are done
+    const uint64_t key = bufferKey(deviceIndex, messageHash);
+    const bool isReliable = m_reliability && !isGroup(deviceIndex);
+    {
+        std::lock_guard<std::mutex> lock(m_pendingBufferMutex);
+        auto* buffer = m_pendingBuffers.find(key);
+        if (buffer == m_pendingBuffers.end())
+        {
+            if (!m_pendingBuffers.emplace(key, PendingBuffer_t{userPayload, 1U}))
+            {
+                iox::p3com::LogWarn() << "[UDPTransport] Too many zero-copy messages in flight, copying!";
+                return iox::cxx::nullopt;
+            }
+            buffer = m_pendingBuffers.find(key);
+        }
+        else if (buffer->userPayload == nullptr)
+        {
+            buffer->userPayload = userPayload;
+        }
+        if (isLast && isReliable)
+        {
+            // Hold it for the retransmissions before retaining, so that an early acknowledgment finds the hold
+            buffer->holdCount++;
+        }
+    }
+    if (isReliable)
+    {
+        const bool isRetained = m_reliability->retain(segments, segmentCount, deviceIndex);
+        if (isLast && !isRetained)
+        {
+            // No retransmissions possible, drop their hold again
+            releaseBuffer(key);
+        }
+    }
+
+    uint32_t begin = 0U;
+    while (begin < segmentCount)
+    {
+        uint32_t end = begin + 1U;
+        while (end < segmentCount && isUserData[end] == isUserData[begin])
+        {
+            end++;
+        }
+        sendSegments(segments + begin,
+                     end - begin,
+                     deviceIndex,
+                     isUserData[begin] ? iox::cxx::optional<uint64_t>(key) : iox::cxx::nullopt);
+        begin = end;
+    }
+
+    if (isLast)
+    {
+        releaseBuffer(key);
+        return 1U;
+    }
+    return 0U;
 }
 
-bool iox::p3com::udp::UDPTransport::sendUserData(
-    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+uint64_t iox::p3com::udp::UDPTransport::bufferKey(uint32_t deviceIndex, iox::p3com::hash_t messageHash) noexcept
 {
-    auto endpoint = m_broadcast.getEndpoint(deviceIndex);
-    endpoint.port(DATA_PORT);
-    try
+    return (static_cast<uint64_t>(deviceIndex) << 32U) | static_cast<uint64_t>(messageHash);
+}
+
+bool iox::p3com::udp::UDPTransport::isZeroCopy(size_t userPayloadSize) const noexcept
+{
+    return m_zeroCopyThreshold != 0U && userPayloadSize >= m_zeroCopyThreshold && m_workers[0]->isZeroCopy();
+}
+
+void iox::p3com::udp::UDPTransport::holdBuffer(uint64_t key) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_pendingBufferMutex);
+    auto* buffer = m_pendingBuffers.find(key);
+    if (buffer != m_pendingBuffers.end())
     {
-        constexpr uint32_t BUFFER_COUNT = 2U;
-        std::array<asio::const_buffer, BUFFER_COUNT> buffers{asio::const_buffer{data1, size1},
-                                                             asio::const_buffer{data2, size2}};
-        std::lock_guard<std::mutex> lock(m_socketMutex);
-        m_dataSocket.send_to(buffers, endpoint);
+        buffer->holdCount++;
+    }
+}
 
-        iox::p3com::LogInfo() << "[UDPTransport] Sent user data message to IP " << endpoint.address().to_string()
-                            << " with index " << deviceIndex;
+void iox::p3com::udp::UDPTransport::releaseBuffer(uint64_t key) noexcept
+{
+    const void* userPayload = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingBufferMutex);
+        auto* buffer = m_pendingBuffers.find(key);
+        if (buffer == m_pendingBuffers.end())
+        {
+            return;
+        }
+        buffer->holdCount--;
+        if (buffer->holdCount != 0U)
+        {
+            return;
+        }
+        userPayload = buffer->userPayload;
+        m_pendingBuffers.erase(buffer);
     }
-    catch (std::exception& e)
+
+    // The buffer sent callback locks the gateway mutexes, so it must not be called with m_pendingBufferMutex held
+    if (userPayload != nullptr && m_bufferSentCallback)
     {
-        iox::p3com::LogError() << "[UDPTransport] " << e.what();
-        setFailed();
+        m_bufferSentCallback(userPayload);
+    }
+}
+
+void iox::p3com::udp::UDPTransport::releaseRetainedBuffer(const void* userPayload,
+                                                          uint32_t deviceIndex,
+                                                          iox::p3com::hash_t messageHash) noexcept
+{
+    const uint64_t key = bufferKey(deviceIndex, messageHash);
+    bool isZeroCopy = false;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingBufferMutex);
+        isZeroCopy = m_pendingBuffers.find(key) != m_pendingBuffers.end();
+    }
+
+    // Messages sent with MSG_ZEROCOPY are only released once the kernel has completed the sends as well
+    if (isZeroCopy)
+    {
+        releaseBuffer(key);
+    }
+    else if (m_bufferSentCallback)
+    {
+        m_bufferSentCallback(userPayload);
+    }
+}
+
+uint32_t iox::p3com::udp::UDPTransport::sendSegments(const iox::p3com::UserDataSegment_t* segments,
+                                                     uint32_t segmentCount,
+                                                     uint32_t deviceIndex,
+                                                     iox::cxx::optional<uint64_t> zeroCopyKey,
+                                                     bool mayWait) noexcept
+{
+    const auto endpoint = dataEndpoint(deviceIndex);
+    const uint32_t worker = workerIndex(segments[0], deviceIndex);
+    const auto sendToWorker = [&](const iox::p3com::UserDataSegment_t* workerSegments, uint32_t workerSegmentCount) {
+        if (!zeroCopyKey.has_value())
+        {
+            return m_workers[worker]->send(workerSegments, workerSegmentCount, endpoint);
+        }
+        // Every zero-copy send holds the chunk until the worker reports its completion
+        holdBuffer(*zeroCopyKey);
+        return m_workers[worker]->sendZeroCopy(workerSegments, workerSegmentCount, endpoint, *zeroCopyKey);
+    };
+    uint32_t sentCount = 0U;
+    if (m_pacer && mayWait)
+    {
+        // Hand the submessages over to the socket in bursts, each one only after the pacer has released it
+        const size_t burstSize = m_pacer->burstSize(deviceIndex);
+        while (sentCount < segmentCount)
+        {
+            uint32_t burstCount = 0U;
+            size_t burstBytes = 0U;
+            while (sentCount + burstCount < segmentCount)
+            {
+                const auto& segment = segments[sentCount + burstCount];
+                const size_t size = segment.serializedDatagramHeaderSize + segment.userPayloadSize;
+                if (burstCount != 0U && burstBytes + size > burstSize)
+                {
+                    break;
+                }
+                burstBytes += size;
+                burstCount++;
+            }
+
+            m_pacer->acquire(deviceIndex, burstBytes);
+            const uint32_t sent = sendToWorker(segments + sentCount, burstCount);
+            sentCount += sent;
+            if (sent < burstCount)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        sentCount = sendToWorker(segments, segmentCount);
+        if (m_pacer)
+        {
+            // Charge the data to the budget of the device, so that the following sends make up for it
+            size_t sentBytes = 0U;
+            for (uint32_t i = 0U; i < sentCount; ++i)
+            {
+                sentBytes += segments[i].serializedDatagramHeaderSize + segments[i].userPayloadSize;
+            }
+            m_pacer->consume(deviceIndex, sentBytes);
+        }
+    }
+    if (sentCount < segmentCount && m_configuredMtu == 0U && !isGroup(deviceIndex))
+    {
+        // The path MTU may have shrunk, so that the datagrams were rejected, probe it again for the next message
+        requestPathMtuProbe(deviceIndex);
+    }
+
+    iox::p3com::LogInfo() << "[UDPTransport] Sent " << sentCount << " user data messages to IP "
+                          << endpoint.address().to_string() << " with index " << deviceIndex << " from worker "
+                          << worker;
+    return sentCount;
+}
+
+asio::ip::udp::endpoint iox::p3com::udp::UDPTransport::dataEndpoint(uint32_t deviceIndex) noexcept
+{
+    if (isGroup(deviceIndex))
+    {
+        const asio::ip::address_v4 group(MULTICAST_GROUP_BASE | (deviceIndex & 0xFFFFU));
+        return asio::ip::udp::endpoint(group, iox::p3com::udp::UDPDataWorker::MULTICAST_PORT);
+    }
+
+    auto endpoint = m_discovery->getEndpoint(deviceIndex);
+    endpoint.port(iox::p3com::udp::UDPDataWorker::DATA_PORT);
+    return endpoint;
+}
+
+uint32_t iox::p3com::udp::UDPTransport::groupOf(const iox::capro::ServiceDescription::ClassHash& serviceHash) noexcept
+{
+    // Fold the service hash into the 16 bits of the group address, every gateway derives the same group for a service.
+    // Distinct services may end up in the same group, their receivers drop the datagrams of the other services.
+    // The mapping is part of the wire format, and the 239.255.0.0/16 scope has no more than 16 bits.
+    uint32_t hash = 0U;
+    for (uint32_t i = 0U; i < iox::capro::CLASS_HASH_ELEMENT_COUNT; ++i)
+    {
+        hash = hash * 31U + serviceHash[i];
+    }
+    hash ^= hash >> 16U;
+    // Avoid the all-zero and all-one host parts
+    const uint32_t group = hash & 0xFFFFU;
+    return (group == 0U || group == 0xFFFFU) ? 1U : group;
+}
+
+bool iox::p3com::udp::UDPTransport::isGroup(uint32_t deviceIndex) noexcept
+{
+    return (deviceIndex & GROUP_DEVICE_INDEX_FLAG) != 0U;
+}
+
+iox::cxx::optional<uint32_t> iox::p3com::udp::UDPTransport::groupDeviceIndex(
+    const iox::capro::ServiceDescription::ClassHash& serviceHash) const noexcept
+{
+    if (!m_isMulticast)
+    {
+        return iox::cxx::nullopt;
+    }
+    return GROUP_DEVICE_INDEX_FLAG | groupOf(serviceHash);
+}
+
+void iox::p3com::udp::UDPTransport::setSubscribedServices(const iox::p3com::ServiceVector_t& services) noexcept
+{
+    if (!m_isMulticast)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> groups;
+    std::vector<iox::capro::ServiceDescription::ClassHash> subscribedServices;
+    groups.reserve(services.size());
+    subscribedServices.reserve(services.size());
+    for (const auto& service : services)
+    {
+        groups.push_back(groupOf(service.getClassHash()));
+        subscribedServices.push_back(service.getClassHash());
+    }
+    std::sort(groups.begin(), groups.end());
+    groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+
+    std::lock_guard<std::mutex> lock(m_groupMutex);
+    for (const auto group : m_joinedGroups)
+    {
+        if (!std::binary_search(groups.begin(), groups.end(), group))
+        {
+            m_workers[0]->leaveGroup(asio::ip::address_v4(MULTICAST_GROUP_BASE | group));
+        }
+    }
+    for (const auto group : groups)
+    {
+        if (!std::binary_search(m_joinedGroups.begin(), m_joinedGroups.end(), group))
+        {
+            m_workers[0]->joinGroup(asio::ip::address_v4(MULTICAST_GROUP_BASE | group));
+        }
+    }
+    m_joinedGroups = std::move(groups);
+    m_subscribedServices = std::move(subscribedServices);
+}
+
+uint32_t iox::p3com::udp::UDPTransport::workerIndex(const iox::p3com::UserDataSegment_t& segment,
+                                                    uint32_t deviceIndex) const noexcept
+{
+    if (m_workers.size() == 1U)
+    {
+        return 0U;
     }
-    return false;
+
+    // Shard by peer and service, so that all messages of one service to one peer leave through the same socket and
+    // thus stay in order, also on the receiving side
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    iox::p3com::deserialize(datagramHeader,
+                            static_cast<const char*>(segment.serializedDatagramHeader),
+                            segment.serializedDatagramHeaderSize);
+    uint32_t hash = deviceIndex;
+    for (uint32_t i = 0U; i < iox::capro::CLASS_HASH_ELEMENT_COUNT; ++i)
+    {
+        hash = hash * 31U + datagramHeader.serviceHash[i];
+    }
+    return hash % static_cast<uint32_t>(m_workers.size());
+}
+
+bool iox::p3com::udp::UDPTransport::willBePending(size_t userPayloadSize) const noexcept
+{
+    // With retransmissions enabled, the chunk is kept until the receiver has acknowledged the message, with zero-copy
+    // sends until the kernel does not reference it anymore
+    return userPayloadSize != 0U && (m_reliability || isZeroCopy(userPayloadSize));
 }
 
-size_t iox::p3com::udp::UDPTransport::maxMessageSize() const noexcept
+bool iox::p3com::udp::UDPTransport::mayDropSubmessages() const noexcept
 {
-    return MAX_DATAGRAM_SIZE;
+    return true;
+}
+
+size_t iox::p3com::udp::UDPTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    // Size the datagrams so that they are not split into IP fragments, a single lost fragment would drop the whole
+    // datagram
+    const uint32_t mtu = (m_configuredMtu != 0U) ? m_configuredMtu : pathMtu(deviceIndex);
+    const size_t datagramSize = std::max(mtu, MIN_MTU) - IP_UDP_HEADER_SIZE;
+    return std::min(datagramSize, iox::p3com::udp::UDPDataWorker::MAX_DATAGRAM_SIZE);
+}
+
+uint32_t iox::p3com::udp::UDPTransport::pathMtu(uint32_t deviceIndex) const noexcept
+{
+    if (deviceIndex >= MAX_DEVICE_COUNT)
+    {
+        return DEFAULT_MTU;
+    }
+    const uint32_t mtu = m_pathMtus[deviceIndex].mtu.load(std::memory_order_relaxed);
+    return (mtu != 0U) ? mtu : DEFAULT_MTU;
+}
+
+void iox::p3com::udp::UDPTransport::requestPathMtuProbe(uint32_t deviceIndex) noexcept
+{
+    // Probing needs a few system calls, so it is done by the io thread, and only once for all requests meanwhile
+    if (deviceIndex >= MAX_DEVICE_COUNT || m_pathMtus[deviceIndex].isProbePending.exchange(true))
+    {
+        return;
+    }
+    m_context.post([this, deviceIndex]() {
+        m_pathMtus[deviceIndex].isProbePending.store(false);
+        updatePathMtu(deviceIndex);
+    });
+}
+
+void iox::p3com::udp::UDPTransport::updatePathMtu(uint32_t deviceIndex) noexcept
+{
+    const auto address = m_discovery->getAddress(deviceIndex);
+    if (!address.has_value())
+    {
+        return;
+    }
+    const uint32_t mtu = probePathMtu(*address);
+    if (m_pathMtus[deviceIndex].mtu.exchange(mtu, std::memory_order_relaxed) != mtu)
+    {
+        iox::p3com::LogInfo() << "[UDPTransport] Path MTU to IP " << address->to_string() << " is " << mtu;
+    }
+}
+
+void iox::p3com::udp::UDPTransport::refreshPathMtus() noexcept
+{
+    // Only the devices which have been probed before, i.e. which have been discovered
+    for (uint32_t i = 0U; i < MAX_DEVICE_COUNT; ++i)
+    {
+        if (m_pathMtus[i].mtu.load(std::memory_order_relaxed) != 0U)
+        {
+            updatePathMtu(i);
+        }
+    }
+    m_pathMtuTimer.expires_from_now(PATH_MTU_REFRESH_PERIOD);
+    m_pathMtuTimer.async_wait([this](asio::error_code ec) {
+        if (!ec)
+        {
+            refreshPathMtus();
+        }
+    });
+}
+
+uint32_t iox::p3com::udp::UDPTransport::probePathMtu(const asio::ip::address& address) noexcept
+{
+#if defined(IP_MTU) && defined(IP_MTU_DISCOVER)
+    // A connected socket with path MTU discovery enabled reports the MTU of the route to the peer, which the kernel
+    // lowers whenever an ICMP "fragmentation needed" message arrives for datagrams with the DF bit set
+    uint32_t mtu = DEFAULT_MTU;
+    try
+    {
+        asio::io_service context;
+        asio::ip::udp::socket socket(context, asio::ip::udp::v4());
+        const int discover = IP_PMTUDISC_DO;
+        if (setsockopt(socket.native_handle(), IPPROTO_IP, IP_MTU_DISCOVER, &discover, sizeof(discover)) != 0)
+        {
+            throw std::runtime_error(std::strerror(errno));
+        }
+        socket.connect(asio::ip::udp::endpoint(address, iox::p3com::udp::UDPDataWorker::DATA_PORT));
+
+        int value = 0;
+        socklen_t length = sizeof(value);
+        if (getsockopt(socket.native_handle(), IPPROTO_IP, IP_MTU, &value, &length) != 0)
+        {
+            throw std::runtime_error(std::strerror(errno));
+        }
+        mtu = static_cast<uint32_t>(value);
+    }
+    catch (std::exception& e)
+    {
+        iox::p3com::LogWarn() << "[UDPTransport] Could not probe the path MTU, assuming " << DEFAULT_MTU << ": "
+                              << e.what();
+    }
+    return mtu;
+#else
+    static_cast<void>(address);
+    return DEFAULT_MTU;
+#endif
 }
 
 iox::p3com::TransportType iox::p3com::udp::UDPTransport::getType() const noexcept
 {
     return iox::p3com::TransportType::UDP;
 }
+
+iox::p3com::TransportStatistics_t iox::p3com::udp::UDPTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    iox::p3com::LatencyHistogram::Counts_t latencyCounts{};
+    for (const auto& worker : m_workers)
+    {
+        const auto workerStats = worker->getStatistics();
+        stats.receivedMessages += workerStats.receivedMessages;
+        stats.receivedBytes += workerStats.receivedBytes;
+        stats.receiveWakeups += workerStats.receiveWakeups;
+        stats.sentMessages += workerStats.sentMessages;
+        stats.sentBytes += workerStats.sentBytes;
+        stats.sendCalls += workerStats.sendCalls;
+        stats.droppedMessages += workerStats.droppedMessages;
+        stats.zeroCopySends += workerStats.zeroCopySends;
+        stats.zeroCopyCopiedSends += workerStats.zeroCopyCopiedSends;
+        const auto workerLatencyCounts = worker->receiveLatencyCounts();
+        for (uint32_t i = 0U; i < iox::p3com::LatencyHistogram::BUCKET_COUNT; ++i)
+        {
+            latencyCounts[i] += workerLatencyCounts[i];
+        }
+    }
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    if (m_reliability)
+    {
+        stats.retransmittedMessages = m_reliability->retransmittedMessages();
+        stats.retransmitRequests = m_reliability->retransmitRequests();
+    }
+    if (m_pacer)
+    {
+        for (uint32_t i = 0U; i < iox::p3com::MAX_DEVICE_COUNT; ++i)
+        {
+            stats.sendRates[i] = m_pacer->rate(i);
+        }
+    }
+    return stats;
+}
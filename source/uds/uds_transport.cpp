@@ -0,0 +1,704 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/uds/uds_transport.hpp"
+#include "p3com/generic/serialization.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+constexpr uint32_t iox::p3com::uds::UDSTransport::MAX_NAME_LENGTH;
+constexpr uint32_t iox::p3com::uds::UDSTransport::MAX_DISCOVERY_SIZE;
+constexpr uint32_t iox::p3com::uds::UDSTransport::SEND_BUFFER_OVERHEAD;
+constexpr uint32_t iox::p3com::uds::UDSTransport::MAX_RECEIVE_BATCH;
+constexpr uint32_t iox::p3com::uds::UDSTransport::HELLO_MAGIC;
+
+namespace
+{
+// Request the send buffer size, which the kernel caps at net.core.wmem_max, and return the size which was set
+int setSendBufferSize(int socket, uint32_t size) noexcept
+{
+    const int requestedSize = static_cast<int>(std::min<uint32_t>(size, INT_MAX / 2));
+    static_cast<void>(::setsockopt(socket, SOL_SOCKET, SO_SNDBUF, &requestedSize, sizeof(requestedSize)));
+    int actualSize = 0;
+    socklen_t length = sizeof(actualSize);
+    if (::getsockopt(socket, SOL_SOCKET, SO_SNDBUF, &actualSize, &length) != 0)
+    {
+        return -1;
+    }
+    return actualSize;
+}
+
+void closeSocket(int& socket) noexcept
+{
+    if (socket >= 0)
+    {
+        static_cast<void>(::close(socket));
+        socket = -1;
+    }
+}
+
+// Closes every received descriptor but the first one, which is returned. Returns the number of received descriptors.
+uint32_t takeDescriptors(msghdr& message, int& descriptor) noexcept
+{
+    uint32_t count = 0U;
+    for (cmsghdr* controlMessage = CMSG_FIRSTHDR(&message); controlMessage != nullptr;
+         controlMessage = CMSG_NXTHDR(&message, controlMessage))
+    {
+        if (controlMessage->cmsg_level != SOL_SOCKET || controlMessage->cmsg_type != SCM_RIGHTS
+            || controlMessage->cmsg_len < CMSG_LEN(0U))
+        {
+            continue;
+        }
+        const size_t descriptorCount = (controlMessage->cmsg_len - CMSG_LEN(0U)) / sizeof(int);
+        for (size_t i = 0U; i < descriptorCount; ++i)
+        {
+            int received = -1;
+            std::memcpy(&received, CMSG_DATA(controlMessage) + i * sizeof(int), sizeof(int));
+            if (count == 0U)
+            {
+                descriptor = received;
+            }
+            else
+            {
+                closeSocket(received);
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+} // anonymous namespace
+
+iox::p3com::uds::UDSTransport::UDSTransport(const iox::p3com::UDSTransportConfig_t& config) noexcept
+    : m_config(config)
+{
+    if (m_config.name.empty() || m_config.name.size() > MAX_NAME_LENGTH)
+    {
+        iox::p3com::LogError() << "[UDSTransport] The socket name has to have between 1 and " << MAX_NAME_LENGTH
+                               << " characters";
+        setFailed();
+        return;
+    }
+
+    // All data sockets get the same send buffer, so its size is probed once
+    int probe = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    const int sendBufferSize = probe < 0 ? -1 : setSendBufferSize(probe, m_config.socketBufferSize);
+    closeSocket(probe);
+    if (sendBufferSize <= static_cast<int>(SEND_BUFFER_OVERHEAD))
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not create a data socket: " << std::strerror(errno);
+        setFailed();
+        return;
+    }
+    m_maxInlineSize = static_cast<uint32_t>(sendBufferSize) - SEND_BUFFER_OVERHEAD;
+    m_receiveBuffer.resize(m_maxInlineSize);
+
+    m_wakeEvent = ::eventfd(0U, EFD_CLOEXEC);
+    if (m_wakeEvent < 0 || !claimIndex())
+    {
+        closeSockets();
+        setFailed();
+        return;
+    }
+
+    iox::p3com::LogInfo() << "[UDSTransport] Claimed index " << m_index << ", sending messages of up to "
+                          << m_maxInlineSize << " B through the socket";
+    if (m_config.memfdThreshold != 0U)
+    {
+        iox::p3com::LogInfo() << "[UDSTransport] Passing user payloads of at least " << m_config.memfdThreshold
+                              << " B in a memfd";
+    }
+
+    m_receiveThread = std::thread([this]() { receiveWorker(); });
+}
+
+iox::p3com::uds::UDSTransport::~UDSTransport()
+{
+    m_isRunning.store(false);
+    if (m_receiveThread.joinable())
+    {
+        const uint64_t wake = 1U;
+        static_cast<void>(::write(m_wakeEvent, &wake, sizeof(wake)));
+        m_receiveThread.join();
+    }
+    closeSockets();
+}
+
+void iox::p3com::uds::UDSTransport::closeSockets() noexcept
+{
+    for (auto& peer : m_peers)
+    {
+        std::lock_guard<std::mutex> lock(peer.mutex);
+        closeSocket(peer.socket);
+    }
+    for (auto& connection : m_connections)
+    {
+        closeSocket(connection.socket);
+    }
+    m_connections.clear();
+    closeSocket(m_listeningSocket);
+    closeSocket(m_discoverySocket);
+    closeSocket(m_wakeEvent);
+}
+
+iox::p3com::uds::UDSTransport::Address_t iox::p3com::uds::UDSTransport::address(SocketKind kind,
+                                                                                uint32_t index) const noexcept
+{
+    const std::string name =
+        m_config.name + (kind == SocketKind::DISCOVERY ? ".discovery." : ".data.") + std::to_string(index);
+
+    // Abstract namespace: the name starts with a null byte and is not null terminated. It disappears together with
+    // the socket, so the index of a gateway which has died is free again.
+    Address_t result{};
+    result.address.sun_family = AF_UNIX;
+    const size_t length = std::min(name.size(), sizeof(result.address.sun_path) - 1U);
+    std::memcpy(&result.address.sun_path[1], name.data(), length);
+    result.length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1U + length);
+    return result;
+}
+
+bool iox::p3com::uds::UDSTransport::claimIndex() noexcept
+{
+    m_discoverySocket = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    m_listeningSocket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (m_discoverySocket < 0 || m_listeningSocket < 0)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not create sockets: " << std::strerror(errno);
+        return false;
+    }
+
+    // The discovery socket is the rendezvous point, binding it claims the index
+    for (uint32_t i = 0U; i < MAX_DEVICE_COUNT; ++i)
+    {
+        const auto discoveryAddress = address(SocketKind::DISCOVERY, i);
+        if (::bind(m_discoverySocket,
+                   reinterpret_cast<const sockaddr*>(&discoveryAddress.address),
+                   discoveryAddress.length)
+            == 0)
+        {
+            m_index = i;
+            break;
+        }
+        if (errno != EADDRINUSE)
+        {
+            iox::p3com::LogError() << "[UDSTransport] Could not bind the discovery socket: " << std::strerror(errno);
+            return false;
+        }
+    }
+    if (m_index == MAX_DEVICE_COUNT)
+    {
+        iox::p3com::LogError() << "[UDSTransport] All " << MAX_DEVICE_COUNT << " indices of " << m_config.name
+                               << " are in use";
+        return false;
+    }
+
+    const auto dataAddress = address(SocketKind::DATA, m_index);
+    if (::bind(m_listeningSocket, reinterpret_cast<const sockaddr*>(&dataAddress.address), dataAddress.length) != 0
+        || ::listen(m_listeningSocket, SOMAXCONN) != 0)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not listen on the data socket: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void iox::p3com::uds::UDSTransport::registerDiscoveryCallback(iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    m_remoteDiscoveryCallback = std::move(callback);
+}
+
+void iox::p3com::uds::UDSTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
+{
+    m_userDataCallback = std::move(callback);
+}
+
+void iox::p3com::uds::UDSTransport::registerBufferNeededCallback(iox::p3com::bufferNeededCallback_t callback) noexcept
+{
+    m_bufferNeededCallback = std::move(callback);
+}
+
+void iox::p3com::uds::UDSTransport::registerBufferReleasedCallback(
+    iox::p3com::bufferReleasedCallback_t callback) noexcept
+{
+    m_bufferReleasedCallback = std::move(callback);
+}
+
+void iox::p3com::uds::UDSTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    if (m_discoverySocket < 0)
+    {
+        return;
+    }
+    for (uint32_t i = 0U; i < MAX_DEVICE_COUNT; ++i)
+    {
+        if (i == m_index)
+        {
+            continue;
+        }
+        // Sending to an index which is not claimed by any gateway fails right away
+        const auto discoveryAddress = address(SocketKind::DISCOVERY, i);
+        static_cast<void>(::sendto(m_discoverySocket,
+                                   data,
+                                   size,
+                                   MSG_DONTWAIT | MSG_NOSIGNAL,
+                                   reinterpret_cast<const sockaddr*>(&discoveryAddress.address),
+                                   discoveryAddress.length));
+    }
+}
+
+bool iox::p3com::uds::UDSTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    if (deviceIndex >= MAX_DEVICE_COUNT || deviceIndex == m_index)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Invalid device index when sending user data";
+        return false;
+    }
+
+    auto& peer = m_peers[deviceIndex];
+    std::lock_guard<std::mutex> lock(peer.mutex);
+    if (peer.socket < 0)
+    {
+        peer.socket = connect(deviceIndex);
+        if (peer.socket < 0)
+        {
+            m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    const bool useMemfd =
+        m_config.memfdThreshold != 0U && (size2 >= m_config.memfdThreshold || size1 + size2 > m_maxInlineSize);
+    const bool isSent =
+        useMemfd ? sendMemfd(peer, data1, size1, data2, size2) : sendInline(peer, data1, size1, data2, size2);
+    if (isSent)
+    {
+        m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_sentBytes.fetch_add(size1 + size2, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+int iox::p3com::uds::UDSTransport::connect(uint32_t deviceIndex) noexcept
+{
+    int socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socket < 0)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not create a data socket: " << std::strerror(errno);
+        return -1;
+    }
+    static_cast<void>(setSendBufferSize(socket, m_config.socketBufferSize));
+    if (m_config.sendTimeout.count() > 0)
+    {
+        // Also limits the time connecting waits for the backlog of a busy gateway
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(m_config.sendTimeout);
+        const auto microseconds =
+            std::chrono::duration_cast<std::chrono::microseconds>(m_config.sendTimeout - seconds);
+        timeval timeout{};
+        timeout.tv_sec = static_cast<time_t>(seconds.count());
+        timeout.tv_usec = static_cast<suseconds_t>(microseconds.count());
+        static_cast<void>(::setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)));
+    }
+
+    const auto dataAddress = address(SocketKind::DATA, deviceIndex);
+    const Hello_t hello{HELLO_MAGIC, m_index};
+    if (::connect(socket, reinterpret_cast<const sockaddr*>(&dataAddress.address), dataAddress.length) != 0
+        || ::send(socket, &hello, sizeof(hello), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hello)))
+    {
+        iox::p3com::LogDebug() << "[UDSTransport] Could not connect to device " << deviceIndex << ": "
+                               << std::strerror(errno);
+        closeSocket(socket);
+        return -1;
+    }
+    iox::p3com::LogInfo() << "[UDSTransport] Connected to device " << deviceIndex;
+    return socket;
+}
+
+bool iox::p3com::uds::UDSTransport::sendInline(
+    Peer_t& peer, const void* data1, size_t size1, const void* data2, size_t size2) noexcept
+{
+    std::array<iovec, 2U> iov{{{const_cast<void*>(data1), size1}, {const_cast<void*>(data2), size2}}};
+    msghdr message{};
+    message.msg_iov = iov.data();
+    message.msg_iovlen = size2 != 0U ? 2U : 1U;
+    return sendMessage(peer, message);
+}
+
+bool iox::p3com::uds::UDSTransport::sendMemfd(
+    Peer_t& peer, const void* data1, size_t size1, const void* data2, size_t size2) noexcept
+{
+    int memfd = ::memfd_create("p3com-uds", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not create a memfd: " << std::strerror(errno);
+        return false;
+    }
+
+    // The memfd belongs to neither iceoryx instance, so the user payload is copied into it once. Together with the copy
+    // of the receiver, this is as many copies as through the socket, the memfd only lifts its size limit.
+    const auto* bytes = static_cast<const uint8_t*>(data2);
+    size_t written = 0U;
+    while (written < size2)
+    {
+        const ssize_t result = ::write(memfd, bytes + written, size2 - written);
+        if (result < 0 && errno != EINTR)
+        {
+            iox::p3com::LogError() << "[UDSTransport] Could not fill the memfd: " << std::strerror(errno);
+            closeSocket(memfd);
+            return false;
+        }
+        written += result < 0 ? 0U : static_cast<size_t>(result);
+    }
+
+    // The receiver maps the memfd, so the sender must not be able to change or shrink it anymore
+    if (::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not seal the memfd: " << std::strerror(errno);
+        closeSocket(memfd);
+        return false;
+    }
+
+    // Only the datagram header goes through the socket, the receiver learns the user payload size from it
+    iovec iov{const_cast<void*>(data1), size1};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1U;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+    controlMessage->cmsg_level = SOL_SOCKET;
+    controlMessage->cmsg_type = SCM_RIGHTS;
+    controlMessage->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(controlMessage), &memfd, sizeof(int));
+
+    const bool isSent = sendMessage(peer, message);
+    closeSocket(memfd);
+    return isSent;
+}
+
+bool iox::p3com::uds::UDSTransport::sendMessage(Peer_t& peer, const msghdr& message) noexcept
+{
+    const int flags = MSG_NOSIGNAL | (m_config.sendTimeout.count() > 0 ? 0 : MSG_DONTWAIT);
+    m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+    if (::sendmsg(peer.socket, &message, flags) >= 0)
+    {
+        return true;
+    }
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+        // The receiving gateway does not keep up, the connection stays usable
+        iox::p3com::LogWarn() << "[UDSTransport] Send timeout, discarding message!";
+    }
+    else if (errno == EMSGSIZE)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Message does not fit into the send buffer! Discarding!";
+    }
+    else
+    {
+        // The other gateway is gone, the next message reconnects to whichever gateway claims its index
+        iox::p3com::LogWarn() << "[UDSTransport] Lost connection: " << std::strerror(errno);
+        closeSocket(peer.socket);
+    }
+    return false;
+}
+
+void iox::p3com::uds::UDSTransport::receiveWorker() noexcept
+{
+    std::vector<pollfd> pollFds;
+    while (m_isRunning.load())
+    {
+        // The first entries are fixed, followed by one entry per accepted connection
+        pollFds.clear();
+        pollFds.push_back({m_wakeEvent, POLLIN, 0});
+        pollFds.push_back({m_discoverySocket, POLLIN, 0});
+        pollFds.push_back({m_listeningSocket, POLLIN, 0});
+        for (const auto& connection : m_connections)
+        {
+            pollFds.push_back({connection.socket, POLLIN, 0});
+        }
+        constexpr size_t CONNECTIONS_OFFSET = 3U;
+
+        if (::poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            iox::p3com::LogError() << "[UDSTransport] Could not poll the sockets: " << std::strerror(errno);
+            setFailed();
+            break;
+        }
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+
+        if ((pollFds[1U].revents & POLLIN) != 0)
+        {
+            receiveDiscovery();
+        }
+        for (size_t i = 0U; i < m_connections.size(); ++i)
+        {
+            auto& connection = m_connections[i];
+            if (pollFds[CONNECTIONS_OFFSET + i].revents != 0 && !receive(connection))
+            {
+                closeSocket(connection.socket);
+            }
+        }
+        m_connections.erase(std::remove_if(m_connections.begin(),
+                                           m_connections.end(),
+                                           [](const Connection_t& connection) { return connection.socket < 0; }),
+                            m_connections.end());
+        if ((pollFds[2U].revents & POLLIN) != 0)
+        {
+            accept();
+        }
+    }
+    iox::p3com::LogInfo() << "[UDSTransport] Receive thread has exited";
+}
+
+void iox::p3com::uds::UDSTransport::receiveDiscovery() noexcept
+{
+    sockaddr_un sender{};
+    socklen_t senderLength = sizeof(sender);
+    const ssize_t received = ::recvfrom(m_discoverySocket,
+                                        m_discoveryBuffer.data(),
+                                        m_discoveryBuffer.size(),
+                                        MSG_DONTWAIT,
+                                        reinterpret_cast<sockaddr*>(&sender),
+                                        &senderLength);
+    if (received <= 0)
+    {
+        return;
+    }
+
+    // The device index of the sender is the index in the name of its discovery socket
+    for (uint32_t i = 0U; i < MAX_DEVICE_COUNT; ++i)
+    {
+        const auto discoveryAddress = address(SocketKind::DISCOVERY, i);
+        if (i != m_index && discoveryAddress.length == senderLength
+            && std::memcmp(&discoveryAddress.address, &sender, senderLength) == 0)
+        {
+            if (m_remoteDiscoveryCallback)
+            {
+                m_remoteDiscoveryCallback(
+                    m_discoveryBuffer.data(), static_cast<size_t>(received), {iox::p3com::TransportType::UDS, i});
+            }
+            return;
+        }
+    }
+    iox::p3com::LogWarn() << "[UDSTransport] Received discovery message from an unknown socket! Discarding!";
+}
+
+void iox::p3com::uds::UDSTransport::accept() noexcept
+{
+    const int socket = ::accept4(m_listeningSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (socket < 0)
+    {
+        iox::p3com::LogWarn() << "[UDSTransport] Could not accept a connection: " << std::strerror(errno);
+        return;
+    }
+    m_connections.push_back({socket, MAX_DEVICE_COUNT});
+}
+
+bool iox::p3com::uds::UDSTransport::receive(Connection_t& connection) noexcept
+{
+    for (uint32_t n = 0U; n < MAX_RECEIVE_BATCH; ++n)
+    {
+        iovec iov{m_receiveBuffer.data(), m_receiveBuffer.size()};
+        alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1U;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        const ssize_t received = ::recvmsg(connection.socket, &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+        if (received < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        if (received == 0)
+        {
+            // The other gateway has closed the connection
+            return false;
+        }
+        const auto receiveTime = std::chrono::steady_clock::now();
+
+        // Any local process can connect, and every descriptor it passes is installed in this process. So all of
+        // them are taken out of the control messages, and only a single memfd is ever kept.
+        int memfd = -1;
+        const uint32_t descriptorCount = takeDescriptors(message, memfd);
+        if (descriptorCount > 1U || (message.msg_flags & MSG_CTRUNC) != 0)
+        {
+            closeSocket(memfd);
+            iox::p3com::LogError() << "[UDSTransport] Received message with unexpected descriptors! Discarding!";
+            if (connection.deviceIndex == MAX_DEVICE_COUNT)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (connection.deviceIndex == MAX_DEVICE_COUNT)
+        {
+            Hello_t hello{};
+            if (static_cast<size_t>(received) == sizeof(hello))
+            {
+                std::memcpy(&hello, m_receiveBuffer.data(), sizeof(hello));
+            }
+            closeSocket(memfd);
+            if (hello.magic != HELLO_MAGIC || hello.index >= MAX_DEVICE_COUNT || hello.index == m_index)
+            {
+                iox::p3com::LogError() << "[UDSTransport] Received invalid connection request! Closing!";
+                return false;
+            }
+            connection.deviceIndex = hello.index;
+            continue;
+        }
+
+        if ((message.msg_flags & MSG_TRUNC) != 0)
+        {
+            iox::p3com::LogError() << "[UDSTransport] Message does not fit into the receive buffer! Discarding!";
+        }
+        else if (memfd >= 0)
+        {
+            m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+            receiveMemfd(m_receiveBuffer.data(), static_cast<size_t>(received), memfd, connection.deviceIndex);
+        }
+        else
+        {
+            m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+            m_receivedBytes.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+            if (m_userDataCallback)
+            {
+                m_userDataCallback(m_receiveBuffer.data(),
+                                   static_cast<size_t>(received),
+                                   {iox::p3com::TransportType::UDS, connection.deviceIndex});
+            }
+        }
+        closeSocket(memfd);
+        m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+    }
+    return true;
+}
+
+void iox::p3com::uds::UDSTransport::receiveMemfd(const void* data,
+                                                 size_t size,
+                                                 int memfd,
+                                                 uint32_t deviceIndex) noexcept
+{
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    const uint32_t headerSize = size < iox::p3com::maxIoxChunkDatagramHeaderSerializationSize()
+                                    ? 0U
+                                    : iox::p3com::deserialize(datagramHeader, static_cast<const char*>(data), size);
+    struct stat status = {};
+    if (headerSize != size || datagramHeader.submessageSize == 0U || ::fstat(memfd, &status) != 0
+        || static_cast<uint64_t>(status.st_size) != datagramHeader.submessageSize)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Received invalid memfd message! Discarding!";
+        return;
+    }
+
+    // A memfd which the sender could still shrink would crash this gateway with SIGBUS while copying from it
+    const int requiredSeals = F_SEAL_SHRINK | F_SEAL_WRITE;
+    const int seals = ::fcntl(memfd, F_GET_SEALS);
+    if (seals < 0 || (seals & requiredSeals) != requiredSeals)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Received memfd which is not sealed! Discarding!";
+        return;
+    }
+    m_receivedBytes.fetch_add(size + datagramHeader.submessageSize, std::memory_order_relaxed);
+
+    void* mapping = ::mmap(nullptr, datagramHeader.submessageSize, PROT_READ, MAP_SHARED, memfd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        iox::p3com::LogError() << "[UDSTransport] Could not map the memfd: " << std::strerror(errno);
+        return;
+    }
+    const auto* payload = static_cast<const uint8_t*>(mapping);
+    const iox::p3com::DeviceIndex_t sender{iox::p3com::TransportType::UDS, deviceIndex};
+
+    if (m_bufferNeededCallback && m_bufferReleasedCallback && datagramHeader.fecGroupSize == 0U)
+    {
+        // The submessage must not write beyond the user header or the user payload of the loaned chunk
+        const uint64_t submessageEnd =
+            static_cast<uint64_t>(datagramHeader.submessageOffset) + datagramHeader.submessageSize;
+        const bool isUserHeader = datagramHeader.submessageOffset < datagramHeader.userHeaderSize;
+        const bool isValid = isUserHeader ? submessageEnd <= datagramHeader.userHeaderSize
+                                          : submessageEnd <= static_cast<uint64_t>(datagramHeader.userHeaderSize)
+                                                                 + datagramHeader.userPayloadSize;
+        void* buffer = isValid ? m_bufferNeededCallback(data, headerSize) : nullptr;
+        if (!isValid)
+        {
+            iox::p3com::LogError() << "[UDSTransport] Received invalid user data message! Discarding!";
+        }
+        else if (buffer != nullptr)
+        {
+            const uint32_t offset = isUserHeader ? datagramHeader.submessageOffset
+                                                 : datagramHeader.submessageOffset - datagramHeader.userHeaderSize;
+            std::memcpy(static_cast<uint8_t*>(buffer) + offset, payload, datagramHeader.submessageSize);
+            m_bufferReleasedCallback(data, headerSize, false, sender);
+        }
+    }
+    else if (m_userDataCallback)
+    {
+        // Without loaned buffers, the message is put together as if it had been sent through the socket
+        const auto* header = static_cast<const uint8_t*>(data);
+        m_messageBuffer.assign(header, header + headerSize);
+        m_messageBuffer.insert(m_messageBuffer.end(), payload, payload + datagramHeader.submessageSize);
+        m_userDataCallback(m_messageBuffer.data(), m_messageBuffer.size(), sender);
+    }
+
+    static_cast<void>(::munmap(mapping, datagramHeader.submessageSize));
+}
+
+size_t iox::p3com::uds::UDSTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    static_cast<void>(deviceIndex);
+    // A memfd carries a user payload of any size, so the messages are only segmented without it
+    if (m_config.memfdThreshold != 0U)
+    {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    return m_maxInlineSize;
+}
+
+iox::p3com::TransportType iox::p3com::uds::UDSTransport::getType() const noexcept
+{
+    return iox::p3com::TransportType::UDS;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::uds::UDSTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
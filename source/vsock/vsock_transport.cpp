@@ -0,0 +1,738 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/vsock/vsock_transport.hpp"
+#include "p3com/generic/serialization.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <fcntl.h>
+#include <linux/vm_sockets.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+constexpr uint32_t iox::p3com::vsock::VSOCKTransport::MAX_PEER_COUNT;
+constexpr uint32_t iox::p3com::vsock::VSOCKTransport::FIRST_GUEST_CID;
+constexpr uint32_t iox::p3com::vsock::VSOCKTransport::MAX_BUFFERED_MESSAGE_SIZE;
+constexpr std::chrono::milliseconds iox::p3com::vsock::VSOCKTransport::RECONNECT_INTERVAL;
+constexpr std::chrono::milliseconds iox::p3com::vsock::VSOCKTransport::CONNECT_TIMEOUT;
+constexpr uint32_t iox::p3com::vsock::VSOCKTransport::HELLO_MAGIC;
+
+namespace
+{
+timeval toTimeval(std::chrono::milliseconds duration) noexcept
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration - seconds);
+    timeval result{};
+    result.tv_sec = static_cast<time_t>(seconds.count());
+    result.tv_usec = static_cast<suseconds_t>(microseconds.count());
+    return result;
+}
+
+uint32_t localCid() noexcept
+{
+    uint32_t cid = VMADDR_CID_ANY;
+    const int device = ::open("/dev/vsock", O_RDONLY | O_CLOEXEC);
+    if (device >= 0)
+    {
+        static_cast<void>(::ioctl(device, IOCTL_VM_SOCKETS_GET_LOCAL_CID, &cid));
+        static_cast<void>(::close(device));
+    }
+    return cid;
+}
+
+void closeSocket(int& socket) noexcept
+{
+    if (socket >= 0)
+    {
+        static_cast<void>(::close(socket));
+        socket = -1;
+    }
+}
+
+} // anonymous namespace
+
+iox::p3com::vsock::VSOCKTransport::VSOCKTransport(const iox::p3com::VSOCKTransportConfig_t& config) noexcept
+    : m_config(config)
+    , m_localCid(localCid())
+{
+    if (m_config.seqpacket
+        && m_config.bufferSize <= sizeof(FrameHeader_t) + iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] The buffer size is too small for a message";
+        setFailed();
+        return;
+    }
+
+    for (const auto& peer : m_config.peers)
+    {
+        if (addPeer(peer.cid, peer.port) == MAX_PEER_COUNT)
+        {
+            iox::p3com::LogWarn() << "[VSOCKTransport] Ignoring peer CID " << peer.cid << ", too many peers";
+        }
+    }
+    for (uint32_t i = 0U; i < m_config.scanCidCount; ++i)
+    {
+        const uint32_t cid = FIRST_GUEST_CID + i;
+        if (cid != m_localCid && addPeer(cid, m_config.port) == MAX_PEER_COUNT)
+        {
+            iox::p3com::LogWarn() << "[VSOCKTransport] Probing only " << MAX_PEER_COUNT << " peers";
+            break;
+        }
+    }
+
+    m_wakeEvent = ::eventfd(0U, EFD_CLOEXEC);
+    m_listeningSocket = ::socket(AF_VSOCK, socketType() | SOCK_CLOEXEC, 0);
+    if (m_wakeEvent < 0 || m_listeningSocket < 0)
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] Could not create a vsock socket: " << std::strerror(errno);
+        closeSockets();
+        setFailed();
+        return;
+    }
+
+    // The accepted connections inherit the buffer size of the listening socket
+    configureSocket(m_listeningSocket);
+    sockaddr_vm address{};
+    address.svm_family = AF_VSOCK;
+    address.svm_cid = VMADDR_CID_ANY;
+    address.svm_port = m_config.port;
+    if (::bind(m_listeningSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(m_listeningSocket, SOMAXCONN) != 0)
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] Could not listen on port " << m_config.port << ": "
+                               << std::strerror(errno);
+        closeSockets();
+        setFailed();
+        return;
+    }
+
+    iox::p3com::LogInfo() << "[VSOCKTransport] Listening on port " << m_config.port << " with "
+                          << (m_config.seqpacket ? "SOCK_SEQPACKET" : "SOCK_STREAM") << " connections, "
+                          << m_peerCount.load() << " peers configured";
+
+    m_acceptThread = std::thread([this]() { acceptWorker(); });
+}
+
+iox::p3com::vsock::VSOCKTransport::~VSOCKTransport()
+{
+    m_isRunning.store(false);
+    if (m_acceptThread.joinable())
+    {
+        // The wake event stays readable, so it terminates the receiving threads as well
+        const uint64_t wake = 1U;
+        static_cast<void>(::write(m_wakeEvent, &wake, sizeof(wake)));
+        m_acceptThread.join();
+    }
+    closeSockets();
+}
+
+void iox::p3com::vsock::VSOCKTransport::closeSockets() noexcept
+{
+    for (auto& peer : m_peers)
+    {
+        std::lock_guard<std::mutex> lock(peer.mutex);
+        closeSocket(peer.socket);
+    }
+    closeSocket(m_listeningSocket);
+    closeSocket(m_wakeEvent);
+}
+
+int iox::p3com::vsock::VSOCKTransport::socketType() const noexcept
+{
+    return m_config.seqpacket ? SOCK_SEQPACKET : SOCK_STREAM;
+}
+
+void iox::p3com::vsock::VSOCKTransport::configureSocket(int socket) const noexcept
+{
+    // The buffer size can only be raised up to the maximum buffer size
+    const unsigned long long bufferSize = m_config.bufferSize;
+    if (::setsockopt(socket, AF_VSOCK, SO_VM_SOCKETS_BUFFER_MAX_SIZE, &bufferSize, sizeof(bufferSize)) != 0
+        || ::setsockopt(socket, AF_VSOCK, SO_VM_SOCKETS_BUFFER_SIZE, &bufferSize, sizeof(bufferSize)) != 0)
+    {
+        iox::p3com::LogWarn() << "[VSOCKTransport] Could not set the buffer size: " << std::strerror(errno);
+    }
+}
+
+uint32_t iox::p3com::vsock::VSOCKTransport::addPeer(uint32_t cid, uint32_t port) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_peersMutex);
+    const uint32_t count = m_peerCount.load(std::memory_order_relaxed);
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        if (m_peers[i].cid == cid && m_peers[i].port == port)
+        {
+            return i;
+        }
+    }
+    if (count == MAX_PEER_COUNT)
+    {
+        return MAX_PEER_COUNT;
+    }
+    m_peers[count].cid = cid;
+    m_peers[count].port = port;
+    m_peerCount.store(count + 1U, std::memory_order_release);
+    return count;
+}
+
+void iox::p3com::vsock::VSOCKTransport::registerDiscoveryCallback(
+    iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    m_remoteDiscoveryCallback = std::move(callback);
+}
+
+void iox::p3com::vsock::VSOCKTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
+{
+    m_userDataCallback = std::move(callback);
+}
+
+void iox::p3com::vsock::VSOCKTransport::registerBufferNeededCallback(
+    iox::p3com::bufferNeededCallback_t callback) noexcept
+{
+    m_bufferNeededCallback = std::move(callback);
+}
+
+void iox::p3com::vsock::VSOCKTransport::registerBufferReleasedCallback(
+    iox::p3com::bufferReleasedCallback_t callback) noexcept
+{
+    m_bufferReleasedCallback = std::move(callback);
+}
+
+void iox::p3com::vsock::VSOCKTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_discoveryMutex);
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        m_lastDiscovery.assign(bytes, bytes + size);
+    }
+
+    // Gateways which are not connected yet get the discovery message once the accepting thread has connected them
+    const uint32_t count = m_peerCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        auto& peer = m_peers[i];
+        std::lock_guard<std::mutex> lock(peer.mutex);
+        if (peer.socket >= 0)
+        {
+            static_cast<void>(sendFrame(peer, FrameKind::DISCOVERY, data, size, nullptr, 0U));
+        }
+    }
+}
+
+bool iox::p3com::vsock::VSOCKTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    if (deviceIndex >= m_peerCount.load(std::memory_order_acquire))
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] Invalid device index when sending user data";
+        return false;
+    }
+
+    // A disconnected gateway is reconnected by the accepting thread, so its messages are dropped without waiting
+    auto& peer = m_peers[deviceIndex];
+    std::lock_guard<std::mutex> lock(peer.mutex);
+    if (peer.socket >= 0 && sendFrame(peer, FrameKind::USER_DATA, data1, size1, data2, size2))
+    {
+        m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_sentBytes.fetch_add(size1 + size2, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+int iox::p3com::vsock::VSOCKTransport::connect(uint32_t cid, uint32_t port) const noexcept
+{
+    int socket = ::socket(AF_VSOCK, socketType() | SOCK_CLOEXEC, 0);
+    if (socket < 0)
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] Could not create a vsock socket: " << std::strerror(errno);
+        return -1;
+    }
+    configureSocket(socket);
+    const timeval connectTimeout = toTimeval(CONNECT_TIMEOUT);
+    static_cast<void>(
+        ::setsockopt(socket, AF_VSOCK, SO_VM_SOCKETS_CONNECT_TIMEOUT, &connectTimeout, sizeof(connectTimeout)));
+    if (m_config.sendTimeout.count() > 0)
+    {
+        const timeval sendTimeout = toTimeval(m_config.sendTimeout);
+        static_cast<void>(::setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout)));
+    }
+
+    sockaddr_vm address{};
+    address.svm_family = AF_VSOCK;
+    address.svm_cid = cid;
+    address.svm_port = port;
+    if (::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        iox::p3com::LogDebug() << "[VSOCKTransport] Could not connect to CID " << cid << " port " << port << ": "
+                               << std::strerror(errno);
+        closeSocket(socket);
+    }
+    return socket;
+}
+
+bool iox::p3com::vsock::VSOCKTransport::sendFrame(
+    Peer_t& peer, FrameKind kind, const void* data1, size_t size1, const void* data2, size_t size2) noexcept
+{
+    const FrameHeader_t frame{kind,
+                              kind == FrameKind::USER_DATA ? static_cast<uint32_t>(size1) : 0U,
+                              static_cast<uint32_t>(size1 + size2)};
+    std::array<iovec, 3U> iov{{{const_cast<FrameHeader_t*>(&frame), sizeof(frame)},
+                               {const_cast<void*>(data1), size1},
+                               {const_cast<void*>(data2), size2}}};
+    msghdr message{};
+    message.msg_iov = iov.data();
+    message.msg_iovlen = size2 != 0U ? 3U : 2U;
+
+    size_t sentSize = 0U;
+    const size_t frameSize = sizeof(frame) + size1 + size2;
+    while (true)
+    {
+        m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+        const ssize_t result = ::sendmsg(peer.socket, &message, MSG_NOSIGNAL);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && sentSize == 0U)
+            {
+                // Nothing of the message was sent, so the connection stays usable
+                iox::p3com::LogWarn() << "[VSOCKTransport] Send timeout, discarding message!";
+                return false;
+            }
+            iox::p3com::LogWarn() << "[VSOCKTransport] Lost connection to CID " << peer.cid << " port " << peer.port
+                                  << ": " << std::strerror(errno);
+            closeSocket(peer.socket);
+            return false;
+        }
+
+        sentSize += static_cast<size_t>(result);
+        if (sentSize == frameSize)
+        {
+            return true;
+        }
+
+        // Only a stream connection sends a part of the message, the rest follows in the next call
+        size_t remaining = static_cast<size_t>(result);
+        while (remaining >= message.msg_iov->iov_len)
+        {
+            remaining -= message.msg_iov->iov_len;
+            ++message.msg_iov;
+            --message.msg_iovlen;
+        }
+        message.msg_iov->iov_base = static_cast<uint8_t*>(message.msg_iov->iov_base) + remaining;
+        message.msg_iov->iov_len -= remaining;
+    }
+}
+
+void iox::p3com::vsock::VSOCKTransport::probePeers() noexcept
+{
+    std::vector<uint8_t> discovery;
+    {
+        std::lock_guard<std::mutex> lock(m_discoveryMutex);
+        discovery = m_lastDiscovery;
+    }
+
+    // Gateways which were not reachable so far get the discovery message as soon as they can be connected
+    const auto now = std::chrono::steady_clock::now();
+    const uint32_t count = m_peerCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0U; i < count && m_isRunning.load(); ++i)
+    {
+        auto& peer = m_peers[i];
+        {
+            std::lock_guard<std::mutex> lock(peer.mutex);
+            if (peer.socket >= 0 || now < peer.nextConnectTime)
+            {
+                continue;
+            }
+        }
+        peer.nextConnectTime = now + RECONNECT_INTERVAL;
+
+        // Connecting may wait for the connect timeout, so the senders to the peer are not blocked meanwhile. Only this
+        // thread opens connections, so the socket of the peer stays closed until it is set here.
+        const int socket = connect(peer.cid, peer.port);
+        if (socket < 0)
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(peer.mutex);
+        peer.socket = socket;
+        const Hello_t hello{HELLO_MAGIC, m_config.port};
+        if (!sendFrame(peer, FrameKind::HELLO, &hello, sizeof(hello), nullptr, 0U))
+        {
+            closeSocket(peer.socket);
+            continue;
+        }
+        iox::p3com::LogInfo() << "[VSOCKTransport] Connected to CID " << peer.cid << " port " << peer.port;
+        if (!discovery.empty())
+        {
+            static_cast<void>(sendFrame(peer, FrameKind::DISCOVERY, discovery.data(), discovery.size(), nullptr, 0U));
+        }
+    }
+}
+
+void iox::p3com::vsock::VSOCKTransport::acceptWorker() noexcept
+{
+    auto nextProbeTime = std::chrono::steady_clock::now();
+    while (m_isRunning.load())
+    {
+        if (std::chrono::steady_clock::now() >= nextProbeTime)
+        {
+            probePeers();
+            nextProbeTime = std::chrono::steady_clock::now() + RECONNECT_INTERVAL;
+        }
+
+        // Join the threads of the closed connections
+        for (auto& connection : m_connections)
+        {
+            if (connection->isFinished.load())
+            {
+                connection->thread.join();
+            }
+        }
+        m_connections.erase(std::remove_if(m_connections.begin(),
+                                           m_connections.end(),
+                                           [](const std::unique_ptr<Connection_t>& connection) {
+                                               return !connection->thread.joinable();
+                                           }),
+                            m_connections.end());
+
+        std::array<pollfd, 2U> pollFds{{{m_listeningSocket, POLLIN, 0}, {m_wakeEvent, POLLIN, 0}}};
+        const auto timeout = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          nextProbeTime - std::chrono::steady_clock::now()),
+                                      std::chrono::milliseconds(0));
+        if (::poll(pollFds.data(), pollFds.size(), static_cast<int>(timeout.count())) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            iox::p3com::LogError() << "[VSOCKTransport] Could not poll the listening socket: " << std::strerror(errno);
+            setFailed();
+            break;
+        }
+        if (pollFds[1U].revents != 0)
+        {
+            break;
+        }
+        if ((pollFds[0U].revents & POLLIN) != 0)
+        {
+            accept();
+        }
+    }
+
+    for (auto& connection : m_connections)
+    {
+        connection->thread.join();
+    }
+    m_connections.clear();
+    iox::p3com::LogInfo() << "[VSOCKTransport] Accept thread has exited";
+}
+
+void iox::p3com::vsock::VSOCKTransport::accept() noexcept
+{
+    sockaddr_vm address{};
+    socklen_t length = sizeof(address);
+    const int socket = ::accept4(m_listeningSocket, reinterpret_cast<sockaddr*>(&address), &length, SOCK_CLOEXEC);
+    if (socket < 0)
+    {
+        iox::p3com::LogWarn() << "[VSOCKTransport] Could not accept a connection: " << std::strerror(errno);
+        return;
+    }
+    if (m_connections.size() >= MAX_PEER_COUNT)
+    {
+        iox::p3com::LogWarn() << "[VSOCKTransport] Too many connections, rejecting CID " << address.svm_cid;
+        static_cast<void>(::close(socket));
+        return;
+    }
+
+    auto connection = std::make_unique<Connection_t>();
+    connection->socket = socket;
+    connection->cid = address.svm_cid;
+    connection->buffer.resize(m_config.seqpacket ? m_config.bufferSize : MAX_BUFFERED_MESSAGE_SIZE);
+    auto& newConnection = *connection;
+    m_connections.push_back(std::move(connection));
+    newConnection.thread = std::thread([this, &newConnection]() { receiveWorker(newConnection); });
+}
+
+bool iox::p3com::vsock::VSOCKTransport::waitReadable(int socket) noexcept
+{
+    std::array<pollfd, 2U> pollFds{{{socket, POLLIN, 0}, {m_wakeEvent, POLLIN, 0}}};
+    while (::poll(pollFds.data(), pollFds.size(), -1) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+    m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+    return pollFds[1U].revents == 0 && m_isRunning.load();
+}
+
+bool iox::p3com::vsock::VSOCKTransport::readExactly(Connection_t& connection, void* data, size_t size) noexcept
+{
+    auto* bytes = static_cast<uint8_t*>(data);
+    size_t receivedSize = 0U;
+    while (receivedSize < size)
+    {
+        const ssize_t result = ::recv(connection.socket, bytes + receivedSize, size - receivedSize, MSG_DONTWAIT);
+        if (result > 0)
+        {
+            receivedSize += static_cast<size_t>(result);
+            continue;
+        }
+        if (result == 0)
+        {
+            return false;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || !waitReadable(connection.socket))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool iox::p3com::vsock::VSOCKTransport::receiveStreamFrame(Connection_t& connection, FrameHeader_t& frame) noexcept
+{
+    if (!readExactly(connection, &frame, sizeof(frame)))
+    {
+        return false;
+    }
+    if (frame.size <= connection.buffer.size())
+    {
+        return readExactly(connection, connection.buffer.data(), frame.size);
+    }
+
+    // The rest of a large message is read by receiveLargeMessage
+    if (frame.kind != FrameKind::USER_DATA || frame.headerSize > frame.size
+        || frame.headerSize > iox::p3com::maxIoxChunkDatagramHeaderSerializationSize())
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] Received invalid frame! Closing the connection!";
+        return false;
+    }
+    return true;
+}
+
+bool iox::p3com::vsock::VSOCKTransport::receiveSeqpacketFrame(Connection_t& connection, FrameHeader_t& frame) noexcept
+{
+    while (true)
+    {
+        std::array<iovec, 2U> iov{{{&frame, sizeof(frame)}, {connection.buffer.data(), connection.buffer.size()}}};
+        msghdr message{};
+        message.msg_iov = iov.data();
+        message.msg_iovlen = iov.size();
+        const ssize_t result = ::recvmsg(connection.socket, &message, MSG_DONTWAIT);
+        if (result > 0)
+        {
+            if ((message.msg_flags & MSG_TRUNC) != 0 || static_cast<size_t>(result) < sizeof(frame)
+                || frame.size != static_cast<size_t>(result) - sizeof(frame))
+            {
+                iox::p3com::LogError() << "[VSOCKTransport] Received invalid frame! Closing the connection!";
+                return false;
+            }
+            return true;
+        }
+        if (result == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            return false;
+        }
+        if (errno != EINTR && !waitReadable(connection.socket))
+        {
+            return false;
+        }
+    }
+}
+
+bool iox::p3com::vsock::VSOCKTransport::receiveLargeMessage(Connection_t& connection,
+                                                            const FrameHeader_t& frame,
+                                                            uint32_t deviceIndex) noexcept
+{
+    // The datagram header is needed to request the buffer, the user data is then read straight into it
+    auto* header = connection.buffer.data();
+    if (!readExactly(connection, header, frame.headerSize))
+    {
+        return false;
+    }
+    const auto receiveTime = std::chrono::steady_clock::now();
+
+    iox::p3com::IoxChunkDatagramHeader_t datagramHeader;
+    const uint32_t headerSize =
+        iox::p3com::deserialize(datagramHeader, reinterpret_cast<const char*>(header), frame.headerSize);
+    const uint64_t submessageEnd =
+        static_cast<uint64_t>(datagramHeader.submessageOffset) + datagramHeader.submessageSize;
+    const bool isUserHeader = datagramHeader.submessageOffset < datagramHeader.userHeaderSize;
+    const bool isValid = m_bufferNeededCallback && m_bufferReleasedCallback && headerSize == frame.headerSize
+                         && frame.size == static_cast<uint64_t>(headerSize) + datagramHeader.submessageSize
+                         && (isUserHeader ? submessageEnd <= datagramHeader.userHeaderSize
+                                          : submessageEnd <= static_cast<uint64_t>(datagramHeader.userHeaderSize)
+                                                                 + datagramHeader.userPayloadSize);
+    void* buffer = isValid ? m_bufferNeededCallback(header, headerSize) : nullptr;
+    if (buffer == nullptr)
+    {
+        if (!isValid)
+        {
+            iox::p3com::LogError() << "[VSOCKTransport] Received invalid user data message! Discarding!";
+        }
+        // Skip the user data, the header is not needed anymore
+        size_t remaining = frame.size - frame.headerSize;
+        while (remaining != 0U)
+        {
+            const size_t size = std::min(remaining, connection.buffer.size());
+            if (!readExactly(connection, connection.buffer.data(), size))
+            {
+                return false;
+            }
+            remaining -= size;
+        }
+        return true;
+    }
+
+    const uint32_t offset = isUserHeader ? datagramHeader.submessageOffset
+                                         : datagramHeader.submessageOffset - datagramHeader.userHeaderSize;
+    const bool isComplete =
+        readExactly(connection, static_cast<uint8_t*>(buffer) + offset, datagramHeader.submessageSize);
+    if (isComplete)
+    {
+        m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+        m_receivedBytes.fetch_add(frame.size, std::memory_order_relaxed);
+    }
+    else
+    {
+        iox::p3com::LogError() << "[VSOCKTransport] Could not receive user data message! Discarding!";
+    }
+    m_bufferReleasedCallback(header, headerSize, !isComplete, {iox::p3com::TransportType::VSOCK, deviceIndex});
+    if (isComplete)
+    {
+        m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+    }
+    return isComplete;
+}
+
+void iox::p3com::vsock::VSOCKTransport::receiveWorker(Connection_t& connection) noexcept
+{
+    // Known once the hello frame was received
+    uint32_t deviceIndex = MAX_PEER_COUNT;
+    bool isConnected = true;
+    while (isConnected && m_isRunning.load())
+    {
+        FrameHeader_t frame{};
+        isConnected =
+            m_config.seqpacket ? receiveSeqpacketFrame(connection, frame) : receiveStreamFrame(connection, frame);
+        if (!isConnected)
+        {
+            break;
+        }
+        const auto receiveTime = std::chrono::steady_clock::now();
+
+        if (frame.kind == FrameKind::HELLO)
+        {
+            Hello_t hello{};
+            if (frame.size == sizeof(hello))
+            {
+                std::memcpy(&hello, connection.buffer.data(), sizeof(hello));
+            }
+            if (deviceIndex != MAX_PEER_COUNT || hello.magic != HELLO_MAGIC)
+            {
+                iox::p3com::LogError() << "[VSOCKTransport] Received invalid hello frame! Closing the connection!";
+                break;
+            }
+            deviceIndex = addPeer(connection.cid, hello.port);
+            if (deviceIndex == MAX_PEER_COUNT)
+            {
+                iox::p3com::LogError() << "[VSOCKTransport] Too many peers, closing the connection of CID "
+                                       << connection.cid;
+                break;
+            }
+            iox::p3com::LogInfo() << "[VSOCKTransport] Accepted connection of CID " << connection.cid << " port "
+                                  << hello.port;
+            continue;
+        }
+        if (deviceIndex == MAX_PEER_COUNT)
+        {
+            iox::p3com::LogError() << "[VSOCKTransport] Received frame before the hello frame! Closing the connection!";
+            break;
+        }
+
+        const iox::p3com::DeviceIndex_t sender{iox::p3com::TransportType::VSOCK, deviceIndex};
+        switch (frame.kind)
+        {
+        case FrameKind::DISCOVERY:
+            if (m_remoteDiscoveryCallback)
+            {
+                m_remoteDiscoveryCallback(connection.buffer.data(), frame.size, sender);
+            }
+            break;
+        case FrameKind::USER_DATA:
+            if (frame.size > connection.buffer.size())
+            {
+                isConnected = receiveLargeMessage(connection, frame, deviceIndex);
+                break;
+            }
+            m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+            m_receivedBytes.fetch_add(frame.size, std::memory_order_relaxed);
+            if (m_userDataCallback)
+            {
+                m_userDataCallback(connection.buffer.data(), frame.size, sender);
+            }
+            m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+            break;
+        default:
+            iox::p3com::LogError() << "[VSOCKTransport] Received frame of unknown kind! Closing the connection!";
+            isConnected = false;
+            break;
+        }
+    }
+
+    closeSocket(connection.socket);
+    connection.isFinished.store(true);
+}
+
+size_t iox::p3com::vsock::VSOCKTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    static_cast<void>(deviceIndex);
+    if (m_config.seqpacket)
+    {
+        return m_config.bufferSize - sizeof(FrameHeader_t);
+    }
+
+    // A stream carries every message as a single frame regardless of its size, as with the TCP transport layer
+    return std::numeric_limits<uint32_t>::max();
+}
+
+iox::p3com::TransportType iox::p3com::vsock::VSOCKTransport::getType() const noexcept
+{
+    return iox::p3com::TransportType::VSOCK;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::vsock::VSOCKTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
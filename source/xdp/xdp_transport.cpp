@@ -0,0 +1,708 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/xdp/xdp_transport.hpp"
+#include "p3com/internal/log/logging.hpp"
+
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+constexpr uint16_t iox::p3com::xdp::XDPTransport::DATA_PORT;
+constexpr uint32_t iox::p3com::xdp::XDPTransport::MAX_RECEIVE_BATCH;
+constexpr uint32_t iox::p3com::xdp::XDPTransport::FRAME_HEADER_SIZE;
+constexpr std::chrono::milliseconds iox::p3com::xdp::XDPTransport::RESOLVE_INTERVAL;
+
+namespace
+{
+constexpr uint32_t IP_HEADER_SIZE = 20U;
+constexpr uint32_t UDP_HEADER_SIZE = 8U;
+constexpr uint32_t ETHERNET_HEADER_SIZE = 14U;
+
+long bpf(int command, bpf_attr& attr) noexcept
+{
+    return ::syscall(__NR_bpf, command, &attr, sizeof(attr));
+}
+
+bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t offset, int32_t immediate) noexcept
+{
+    bpf_insn result{};
+    result.code = code;
+    result.dst_reg = dst & 0x0FU;
+    result.src_reg = src & 0x0FU;
+    result.off = offset;
+    result.imm = immediate;
+    return result;
+}
+
+uint16_t ipChecksum(const void* header, size_t size) noexcept
+{
+    const auto* bytes = static_cast<const uint8_t*>(header);
+    uint32_t sum = 0U;
+    for (size_t i = 0U; i + 1U < size; i += 2U)
+    {
+        sum += static_cast<uint32_t>(bytes[i] << 8U) | bytes[i + 1U];
+    }
+    while ((sum >> 16U) != 0U)
+    {
+        sum = (sum & 0xFFFFU) + (sum >> 16U);
+    }
+    return htons(static_cast<uint16_t>(~sum));
+}
+
+void closeFd(int& fd) noexcept
+{
+    if (fd >= 0)
+    {
+        static_cast<void>(::close(fd));
+        fd = -1;
+    }
+}
+
+} // anonymous namespace
+
+iox::p3com::xdp::XDPTransport::XDPTransport(const iox::p3com::XDPTransportConfig_t& config) noexcept
+    : m_config(config)
+    , m_discovery(iox::p3com::SocketDiscovery::acquire())
+{
+    if (m_config.frameSize != 2048U && m_config.frameSize != 4096U)
+    {
+        iox::p3com::LogError() << "[XDPTransport] The frame size has to be 2048 or 4096";
+        setFailed();
+        return;
+    }
+    if (m_config.frameCount < 2U || (m_config.frameCount & (m_config.frameCount - 1U)) != 0U)
+    {
+        iox::p3com::LogError() << "[XDPTransport] The frame count has to be a power of two";
+        setFailed();
+        return;
+    }
+
+    if (!m_discovery->isGood() || !readInterface() || !loadProgram() || !attachProgram() || !createSocket())
+    {
+        closeAll();
+        setFailed();
+        return;
+    }
+
+    m_wakeEvent = ::eventfd(0U, EFD_CLOEXEC);
+    if (m_wakeEvent < 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not create the wake event: " << std::strerror(errno);
+        closeAll();
+        setFailed();
+        return;
+    }
+
+    iox::p3com::LogInfo() << "[XDPTransport] Receiving on queue " << m_config.queueId << " of "
+                          << m_config.interfaceName << " in " << (m_isZeroCopy ? "zero-copy" : "copy")
+                          << " mode, maximum message size " << maxMessageSize(0U) << " B";
+
+    m_receiveThread = std::thread([this]() { receiveWorker(); });
+}
+
+iox::p3com::xdp::XDPTransport::~XDPTransport()
+{
+    // The discovery outlives this transport if another socket transport still uses it
+    m_discovery->unregisterDiscoveryCallback(iox::p3com::TransportType::XDP);
+    m_isRunning.store(false);
+    if (m_receiveThread.joinable())
+    {
+        const uint64_t wake = 1U;
+        static_cast<void>(::write(m_wakeEvent, &wake, sizeof(wake)));
+        m_receiveThread.join();
+    }
+    closeAll();
+}
+
+void iox::p3com::xdp::XDPTransport::closeAll() noexcept
+{
+    // Closing the link detaches the XDP program from the interface
+    closeFd(m_linkFd);
+    closeFd(m_programFd);
+    closeFd(m_mapFd);
+    unmapRing(m_fillRing);
+    unmapRing(m_completionRing);
+    unmapRing(m_rxRing);
+    unmapRing(m_txRing);
+    closeFd(m_socket);
+    if (m_umem != nullptr)
+    {
+        static_cast<void>(::munmap(m_umem, m_umemSize));
+        m_umem = nullptr;
+    }
+    closeFd(m_resolveSocket);
+    closeFd(m_wakeEvent);
+}
+
+bool iox::p3com::xdp::XDPTransport::readInterface() noexcept
+{
+    m_ifindex = ::if_nametoindex(m_config.interfaceName.c_str());
+    if (m_ifindex == 0U)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Unknown interface '" << m_config.interfaceName
+                               << "', set the interface key in the [xdp] table";
+        return false;
+    }
+
+    m_resolveSocket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_resolveSocket < 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not create a UDP socket: " << std::strerror(errno);
+        return false;
+    }
+    // The MAC addresses have to be resolved on the interface of the XDP socket
+    static_cast<void>(::setsockopt(m_resolveSocket,
+                                   SOL_SOCKET,
+                                   SO_BINDTODEVICE,
+                                   m_config.interfaceName.c_str(),
+                                   static_cast<socklen_t>(m_config.interfaceName.size())));
+
+    ifreq request{};
+    std::strncpy(request.ifr_name, m_config.interfaceName.c_str(), IFNAMSIZ - 1);
+    if (::ioctl(m_resolveSocket, SIOCGIFHWADDR, &request) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not read the MAC address: " << std::strerror(errno);
+        return false;
+    }
+    std::memcpy(m_localMac.data(), request.ifr_hwaddr.sa_data, ETH_ALEN);
+    if (::ioctl(m_resolveSocket, SIOCGIFADDR, &request) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not read the IPv4 address: " << std::strerror(errno);
+        return false;
+    }
+    m_localAddress = reinterpret_cast<const sockaddr_in*>(&request.ifr_addr)->sin_addr;
+    if (::ioctl(m_resolveSocket, SIOCGIFMTU, &request) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not read the MTU: " << std::strerror(errno);
+        return false;
+    }
+    m_mtu = static_cast<uint32_t>(request.ifr_mtu);
+    return true;
+}
+
+bool iox::p3com::xdp::XDPTransport::loadProgram() noexcept
+{
+    bpf_attr mapAttr{};
+    mapAttr.map_type = BPF_MAP_TYPE_XSKMAP;
+    mapAttr.key_size = sizeof(uint32_t);
+    mapAttr.value_size = sizeof(int);
+    mapAttr.max_entries = m_config.queueId + 1U;
+    std::strncpy(mapAttr.map_name, "p3com_xsks", BPF_OBJ_NAME_LEN - 1);
+    m_mapFd = static_cast<int>(bpf(BPF_MAP_CREATE, mapAttr));
+    if (m_mapFd < 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not create the XSK map: " << std::strerror(errno);
+        return false;
+    }
+
+    // Redirects the IPv4 datagrams without options for the data port to the socket of the receive queue, and passes
+    // everything else on to the kernel. The fields are compared in network byte order, as they are in the frame.
+    constexpr int16_t PASS = 20;
+    const std::array<bpf_insn, 22U> program{{
+        instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+        instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1, offsetof(xdp_md, data), 0),
+        instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_1, offsetof(xdp_md, data_end), 0),
+        instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0),
+        instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, FRAME_HEADER_SIZE),
+        instruction(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, PASS - 6, 0),
+        instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, offsetof(ethhdr, h_proto), 0),
+        instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 8, htons(ETH_P_IP)),
+        instruction(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE, 0),
+        instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 10, 0x45),
+        instruction(
+            BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + offsetof(iphdr, protocol), 0),
+        instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 12, IPPROTO_UDP),
+        instruction(BPF_LDX | BPF_MEM | BPF_H,
+                    BPF_REG_5,
+                    BPF_REG_2,
+                    ETHERNET_HEADER_SIZE + IP_HEADER_SIZE + offsetof(udphdr, dest),
+                    0),
+        instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 14, htons(DATA_PORT)),
+        instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, rx_queue_index), 0),
+        instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, m_mapFd),
+        instruction(0U, 0U, 0U, 0, 0),
+        // A receive queue without a socket passes the frame on as well
+        instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS),
+        instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+        instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS),
+        instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+    }};
+
+    constexpr const char LICENSE[] = "Dual BSD/GPL";
+    bpf_attr programAttr{};
+    programAttr.prog_type = BPF_PROG_TYPE_XDP;
+    programAttr.expected_attach_type = BPF_XDP;
+    programAttr.insn_cnt = static_cast<uint32_t>(program.size());
+    programAttr.insns = reinterpret_cast<uint64_t>(program.data());
+    programAttr.license = reinterpret_cast<uint64_t>(LICENSE);
+    std::strncpy(programAttr.prog_name, "p3com_xdp", BPF_OBJ_NAME_LEN - 1);
+    m_programFd = static_cast<int>(bpf(BPF_PROG_LOAD, programAttr));
+    if (m_programFd < 0)
+    {
+        // Load it again with the log of the verifier, which explains the rejection
+        const int error = errno;
+        std::vector<char> log(16384U, '\0');
+        programAttr.log_level = 1U;
+        programAttr.log_buf = reinterpret_cast<uint64_t>(log.data());
+        programAttr.log_size = static_cast<uint32_t>(log.size());
+        static_cast<void>(bpf(BPF_PROG_LOAD, programAttr));
+        iox::p3com::LogError() << "[XDPTransport] Could not load the XDP program: " << std::strerror(error) << "\n"
+                               << log.data();
+        return false;
+    }
+    return true;
+}
+
+bool iox::p3com::xdp::XDPTransport::attachProgram() noexcept
+{
+    // Zero-copy needs the XDP program to run in the driver, generic mode works with every driver
+    bpf_attr linkAttr{};
+    linkAttr.link_create.prog_fd = static_cast<uint32_t>(m_programFd);
+    linkAttr.link_create.target_ifindex = m_ifindex;
+    linkAttr.link_create.attach_type = BPF_XDP;
+    if (!m_config.genericXdp)
+    {
+        linkAttr.link_create.flags = XDP_FLAGS_DRV_MODE;
+        m_linkFd = static_cast<int>(bpf(BPF_LINK_CREATE, linkAttr));
+        if (m_linkFd >= 0)
+        {
+            return true;
+        }
+        iox::p3com::LogWarn() << "[XDPTransport] Could not attach the XDP program in native mode ("
+                              << std::strerror(errno) << "), falling back to generic mode";
+    }
+
+    linkAttr.link_create.flags = XDP_FLAGS_SKB_MODE;
+    m_linkFd = static_cast<int>(bpf(BPF_LINK_CREATE, linkAttr));
+    if (m_linkFd < 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not attach the XDP program to " << m_config.interfaceName
+                               << ": " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool iox::p3com::xdp::XDPTransport::createSocket() noexcept
+{
+    m_umemSize = static_cast<size_t>(m_config.frameCount) * m_config.frameSize;
+    void* umem = ::mmap(nullptr, m_umemSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (umem == MAP_FAILED)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not allocate the packet buffer: " << std::strerror(errno);
+        return false;
+    }
+    m_umem = static_cast<uint8_t*>(umem);
+
+    m_socket = ::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (m_socket < 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not create the AF_XDP socket: " << std::strerror(errno);
+        return false;
+    }
+
+    xdp_umem_reg umemRegistration{};
+    umemRegistration.addr = reinterpret_cast<uint64_t>(m_umem);
+    umemRegistration.len = m_umemSize;
+    umemRegistration.chunk_size = m_config.frameSize;
+    // Half of the frames are owned by the fill and RX rings, the other half by the TX and completion rings
+    const int ringSize = static_cast<int>(m_config.frameCount / 2U);
+    if (::setsockopt(m_socket, SOL_XDP, XDP_UMEM_REG, &umemRegistration, sizeof(umemRegistration)) != 0
+        || ::setsockopt(m_socket, SOL_XDP, XDP_UMEM_FILL_RING, &ringSize, sizeof(ringSize)) != 0
+        || ::setsockopt(m_socket, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ringSize, sizeof(ringSize)) != 0
+        || ::setsockopt(m_socket, SOL_XDP, XDP_RX_RING, &ringSize, sizeof(ringSize)) != 0
+        || ::setsockopt(m_socket, SOL_XDP, XDP_TX_RING, &ringSize, sizeof(ringSize)) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not set up the rings: " << std::strerror(errno);
+        return false;
+    }
+
+    xdp_mmap_offsets offsets{};
+    socklen_t length = sizeof(offsets);
+    if (::getsockopt(m_socket, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &length) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not read the ring offsets: " << std::strerror(errno);
+        return false;
+    }
+    const auto size = static_cast<uint32_t>(ringSize);
+    if (!mapRing(m_fillRing, size, XDP_UMEM_PGOFF_FILL_RING, offsets.fr, sizeof(uint64_t))
+        || !mapRing(m_completionRing, size, XDP_UMEM_PGOFF_COMPLETION_RING, offsets.cr, sizeof(uint64_t))
+        || !mapRing(m_rxRing, size, XDP_PGOFF_RX_RING, offsets.rx, sizeof(xdp_desc))
+        || !mapRing(m_txRing, size, XDP_PGOFF_TX_RING, offsets.tx, sizeof(xdp_desc)))
+    {
+        return false;
+    }
+
+    // The kernel can only receive into the frames which are in the fill ring
+    auto* fillDescriptors = static_cast<uint64_t*>(m_fillRing.descriptors);
+    for (uint32_t i = 0U; i < size; ++i)
+    {
+        fillDescriptors[i] = static_cast<uint64_t>(i) * m_config.frameSize;
+    }
+    __atomic_store_n(m_fillRing.producer, size, __ATOMIC_RELEASE);
+    for (uint32_t i = size; i < m_config.frameCount; ++i)
+    {
+        m_freeTxFrames.push_back(static_cast<uint64_t>(i) * m_config.frameSize);
+    }
+
+    if (!bindSocket())
+    {
+        return false;
+    }
+
+    bpf_attr mapAttr{};
+    const uint32_t key = m_config.queueId;
+    const int value = m_socket;
+    mapAttr.map_fd = static_cast<uint32_t>(m_mapFd);
+    mapAttr.key = reinterpret_cast<uint64_t>(&key);
+    mapAttr.value = reinterpret_cast<uint64_t>(&value);
+    if (bpf(BPF_MAP_UPDATE_ELEM, mapAttr) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not add the socket to the XSK map: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool iox::p3com::xdp::XDPTransport::mapRing(
+    Ring_t& ring, uint32_t size, off_t offset, const xdp_ring_offset& offsets, size_t descriptorSize) noexcept
+{
+    ring.mapSize = offsets.desc + size * descriptorSize;
+    void* map = ::mmap(nullptr, ring.mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_socket, offset);
+    if (map == MAP_FAILED)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not map a ring: " << std::strerror(errno);
+        return false;
+    }
+    auto* base = static_cast<uint8_t*>(map);
+    ring.map = map;
+    ring.producer = reinterpret_cast<uint32_t*>(base + offsets.producer);
+    ring.consumer = reinterpret_cast<uint32_t*>(base + offsets.consumer);
+    ring.flags = reinterpret_cast<uint32_t*>(base + offsets.flags);
+    ring.descriptors = base + offsets.desc;
+    ring.size = size;
+    ring.mask = size - 1U;
+    return true;
+}
+
+void iox::p3com::xdp::XDPTransport::unmapRing(Ring_t& ring) noexcept
+{
+    if (ring.map != nullptr)
+    {
+        static_cast<void>(::munmap(ring.map, ring.mapSize));
+        ring = Ring_t();
+    }
+}
+
+bool iox::p3com::xdp::XDPTransport::bindSocket() noexcept
+{
+    sockaddr_xdp address{};
+    address.sxdp_family = AF_XDP;
+    address.sxdp_ifindex = m_ifindex;
+    address.sxdp_queue_id = m_config.queueId;
+
+    // A socket of a generic XDP program only receives in copy mode
+    if (m_config.zeroCopy && !m_config.genericXdp)
+    {
+        address.sxdp_flags = XDP_USE_NEED_WAKEUP | XDP_ZEROCOPY;
+        if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+        {
+            m_isZeroCopy = true;
+            return true;
+        }
+        iox::p3com::LogWarn() << "[XDPTransport] The driver does not support zero-copy (" << std::strerror(errno)
+                              << "), falling back to copy mode";
+    }
+
+    address.sxdp_flags = XDP_USE_NEED_WAKEUP | XDP_COPY;
+    if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Could not bind to queue " << m_config.queueId << " of "
+                               << m_config.interfaceName << ": " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void iox::p3com::xdp::XDPTransport::registerDiscoveryCallback(
+    iox::p3com::remoteDiscoveryCallback_t callback) noexcept
+{
+    m_discovery->registerDiscoveryCallback(iox::p3com::TransportType::XDP, std::move(callback));
+}
+
+void iox::p3com::xdp::XDPTransport::registerUserDataCallback(iox::p3com::userDataCallback_t callback) noexcept
+{
+    m_userDataCallback = std::move(callback);
+}
+
+void iox::p3com::xdp::XDPTransport::sendBroadcast(const void* data, size_t size) noexcept
+{
+    m_discovery->sendBroadcast(data, size);
+}
+
+bool iox::p3com::xdp::XDPTransport::resolve(uint32_t deviceIndex, const asio::ip::address& address) noexcept
+{
+    auto& neighbor = m_neighbors[deviceIndex];
+    const auto now = std::chrono::steady_clock::now();
+    if (neighbor.isResolved || now < neighbor.nextResolveTime)
+    {
+        return neighbor.isResolved;
+    }
+    neighbor.nextResolveTime = now + RESOLVE_INTERVAL;
+
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(DATA_PORT);
+    destination.sin_addr.s_addr = htonl(address.to_v4().to_ulong());
+    arpreq request{};
+    std::memcpy(&request.arp_pa, &destination, sizeof(destination));
+    std::strncpy(request.arp_dev, m_config.interfaceName.c_str(), sizeof(request.arp_dev) - 1U);
+    if (::ioctl(m_resolveSocket, SIOCGARP, &request) == 0 && (request.arp_flags & ATF_COM) != 0)
+    {
+        std::memcpy(neighbor.mac.data(), request.arp_ha.sa_data, ETH_ALEN);
+        neighbor.isResolved = true;
+        iox::p3com::LogInfo() << "[XDPTransport] Resolved the MAC address of " << address.to_string();
+        return true;
+    }
+
+    // An empty datagram through the network stack makes the kernel resolve the address, it is discarded by the
+    // receiving transport
+    static_cast<void>(::sendto(m_resolveSocket,
+                               nullptr,
+                               0U,
+                               MSG_DONTWAIT,
+                               reinterpret_cast<const sockaddr*>(&destination),
+                               sizeof(destination)));
+    iox::p3com::LogDebug() << "[XDPTransport] Resolving the MAC address of " << address.to_string();
+    return false;
+}
+
+void iox::p3com::xdp::XDPTransport::reclaimSentFrames() noexcept
+{
+    const uint32_t producer = __atomic_load_n(m_completionRing.producer, __ATOMIC_ACQUIRE);
+    uint32_t consumer = *m_completionRing.consumer;
+    const auto* descriptors = static_cast<const uint64_t*>(m_completionRing.descriptors);
+    for (; consumer != producer; ++consumer)
+    {
+        m_freeTxFrames.push_back(descriptors[consumer & m_completionRing.mask]);
+    }
+    __atomic_store_n(m_completionRing.consumer, consumer, __ATOMIC_RELEASE);
+}
+
+bool iox::p3com::xdp::XDPTransport::sendUserData(
+    const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept
+{
+    const size_t size = size1 + size2;
+    if (size > maxMessageSize(deviceIndex))
+    {
+        iox::p3com::LogError() << "[XDPTransport] Message does not fit into a frame! Discarding!";
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    const auto address = m_discovery->getAddress(deviceIndex);
+    if (!address.has_value() || deviceIndex >= MAX_DEVICE_COUNT)
+    {
+        iox::p3com::LogError() << "[XDPTransport] Invalid device index when sending user data";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    reclaimSentFrames();
+    // Every TX frame is either free or in one of the two rings, so a free frame always fits into the TX ring
+    if (!resolve(deviceIndex, *address) || m_freeTxFrames.empty())
+    {
+        m_droppedMessages.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    const uint64_t frameAddress = m_freeTxFrames.back();
+    m_freeTxFrames.pop_back();
+
+    uint8_t* frame = m_umem + frameAddress;
+    auto* ethernetHeader = reinterpret_cast<ethhdr*>(frame);
+    std::memcpy(ethernetHeader->h_dest, m_neighbors[deviceIndex].mac.data(), ETH_ALEN);
+    std::memcpy(ethernetHeader->h_source, m_localMac.data(), ETH_ALEN);
+    ethernetHeader->h_proto = htons(ETH_P_IP);
+
+    iphdr ipHeader{};
+    ipHeader.version = 4U;
+    ipHeader.ihl = IP_HEADER_SIZE / 4U;
+    ipHeader.tot_len = htons(static_cast<uint16_t>(IP_HEADER_SIZE + UDP_HEADER_SIZE + size));
+    ipHeader.id = htons(m_ipIdentification++);
+    ipHeader.frag_off = htons(IP_DF);
+    ipHeader.ttl = 64U;
+    ipHeader.protocol = IPPROTO_UDP;
+    ipHeader.saddr = m_localAddress.s_addr;
+    ipHeader.daddr = htonl(address->to_v4().to_ulong());
+    ipHeader.check = ipChecksum(&ipHeader, sizeof(ipHeader));
+    std::memcpy(frame + ETHERNET_HEADER_SIZE, &ipHeader, sizeof(ipHeader));
+
+    // The UDP checksum is optional with IPv4
+    udphdr udpHeader{};
+    udpHeader.source = htons(DATA_PORT);
+    udpHeader.dest = htons(DATA_PORT);
+    udpHeader.len = htons(static_cast<uint16_t>(UDP_HEADER_SIZE + size));
+    std::memcpy(frame + ETHERNET_HEADER_SIZE + IP_HEADER_SIZE, &udpHeader, sizeof(udpHeader));
+
+    std::memcpy(frame + FRAME_HEADER_SIZE, data1, size1);
+    if (size2 != 0U)
+    {
+        std::memcpy(frame + FRAME_HEADER_SIZE + size1, data2, size2);
+    }
+
+    const uint32_t producer = *m_txRing.producer;
+    auto* descriptors = static_cast<xdp_desc*>(m_txRing.descriptors);
+    descriptors[producer & m_txRing.mask] = xdp_desc{frameAddress, static_cast<uint32_t>(FRAME_HEADER_SIZE + size), 0U};
+    __atomic_store_n(m_txRing.producer, producer + 1U, __ATOMIC_RELEASE);
+
+    // In copy mode, the frames are only sent by this call
+    if ((__atomic_load_n(m_txRing.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) != 0U)
+    {
+        m_sendCalls.fetch_add(1U, std::memory_order_relaxed);
+        if (::sendto(m_socket, nullptr, 0U, MSG_DONTWAIT, nullptr, 0U) < 0 && errno != EAGAIN && errno != EBUSY
+            && errno != ENOBUFS)
+        {
+            iox::p3com::LogWarn() << "[XDPTransport] Could not wake up the driver: " << std::strerror(errno);
+        }
+    }
+    m_sentMessages.fetch_add(1U, std::memory_order_relaxed);
+    m_sentBytes.fetch_add(size, std::memory_order_relaxed);
+    return false;
+}
+
+void iox::p3com::xdp::XDPTransport::receiveWorker() noexcept
+{
+    std::array<pollfd, 2U> pollFds{{{m_socket, POLLIN, 0}, {m_wakeEvent, POLLIN, 0}}};
+    while (m_isRunning.load())
+    {
+        // Polling also wakes up the driver to refill its receive queue from the fill ring
+        if (::poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            iox::p3com::LogError() << "[XDPTransport] Could not poll the socket: " << std::strerror(errno);
+            setFailed();
+            break;
+        }
+        if (pollFds[1U].revents != 0)
+        {
+            break;
+        }
+        m_receiveWakeups.fetch_add(1U, std::memory_order_relaxed);
+        while (receive() == MAX_RECEIVE_BATCH && m_isRunning.load())
+        {
+        }
+    }
+    iox::p3com::LogInfo() << "[XDPTransport] Receive thread has exited";
+}
+
+uint32_t iox::p3com::xdp::XDPTransport::receive() noexcept
+{
+    const uint32_t producer = __atomic_load_n(m_rxRing.producer, __ATOMIC_ACQUIRE);
+    const uint32_t consumer = *m_rxRing.consumer;
+    const uint32_t count = std::min(producer - consumer, MAX_RECEIVE_BATCH);
+    if (count == 0U)
+    {
+        return 0U;
+    }
+
+    // The frames go back to the fill ring, which has room for all of them since the RX half of the frames is either
+    // in one of the two rings or being handled here
+    const auto* rxDescriptors = static_cast<const xdp_desc*>(m_rxRing.descriptors);
+    auto* fillDescriptors = static_cast<uint64_t*>(m_fillRing.descriptors);
+    const uint32_t fillProducer = *m_fillRing.producer;
+    const uint64_t frameMask = ~static_cast<uint64_t>(m_config.frameSize - 1U);
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        const xdp_desc& descriptor = rxDescriptors[(consumer + i) & m_rxRing.mask];
+        handleFrame(m_umem + descriptor.addr, descriptor.len);
+        fillDescriptors[(fillProducer + i) & m_fillRing.mask] = descriptor.addr & frameMask;
+    }
+    __atomic_store_n(m_rxRing.consumer, consumer + count, __ATOMIC_RELEASE);
+    __atomic_store_n(m_fillRing.producer, fillProducer + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+void iox::p3com::xdp::XDPTransport::handleFrame(const uint8_t* frame, uint32_t size) noexcept
+{
+    const auto receiveTime = std::chrono::steady_clock::now();
+
+    // The XDP program only lets IPv4 datagrams without options for the data port through
+    iphdr ipHeader{};
+    udphdr udpHeader{};
+    if (size < FRAME_HEADER_SIZE)
+    {
+        return;
+    }
+    std::memcpy(&ipHeader, frame + ETHERNET_HEADER_SIZE, sizeof(ipHeader));
+    std::memcpy(&udpHeader, frame + ETHERNET_HEADER_SIZE + IP_HEADER_SIZE, sizeof(udpHeader));
+    const uint32_t udpSize = ntohs(udpHeader.len);
+    if (udpSize <= UDP_HEADER_SIZE || ETHERNET_HEADER_SIZE + IP_HEADER_SIZE + udpSize > size
+        || (ntohs(ipHeader.frag_off) & (IP_MF | IP_OFFMASK)) != 0U)
+    {
+        // Also the empty datagrams which resolve the MAC address of this gateway
+        return;
+    }
+    const uint32_t payloadSize = udpSize - UDP_HEADER_SIZE;
+
+    m_receivedMessages.fetch_add(1U, std::memory_order_relaxed);
+    m_receivedBytes.fetch_add(payloadSize, std::memory_order_relaxed);
+    const auto index = m_discovery->getIndex(asio::ip::address_v4(ntohl(ipHeader.saddr)));
+    if (!index.has_value())
+    {
+        iox::p3com::LogError() << "[XDPTransport] Received user data message from an unknown device! Discarding!";
+        return;
+    }
+    if (m_userDataCallback)
+    {
+        m_userDataCallback(frame + FRAME_HEADER_SIZE, payloadSize, {iox::p3com::TransportType::XDP, *index});
+    }
+    m_receiveLatency.record(std::chrono::steady_clock::now() - receiveTime);
+}
+
+size_t iox::p3com::xdp::XDPTransport::maxMessageSize(uint32_t deviceIndex) const noexcept
+{
+    static_cast<void>(deviceIndex);
+    // The driver receives behind the XDP headroom of a frame
+    const uint32_t frameLimit = m_config.frameSize - XDP_PACKET_HEADROOM - FRAME_HEADER_SIZE;
+    const uint32_t mtuLimit = m_mtu - IP_HEADER_SIZE - UDP_HEADER_SIZE;
+    return std::min(frameLimit, mtuLimit);
+}
+
+iox::p3com::TransportType iox::p3com::xdp::XDPTransport::getType() const noexcept
+{
+    return iox::p3com::TransportType::XDP;
+}
+
+iox::p3com::TransportStatistics_t iox::p3com::xdp::XDPTransport::getStatistics() const noexcept
+{
+    iox::p3com::TransportStatistics_t stats;
+    stats.receivedMessages = m_receivedMessages.load(std::memory_order_relaxed);
+    stats.receivedBytes = m_receivedBytes.load(std::memory_order_relaxed);
+    stats.receiveWakeups = m_receiveWakeups.load(std::memory_order_relaxed);
+    stats.sentMessages = m_sentMessages.load(std::memory_order_relaxed);
+    stats.sentBytes = m_sentBytes.load(std::memory_order_relaxed);
+    stats.sendCalls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.droppedMessages = m_droppedMessages.load(std::memory_order_relaxed);
+    const auto latencyCounts = m_receiveLatency.counts();
+    stats.receiveLatencyP50Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.5);
+    stats.receiveLatencyP99Ns = iox::p3com::LatencyHistogram::percentile(latencyCounts, 0.99);
+    return stats;
+}
@@ -0,0 +1,229 @@
+// Copyright 2023 NXP
+
+#include "p3com/generic/fec.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace
+{
+using namespace iox::p3com;
+
+class FecManager_test : public ::testing::Test
+{
+  protected:
+    static constexpr hash_t MESSAGE_HASH = 0x1234U;
+    static constexpr uint32_t SUBMESSAGE_SIZE = 100U;
+
+    void SetUp() override
+    {
+        m_sut = std::make_unique<FecManager>();
+    }
+
+    void setUpMessage(uint32_t userPayloadSize, uint32_t groupSize, uint32_t parityCount)
+    {
+        m_payload.resize(userPayloadSize);
+        for (uint32_t i = 0U; i < userPayloadSize; ++i)
+        {
+            m_payload[i] = static_cast<uint8_t>(i * 7U + 3U);
+        }
+        m_received.assign(userPayloadSize, 0U);
+
+        m_header = IoxChunkDatagramHeader_t{};
+        m_header.messageHash = MESSAGE_HASH;
+        m_header.submessageCount = (userPayloadSize + SUBMESSAGE_SIZE - 1U) / SUBMESSAGE_SIZE;
+        m_header.userPayloadSize = userPayloadSize;
+        m_header.userPayloadAlignment = 8U;
+        m_header.userHeaderSize = 0U;
+        m_header.fecGroupSize = groupSize;
+        m_header.fecParityCount = parityCount;
+        m_header.fecParityIndex = FEC_DATA_INDEX;
+    }
+
+    // Hands the data submessage with the given index over to the manager, as the data reader does
+    bool receiveData(uint32_t index)
+    {
+        auto header = dataHeader(index);
+        std::copy_n(&m_payload[header.submessageOffset], header.submessageSize, &m_received[header.submessageOffset]);
+        return m_sut->acceptData(header, deadline());
+    }
+
+    // Builds the parity like the data writer, the short last submessage is XORed as if it was padded with zeros
+    void receiveParity(uint32_t groupIndex, uint32_t parityIndex)
+    {
+        const uint32_t firstIndex = groupIndex * m_header.fecGroupSize;
+        const uint32_t endIndex = std::min(firstIndex + m_header.fecGroupSize, m_header.submessageCount);
+        std::vector<uint8_t> parity(SUBMESSAGE_SIZE, 0U);
+        for (uint32_t i = firstIndex + parityIndex; i < endIndex; i += m_header.fecParityCount)
+        {
+            const auto header = dataHeader(i);
+            for (uint32_t j = 0U; j < header.submessageSize; ++j)
+            {
+                parity[j] ^= m_payload[header.submessageOffset + j];
+            }
+        }
+
+        auto header = m_header;
+        header.submessageOffset = firstIndex * SUBMESSAGE_SIZE;
+        header.submessageSize = SUBMESSAGE_SIZE;
+        header.fecParityIndex = parityIndex;
+        m_sut->acceptParity(header, parity.data(), deadline());
+    }
+
+    IoxChunkDatagramHeader_t dataHeader(uint32_t index) const
+    {
+        auto header = m_header;
+        header.submessageOffset = index * SUBMESSAGE_SIZE;
+        header.submessageSize = std::min(SUBMESSAGE_SIZE, m_header.userPayloadSize - header.submessageOffset);
+        return header;
+    }
+
+    // Rebuilds the next submessage, checks it against the sent data and writes it to the received payload
+    bool recoverAndCheck(uint32_t expectedIndex)
+    {
+        IoxChunkDatagramHeader_t header{};
+        if (!m_sut->recoverNext(MESSAGE_HASH, m_received.data(), header, m_buffer))
+        {
+            return false;
+        }
+        const auto expected = dataHeader(expectedIndex);
+        EXPECT_EQ(header.submessageOffset, expected.submessageOffset);
+        EXPECT_EQ(header.submessageSize, expected.submessageSize);
+        EXPECT_EQ(header.fecParityIndex, FEC_DATA_INDEX);
+        EXPECT_TRUE(std::equal(
+            m_buffer.begin(), m_buffer.begin() + header.submessageSize, &m_payload[expected.submessageOffset]));
+        std::copy_n(m_buffer.begin(), header.submessageSize, &m_received[header.submessageOffset]);
+        return true;
+    }
+
+    static std::chrono::steady_clock::time_point deadline()
+    {
+        return std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    }
+
+    std::unique_ptr<FecManager> m_sut;
+    IoxChunkDatagramHeader_t m_header{};
+    std::vector<uint8_t> m_payload;
+    std::vector<uint8_t> m_received;
+    FecSubmessageBuffer_t m_buffer;
+};
+
+constexpr hash_t FecManager_test::MESSAGE_HASH;
+constexpr uint32_t FecManager_test::SUBMESSAGE_SIZE;
+
+TEST_F(FecManager_test, LostSubmessageIsRebuiltFromParity)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 1U);
+    EXPECT_TRUE(receiveData(0U));
+    EXPECT_TRUE(receiveData(1U));
+    EXPECT_TRUE(receiveData(3U));
+    receiveParity(0U, 0U);
+
+    EXPECT_TRUE(recoverAndCheck(2U));
+    EXPECT_EQ(m_received, m_payload);
+    EXPECT_FALSE(recoverAndCheck(2U));
+    EXPECT_EQ(m_sut->getStatistics().recoveredSubmessages, 1U);
+}
+
+TEST_F(FecManager_test, ShortLastSubmessageIsRebuiltWithItsOwnSize)
+{
+    setUpMessage(3U * SUBMESSAGE_SIZE + 50U, 4U, 1U);
+    EXPECT_TRUE(receiveData(0U));
+    EXPECT_TRUE(receiveData(1U));
+    EXPECT_TRUE(receiveData(2U));
+    receiveParity(0U, 0U);
+
+    EXPECT_TRUE(recoverAndCheck(3U));
+    EXPECT_EQ(m_received, m_payload);
+}
+
+TEST_F(FecManager_test, InterleavedParitiesRebuildAdjacentLosses)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 2U);
+    EXPECT_TRUE(receiveData(0U));
+    EXPECT_TRUE(receiveData(1U));
+    receiveParity(0U, 0U);
+    receiveParity(0U, 1U);
+
+    // Parity 0 covers the submessages 0 and 2, parity 1 the submessages 1 and 3
+    EXPECT_TRUE(recoverAndCheck(2U));
+    EXPECT_TRUE(recoverAndCheck(3U));
+    EXPECT_EQ(m_received, m_payload);
+    EXPECT_EQ(m_sut->getStatistics().recoveredSubmessages, 2U);
+}
+
+TEST_F(FecManager_test, TwoLossesCoveredByTheSameParityAreNotRebuilt)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 1U);
+    EXPECT_TRUE(receiveData(0U));
+    EXPECT_TRUE(receiveData(3U));
+    receiveParity(0U, 0U);
+
+    EXPECT_FALSE(recoverAndCheck(1U));
+}
+
+TEST_F(FecManager_test, EveryGroupIsRebuiltFromItsOwnParity)
+{
+    setUpMessage(8U * SUBMESSAGE_SIZE, 4U, 1U);
+    for (uint32_t i : {0U, 2U, 3U, 4U, 5U, 6U})
+    {
+        EXPECT_TRUE(receiveData(i));
+    }
+    receiveParity(0U, 0U);
+    receiveParity(1U, 0U);
+
+    EXPECT_TRUE(recoverAndCheck(1U));
+    EXPECT_TRUE(recoverAndCheck(7U));
+    EXPECT_EQ(m_received, m_payload);
+}
+
+TEST_F(FecManager_test, DuplicateDataIsDiscarded)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 1U);
+    EXPECT_TRUE(receiveData(0U));
+    EXPECT_FALSE(receiveData(0U));
+}
+
+TEST_F(FecManager_test, DataOfCompletedMessageIsDiscarded)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 1U);
+    EXPECT_TRUE(receiveData(0U));
+    m_sut->complete(MESSAGE_HASH);
+
+    EXPECT_FALSE(receiveData(1U));
+    receiveParity(0U, 0U);
+    EXPECT_FALSE(recoverAndCheck(1U));
+}
+
+TEST_F(FecManager_test, InvalidParityIsDiscarded)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 1U);
+    EXPECT_TRUE(receiveData(0U));
+    EXPECT_TRUE(receiveData(1U));
+    EXPECT_TRUE(receiveData(3U));
+
+    auto header = m_header;
+    header.submessageOffset = 0U;
+    header.submessageSize = SUBMESSAGE_SIZE;
+    header.fecParityIndex = 1U;
+    const std::vector<uint8_t> parity(SUBMESSAGE_SIZE, 0U);
+    m_sut->acceptParity(header, parity.data(), deadline());
+
+    EXPECT_FALSE(recoverAndCheck(2U));
+}
+
+TEST_F(FecManager_test, ExpiredMessageIsCountedAsLost)
+{
+    setUpMessage(4U * SUBMESSAGE_SIZE, 4U, 1U);
+    EXPECT_TRUE(m_sut->acceptData(dataHeader(0U), std::chrono::steady_clock::now() - std::chrono::seconds(1)));
+    m_sut->checkMessages();
+
+    EXPECT_EQ(m_sut->getStatistics().lostMessages, 1U);
+}
+
+} // namespace
@@ -0,0 +1,189 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/shm/shm_region.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+using namespace iox::p3com::shm;
+
+class SHMRing_test : public ::testing::Test
+{
+  protected:
+    static constexpr uint32_t SLOT_COUNT = 4U;
+    static constexpr uint32_t SLOT_SIZE = 256U;
+    // The control block of the ring is aligned to cache lines
+    static constexpr size_t ALIGNMENT = 64U;
+
+    void SetUp() override
+    {
+        // Zeroed like a fresh shared memory object
+        const size_t size = (SHMRing::requiredSize(SLOT_COUNT, SLOT_SIZE) + ALIGNMENT - 1U) / ALIGNMENT * ALIGNMENT;
+        void* memory = nullptr;
+        ASSERT_EQ(posix_memalign(&memory, ALIGNMENT, size), 0);
+        m_memory.reset(static_cast<uint8_t*>(memory));
+        std::memset(m_memory.get(), 0, size);
+        m_sut.attach(m_memory.get(), SLOT_COUNT, SLOT_SIZE);
+    }
+
+    bool push(uint32_t value)
+    {
+        auto* slot = m_sut.reserve();
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        std::memcpy(slot, &value, sizeof(value));
+        m_sut.commit(SHMRing::Kind::USER_DATA, static_cast<uint32_t>(sizeof(value)) + value % 16U);
+        return true;
+    }
+
+    void expectPop(uint32_t value)
+    {
+        SHMRing::Descriptor_t descriptor{};
+        const auto* slot = m_sut.peek(descriptor);
+        ASSERT_NE(slot, nullptr);
+        uint32_t received = 0U;
+        std::memcpy(&received, slot, sizeof(received));
+        EXPECT_EQ(received, value);
+        EXPECT_EQ(descriptor.kind, SHMRing::Kind::USER_DATA);
+        EXPECT_EQ(descriptor.size, sizeof(value) + value % 16U);
+        m_sut.pop();
+    }
+
+    struct Free_t
+    {
+        void operator()(uint8_t* memory) const
+        {
+            std::free(memory);
+        }
+    };
+
+    std::unique_ptr<uint8_t, Free_t> m_memory;
+    SHMRing m_sut;
+};
+
+constexpr uint32_t SHMRing_test::SLOT_COUNT;
+constexpr uint32_t SHMRing_test::SLOT_SIZE;
+constexpr size_t SHMRing_test::ALIGNMENT;
+
+TEST_F(SHMRing_test, NewRingIsEmpty)
+{
+    SHMRing::Descriptor_t descriptor{};
+
+    EXPECT_EQ(m_sut.peek(descriptor), nullptr);
+}
+
+TEST_F(SHMRing_test, MessagesArePoppedInOrder)
+{
+    EXPECT_TRUE(push(1U));
+    EXPECT_TRUE(push(2U));
+    EXPECT_TRUE(push(3U));
+
+    expectPop(1U);
+    expectPop(2U);
+    expectPop(3U);
+    SHMRing::Descriptor_t descriptor{};
+    EXPECT_EQ(m_sut.peek(descriptor), nullptr);
+}
+
+TEST_F(SHMRing_test, PeekDoesNotRemoveTheMessage)
+{
+    EXPECT_TRUE(push(5U));
+    SHMRing::Descriptor_t descriptor{};
+    const auto* first = m_sut.peek(descriptor);
+    const auto* second = m_sut.peek(descriptor);
+
+    EXPECT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(SHMRing_test, FullRingRejectsReservations)
+{
+    for (uint32_t i = 0U; i < SLOT_COUNT; ++i)
+    {
+        EXPECT_TRUE(push(i));
+    }
+
+    EXPECT_EQ(m_sut.reserve(), nullptr);
+    expectPop(0U);
+    EXPECT_TRUE(push(SLOT_COUNT));
+    EXPECT_EQ(m_sut.reserve(), nullptr);
+}
+
+TEST_F(SHMRing_test, PositionsWrapAroundTheSlots)
+{
+    // Interleaved, so that the head and the tail wrap around at different times
+    uint32_t pushed = 0U;
+    uint32_t popped = 0U;
+    for (uint32_t round = 0U; round < 10U * SLOT_COUNT; ++round)
+    {
+        while (push(pushed))
+        {
+            pushed++;
+        }
+        const uint32_t popCount = round % SLOT_COUNT + 1U;
+        for (uint32_t i = 0U; i < popCount; ++i)
+        {
+            expectPop(popped++);
+        }
+    }
+
+    EXPECT_GT(pushed, 10U * SLOT_COUNT);
+    while (popped != pushed)
+    {
+        expectPop(popped++);
+    }
+    SHMRing::Descriptor_t descriptor{};
+    EXPECT_EQ(m_sut.peek(descriptor), nullptr);
+}
+
+TEST_F(SHMRing_test, SlotsAreReusedAfterWrapAround)
+{
+    const auto* first = m_sut.reserve();
+    for (uint32_t i = 0U; i < SLOT_COUNT; ++i)
+    {
+        EXPECT_TRUE(push(i));
+        expectPop(i);
+    }
+
+    EXPECT_EQ(m_sut.reserve(), first);
+}
+
+TEST_F(SHMRing_test, DiscardDropsAllMessages)
+{
+    EXPECT_TRUE(push(1U));
+    EXPECT_TRUE(push(2U));
+    m_sut.discard();
+
+    SHMRing::Descriptor_t descriptor{};
+    EXPECT_EQ(m_sut.peek(descriptor), nullptr);
+    EXPECT_TRUE(push(3U));
+    expectPop(3U);
+}
+
+TEST_F(SHMRing_test, CommitWithoutSleepingConsumerNeedsNoWakeup)
+{
+    auto* slot = m_sut.reserve();
+    ASSERT_NE(slot, nullptr);
+
+    EXPECT_FALSE(m_sut.commit(SHMRing::Kind::DISCOVERY, 0U));
+}
+
+TEST_F(SHMRing_test, WaitReturnsRightAwayIfRingIsNotEmpty)
+{
+    EXPECT_TRUE(push(1U));
+    const auto start = std::chrono::steady_clock::now();
+    m_sut.wait(std::chrono::milliseconds(1000));
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+}
+
+} // namespace
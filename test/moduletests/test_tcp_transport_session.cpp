@@ -0,0 +1,415 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/tcp/tcp_server_transport_session.hpp"
+
+#include "gtest/gtest.h"
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace
+{
+using namespace iox::p3com;
+using namespace iox::p3com::tcp;
+
+/**
+ * @brief Feeds hand-made frames into a server session over a loopback connection and records what it hands over
+ */
+class TCPTransportSession_test : public ::testing::Test
+{
+  protected:
+    static constexpr std::chrono::seconds TIMEOUT{5};
+    static constexpr size_t LARGE_MESSAGE_HEADER_SIZE = 16U;
+    static constexpr uint32_t LARGE_MESSAGE_DEVICE_INDEX = 7U;
+    static constexpr size_t LARGE_MESSAGE_SIZE = TCPTransportSession::MAX_PACKET_SIZE + 10000U;
+
+    void SetUp() override
+    {
+        m_sut = std::make_shared<TCPServerTransportSession>(
+            m_ioService,
+            m_config,
+            [this](const void* data, size_t size, asio::ip::tcp::endpoint, std::chrono::steady_clock::time_point) {
+                const auto* bytes = static_cast<const uint8_t*>(data);
+                m_messages.emplace_back(bytes, bytes + size);
+            },
+            [this](const void* data, size_t size, size_t messageSize, asio::ip::tcp::endpoint) {
+                const auto* bytes = static_cast<const uint8_t*>(data);
+                m_largeMessageBeginning.assign(bytes, bytes + size);
+                m_largeMessageSize = messageSize;
+                m_largeMessageBuffer.assign(messageSize - LARGE_MESSAGE_HEADER_SIZE, 0U);
+                return TCPTransportSession::MessageBuffer_t{m_isLargeMessageDiscarded ? nullptr
+                                                                                      : m_largeMessageBuffer.data(),
+                                                            LARGE_MESSAGE_HEADER_SIZE,
+                                                            LARGE_MESSAGE_DEVICE_INDEX};
+            },
+            [this](const void* header,
+                   size_t headerSize,
+                   bool isComplete,
+                   uint32_t deviceIndex,
+                   std::chrono::steady_clock::time_point) {
+                const auto* bytes = static_cast<const uint8_t*>(header);
+                m_largeMessageHeader.assign(bytes, bytes + headerSize);
+                m_isLargeMessageComplete = isComplete;
+                m_largeMessageDeviceIndex = deviceIndex;
+                m_largeMessageReadCount++;
+            },
+            [](const void*) {},
+            [this](TCPTransportSession*) { m_closedCount++; });
+
+        asio::ip::tcp::acceptor acceptor{m_ioService,
+                                         asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0U)};
+        m_client.connect(acceptor.local_endpoint());
+        acceptor.accept(m_sut->getSocket());
+        m_sut->start();
+    }
+
+    void TearDown() override
+    {
+        asio::error_code ec;
+        m_client.close(ec);
+        m_sut.reset();
+    }
+
+    static std::vector<uint8_t> makeMessage(size_t size, uint8_t seed)
+    {
+        std::vector<uint8_t> message(size);
+        for (size_t i = 0U; i < size; ++i)
+        {
+            message[i] = static_cast<uint8_t>(i * 13U + seed);
+        }
+        return message;
+    }
+
+    static void appendFrame(std::vector<uint8_t>& stream, const std::vector<uint8_t>& message)
+    {
+        const size_t size = message.size();
+        const auto* sizeBytes = reinterpret_cast<const uint8_t*>(&size);
+        stream.insert(stream.end(), sizeBytes, sizeBytes + sizeof(size));
+        stream.insert(stream.end(), message.begin(), message.end());
+    }
+
+    // Written by the io service, so that streams larger than the socket buffers are read while they are written. The
+    // data has to stay valid until the session has handed it over.
+    void write(const uint8_t* data, size_t size)
+    {
+        asio::async_write(m_client, asio::buffer(data, size), [](asio::error_code, size_t) {});
+    }
+
+    template <typename Predicate>
+    bool runUntil(Predicate predicate)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+        while (!predicate() && std::chrono::steady_clock::now() < deadline)
+        {
+            m_ioService.run_one_for(std::chrono::milliseconds(10));
+        }
+        return predicate();
+    }
+
+    // Gives the session the chance to hand over anything it should not have
+    void runFor(std::chrono::milliseconds duration)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            m_ioService.run_one_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    TCPTransportConfig_t m_config;
+    asio::io_service m_ioService;
+    asio::ip::tcp::socket m_client{m_ioService};
+    std::shared_ptr<TCPServerTransportSession> m_sut;
+
+    std::vector<std::vector<uint8_t>> m_messages;
+    bool m_isLargeMessageDiscarded{false};
+    std::vector<uint8_t> m_largeMessageBeginning;
+    size_t m_largeMessageSize{0U};
+    std::vector<uint8_t> m_largeMessageBuffer;
+    std::vector<uint8_t> m_largeMessageHeader;
+    bool m_isLargeMessageComplete{false};
+    uint32_t m_largeMessageDeviceIndex{0U};
+    uint32_t m_largeMessageReadCount{0U};
+    uint32_t m_closedCount{0U};
+};
+
+/**
+ * @brief Same as above with the io_uring of the connection, which falls back to the io thread if it is not available
+ */
+class TCPTransportSessionIoUring_test : public TCPTransportSession_test
+{
+  protected:
+    TCPTransportSessionIoUring_test()
+    {
+        m_config.ioUring = true;
+    }
+};
+
+constexpr std::chrono::seconds TCPTransportSession_test::TIMEOUT;
+constexpr size_t TCPTransportSession_test::LARGE_MESSAGE_HEADER_SIZE;
+constexpr uint32_t TCPTransportSession_test::LARGE_MESSAGE_DEVICE_INDEX;
+constexpr size_t TCPTransportSession_test::LARGE_MESSAGE_SIZE;
+
+TEST_F(TCPTransportSession_test, FramesReadAtOnceAreHandedOverOneByOne)
+{
+    const std::vector<std::vector<uint8_t>> messages{makeMessage(10U, 1U), makeMessage(1000U, 2U), makeMessage(1U, 3U)};
+    std::vector<uint8_t> stream;
+    for (const auto& message : messages)
+    {
+        appendFrame(stream, message);
+    }
+    write(stream.data(), stream.size());
+
+    ASSERT_TRUE(runUntil([this]() { return m_messages.size() == 3U; }));
+    EXPECT_EQ(m_messages, messages);
+}
+
+TEST_F(TCPTransportSession_test, FrameSplitAcrossReadsIsHandedOverOnceComplete)
+{
+    const auto message = makeMessage(5000U, 4U);
+    std::vector<uint8_t> stream;
+    appendFrame(stream, message);
+
+    // Split within the length prefix and within the message
+    write(stream.data(), 3U);
+    runFor(std::chrono::milliseconds(50));
+    write(stream.data() + 3U, 2000U);
+    runFor(std::chrono::milliseconds(50));
+    EXPECT_TRUE(m_messages.empty());
+
+    write(stream.data() + 2003U, stream.size() - 2003U);
+    ASSERT_TRUE(runUntil([this]() { return m_messages.size() == 1U; }));
+    EXPECT_EQ(m_messages[0], message);
+}
+
+TEST_F(TCPTransportSession_test, ManySmallFramesWrapAroundTheReadBuffer)
+{
+    // Several times the size of the read buffer, with frame sizes which do not divide it
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0U; i < 200U; ++i)
+    {
+        messages.push_back(makeMessage(3000U + i * 37U, static_cast<uint8_t>(i)));
+        appendFrame(stream, messages.back());
+    }
+    write(stream.data(), stream.size());
+
+    ASSERT_TRUE(runUntil([this, &messages]() { return m_messages.size() == messages.size(); }));
+    EXPECT_EQ(m_messages, messages);
+}
+
+TEST_F(TCPTransportSession_test, LargeMessageIsReadIntoItsBuffer)
+{
+    const auto message = makeMessage(LARGE_MESSAGE_SIZE, 6U);
+    const auto following = makeMessage(100U, 7U);
+    std::vector<uint8_t> stream;
+    appendFrame(stream, message);
+    appendFrame(stream, following);
+
+    // Only the beginning is sent first, so the rest is read straight into the buffer
+    const size_t firstPartSize = sizeof(size_t) + 1000U;
+    write(stream.data(), firstPartSize);
+    ASSERT_TRUE(runUntil([this]() { return m_largeMessageSize != 0U; }));
+    EXPECT_EQ(m_largeMessageSize, LARGE_MESSAGE_SIZE);
+    ASSERT_GE(m_largeMessageBeginning.size(), LARGE_MESSAGE_HEADER_SIZE);
+    EXPECT_TRUE(std::equal(m_largeMessageBeginning.begin(), m_largeMessageBeginning.end(), message.begin()));
+    EXPECT_EQ(m_largeMessageReadCount, 0U);
+
+    write(stream.data() + firstPartSize, stream.size() - firstPartSize);
+    ASSERT_TRUE(runUntil([this]() { return m_largeMessageReadCount == 1U && m_messages.size() == 1U; }));
+    EXPECT_TRUE(m_isLargeMessageComplete);
+    EXPECT_EQ(m_largeMessageDeviceIndex, LARGE_MESSAGE_DEVICE_INDEX);
+    EXPECT_TRUE(std::equal(m_largeMessageHeader.begin(),
+                           m_largeMessageHeader.end(),
+                           message.begin(),
+                           message.begin() + LARGE_MESSAGE_HEADER_SIZE));
+    EXPECT_TRUE(std::equal(m_largeMessageBuffer.begin(),
+                           m_largeMessageBuffer.end(),
+                           message.begin() + LARGE_MESSAGE_HEADER_SIZE,
+                           message.end()));
+    EXPECT_EQ(m_messages[0], following);
+}
+
+TEST_F(TCPTransportSession_test, LargeMessageReadAtOnceIsCopiedIntoItsBuffer)
+{
+    const auto message = makeMessage(LARGE_MESSAGE_SIZE, 8U);
+    std::vector<uint8_t> stream;
+    appendFrame(stream, message);
+    write(stream.data(), stream.size());
+
+    ASSERT_TRUE(runUntil([this]() { return m_largeMessageReadCount == 1U; }));
+    EXPECT_TRUE(m_isLargeMessageComplete);
+    EXPECT_TRUE(std::equal(m_largeMessageBuffer.begin(),
+                           m_largeMessageBuffer.end(),
+                           message.begin() + LARGE_MESSAGE_HEADER_SIZE,
+                           message.end()));
+}
+
+TEST_F(TCPTransportSession_test, DiscardedLargeMessageIsSkipped)
+{
+    m_isLargeMessageDiscarded = true;
+    const auto message = makeMessage(LARGE_MESSAGE_SIZE, 9U);
+    const auto following = makeMessage(100U, 10U);
+    std::vector<uint8_t> stream;
+    appendFrame(stream, message);
+    appendFrame(stream, following);
+    write(stream.data(), stream.size());
+
+    ASSERT_TRUE(runUntil([this]() { return m_messages.size() == 1U; }));
+    EXPECT_EQ(m_largeMessageSize, LARGE_MESSAGE_SIZE);
+    EXPECT_EQ(m_largeMessageReadCount, 0U);
+    EXPECT_EQ(m_messages[0], following);
+}
+
+TEST_F(TCPTransportSession_test, SentMessageIsFramedWithItsLength)
+{
+    const auto header = makeMessage(20U, 11U);
+    const auto payload = makeMessage(3000U, 12U);
+    m_sut->sendData(header.data(), header.size(), payload.data(), payload.size());
+    runFor(std::chrono::milliseconds(50));
+
+    // Preceded by the empty frame which confirms the connection
+    size_t size = 1U;
+    asio::read(m_client, asio::buffer(&size, sizeof(size)));
+    ASSERT_EQ(size, 0U);
+    asio::read(m_client, asio::buffer(&size, sizeof(size)));
+    ASSERT_EQ(size, header.size() + payload.size());
+    std::vector<uint8_t> message(size);
+    asio::read(m_client, asio::buffer(message));
+    EXPECT_TRUE(std::equal(header.begin(), header.end(), message.begin()));
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), message.begin() + header.size()));
+}
+
+TEST_F(TCPTransportSession_test, QueuedMessagesAreWrittenWithASingleGatherWrite)
+{
+    std::vector<std::vector<uint8_t>> messages;
+    for (uint32_t i = 0U; i < 10U; ++i)
+    {
+        messages.push_back(makeMessage(100U + i, static_cast<uint8_t>(i)));
+        m_sut->sendData(messages.back().data(), messages.back().size(), nullptr, 0U);
+    }
+    runFor(std::chrono::milliseconds(50));
+
+    // The empty frame which confirms the connection is still queued as well
+    std::vector<std::vector<uint8_t>> expected{{}};
+    expected.insert(expected.end(), messages.begin(), messages.end());
+    for (const auto& message : expected)
+    {
+        size_t size = 0U;
+        asio::read(m_client, asio::buffer(&size, sizeof(size)));
+        ASSERT_EQ(size, message.size());
+        std::vector<uint8_t> received(size);
+        asio::read(m_client, asio::buffer(received));
+        EXPECT_EQ(received, message);
+    }
+    TransportStatistics_t stats;
+    m_sut->addStatistics(stats);
+    EXPECT_EQ(stats.sentMessages, messages.size());
+    EXPECT_EQ(stats.sendCalls, 1U);
+}
+
+TEST_F(TCPTransportSession_test, HeartbeatsAreNotHandedOver)
+{
+    const auto message = makeMessage(100U, 5U);
+    std::vector<uint8_t> stream;
+    appendFrame(stream, {});
+    appendFrame(stream, message);
+    appendFrame(stream, {});
+    write(stream.data(), stream.size());
+
+    ASSERT_TRUE(runUntil([this]() { return m_messages.size() == 1U; }));
+    runFor(std::chrono::milliseconds(50));
+    ASSERT_EQ(m_messages.size(), 1U);
+    EXPECT_EQ(m_messages[0], message);
+}
+
+TEST_F(TCPTransportSession_test, OpenedSessionConfirmsTheConnectionWithoutHeartbeats)
+{
+    runFor(std::chrono::milliseconds(50));
+
+    size_t size = 1U;
+    asio::read(m_client, asio::buffer(&size, sizeof(size)));
+    EXPECT_EQ(size, 0U);
+}
+
+TEST_F(TCPTransportSession_test, StoppedSessionIsDestroyedOnceItsHandlersHaveRun)
+{
+    const std::weak_ptr<TCPServerTransportSession> session = m_sut;
+    m_sut->stop();
+    m_sut.reset();
+
+    // The aborted read is still pending and keeps the session alive
+    EXPECT_FALSE(session.expired());
+    EXPECT_EQ(m_closedCount, 1U);
+    ASSERT_TRUE(runUntil([&session]() { return session.expired(); }));
+}
+
+TEST_F(TCPTransportSessionIoUring_test, FramesAndLargeMessagesAreReceived)
+{
+    const auto message = makeMessage(5000U, 13U);
+    const auto largeMessage = makeMessage(LARGE_MESSAGE_SIZE, 14U);
+    const auto following = makeMessage(100U, 15U);
+    std::vector<uint8_t> stream;
+    appendFrame(stream, message);
+    appendFrame(stream, largeMessage);
+    appendFrame(stream, following);
+
+    // Split within the first frame and within the large message
+    write(stream.data(), 2000U);
+    runFor(std::chrono::milliseconds(50));
+    EXPECT_TRUE(m_messages.empty());
+    write(stream.data() + 2000U, 20000U);
+    runFor(std::chrono::milliseconds(50));
+    write(stream.data() + 22000U, stream.size() - 22000U);
+
+    ASSERT_TRUE(runUntil([this]() { return m_largeMessageReadCount == 1U && m_messages.size() == 2U; }));
+    EXPECT_EQ(m_messages[0], message);
+    EXPECT_EQ(m_messages[1], following);
+    EXPECT_TRUE(m_isLargeMessageComplete);
+    EXPECT_TRUE(std::equal(m_largeMessageBuffer.begin(),
+                           m_largeMessageBuffer.end(),
+                           largeMessage.begin() + LARGE_MESSAGE_HEADER_SIZE,
+                           largeMessage.end()));
+}
+
+TEST_F(TCPTransportSessionIoUring_test, QueuedMessagesAreWrittenWithASingleSend)
+{
+    std::vector<std::vector<uint8_t>> messages;
+    for (uint32_t i = 0U; i < 10U; ++i)
+    {
+        messages.push_back(makeMessage(100U + i, static_cast<uint8_t>(i)));
+        m_sut->sendData(messages.back().data(), messages.back().size(), nullptr, 0U);
+    }
+    runFor(std::chrono::milliseconds(50));
+
+    std::vector<std::vector<uint8_t>> expected{{}};
+    expected.insert(expected.end(), messages.begin(), messages.end());
+    for (const auto& message : expected)
+    {
+        size_t size = 0U;
+        asio::read(m_client, asio::buffer(&size, sizeof(size)));
+        ASSERT_EQ(size, message.size());
+        std::vector<uint8_t> received(size);
+        asio::read(m_client, asio::buffer(received));
+        EXPECT_EQ(received, message);
+    }
+    TransportStatistics_t stats;
+    m_sut->addStatistics(stats);
+    EXPECT_EQ(stats.sentMessages, messages.size());
+    EXPECT_EQ(stats.sendCalls, 1U);
+}
+
+TEST_F(TCPTransportSessionIoUring_test, ClosedConnectionClosesTheSession)
+{
+    asio::error_code ec;
+    m_client.close(ec);
+
+    ASSERT_TRUE(runUntil([this]() { return m_closedCount == 1U; }));
+}
+
+} // namespace
@@ -0,0 +1,118 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/transport.hpp"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+using namespace iox::p3com;
+
+/**
+ * @brief Transport layer which only records the submessages sent with `sendUserData`
+ */
+class RecordingTransport : public TransportLayer
+{
+  public:
+    struct Call_t
+    {
+        const void* data1;
+        size_t size1;
+        const void* data2;
+        size_t size2;
+        uint32_t deviceIndex;
+    };
+
+    void registerDiscoveryCallback(remoteDiscoveryCallback_t) noexcept override
+    {
+    }
+
+    void sendBroadcast(const void*, size_t) noexcept override
+    {
+    }
+
+    void registerUserDataCallback(userDataCallback_t) noexcept override
+    {
+    }
+
+    bool sendUserData(
+        const void* data1, size_t size1, const void* data2, size_t size2, uint32_t deviceIndex) noexcept override
+    {
+        const bool isPending = m_pendingCalls.size() > m_calls.size() && m_pendingCalls[m_calls.size()];
+        m_calls.push_back({data1, size1, data2, size2, deviceIndex});
+        return isPending;
+    }
+
+    size_t maxMessageSize(uint32_t) const noexcept override
+    {
+        return 1024U;
+    }
+
+    TransportType getType() const noexcept override
+    {
+        return TransportType::NONE;
+    }
+
+    // Whether the n-th sent submessage is pending
+    std::vector<bool> m_pendingCalls;
+    std::vector<Call_t> m_calls;
+};
+
+class TransportBatch_test : public ::testing::Test
+{
+  protected:
+    static constexpr uint32_t SEGMENT_COUNT = 3U;
+    static constexpr uint32_t DEVICE_INDEX = 5U;
+
+    void SetUp() override
+    {
+        for (uint32_t i = 0U; i < SEGMENT_COUNT; ++i)
+        {
+            m_segments[i] = {&m_headers[i], i + 1U, &m_payloads[i], 10U * (i + 1U)};
+        }
+    }
+
+    RecordingTransport m_sut;
+    std::array<uint64_t, SEGMENT_COUNT> m_headers{};
+    std::array<std::array<uint8_t, 64U>, SEGMENT_COUNT> m_payloads{};
+    std::array<UserDataSegment_t, SEGMENT_COUNT> m_segments{};
+};
+
+constexpr uint32_t TransportBatch_test::SEGMENT_COUNT;
+constexpr uint32_t TransportBatch_test::DEVICE_INDEX;
+
+TEST_F(TransportBatch_test, SubmessagesAreSentInOrder)
+{
+    EXPECT_EQ(m_sut.sendUserDataBatch(m_segments.data(), SEGMENT_COUNT, DEVICE_INDEX), 0U);
+
+    ASSERT_EQ(m_sut.m_calls.size(), SEGMENT_COUNT);
+    for (uint32_t i = 0U; i < SEGMENT_COUNT; ++i)
+    {
+        const auto& call = m_sut.m_calls[i];
+        EXPECT_EQ(call.data1, m_segments[i].serializedDatagramHeader);
+        EXPECT_EQ(call.size1, m_segments[i].serializedDatagramHeaderSize);
+        EXPECT_EQ(call.data2, m_segments[i].userPayload);
+        EXPECT_EQ(call.size2, m_segments[i].userPayloadSize);
+        EXPECT_EQ(call.deviceIndex, DEVICE_INDEX);
+    }
+}
+
+TEST_F(TransportBatch_test, PendingSubmessagesAreCounted)
+{
+    m_sut.m_pendingCalls = {true, false, true};
+
+    EXPECT_EQ(m_sut.sendUserDataBatch(m_segments.data(), SEGMENT_COUNT, DEVICE_INDEX), 2U);
+}
+
+TEST_F(TransportBatch_test, EmptyBatchSendsNothing)
+{
+    EXPECT_EQ(m_sut.sendUserDataBatch(m_segments.data(), 0U, DEVICE_INDEX), 0U);
+
+    EXPECT_TRUE(m_sut.m_calls.empty());
+}
+
+} // namespace
@@ -0,0 +1,230 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/udp/udp_data_worker.hpp"
+
+#include "gtest/gtest.h"
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <vector>
+
+namespace
+{
+using namespace iox::p3com;
+using namespace iox::p3com::udp;
+
+/**
+ * @brief Sends datagrams to a worker over the loopback interface. The worker thread is held in the data callback of
+ * the first datagram until all datagrams are sent, so that the others are waiting in the socket together.
+ */
+class UDPDataWorker_test : public ::testing::Test
+{
+  protected:
+    static constexpr std::chrono::seconds TIMEOUT{5};
+    static constexpr uint32_t BATCH_SIZE = 8U;
+
+    void TearDown() override
+    {
+        release();
+        m_sut.reset();
+    }
+
+    void createWorker(uint32_t receiveBatchSize, bool segmentationOffload = false)
+    {
+        UDPTransportConfig_t config;
+        config.receiveBatchSize = receiveBatchSize;
+        config.segmentationOffload = segmentationOffload;
+        m_sut = std::make_unique<UDPDataWorker>(
+            0U,
+            config,
+            [this](const void* data, size_t size, const asio::ip::address&, bool) {
+                std::vector<uint8_t> datagram(static_cast<const uint8_t*>(data),
+                                              static_cast<const uint8_t*>(data) + size);
+                bool isFirst = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    isFirst = m_datagrams.empty();
+                    m_datagrams.push_back(std::move(datagram));
+                }
+                m_received.notify_all();
+                if (isFirst)
+                {
+                    m_release.wait();
+                }
+            },
+            [this]() { m_isFailed = true; },
+            [](uint64_t) {},
+            nullptr,
+            nullptr);
+        ASSERT_FALSE(m_isFailed);
+    }
+
+    void send(uint32_t count)
+    {
+        asio::ip::udp::socket socket{m_ioService, asio::ip::udp::v4()};
+        const asio::ip::udp::endpoint endpoint{asio::ip::address_v4::loopback(), UDPDataWorker::DATA_PORT};
+        for (uint32_t i = 0U; i < count; ++i)
+        {
+            const std::vector<uint8_t> datagram(100U + i, static_cast<uint8_t>(i));
+            socket.send_to(asio::buffer(datagram), endpoint);
+            if (i == 0U)
+            {
+                // The other datagrams are sent while the worker thread is held by the first one
+                ASSERT_TRUE(waitForDatagrams(1U));
+            }
+        }
+    }
+
+    void release()
+    {
+        if (!m_isReleased)
+        {
+            m_isReleased = true;
+            m_releasePromise.set_value();
+        }
+    }
+
+    bool waitForDatagrams(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_received.wait_for(lock, TIMEOUT, [this, count]() { return m_datagrams.size() >= count; });
+    }
+
+    void expectDatagramsInOrder(uint32_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ASSERT_EQ(m_datagrams.size(), count);
+        for (uint32_t i = 0U; i < count; ++i)
+        {
+            EXPECT_EQ(m_datagrams[i], std::vector<uint8_t>(100U + i, static_cast<uint8_t>(i))) << "datagram " << i;
+        }
+    }
+
+    // Submessages with a header and a payload, the last one is shorter
+    void makeSegments(uint32_t count, size_t payloadSize)
+    {
+        m_headers.clear();
+        m_payloads.clear();
+        m_segments.clear();
+        for (uint32_t i = 0U; i < count; ++i)
+        {
+            m_headers.emplace_back(16U, static_cast<uint8_t>(i));
+            m_payloads.emplace_back(i + 1U == count ? payloadSize / 2U : payloadSize, static_cast<uint8_t>(i + 100U));
+        }
+        for (uint32_t i = 0U; i < count; ++i)
+        {
+            m_segments.push_back(
+                {m_headers[i].data(), m_headers[i].size(), m_payloads[i].data(), m_payloads[i].size()});
+        }
+    }
+
+    void expectSegmentsReceived(asio::ip::udp::socket& receiver)
+    {
+        // The datagrams are only waited for briefly, so that a lost one fails the test instead of blocking it
+        const struct timeval timeout{static_cast<time_t>(TIMEOUT.count()), 0};
+        ASSERT_EQ(setsockopt(receiver.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)), 0);
+        std::vector<uint8_t> datagram(UDPDataWorker::MAX_DATAGRAM_SIZE);
+        for (size_t i = 0U; i < m_segments.size(); ++i)
+        {
+            asio::error_code ec;
+            const size_t size = receiver.receive(asio::buffer(datagram), 0, ec);
+            ASSERT_FALSE(ec) << "datagram " << i;
+            auto expected = m_headers[i];
+            expected.insert(expected.end(), m_payloads[i].begin(), m_payloads[i].end());
+            EXPECT_EQ(std::vector<uint8_t>(datagram.begin(), datagram.begin() + size), expected) << "datagram " << i;
+        }
+    }
+
+    asio::io_service m_ioService;
+    std::unique_ptr<UDPDataWorker> m_sut;
+    std::vector<std::vector<uint8_t>> m_headers;
+    std::vector<std::vector<uint8_t>> m_payloads;
+    std::vector<UserDataSegment_t> m_segments;
+    std::atomic<bool> m_isFailed{false};
+
+    std::mutex m_mutex;
+    std::condition_variable m_received;
+    std::vector<std::vector<uint8_t>> m_datagrams;
+    std::promise<void> m_releasePromise;
+    std::shared_future<void> m_release{m_releasePromise.get_future().share()};
+    bool m_isReleased{false};
+};
+
+constexpr std::chrono::seconds UDPDataWorker_test::TIMEOUT;
+constexpr uint32_t UDPDataWorker_test::BATCH_SIZE;
+
+TEST_F(UDPDataWorker_test, WaitingDatagramsAreReceivedWithASingleWakeup)
+{
+    createWorker(BATCH_SIZE);
+    send(1U + BATCH_SIZE);
+    release();
+
+    ASSERT_TRUE(waitForDatagrams(1U + BATCH_SIZE));
+    expectDatagramsInOrder(1U + BATCH_SIZE);
+    const auto stats = m_sut->getStatistics();
+    EXPECT_EQ(stats.receivedMessages, 1U + BATCH_SIZE);
+    // One wakeup for the first datagram and one for all datagrams which were sent while it was handled
+    EXPECT_EQ(stats.receiveWakeups, 2U);
+}
+
+TEST_F(UDPDataWorker_test, BatchIsLimitedToTheConfiguredSize)
+{
+    createWorker(BATCH_SIZE);
+    send(1U + 2U * BATCH_SIZE);
+    release();
+
+    ASSERT_TRUE(waitForDatagrams(1U + 2U * BATCH_SIZE));
+    expectDatagramsInOrder(1U + 2U * BATCH_SIZE);
+    const auto stats = m_sut->getStatistics();
+    EXPECT_EQ(stats.receivedMessages, 1U + 2U * BATCH_SIZE);
+    EXPECT_EQ(stats.receiveWakeups, 3U);
+}
+
+TEST_F(UDPDataWorker_test, WithoutBatchingEveryDatagramNeedsItsOwnWakeup)
+{
+    createWorker(1U);
+    send(1U + BATCH_SIZE);
+    release();
+
+    ASSERT_TRUE(waitForDatagrams(1U + BATCH_SIZE));
+    expectDatagramsInOrder(1U + BATCH_SIZE);
+    const auto stats = m_sut->getStatistics();
+    EXPECT_EQ(stats.receivedMessages, 1U + BATCH_SIZE);
+    EXPECT_EQ(stats.receiveWakeups, 1U + BATCH_SIZE);
+}
+
+TEST_F(UDPDataWorker_test, SubmessagesAreSentInOrderWithASingleCall)
+{
+    createWorker(BATCH_SIZE);
+    asio::ip::udp::socket receiver{m_ioService, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0U)};
+    makeSegments(BATCH_SIZE, 1000U);
+
+    EXPECT_EQ(m_sut->send(m_segments.data(), BATCH_SIZE, receiver.local_endpoint()), BATCH_SIZE);
+    expectSegmentsReceived(receiver);
+    const auto stats = m_sut->getStatistics();
+    EXPECT_EQ(stats.sentMessages, BATCH_SIZE);
+    EXPECT_EQ(stats.sendCalls, 1U);
+}
+
+TEST_F(UDPDataWorker_test, SegmentationOffloadKeepsTheDatagramBoundaries)
+{
+    // Falls back to sendmmsg if the kernel does not support UDP_SEGMENT, which has to deliver the same datagrams
+    createWorker(BATCH_SIZE, true);
+    asio::ip::udp::socket receiver{m_ioService, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0U)};
+    makeSegments(BATCH_SIZE, 1000U);
+
+    EXPECT_EQ(m_sut->send(m_segments.data(), BATCH_SIZE, receiver.local_endpoint()), BATCH_SIZE);
+    expectSegmentsReceived(receiver);
+    EXPECT_EQ(m_sut->getStatistics().sentMessages, BATCH_SIZE);
+}
+
+} // namespace
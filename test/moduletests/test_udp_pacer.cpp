@@ -0,0 +1,164 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/udp/udp_pacer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+using namespace iox::p3com;
+using namespace iox::p3com::udp;
+
+class UDPPacer_test : public ::testing::Test
+{
+  protected:
+    static constexpr uint32_t DEVICE_INDEX = 1U;
+    // 80 Mbit/s, i.e. 10 MB/s
+    static constexpr uint32_t MAX_RATE_MBPS = 80U;
+    static constexpr uint64_t MAX_RATE = 10000000U;
+    static constexpr size_t MIN_BURST_SIZE = 65536U;
+
+    static UDPTransportConfig_t makeConfig(bool isAdaptive)
+    {
+        UDPTransportConfig_t config;
+        config.maxRateMbps = MAX_RATE_MBPS;
+        config.reliability = isAdaptive;
+        return config;
+    }
+
+    // The rate is adapted at most once per 5 ms
+    static void waitForAdaptation()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(6));
+    }
+};
+
+constexpr uint32_t UDPPacer_test::DEVICE_INDEX;
+constexpr uint32_t UDPPacer_test::MAX_RATE_MBPS;
+constexpr uint64_t UDPPacer_test::MAX_RATE;
+constexpr size_t UDPPacer_test::MIN_BURST_SIZE;
+
+TEST_F(UDPPacer_test, UnusedDeviceHasNoRate)
+{
+    UDPPacer sut{makeConfig(false)};
+
+    EXPECT_EQ(sut.rate(DEVICE_INDEX), 0U);
+    EXPECT_EQ(sut.burstSize(DEVICE_INDEX), MIN_BURST_SIZE);
+}
+
+TEST_F(UDPPacer_test, DeviceWithoutFeedbackIsPacedWithMaximumRate)
+{
+    UDPPacer sut{makeConfig(false)};
+    sut.consume(DEVICE_INDEX, 1U);
+
+    EXPECT_EQ(sut.rate(DEVICE_INDEX), MAX_RATE);
+    EXPECT_EQ(sut.rate(DEVICE_INDEX + 1U), 0U);
+}
+
+TEST_F(UDPPacer_test, InvalidDeviceIndexIsNotPaced)
+{
+    UDPPacer sut{makeConfig(false)};
+    sut.consume(MAX_DEVICE_COUNT, 1000000U);
+
+    EXPECT_EQ(sut.rate(MAX_DEVICE_COUNT), 0U);
+    EXPECT_EQ(sut.burstSize(MAX_DEVICE_COUNT), MIN_BURST_SIZE);
+}
+
+TEST_F(UDPPacer_test, FullBurstIsSentWithoutWaiting)
+{
+    UDPPacer sut{makeConfig(false)};
+    const auto start = std::chrono::steady_clock::now();
+    sut.acquire(DEVICE_INDEX, MIN_BURST_SIZE);
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+}
+
+TEST_F(UDPPacer_test, SenderWaitsForTheDebtOfPreviousSends)
+{
+    UDPPacer sut{makeConfig(false)};
+    // 100 kB beyond the burst take 10 ms at 10 MB/s
+    sut.consume(DEVICE_INDEX, MIN_BURST_SIZE + 100000U);
+    const auto start = std::chrono::steady_clock::now();
+    sut.acquire(DEVICE_INDEX, 1U);
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(8));
+}
+
+TEST_F(UDPPacer_test, BucketIsRefilledWithTheRate)
+{
+    UDPPacer sut{makeConfig(false)};
+    sut.consume(DEVICE_INDEX, MIN_BURST_SIZE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto start = std::chrono::steady_clock::now();
+    sut.acquire(DEVICE_INDEX, MIN_BURST_SIZE);
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+}
+
+TEST_F(UDPPacer_test, AdaptivePacingStartsWithAFractionOfTheMaximumRate)
+{
+    UDPPacer sut{makeConfig(true)};
+    sut.consume(DEVICE_INDEX, 1U);
+
+    EXPECT_EQ(sut.rate(DEVICE_INDEX), MAX_RATE / 8U);
+}
+
+TEST_F(UDPPacer_test, FeedbackIsIgnoredWithoutAdaptivePacing)
+{
+    UDPPacer sut{makeConfig(false)};
+    sut.consume(DEVICE_INDEX, 1U);
+    waitForAdaptation();
+    sut.feedback(DEVICE_INDEX, true, std::chrono::steady_clock::duration::zero(), 1000U);
+
+    EXPECT_EQ(sut.rate(DEVICE_INDEX), MAX_RATE);
+}
+
+TEST_F(UDPPacer_test, RateGrowsInSlowStart)
+{
+    UDPPacer sut{makeConfig(true)};
+    sut.consume(DEVICE_INDEX, 1U);
+    waitForAdaptation();
+    sut.feedback(DEVICE_INDEX, false, std::chrono::steady_clock::duration::zero(), 1000U);
+
+    EXPECT_NEAR(static_cast<double>(sut.rate(DEVICE_INDEX)), MAX_RATE / 8.0 * 1.5, 1.0);
+}
+
+TEST_F(UDPPacer_test, RateShrinksOnLoss)
+{
+    UDPPacer sut{makeConfig(true)};
+    sut.consume(DEVICE_INDEX, 1U);
+    waitForAdaptation();
+    sut.feedback(DEVICE_INDEX, true, std::chrono::steady_clock::duration::zero(), 1000U);
+
+    EXPECT_NEAR(static_cast<double>(sut.rate(DEVICE_INDEX)), MAX_RATE / 8.0 * 0.7, 1.0);
+}
+
+TEST_F(UDPPacer_test, RateIsAdaptedOncePerPeriod)
+{
+    UDPPacer sut{makeConfig(true)};
+    sut.consume(DEVICE_INDEX, 1U);
+    waitForAdaptation();
+    sut.feedback(DEVICE_INDEX, true, std::chrono::steady_clock::duration::zero(), 1000U);
+    sut.feedback(DEVICE_INDEX, true, std::chrono::steady_clock::duration::zero(), 1000U);
+
+    EXPECT_NEAR(static_cast<double>(sut.rate(DEVICE_INDEX)), MAX_RATE / 8.0 * 0.7, 1.0);
+}
+
+TEST_F(UDPPacer_test, RateNeverExceedsTheMaximum)
+{
+    UDPPacer sut{makeConfig(true)};
+    sut.consume(DEVICE_INDEX, 1U);
+    for (uint32_t i = 0U; i < 8U; ++i)
+    {
+        waitForAdaptation();
+        sut.feedback(DEVICE_INDEX, false, std::chrono::steady_clock::duration::zero(), 1000U);
+    }
+
+    EXPECT_EQ(sut.rate(DEVICE_INDEX), MAX_RATE);
+}
+
+} // namespace
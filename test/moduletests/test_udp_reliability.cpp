@@ -0,0 +1,156 @@
+// Copyright 2023 NXP
+
+#include "p3com/transport/udp/udp_reliability.hpp"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+namespace
+{
+using namespace iox::p3com::udp;
+
+class UDPRangeList_test : public ::testing::Test
+{
+  protected:
+    using Range_t = UDPRangeList::Range_t;
+
+    bool insert(uint32_t offset, uint32_t size)
+    {
+        return m_sut.insert({offset, size});
+    }
+
+    static void expectRanges(const Range_t* ranges, uint32_t count, std::initializer_list<Range_t> expected)
+    {
+        ASSERT_EQ(count, expected.size());
+        uint32_t i = 0U;
+        for (const auto& range : expected)
+        {
+            EXPECT_EQ(ranges[i].offset, range.offset) << "range " << i;
+            EXPECT_EQ(ranges[i].size, range.size) << "range " << i;
+            ++i;
+        }
+    }
+
+    void expectRanges(std::initializer_list<Range_t> expected) const
+    {
+        std::array<Range_t, UDPRangeList::MAX_RANGE_COUNT> ranges{};
+        for (uint32_t i = 0U; i < m_sut.size(); ++i)
+        {
+            ranges[i] = m_sut[i];
+        }
+        expectRanges(ranges.data(), m_sut.size(), expected);
+    }
+
+    void expectMissingRanges(uint32_t totalSize, uint32_t maxCount, std::initializer_list<Range_t> expected) const
+    {
+        std::array<Range_t, UDPRangeList::MAX_RANGE_COUNT> ranges{};
+        const uint32_t count = m_sut.missingRanges(totalSize, ranges.data(), maxCount);
+        expectRanges(ranges.data(), count, expected);
+    }
+
+    UDPRangeList m_sut;
+};
+
+TEST_F(UDPRangeList_test, DisjointRangesAreKeptSorted)
+{
+    EXPECT_TRUE(insert(200U, 10U));
+    EXPECT_TRUE(insert(0U, 10U));
+    EXPECT_TRUE(insert(100U, 10U));
+
+    expectRanges({{0U, 10U}, {100U, 10U}, {200U, 10U}});
+    EXPECT_EQ(m_sut.coveredSize(), 30U);
+}
+
+TEST_F(UDPRangeList_test, TouchingRangesAreMerged)
+{
+    EXPECT_TRUE(insert(0U, 10U));
+    EXPECT_TRUE(insert(10U, 10U));
+
+    expectRanges({{0U, 20U}});
+}
+
+TEST_F(UDPRangeList_test, RangeClosingAGapMergesBothNeighbours)
+{
+    EXPECT_TRUE(insert(0U, 10U));
+    EXPECT_TRUE(insert(20U, 10U));
+    EXPECT_TRUE(insert(10U, 10U));
+
+    expectRanges({{0U, 30U}});
+    EXPECT_EQ(m_sut.coveredSize(), 30U);
+}
+
+TEST_F(UDPRangeList_test, OverlappingRangeSwallowsAllRangesItSpans)
+{
+    EXPECT_TRUE(insert(0U, 10U));
+    EXPECT_TRUE(insert(20U, 10U));
+    EXPECT_TRUE(insert(40U, 10U));
+    EXPECT_TRUE(insert(100U, 10U));
+    EXPECT_TRUE(insert(5U, 40U));
+
+    expectRanges({{0U, 50U}, {100U, 10U}});
+    EXPECT_EQ(m_sut.coveredSize(), 60U);
+}
+
+TEST_F(UDPRangeList_test, RangeBeforeTheFirstIsMergedOnlyWhenTouching)
+{
+    EXPECT_TRUE(insert(50U, 10U));
+    EXPECT_TRUE(insert(30U, 10U));
+    EXPECT_TRUE(insert(40U, 5U));
+
+    expectRanges({{30U, 15U}, {50U, 10U}});
+}
+
+TEST_F(UDPRangeList_test, CoveredRangesAreDetected)
+{
+    EXPECT_TRUE(insert(0U, 10U));
+    EXPECT_TRUE(insert(20U, 10U));
+
+    EXPECT_TRUE(m_sut.isCovered({0U, 10U}));
+    EXPECT_TRUE(m_sut.isCovered({22U, 5U}));
+    EXPECT_FALSE(m_sut.isCovered({5U, 10U}));
+    EXPECT_FALSE(m_sut.isCovered({10U, 10U}));
+}
+
+TEST_F(UDPRangeList_test, FullListOnlyAcceptsMergingRanges)
+{
+    for (uint32_t i = 0U; i < UDPRangeList::MAX_RANGE_COUNT; ++i)
+    {
+        EXPECT_TRUE(insert(i * 20U, 10U));
+    }
+
+    EXPECT_FALSE(insert(UDPRangeList::MAX_RANGE_COUNT * 20U, 10U));
+    EXPECT_EQ(m_sut.size(), UDPRangeList::MAX_RANGE_COUNT);
+
+    EXPECT_TRUE(insert(10U, 10U));
+    EXPECT_EQ(m_sut.size(), UDPRangeList::MAX_RANGE_COUNT - 1U);
+    EXPECT_EQ(m_sut[0].offset, 0U);
+    EXPECT_EQ(m_sut[0].size, 30U);
+}
+
+TEST_F(UDPRangeList_test, MissingRangesAreTheGapsAndTheTail)
+{
+    EXPECT_TRUE(insert(10U, 10U));
+    EXPECT_TRUE(insert(30U, 10U));
+
+    expectMissingRanges(50U, UDPRangeList::MAX_RANGE_COUNT, {{0U, 10U}, {20U, 10U}, {40U, 10U}});
+}
+
+TEST_F(UDPRangeList_test, CompleteMessageHasNoMissingRanges)
+{
+    EXPECT_TRUE(insert(0U, 50U));
+
+    expectMissingRanges(50U, UDPRangeList::MAX_RANGE_COUNT, {});
+}
+
+TEST_F(UDPRangeList_test, OnlyTheFirstMissingRangesAreWritten)
+{
+    EXPECT_TRUE(insert(10U, 10U));
+    EXPECT_TRUE(insert(30U, 10U));
+
+    expectMissingRanges(50U, 2U, {{0U, 10U}, {20U, 10U}});
+}
+
+} // namespace